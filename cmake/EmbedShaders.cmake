@@ -0,0 +1,67 @@
+# 由pbr_embed_shaders以cmake -P调用，把SPIR-V写为constexpr数组与注册表
+#
+# 输入：
+#   OUTPUT  生成的源文件路径
+#   ENTRIES 注册表项列表，每项为"名称|排列|SPIR-V路径"（默认排列为空）
+
+# 脚本模式没有工程的策略设置（列表需保留空的排列字段）
+cmake_minimum_required(VERSION 3.10)
+
+set(arrays "")
+set(table "")
+set(index 0)
+foreach(entry IN LISTS ENTRIES)
+  string(REPLACE "|" ";" fields "${entry}")
+  list(GET fields 0 name)
+  list(GET fields 1 permutation)
+  list(GET fields 2 path)
+
+  file(READ "${path}" hex HEX)
+  string(LENGTH "${hex}" length)
+  math(EXPR remainder "${length} % 8")
+  if(length EQUAL 0 OR NOT remainder EQUAL 0)
+    message(FATAL_ERROR "Invalid SPIR-V size: ${path}")
+  endif()
+  math(EXPR word_count "${length} / 8")
+
+  # SPIR-V按小端32位字存储，每行6个字（CMake正则不支持{n}重复）
+  string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1, " words "${hex}")
+  set(word "0x........, ")
+  set(line "${word}${word}${word}${word}${word}${word}")
+  string(REGEX REPLACE "(${line})" "\\1\n" words "${words}")
+  string(REPLACE " \n" "\n    " words "${words}")
+  string(REGEX REPLACE "[, \n]+$" "" words "${words}")
+  if(permutation)
+    string(APPEND arrays "// ${name}.${permutation}\n")
+  else()
+    string(APPEND arrays "// ${name}\n")
+  endif()
+  string(APPEND arrays
+    "constexpr uint32_t kCode${index}[] = {\n    ${words}};\n\n")
+  string(APPEND table
+    "    {\"${name}\", \"${permutation}\", kCode${index}, ${word_count}},\n")
+  math(EXPR index "${index} + 1")
+endforeach()
+
+set(content "// 由cmake/EmbedShaders.cmake生成，请勿手动修改\n")
+string(APPEND content "#include \"utils/ShaderRegistry.hpp\"\n\n")
+string(APPEND content "namespace ShaderRegistry {\n\n")
+if(index EQUAL 0)
+  string(APPEND content "std::span<const Entry> Entries() { return {}; }\n")
+else()
+  string(APPEND content "namespace {\n\n${arrays}")
+  string(APPEND content "constexpr Entry kEntries[] = {\n${table}};\n\n")
+  string(APPEND content "}  // namespace\n\n")
+  string(APPEND content
+    "std::span<const Entry> Entries() { return kEntries; }\n")
+endif()
+string(APPEND content "\n}  // namespace ShaderRegistry\n")
+
+# 内容不变时不改写，避免重新编译
+if(EXISTS "${OUTPUT}")
+  file(READ "${OUTPUT}" existing)
+  if(existing STREQUAL content)
+    return()
+  endif()
+endif()
+file(WRITE "${OUTPUT}" "${content}")
@@ -0,0 +1,130 @@
+# GLSL着色器的构建时编译与嵌入
+#
+# shaders/vulkan下的每个着色器编译为<名称>_<阶段>.spv（如geometry_frag.spv），
+# 以pbr_add_shader_permutation登记的排列附加预处理定义编译为
+# <名称>_<阶段>.<排列>.spv。PBR_EMBED_SHADERS开启时全部SPIR-V由
+# EmbedShaders.cmake写入生成的ShaderRegistry.cpp，以constexpr数组嵌入
+# 可执行文件，运行时不读取着色器文件；关闭时注册表为空，运行时从
+# PBR_SHADER_DIR（构建目录下的shaders/）读取，修改GLSL后只需重新编译SPIR-V。
+
+option(PBR_EMBED_SHADERS "Embed compiled SPIR-V into the executable" ON)
+
+set(PBR_SHADER_SOURCE_DIR ${CMAKE_SOURCE_DIR}/shaders/vulkan)
+set(PBR_SHADER_BINARY_DIR ${CMAKE_BINARY_DIR}/shaders)
+# 与VKDeviceSelector要求的最低API版本一致
+set(PBR_SHADER_TARGET_ENV vulkan1.3)
+
+# 优先使用FindVulkan找到的编译器（CMake 3.21+），否则在VULKAN_SDK中查找
+if(Vulkan_GLSLANG_VALIDATOR_EXECUTABLE)
+  set(PBR_GLSLANG_VALIDATOR ${Vulkan_GLSLANG_VALIDATOR_EXECUTABLE})
+else()
+  find_program(PBR_GLSLANG_VALIDATOR glslangValidator
+    HINTS "$ENV{VULKAN_SDK}/bin" "$ENV{VULKAN_SDK}/Bin")
+endif()
+if(Vulkan_GLSLC_EXECUTABLE)
+  set(PBR_GLSLC ${Vulkan_GLSLC_EXECUTABLE})
+else()
+  find_program(PBR_GLSLC glslc
+    HINTS "$ENV{VULKAN_SDK}/bin" "$ENV{VULKAN_SDK}/Bin")
+endif()
+if(NOT PBR_GLSLANG_VALIDATOR AND NOT PBR_GLSLC)
+  message(FATAL_ERROR
+    "glslangValidator or glslc is required to compile shaders "
+    "(install the Vulkan SDK or set VULKAN_SDK)")
+endif()
+
+# 登记着色器排列：pbr_add_shader_permutation(<源文件名> <排列名> [定义...])，
+# 例如pbr_add_shader_permutation(geometry.frag debug PBR_DEBUG_NORMALS=1)
+function(pbr_add_shader_permutation source permutation)
+  string(REPLACE ";" "," defines "${ARGN}")
+  set_property(GLOBAL APPEND PROPERTY PBR_SHADER_PERMUTATIONS
+    "${source}|${permutation}|${defines}")
+endfunction()
+
+# 编译一个着色器排列，输出SPIR-V路径与注册表项（名称|排列|路径）；
+# 着色器以#include引用的*.glsl变化时一并重新编译
+function(_pbr_compile_shader source permutation defines out_spv out_entry)
+  get_filename_component(name ${source} NAME_WE)
+  get_filename_component(extension ${source} EXT)
+  string(SUBSTRING ${extension} 1 -1 stage)
+  set(id "${name}_${stage}")
+  if(permutation)
+    set(file_name "${id}.${permutation}.spv")
+  else()
+    set(file_name "${id}.spv")
+  endif()
+  set(output ${PBR_SHADER_BINARY_DIR}/${file_name})
+
+  set(define_args)
+  foreach(define IN LISTS defines)
+    list(APPEND define_args "-D${define}")
+  endforeach()
+  if(PBR_GLSLANG_VALIDATOR)
+    set(command ${PBR_GLSLANG_VALIDATOR} -V
+      --target-env ${PBR_SHADER_TARGET_ENV} ${define_args}
+      -o ${output} ${source})
+  else()
+    set(command ${PBR_GLSLC} --target-env=${PBR_SHADER_TARGET_ENV}
+      ${define_args} -o ${output} ${source})
+  endif()
+
+  add_custom_command(
+    OUTPUT ${output}
+    COMMAND ${CMAKE_COMMAND} -E make_directory ${PBR_SHADER_BINARY_DIR}
+    COMMAND ${command}
+    DEPENDS ${source} ${PBR_SHADER_INCLUDES}
+    COMMENT "Compiling shader ${file_name}"
+    VERBATIM)
+  set(${out_spv} ${output} PARENT_SCOPE)
+  set(${out_entry} "${id}|${permutation}|${output}" PARENT_SCOPE)
+endfunction()
+
+# 编译全部着色器并把生成的注册表加入target
+function(pbr_embed_shaders target)
+  file(GLOB sources
+    ${PBR_SHADER_SOURCE_DIR}/*.vert
+    ${PBR_SHADER_SOURCE_DIR}/*.frag
+    ${PBR_SHADER_SOURCE_DIR}/*.comp)
+  list(SORT sources)
+  file(GLOB PBR_SHADER_INCLUDES ${PBR_SHADER_SOURCE_DIR}/*.glsl)
+
+  set(outputs)
+  set(entries)
+  foreach(source IN LISTS sources)
+    _pbr_compile_shader(${source} "" "" spv entry)
+    list(APPEND outputs ${spv})
+    list(APPEND entries ${entry})
+  endforeach()
+
+  get_property(permutations GLOBAL PROPERTY PBR_SHADER_PERMUTATIONS)
+  foreach(permutation_entry IN LISTS permutations)
+    string(REPLACE "|" ";" fields "${permutation_entry}")
+    list(GET fields 0 source)
+    list(GET fields 1 permutation)
+    list(GET fields 2 defines)
+    string(REPLACE "," ";" defines "${defines}")
+    _pbr_compile_shader(${PBR_SHADER_SOURCE_DIR}/${source} ${permutation}
+      "${defines}" spv entry)
+    list(APPEND outputs ${spv})
+    list(APPEND entries ${entry})
+  endforeach()
+
+  if(NOT PBR_EMBED_SHADERS)
+    set(entries)
+  endif()
+  # 命令参数中的分号会拆分参数，以生成器表达式传递列表
+  string(REPLACE ";" "$<SEMICOLON>" entries_arg "${entries}")
+
+  set(registry ${CMAKE_BINARY_DIR}/generated/ShaderRegistry.cpp)
+  add_custom_command(
+    OUTPUT ${registry}
+    COMMAND ${CMAKE_COMMAND} "-DOUTPUT=${registry}"
+      "-DENTRIES=${entries_arg}"
+      -P ${CMAKE_SOURCE_DIR}/cmake/EmbedShaders.cmake
+    DEPENDS ${outputs} ${CMAKE_SOURCE_DIR}/cmake/EmbedShaders.cmake
+    COMMENT "Generating shader registry"
+    VERBATIM)
+  target_sources(${target} PRIVATE ${registry})
+  target_compile_definitions(${target} PRIVATE
+    PBR_SHADER_DIR="${PBR_SHADER_BINARY_DIR}/")
+endfunction()
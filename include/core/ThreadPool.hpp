@@ -0,0 +1,56 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 固定大小的工作线程池
+ *
+ * 任务按提交顺序出队执行，Submit返回的future用于等待完成，
+ * 任务中抛出的异常在future.get()时重新抛出。
+ */
+class ThreadPool {
+ public:
+  // threadCount为0时使用硬件并发数
+  explicit ThreadPool(uint32_t threadCount = 0);
+  ~ThreadPool();
+
+  // 禁止拷贝
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  template <typename Func>
+  std::future<void> Submit(Func&& func) {
+    auto task =
+        std::make_shared<std::packaged_task<void()>>(std::forward<Func>(func));
+    std::future<void> future = task->get_future();
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_tasks.emplace([task]() { (*task)(); });
+    }
+    m_condition.notify_one();
+    return future;
+  }
+
+  uint32_t GetThreadCount() const {
+    return static_cast<uint32_t>(m_workers.size());
+  }
+
+  // 硬件并发数（无法获取时返回1）
+  static uint32_t HardwareConcurrency();
+
+ private:
+  void WorkerLoop();
+
+  std::vector<std::thread> m_workers;
+  std::queue<std::function<void()>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stopping = false;
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <chrono>
+
+/**
+ * @brief 简单的CPU计时器
+ *
+ * 基于steady_clock的高精度计时，用于统计CPU端耗时。
+ */
+class Timer {
+ public:
+  Timer() { Reset(); }
+  ~Timer() = default;
+
+  // 重新开始计时
+  void Reset();
+
+  // 获取自上次Reset以来经过的时间
+  double ElapsedSeconds() const;
+  double ElapsedMilliseconds() const;
+  double ElapsedMicroseconds() const;
+
+ private:
+  std::chrono::steady_clock::time_point m_start;
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "VKFrameScheduler.hpp"
+#include "VKProfiler.hpp"
+#include "VKRenderGraph.hpp"
+
+/**
+ * @brief 异步计算队列调度器
+ *
+ * 把渲染图的各批次录制到对应队列族的命令缓冲，并按批次顺序经帧调度器
+ * 提交：每个批次触发本队列时间线的下一个值，批次的跨队列等待转换为
+ * 对另一队列时间线的等待值。
+ * 每个飞行帧每个队列一个命令池，帧开始时整池重置。
+ * 交换链获取信号量由首次访问输出目标的批次等待；呈现信号量随最后一个
+ * 批次（已汇合计算队列）触发，与单队列路径的提交语义一致。
+ */
+class VKAsyncCompute {
+ public:
+  // 一帧的外部同步对象（离屏模式没有信号量）
+  struct FrameSync {
+    vk::Semaphore waitSemaphore;
+    vk::PipelineStageFlags2 waitStage;
+    uint32_t waitBatch = 0;  // 等待waitSemaphore的批次
+    vk::Semaphore signalSemaphore;
+  };
+
+  VKAsyncCompute(vk::Device device, VKFrameScheduler& scheduler,
+                 uint32_t graphicsFamily, uint32_t computeFamily,
+                 uint32_t framesInFlight);
+  ~VKAsyncCompute();
+
+  // 禁止拷贝
+  VKAsyncCompute(const VKAsyncCompute&) = delete;
+  VKAsyncCompute& operator=(const VKAsyncCompute&) = delete;
+
+  // 帧开始时调用（该帧槽位已等待）：整池重置该帧两个队列的命令池
+  void BeginFrame(uint32_t frameIndex);
+
+  // 逐批次录制并提交已编译的渲染图；提供分析器时在首个批次开头录制查询重置
+  void Execute(const VKRenderGraph& graph, VKProfiler* profiler,
+               const FrameSync& sync);
+
+ private:
+  struct QueueFrameData {
+    vk::CommandPool pool;
+    std::vector<vk::CommandBuffer> buffers;
+    uint32_t usedBuffers = 0;  // 本帧已使用的命令缓冲数
+  };
+
+  vk::CommandBuffer AcquireBuffer(QueueFrameData& data);
+
+  vk::Device m_device;
+  VKFrameScheduler& m_scheduler;
+  // m_frames[frame][queue]
+  std::vector<std::array<QueueFrameData, 2>> m_frames;
+  uint32_t m_frameIndex = 0;
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+
+/**
+ * @brief 无绑定（bindless）材质纹理表
+ *
+ * 基于VK_EXT_descriptor_indexing，将所有纹理视图放入一个
+ * 部分绑定（partially bound）的大型采样器数组中。
+ * 材质记录（含纹理索引）存放在VKMaterialTable的存储缓冲中，以binding 1
+ * 绑定，着色器按材质索引取用，绘制时无需重新绑定描述符集。
+ */
+class VKBindlessTable {
+ public:
+  struct Config {
+    uint32_t maxTextures = 4096;  // 纹理数组容量（受设备上限约束）
+  };
+
+  VKBindlessTable(vk::Device device, vk::PhysicalDevice physicalDevice,
+                  uint32_t deviceTextureLimit, const Config& config = {});
+  ~VKBindlessTable();
+
+  // 禁止拷贝
+  VKBindlessTable(const VKBindlessTable&) = delete;
+  VKBindlessTable& operator=(const VKBindlessTable&) = delete;
+
+  // 注册纹理，返回其在纹理数组中的索引
+  uint32_t RegisterTexture(vk::ImageView imageView, vk::Sampler sampler);
+
+  // 改写已注册的纹理槽位（调用方保证该槽位不被在途命令引用）
+  void UpdateTexture(uint32_t index, vk::ImageView imageView,
+                     vk::Sampler sampler);
+
+  // 写入材质记录缓冲（binding 1），需在首次绘制前设置
+  void SetMaterialBuffer(vk::Buffer buffer, vk::DeviceSize size);
+
+  vk::DescriptorSetLayout GetLayout() const { return m_layout; }
+  vk::DescriptorSet GetSet() const { return m_set; }
+  uint32_t GetTextureCount() const { return m_textureCount; }
+
+ private:
+  void CreateLayout();
+  void CreatePool();
+  void AllocateSet();
+
+  vk::Device m_device;
+  vk::PhysicalDevice m_physicalDevice;
+  Config m_config;
+
+  vk::DescriptorSetLayout m_layout;
+  vk::DescriptorPool m_pool;
+  vk::DescriptorSet m_set;
+
+  uint32_t m_textureCount = 0;
+};
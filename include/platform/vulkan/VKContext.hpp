@@ -1,47 +1,166 @@
 #pragma once
+#include <array>
 #include <memory>
+#include <string>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
 #include "../WindowHandler.hpp"
+#include "VKBindlessTable.hpp"
+#include "VKDeferredLighting.hpp"
+#include "VKFrameScheduler.hpp"
+#include "VKGpuCulling.hpp"
+#include "VKIBLBaker.hpp"
+#include "VKMipGenerator.hpp"
+#include "VKOffscreenTarget.hpp"
+#include "VKPipelineCache.hpp"
 #include "VKShader.hpp"
+#include "rendering/MaterialFeatures.hpp"
+#include "vkbasic/VKDescriptorCache.hpp"
 #include "vkbasic/VKDescriptorPool.hpp"
 #include "vkbasic/VKDevice.hpp"
+#include "vkbasic/VKDeviceSelector.hpp"
 #include "vkbasic/VKInstance.hpp"
 #include "vkbasic/VKSwapChain.hpp"
 
 class VKContext {
  public:
+  // 无窗口离屏模式配置
+  struct HeadlessConfig {
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    uint32_t framesInFlight = 3;  // 同时在途的帧数（回读与渲染重叠）
+    VKOffscreenTarget::FileFormat fileFormat =
+        VKOffscreenTarget::FileFormat::PNG;
+    std::string outputDirectory;  // 为空时不写出文件
+  };
+
   VKContext(Window* window) : m_windowHandle(window) { Init(); }
+  explicit VKContext(const HeadlessConfig& config)
+      : m_windowHandle(nullptr), m_headless(true), m_headlessConfig(config) {
+    Init();
+  }
+  ~VKContext();
   Window* m_windowHandle;
 
-  // 渲染管线
+  // 离屏模式下不创建表面与交换链
+  bool m_headless = false;
+  HeadlessConfig m_headlessConfig;
+
+  // 渲染管线（动态渲染，输出到G-Buffer）
   vk::PipelineLayout m_pipelineLayout;
-  vk::Pipeline m_graphicsPipeline;
+
+  // 几何管线变体（按绘制路径区分顶点着色器与材质绑定方式），由管线缓存
+  // 持有：逐对象直接绘制在初始化时同步编译，其余变体在后台编译
+  enum class GeometryPipeline : uint32_t {
+    Direct,
+    Bindless,
+    Indirect,
+    IndirectBindless
+  };
+  std::unique_ptr<VKPipelineCache> m_pipelineCache;
+  // 不阻塞：按材质特性位取得特化变体，未就绪时退回通用变体（kAll），
+  // 通用变体也未就绪时返回兼容的已就绪管线或空（调用方跳过相关绘制）
+  vk::Pipeline acquireGeometryPipeline(
+      GeometryPipeline kind,
+      uint32_t materialFeatures = MaterialFeatures::kAll) const;
+
+  // G-Buffer布局：完整布局为位置、法线、反照率、材质参数；
+  // 紧凑布局由深度重建位置，法线以八面体编码存入双通道，
+  // 反照率与材质参数为RGBA8（几何与光照着色器以特化常量切换）
+  enum class GBufferLayout : uint32_t { Full = 0, Lean = 1 };
+  struct GBufferFormats {
+    std::vector<vk::Format> color;  // 与geometry.frag的输出顺序一致
+    vk::Format depth = vk::Format::eUndefined;
+    uint32_t BytesPerPixel() const;
+  };
+  GBufferLayout m_gbufferLayout = GBufferLayout::Full;
+  GBufferFormats m_gbufferFormats;  // 当前布局的格式
+
+  // 切换G-Buffer布局：等待设备空闲后按新格式取得几何与光照管线
+  void setGBufferLayout(GBufferLayout layout);
 
   // 描述符相关
   vk::DescriptorSetLayout m_descriptorSetLayout;
   std::vector<vk::DescriptorSet> m_descriptorSets;
   vk::Sampler m_textureSampler;
 
-  // 同步对象
+  // 无绑定路径（设备支持描述符索引时可用）
+  bool m_bindlessSupported = false;
+  std::shared_ptr<VKBindlessTable> m_bindlessTable;
+  vk::DescriptorSetLayout m_frameSetLayout;  // 仅含逐对象变换UBO的set 0
+  vk::PipelineLayout m_bindlessPipelineLayout;
+
+  // 间接绘制路径：逐绘制数据以gl_InstanceIndex索引（着色器缺失时不可用）
+  // 逐材质布局为材质集+绘制集，无绑定布局为帧集+绘制集+纹理表
+  bool m_indirectSupported = false;
+  vk::DescriptorSetLayout m_drawSetLayout;  // 逐绘制数据SSBO（动态偏移）
+  vk::PipelineLayout m_indirectPipelineLayout;
+  vk::PipelineLayout m_indirectBindlessPipelineLayout;
+
+  // GPU剔除：视锥与两阶段层次Z遮挡剔除，输出压缩后的间接命令
+  // （依赖间接绘制路径与firstInstance，计算着色器缺失时不可用）
+  bool m_gpuCullingSupported = false;
+  vk::DescriptorSetLayout m_cullSetLayout;
+  vk::PipelineLayout m_cullPipelineLayout;
+  vk::Pipeline m_cullPipeline;
+  vk::DescriptorSetLayout m_pyramidSetLayout;  // 深度金字塔逐级归约
+  vk::PipelineLayout m_pyramidPipelineLayout;
+  vk::Pipeline m_pyramidPipeline;
+
+  // 分块延迟光照：光源分块与着色两个计算管线共用一个布局
+  // （计算着色器缺失时呈现过程直接复制反照率）
+  bool m_deferredLightingSupported = false;
+  vk::DescriptorSetLayout m_lightingSetLayout;
+  vk::PipelineLayout m_lightingPipelineLayout;
+  vk::Pipeline m_lightCullPipeline;
+  vk::Pipeline m_lightingPipeline;
+
+  // IBL烘焙的计算后端：预过滤与BRDF查找表共用一个布局
+  // （计算着色器缺失时IBLBaker只使用CPU路径）
+  bool m_iblBakeSupported = false;
+  vk::DescriptorSetLayout m_iblSetLayout;
+  vk::PipelineLayout m_iblPipelineLayout;
+  vk::Pipeline m_iblPrefilterPipeline;
+  vk::Pipeline m_brdfLutPipeline;
+  VKIBLBaker::Pipelines getIBLPipelines() const;
+
+  // GPU mip生成的计算降采样（着色器缺失时只使用blit）
+  bool m_mipGenComputeSupported = false;
+  vk::DescriptorSetLayout m_mipGenSetLayout;
+  vk::PipelineLayout m_mipGenPipelineLayout;
+  vk::Pipeline m_mipDownsamplePipeline;
+  VKMipGenerator::Pipelines getMipGenPipelines() const;
+
+  // 同步对象：帧与队列间以时间线调度，二值信号量只用于交换链
+  std::unique_ptr<VKFrameScheduler> m_frameScheduler;
   std::vector<vk::Semaphore> m_imageAvailableSemaphores;
   std::vector<vk::Semaphore> m_renderFinishedSemaphores;
-  std::vector<vk::Fence> m_inFlightFences;
   std::vector<vk::CommandBuffer> m_commandBuffers;
   //基础vulkan类
   std::shared_ptr<VKInstance> m_instance;
   std::shared_ptr<VKShader> m_shader;
+  std::shared_ptr<VKShader> m_bindlessShader;
+  std::shared_ptr<VKShader> m_indirectShader;
+  std::shared_ptr<VKShader> m_indirectBindlessShader;
   std::shared_ptr<VKDevice> m_device;
   std::shared_ptr<VKDescriptorPool> m_descriptorPool;
+  std::shared_ptr<VKDescriptorCache> m_descriptorCache;
   std::shared_ptr<VKSwapChain> m_swapChain;
   vk::PhysicalDevice m_physicalDevice;
+  // 选中设备的能力档案（环境变量PBR_DEVICE可强制指定设备）
+  DeviceCapabilities m_deviceCapabilities;
   vk::SurfaceKHR m_surface;
   //命令缓冲池
   std::shared_ptr<vk::CommandPool> m_graphicsCommandPool;
   std::shared_ptr<vk::CommandPool> m_transferCommandPool;
   std::shared_ptr<vk::CommandPool> m_computeCommandPool;
 
+  // 创建逐帧命令缓冲与同步对象（渲染完成信号量按交换链图像数量创建）
+  void createFrameResources(uint32_t framesInFlight);
+  // 交换链重建可能改变图像数量，按当前数量增减渲染完成信号量
+  void syncRenderFinishedSemaphores();
+
  private:
   void Init();
   void createInstance();
@@ -50,5 +169,30 @@ class VKContext {
   void createDevice();
   void createSwapChain();
   void createDescriptorPool();
+  void createDescriptorSetLayout();
+  void createDescriptorCache();
+  void createPipelineLayout();
+  void createTextureSampler();
+  void createBindlessResources();
+  void createGBufferFormats();
+  void createGraphicsPipelines();
+  void createIndirectResources();
+  void createIndirectPipelines();
+  void createCullingResources();
+  void createCullingPipelines();
+  void createLightingResources();
+  void createLightingPipelines();
+  void createIBLResources();
+  void createIBLPipelines();
+  void createMipGenResources();
+  void createMipGenPipelines();
+  // shader为着色器名称（如cull_comp），见ShaderLoader::Load
+  vk::Pipeline createComputePipeline(
+      const std::string& shader, vk::PipelineLayout layout,
+      const vk::SpecializationInfo* specialization = nullptr);
+  // 变体的着色器不可用时返回的描述不含着色器模块
+  VKPipelineCache::GraphicsDesc geometryPipelineDesc(
+      GeometryPipeline kind,
+      uint32_t materialFeatures = MaterialFeatures::kAll) const;
   void createCommandPools();
 };
\ No newline at end of file
@@ -0,0 +1,129 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "vkbasic/VKDescriptorPool.hpp"
+
+/**
+ * @brief 分块延迟光照
+ *
+ * 点光源列表逐帧写入主机可见缓冲，光照分两个计算过程：
+ * - 光源分块：每个16x16像素块一个工作组，由深度缓冲求块内深度范围，
+ *   与块视锥（四个侧面与深度范围）相交的光源写入该块的光源列表。
+ * - 着色：逐像素读取G-Buffer，只对所在块列表中的光源计算Cook-Torrance BRDF，
+ *   经曝光与ACES色调映射写入HDR图像，由呈现过程复制到输出目标。
+ * 着色开销与块内光源数成正比，而非与场景光源总数成正比。
+ */
+class VKDeferredLighting {
+ public:
+  static constexpr uint32_t kTileSize = 16;  // 与两个计算着色器的工作组一致
+  // 每块列表的首元素为光源数，其后最多kMaxLightsPerTile个光源下标
+  static constexpr uint32_t kMaxLightsPerTile = 255;
+  static constexpr vk::Format kOutputFormat = vk::Format::eR16G16B16A16Sfloat;
+
+  // 与light_cull.comp、deferred_lighting.comp中的PointLight一致（std430）
+  struct PointLight {
+    glm::vec3 position{0.0f};
+    float radius = 10.0f;  // 影响范围，之外的贡献截断为0
+    glm::vec3 color{1.0f};
+    float intensity = 1.0f;
+  };
+
+  struct Pipelines {
+    vk::DescriptorSetLayout setLayout;
+    vk::PipelineLayout layout;
+    vk::Pipeline lightCull;
+    vk::Pipeline lighting;
+  };
+
+  // 渲染图编译后的资源（瞬态资源的句柄随编译重建）
+  struct Targets {
+    vk::ImageView depth;
+    vk::ImageView position;  // 紧凑G-Buffer没有位置目标，为空
+    vk::ImageView normal;
+    vk::ImageView albedo;
+    vk::ImageView material;
+    vk::ImageView output;
+    vk::Buffer tileLights;
+  };
+
+  VKDeferredLighting(vk::Device device, vk::PhysicalDevice physicalDevice,
+                     std::shared_ptr<VKDescriptorPool> descriptorPool,
+                     const Pipelines& pipelines, uint32_t framesInFlight);
+  ~VKDeferredLighting();
+
+  // 禁止拷贝
+  VKDeferredLighting(const VKDeferredLighting&) = delete;
+  VKDeferredLighting& operator=(const VKDeferredLighting&) = delete;
+
+  // G-Buffer布局切换后管线按新的特化常量重建
+  void SetPipelines(const Pipelines& pipelines) { m_pipelines = pipelines; }
+
+  // 分块光源列表的字节数（渲染图按此创建瞬态缓冲）
+  static vk::DeviceSize GetTileBufferSize(vk::Extent2D extent);
+
+  // 渲染图编译后调用（调用方已等待设备空闲）
+  void SetTargets(vk::Extent2D extent, const Targets& targets);
+
+  // 帧开始（该帧槽位已等待）：写入本帧的光源与相机参数。
+  // 容量不足时等待设备空闲后扩容
+  void BeginFrame(uint32_t frameIndex, const std::vector<PointLight>& lights,
+                  const glm::mat4& view, const glm::mat4& projection);
+
+  // 渲染图过程中录制
+  void RecordLightCulling(vk::CommandBuffer commandBuffer) const;
+  void RecordLighting(vk::CommandBuffer commandBuffer) const;
+
+  void SetExposure(float exposure) { m_exposure = exposure; }
+  float GetExposure() const { return m_exposure; }
+  void SetAmbient(const glm::vec3& ambient) { m_ambient = ambient; }
+
+ private:
+  // 与着色器中的LightingParams一致（std140）
+  struct LightingParams {
+    glm::mat4 view;
+    glm::mat4 inverseProjection;
+    glm::mat4 inverseViewProjection;  // 紧凑G-Buffer由深度重建世界位置
+    glm::vec4 cameraPosition;         // w为曝光
+    glm::vec4 ambient;
+    uint32_t lightCount;
+    uint32_t tileCountX;
+    uint32_t width;
+    uint32_t height;
+  };
+
+  void CreateLightBuffer(uint32_t capacity);
+  void DestroyLightBuffer();
+  void UpdateBufferDescriptors();
+  void Dispatch(vk::CommandBuffer commandBuffer, vk::Pipeline pipeline) const;
+
+  vk::Device m_device;
+  vk::PhysicalDevice m_physicalDevice;
+  std::shared_ptr<VKDescriptorPool> m_descriptorPool;
+  Pipelines m_pipelines;
+  uint32_t m_framesInFlight;
+
+  // 主机可见：逐帧参数与光源数组（各飞行帧一段，以动态偏移绑定）
+  vk::Buffer m_paramsBuffer;
+  vk::DeviceMemory m_paramsMemory;
+  uint8_t* m_paramsMapped = nullptr;
+  vk::DeviceSize m_paramsStride = 0;
+  vk::Buffer m_lightBuffer;
+  vk::DeviceMemory m_lightMemory;
+  uint8_t* m_lightMapped = nullptr;
+  vk::DeviceSize m_lightStride = 0;
+  uint32_t m_lightCapacity = 0;
+
+  vk::Sampler m_sampler;  // G-Buffer按texelFetch读取，最近邻即可
+  vk::DescriptorSet m_set;
+  vk::Buffer m_tileBuffer;
+  vk::DeviceSize m_tileBytes = 0;
+
+  vk::Extent2D m_extent;
+  uint32_t m_frameIndex = 0;
+  float m_exposure = 1.0f;
+  glm::vec3 m_ambient{0.03f};
+};
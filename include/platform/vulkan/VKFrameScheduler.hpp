@@ -0,0 +1,91 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+/**
+ * @brief 基于时间线信号量的帧调度器
+ *
+ * 图形、计算、传输队列各一个时间线信号量，每次提交触发本队列单调递增
+ * 的下一个值，取代逐帧栅栏：帧槽位复用前以waitSemaphores等待该槽位
+ * 上次记录的图形队列值，资源退休与延迟销毁按提交时各队列的值判断。
+ * 帧的最后一次提交总在图形队列（异步计算的末批次已汇合计算队列），
+ * 图形队列的值即代表整帧完成。
+ * 二值信号量只保留在交换链需要的位置（获取与呈现），由调用方作为
+ * 额外的等待/触发信号量传入Submit。
+ */
+class VKFrameScheduler {
+ public:
+  enum class QueueType : uint32_t { Graphics = 0, Compute, Transfer, Count };
+  static constexpr uint32_t kQueueCount =
+      static_cast<uint32_t>(QueueType::Count);
+
+  // 各队列的时间线值（提交时刻的快照）
+  using Point = std::array<uint64_t, kQueueCount>;
+
+  // queues按QueueType索引；共享同一队列时各自的时间线仍独立计数
+  VKFrameScheduler(vk::Device device,
+                   const std::array<vk::Queue, kQueueCount>& queues,
+                   uint32_t framesInFlight);
+  // 调用方需保证设备空闲，剩余的延迟销毁在此执行
+  ~VKFrameScheduler();
+
+  // 禁止拷贝
+  VKFrameScheduler(const VKFrameScheduler&) = delete;
+  VKFrameScheduler& operator=(const VKFrameScheduler&) = delete;
+
+  // 等待该帧槽位上次提交的工作完成，并回收已完成的延迟销毁
+  void BeginFrame(uint32_t frameIndex);
+  // 记录本帧槽位的完成值（本帧所有提交之后调用）
+  void EndFrame();
+
+  // 提交命令缓冲并触发本队列的下一个时间线值，返回该值；
+  // waits与signals为额外的信号量（二值信号量的值字段被忽略）
+  uint64_t Submit(QueueType queue, vk::CommandBuffer commandBuffer,
+                  const std::vector<vk::SemaphoreSubmitInfo>& waits = {},
+                  const std::vector<vk::SemaphoreSubmitInfo>& signals = {});
+
+  vk::Semaphore GetTimeline(QueueType queue) const {
+    return m_timelines[Index(queue)];
+  }
+  vk::Queue GetQueue(QueueType queue) const { return m_queues[Index(queue)]; }
+  // 最近一次提交的值与GPU已完成的值
+  uint64_t GetSubmittedValue(QueueType queue) const {
+    return m_submitted[Index(queue)];
+  }
+  uint64_t GetCompletedValue(QueueType queue) const;
+  Point GetSubmittedPoint() const { return m_submitted; }
+
+  bool IsComplete(QueueType queue, uint64_t value) const {
+    return GetCompletedValue(queue) >= value;
+  }
+  bool IsComplete(const Point& point) const;
+  void Wait(QueueType queue, uint64_t value) const;
+  // 等待所有队列已提交的工作完成并执行全部延迟销毁
+  void WaitIdle();
+
+  // 当前已提交的工作全部完成后执行destroy（在BeginFrame/Collect中调用）
+  void DeferDestroy(std::function<void()> destroy);
+  // 执行已到期的延迟销毁
+  void Collect();
+
+ private:
+  struct Deferred {
+    Point point;
+    std::function<void()> destroy;
+  };
+
+  static uint32_t Index(QueueType queue) {
+    return static_cast<uint32_t>(queue);
+  }
+
+  vk::Device m_device;
+  std::array<vk::Queue, kQueueCount> m_queues;
+  std::array<vk::Semaphore, kQueueCount> m_timelines;
+  Point m_submitted{};
+  std::vector<uint64_t> m_frameValues;  // 各帧槽位最后一次提交的图形值
+  uint32_t m_frameIndex = 0;
+  std::vector<Deferred> m_deferred;  // 按提交顺序追加
+};
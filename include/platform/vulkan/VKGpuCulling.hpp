@@ -0,0 +1,192 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "VKIndirectDrawList.hpp"
+#include "vkbasic/VKDescriptorPool.hpp"
+
+/**
+ * @brief GPU视锥与两阶段层次Z遮挡剔除
+ *
+ * 输入为间接绘制列表本帧的命令与逐绘制包围球，计算着色器逐绘制测试：
+ * - 阶段一：视锥剔除，并以上一帧的深度金字塔（及上一帧的视图投影）做遮挡测试，
+ *   通过的绘制先行绘制；被遮挡的绘制记录标记。
+ * - 以阶段一的深度构建本帧金字塔，阶段二只复查被标记的绘制，补绘被误剔除的对象；
+ *   全部绘制完成后再次构建金字塔供下一帧阶段一使用。
+ * 支持间接数量扩展时幸存命令按批次压缩并由GPU写入绘制数量，
+ * 否则保持原位并将被剔除命令的instanceCount置零。
+ * 剔除计数写入逐帧主机可见缓冲，在该帧槽位等待后读回。
+ */
+class VKGpuCulling {
+ public:
+  enum class Phase : uint32_t { Early = 0, Late = 1 };
+
+  // 与depth_pyramid.comp的推送常量一致
+  struct PyramidPushConstants {
+    int32_t srcWidth;
+    int32_t srcHeight;
+    int32_t dstWidth;
+    int32_t dstHeight;
+    uint32_t level;  // 0表示从深度缓冲复制
+    uint32_t padding;
+  };
+
+  struct Pipelines {
+    vk::DescriptorSetLayout cullSetLayout;
+    vk::PipelineLayout cullLayout;
+    vk::Pipeline cull;
+    vk::DescriptorSetLayout pyramidSetLayout;
+    vk::PipelineLayout pyramidLayout;
+    vk::Pipeline pyramid;
+  };
+
+  struct Stats {
+    uint32_t drawCount = 0;
+    uint32_t frustumCulled = 0;
+    uint32_t occlusionCulled = 0;  // 两个阶段都判定为被遮挡
+    uint32_t visibleEarly = 0;     // 阶段一绘制
+    uint32_t visibleLate = 0;      // 阶段二补绘
+    uint32_t Visible() const { return visibleEarly + visibleLate; }
+    uint32_t Culled() const { return frustumCulled + occlusionCulled; }
+  };
+
+  VKGpuCulling(vk::Device device, vk::PhysicalDevice physicalDevice,
+               std::shared_ptr<VKDescriptorPool> descriptorPool,
+               const Pipelines& pipelines, uint32_t framesInFlight,
+               bool drawIndirectCount);
+  ~VKGpuCulling();
+
+  // 禁止拷贝
+  VKGpuCulling(const VKGpuCulling&) = delete;
+  VKGpuCulling& operator=(const VKGpuCulling&) = delete;
+
+  // 按深度缓冲尺寸重建金字塔（初始化为最远深度），尺寸不变时直接返回
+  void Resize(vk::Extent2D extent, vk::Queue queue,
+              vk::CommandPool commandPool);
+
+  // 渲染图编译后设置深度源（瞬态深度图像的视图随编译重建）
+  void SetDepthSource(vk::ImageView depthView);
+
+  // 帧开始（该帧槽位已等待、绘制列表已构建）：读回该槽位上次的统计，
+  // 写入本帧两个阶段的参数。容量不足时等待设备空闲后扩容
+  void BeginFrame(uint32_t frameIndex, const VKIndirectDrawList& drawList,
+                  const glm::mat4& viewProjection);
+
+  // 下一帧阶段一不做遮挡测试（如相机跳变后上一帧金字塔不再可信）
+  void InvalidateHistory() { m_historyValid = false; }
+
+  // 渲染图过程中录制
+  void RecordResetCounts(vk::CommandBuffer commandBuffer) const;
+  void RecordCull(vk::CommandBuffer commandBuffer, Phase phase) const;
+  void RecordBuildPyramid(vk::CommandBuffer commandBuffer) const;
+  // 绘制一个批次在指定阶段幸存的命令（调用方已绑定该批次的几何与描述符）
+  void DrawBatch(vk::CommandBuffer commandBuffer, Phase phase,
+                 uint32_t batchIndex,
+                 const VKIndirectDrawList::Batch& batch) const;
+
+  // 导入渲染图的资源（GetGeneration变化表示缓冲已重建）
+  vk::Buffer GetCommandBuffer() const { return m_commandBuffer; }
+  vk::DeviceSize GetCommandBufferSize() const { return m_commandBytes; }
+  vk::Buffer GetCountBuffer() const { return m_countBuffer; }
+  vk::DeviceSize GetCountBufferSize() const { return m_countBytes; }
+  vk::Buffer GetOccludedBuffer() const { return m_occludedBuffer; }
+  vk::DeviceSize GetOccludedBufferSize() const { return m_occludedBytes; }
+  uint32_t GetGeneration() const { return m_generation; }
+
+  vk::Image GetPyramidImage() const { return m_pyramidImage; }
+  vk::ImageView GetPyramidView() const { return m_pyramidView; }
+  vk::Extent2D GetPyramidExtent() const { return m_pyramidExtent; }
+  static constexpr vk::Format kPyramidFormat = vk::Format::eR32Sfloat;
+
+  bool IsCompacting() const { return m_drawIndexedIndirectCount != nullptr; }
+  const Stats& GetLastStats() const { return m_lastStats; }
+
+ private:
+  // 与cull.comp中的CullParams一致（std140）
+  struct CullParams {
+    glm::mat4 occlusionViewProjection;
+    glm::vec4 frustumPlanes[6];
+    glm::vec4 pyramidSize;  // xy为第0级尺寸，z为级数
+    uint32_t drawCount;
+    uint32_t phase;
+    uint32_t occlusionEnabled;
+    uint32_t compact;
+    uint32_t commandBase;  // 输出命令与计数的起始下标（阶段二在后半部分）
+    uint32_t countBase;
+    uint32_t padding[2];
+  };
+
+  // 与cull.comp中的CullStats一致
+  struct GpuStats {
+    uint32_t frustumCulled;
+    uint32_t occludedEarly;
+    uint32_t visibleEarly;
+    uint32_t visibleLate;
+  };
+
+  struct FrameSlot {
+    uint32_t drawCount = 0;
+    uint32_t commandOffset = 0;   // 绘制列表命令区域的动态偏移
+    uint32_t cullDataOffset = 0;  // 绘制列表包围球区域的动态偏移
+    bool submitted = false;
+  };
+
+  void CreateBuffers(uint32_t capacity);
+  void DestroyBuffers();
+  void DestroyPyramid();
+  void UpdateCullSet(const VKIndirectDrawList& drawList);
+  vk::Extent2D GetMipExtent(uint32_t level) const;
+
+  vk::Device m_device;
+  vk::PhysicalDevice m_physicalDevice;
+  std::shared_ptr<VKDescriptorPool> m_descriptorPool;
+  Pipelines m_pipelines;
+  uint32_t m_framesInFlight;
+  PFN_vkCmdDrawIndexedIndirectCountKHR m_drawIndexedIndirectCount = nullptr;
+
+  // 设备本地：两阶段输出命令与批次计数（各占一半），阶段一遮挡标记
+  vk::Buffer m_commandBuffer;
+  vk::DeviceMemory m_commandMemory;
+  vk::DeviceSize m_commandBytes = 0;
+  vk::Buffer m_countBuffer;
+  vk::DeviceMemory m_countMemory;
+  vk::DeviceSize m_countBytes = 0;
+  vk::Buffer m_occludedBuffer;
+  vk::DeviceMemory m_occludedMemory;
+  vk::DeviceSize m_occludedBytes = 0;
+  uint32_t m_capacity = 0;
+  uint32_t m_generation = 0;
+
+  // 主机可见：逐帧两阶段参数与统计计数
+  vk::Buffer m_paramsBuffer;
+  vk::DeviceMemory m_paramsMemory;
+  uint8_t* m_paramsMapped = nullptr;
+  vk::DeviceSize m_paramsStride = 0;
+  vk::Buffer m_statsBuffer;
+  vk::DeviceMemory m_statsMemory;
+  uint8_t* m_statsMapped = nullptr;
+  vk::DeviceSize m_statsStride = 0;
+
+  // 深度金字塔：逐级保持通用布局由归约着色器读写，整体以采样方式供剔除读取
+  vk::Image m_pyramidImage;
+  vk::DeviceMemory m_pyramidMemory;
+  vk::ImageView m_pyramidView;
+  std::vector<vk::ImageView> m_pyramidMipViews;
+  std::vector<vk::DescriptorSet> m_pyramidSets;
+  vk::Extent2D m_pyramidExtent;
+  uint32_t m_pyramidLevels = 0;
+  vk::Sampler m_sampler;
+
+  vk::DescriptorSet m_cullSet;
+  uint32_t m_drawListGeneration = 0;
+  uint32_t m_cullSetGeneration = 0;
+
+  std::vector<FrameSlot> m_slots;
+  uint32_t m_frameIndex = 0;
+  glm::mat4 m_previousViewProjection{1.0f};
+  bool m_historyValid = false;
+  Stats m_lastStats;
+};
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "rendering/IBLBaker.hpp"
+#include "vkbasic/VKDescriptorPool.hpp"
+
+/**
+ * @brief IBL烘焙的Vulkan计算后端
+ *
+ * 源立方体的mip链以RGBA16F上传为可采样的立方体图像，硬件三线性与
+ * 跨面过滤代替CPU的逐面双线性；每级预过滤与BRDF查找表各一次调度，
+ * 结果写入主机可见的存储缓冲，布局与CubeMipLevel一致，可直接拷回。
+ * 任何Vulkan错误都返回false，由IBLBaker回退到CPU路径。
+ */
+class VKIBLBaker : public IBLBaker::ComputeBackend {
+ public:
+  static constexpr uint32_t kGroupSize = 8;  // 与两个计算着色器的工作组一致
+
+  struct Pipelines {
+    vk::DescriptorSetLayout setLayout;
+    vk::PipelineLayout layout;
+    vk::Pipeline prefilter;
+    vk::Pipeline brdfLut;
+  };
+
+  // 与ibl_prefilter.comp、brdf_lut.comp的推送常量一致
+  struct PushConstants {
+    uint32_t size;          // 输出一级（或查找表）的边长
+    uint32_t sampleCount;
+    uint32_t outputOffset;  // 输出缓冲中的起始元素
+    uint32_t sourceSize;    // 源立方体第0级的边长
+    float roughness;
+    float sourceMaxLod;
+  };
+
+  VKIBLBaker(vk::Device device, vk::PhysicalDevice physicalDevice,
+             std::shared_ptr<VKDescriptorPool> descriptorPool,
+             const Pipelines& pipelines, vk::Queue queue,
+             vk::CommandPool commandPool);
+  ~VKIBLBaker() override = default;
+
+  // 禁止拷贝
+  VKIBLBaker(const VKIBLBaker&) = delete;
+  VKIBLBaker& operator=(const VKIBLBaker&) = delete;
+
+  bool Prefilter(const std::vector<CubeMipLevel>& environment,
+                 const IBLBaker::Settings& settings,
+                 std::vector<CubeMipLevel>& prefiltered) override;
+  bool BakeBrdfLut(const IBLBaker::Settings& settings,
+                   std::vector<float>& lut) override;
+
+ private:
+  // 一次烘焙的临时资源，析构时释放
+  struct Resources {
+    vk::Device device;
+    std::shared_ptr<VKDescriptorPool> descriptorPool;
+    vk::Buffer staging;
+    vk::DeviceMemory stagingMemory;
+    vk::Image image;
+    vk::DeviceMemory imageMemory;
+    vk::ImageView view;
+    vk::Sampler sampler;
+    vk::Buffer output;
+    vk::DeviceMemory outputMemory;
+    vk::DescriptorSet set;
+    vk::CommandPool commandPool;
+    vk::CommandBuffer commandBuffer;  // 提交完成后置空
+    ~Resources();
+  };
+
+  void CreateOutputBuffer(Resources& resources, vk::DeviceSize size) const;
+  void UploadEnvironment(Resources& resources,
+                         const std::vector<CubeMipLevel>& environment) const;
+  void BeginCommands(Resources& resources) const;
+  // 输出缓冲对主机可见后提交并等待完成
+  void SubmitAndWait(Resources& resources) const;
+
+  vk::Device m_device;
+  vk::PhysicalDevice m_physicalDevice;
+  std::shared_ptr<VKDescriptorPool> m_descriptorPool;
+  Pipelines m_pipelines;
+  vk::Queue m_queue;
+  vk::CommandPool m_commandPool;
+};
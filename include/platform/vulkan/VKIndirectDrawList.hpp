@@ -0,0 +1,138 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "rendering/ObjectTransform.hpp"
+#include "vkbasic/VKGeometryPool.hpp"
+
+/**
+ * @brief 逐帧间接绘制列表
+ *
+ * 每帧把所有绘制项按（几何池块, 批次键）排序后写入持久映射的
+ * 间接命令缓冲与逐绘制数据缓冲（均按飞行帧划分区域）。
+ * 第i条命令的firstInstance为i，着色器以gl_InstanceIndex索引逐绘制数据；
+ * 块与批次键相同的连续命令组成一个批次，用一次多命令间接绘制提交。
+ * 容量不足时等待设备空闲后扩容，GetGeneration变化表示缓冲已重建。
+ * 命令与逐绘制包围球同时可作为存储缓冲读取，供GPU剔除生成压缩后的命令。
+ */
+class VKIndirectDrawList {
+ public:
+  // 与geometry_indirect.vert中的DrawData一致（std430）
+  struct DrawData {
+    ObjectTransform transform;
+    uint32_t materialIndex;  // GPU材质表索引
+    uint32_t padding[3];
+  };
+
+  // 与cull.comp中的CullData一致（std430）
+  struct CullData {
+    glm::vec4 sphere;  // 世界空间包围球：xyz为球心，w为半径
+    uint32_t batch;    // 所属批次序号（压缩输出的计数槽位）
+    uint32_t batchFirstDraw;
+    uint32_t padding[2];
+  };
+
+  struct DrawItem {
+    const VKGeometryPool::Allocation* geometry;
+    const glm::mat4* transform;
+    uint32_t batchKey;       // 需要切换绑定的状态（如逐材质描述符集）
+    uint32_t materialIndex;  // 写入DrawData
+    glm::vec4 bounds{0.0f};  // 世界空间包围球，写入CullData
+  };
+
+  struct Batch {
+    uint32_t block;
+    uint32_t batchKey;
+    uint32_t firstDraw;
+    uint32_t drawCount;
+  };
+
+  VKIndirectDrawList(vk::Device device, vk::PhysicalDevice physicalDevice,
+                     uint32_t framesInFlight, uint32_t initialCapacity = 4096);
+  ~VKIndirectDrawList();
+
+  // 禁止拷贝
+  VKIndirectDrawList(const VKIndirectDrawList&) = delete;
+  VKIndirectDrawList& operator=(const VKIndirectDrawList&) = delete;
+
+  // 构建当前帧的命令与逐绘制数据（该帧槽位已等待），返回批次列表；
+  // 逐绘制的法线矩阵与MVP在写入时计算
+  const std::vector<Batch>& Build(uint32_t frameIndex,
+                                  const std::vector<DrawItem>& items,
+                                  const glm::mat4& viewProjection);
+
+  // 当前帧的间接命令缓冲与批次的字节偏移
+  vk::Buffer GetCommandBuffer() const { return m_commandBuffer; }
+  vk::DeviceSize GetCommandOffset(const Batch& batch) const {
+    return m_commandFrameBytes * m_frameIndex +
+           batch.firstDraw * sizeof(vk::DrawIndexedIndirectCommand);
+  }
+
+  // 逐绘制数据：以eStorageBufferDynamic绑定，动态偏移为当前帧区域起点
+  vk::DescriptorBufferInfo GetDrawDataDescriptor() const {
+    return vk::DescriptorBufferInfo(m_drawDataBuffer, 0, m_drawDataFrameBytes);
+  }
+  uint32_t GetDrawDataOffset() const {
+    return static_cast<uint32_t>(m_drawDataFrameBytes * m_frameIndex);
+  }
+
+  // 剔除着色器读取的命令与包围球：以eStorageBufferDynamic绑定
+  vk::DescriptorBufferInfo GetCommandDescriptor() const {
+    return vk::DescriptorBufferInfo(m_commandBuffer, 0, m_commandFrameBytes);
+  }
+  uint32_t GetCommandFrameOffset() const {
+    return static_cast<uint32_t>(m_commandFrameBytes * m_frameIndex);
+  }
+  vk::DescriptorBufferInfo GetCullDataDescriptor() const {
+    return vk::DescriptorBufferInfo(m_cullDataBuffer, 0, m_cullDataFrameBytes);
+  }
+  uint32_t GetCullDataOffset() const {
+    return static_cast<uint32_t>(m_cullDataFrameBytes * m_frameIndex);
+  }
+
+  // 当前帧已写入的命令（按排序后的绘制顺序）
+  const vk::DrawIndexedIndirectCommand* GetCommands() const {
+    return reinterpret_cast<const vk::DrawIndexedIndirectCommand*>(
+        m_commandMapped + m_commandFrameBytes * m_frameIndex);
+  }
+  size_t GetBatchCount() const { return m_batches.size(); }
+  const std::vector<Batch>& GetBatches() const { return m_batches; }
+
+  uint32_t GetGeneration() const { return m_generation; }
+  uint32_t GetCapacity() const { return m_capacity; }
+  uint32_t GetDrawCount() const { return m_drawCount; }
+
+ private:
+  void CreateBuffers(uint32_t capacity);
+  void DestroyBuffers();
+
+  vk::Device m_device;
+  vk::PhysicalDevice m_physicalDevice;
+  uint32_t m_framesInFlight;
+  vk::DeviceSize m_storageAlignment = 256;
+
+  vk::Buffer m_commandBuffer;
+  vk::DeviceMemory m_commandMemory;
+  uint8_t* m_commandMapped = nullptr;
+  vk::DeviceSize m_commandFrameBytes = 0;
+
+  vk::Buffer m_drawDataBuffer;
+  vk::DeviceMemory m_drawDataMemory;
+  uint8_t* m_drawDataMapped = nullptr;
+  vk::DeviceSize m_drawDataFrameBytes = 0;
+
+  vk::Buffer m_cullDataBuffer;
+  vk::DeviceMemory m_cullDataMemory;
+  uint8_t* m_cullDataMapped = nullptr;
+  vk::DeviceSize m_cullDataFrameBytes = 0;
+
+  uint32_t m_capacity = 0;
+  uint32_t m_generation = 0;
+  uint32_t m_frameIndex = 0;
+  uint32_t m_drawCount = 0;
+  std::vector<std::pair<uint64_t, uint32_t>> m_sortKeys;
+  std::vector<Batch> m_batches;
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "rendering/MaterialFeatures.hpp"
+
+/**
+ * @brief GPU材质表
+ *
+ * 所有材质记录（材质常量与六个无绑定纹理索引，std430打包）存放在一个
+ * 设备本地的存储缓冲中，着色器按逐绘制的材质索引读取，切换材质只需
+ * 改变索引，无需重新绑定描述符集或上传uniform。
+ * CPU端保留记录副本并跟踪脏区间，RecordUpload把脏区间经当前帧的暂存
+ * 区域复制到设备缓冲；复制录制在本帧命令中，在途帧读取的仍是旧内容。
+ */
+class VKMaterialTable {
+ public:
+  // 与geometry_bindless.frag中的MaterialRecord一致（std430，80字节）
+  struct Record {
+    MaterialConstants constants;
+    uint32_t textureIndices[MaterialFeatures::kSlotCount] = {};
+    uint32_t padding[2] = {0, 0};
+  };
+  static_assert(sizeof(Record) == 80, "Record must match the GLSL layout");
+
+  VKMaterialTable(vk::Device device, vk::PhysicalDevice physicalDevice,
+                  uint32_t framesInFlight, uint32_t capacity = 1024);
+  ~VKMaterialTable();
+
+  // 禁止拷贝
+  VKMaterialTable(const VKMaterialTable&) = delete;
+  VKMaterialTable& operator=(const VKMaterialTable&) = delete;
+
+  // 添加材质记录，返回材质索引
+  uint32_t Add(const Record& record);
+  // 改写材质记录，下一次RecordUpload时生效
+  void Update(uint32_t index, const Record& record);
+  void UpdateTextureIndices(
+      uint32_t index,
+      const std::array<uint32_t, MaterialFeatures::kSlotCount>& indices);
+
+  // 把脏区间复制到设备缓冲（frameIndex的槽位已等待），无改动时不录制命令
+  void RecordUpload(vk::CommandBuffer commandBuffer, uint32_t frameIndex);
+  bool HasPendingUpload() const { return m_dirtyBegin < m_dirtyEnd; }
+
+  vk::Buffer GetBuffer() const { return m_buffer; }
+  vk::DeviceSize GetSize() const { return m_capacity * sizeof(Record); }
+  uint32_t GetCount() const { return static_cast<uint32_t>(m_records.size()); }
+  uint64_t GetUploadedBytes() const { return m_uploadedBytes; }
+
+ private:
+  void MarkDirty(uint32_t index);
+
+  vk::Device m_device;
+  uint32_t m_framesInFlight;
+  uint32_t m_capacity;
+
+  // 设备本地记录缓冲与按飞行帧划分的暂存缓冲（持久映射）
+  vk::Buffer m_buffer;
+  vk::DeviceMemory m_memory;
+  vk::Buffer m_stagingBuffer;
+  vk::DeviceMemory m_stagingMemory;
+  uint8_t* m_stagingMapped = nullptr;
+
+  std::vector<Record> m_records;
+  uint32_t m_dirtyBegin = 0;  // 待上传区间[begin, end)
+  uint32_t m_dirtyEnd = 0;
+  uint64_t m_uploadedBytes = 0;
+};
@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "resource/Texture.hpp"
+#include "vkbasic/VKDescriptorPool.hpp"
+
+/**
+ * @brief GPU mip链生成
+ *
+ * 没有mip链的纹理只上传第0级，其余各级在GPU上生成，多张纹理的生成命令
+ * 录制在同一个命令缓冲中，每一级的屏障对全部纹理合并提交。
+ * 格式支持blit与线性过滤时逐级vkCmdBlitImage（sRGB格式在线性空间过滤）；
+ * 法线贴图（需逐级重新归一化）与不支持线性过滤的8位四通道格式使用
+ * mip_downsample.comp单次调度生成整条链；其余格式退回最近点blit。
+ */
+class VKMipGenerator {
+ public:
+  // 与mip_downsample.comp一致：最多13级（第0级边长8192）
+  static constexpr uint32_t kMaxComputeLevels = 13;
+  static constexpr uint32_t kGroupSize = 256;
+  static constexpr uint32_t kTileSize = 32;  // 每个工作组覆盖的第1级边长
+
+  enum class Method { None, Blit, Compute };
+
+  struct Pipelines {
+    vk::DescriptorSetLayout setLayout;
+    vk::PipelineLayout layout;
+    vk::Pipeline downsample;
+  };
+
+  // 与mip_downsample.comp的推送常量一致
+  struct PushConstants {
+    int32_t width;
+    int32_t height;
+    uint32_t levelCount;
+    uint32_t mode;
+    uint32_t groupCount;
+    uint32_t counterIndex;
+  };
+
+  // 纹理的生成方式与图像应使用的级数、用途、创建标志
+  struct Plan {
+    Method method = Method::None;
+    uint32_t mipLevels = 1;
+    vk::ImageUsageFlags usage;
+    vk::ImageCreateFlags flags;
+  };
+
+  VKMipGenerator(vk::Device device, vk::PhysicalDevice physicalDevice,
+                 std::shared_ptr<VKDescriptorPool> descriptorPool,
+                 const Pipelines& pipelines);
+  // 调用方需保证已录制的命令执行完成
+  ~VKMipGenerator();
+
+  // 禁止拷贝
+  VKMipGenerator(const VKMipGenerator&) = delete;
+  VKMipGenerator& operator=(const VKMipGenerator&) = delete;
+
+  // 为只有第0级的纹理选择生成方式（1x1纹理或格式不支持时为None）
+  Plan PlanFor(const Texture& texture, vk::Format format) const;
+
+  // 登记按plan创建、第0级已上传且全部级处于TransferDstOptimal的图像
+  void Enqueue(vk::Image image, vk::Format format, const Texture& texture,
+               const Plan& plan);
+  bool HasPending() const { return !m_jobs.empty(); }
+
+  // 录制全部登记图像的生成命令，结束时所有级处于ShaderReadOnlyOptimal
+  void Record(vk::CommandBuffer commandBuffer);
+  // 命令缓冲执行完成后释放本批的视图、描述符集与计数缓冲
+  void ReleaseBatch();
+  // 把本批的临时资源移出，返回的函数在命令缓冲执行完成后调用以释放，
+  // 生成器可立即开始下一批
+  std::function<void()> DetachBatch();
+
+ private:
+  struct Job {
+    vk::Image image;
+    vk::Format format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipLevels;
+    Method method;
+    uint32_t mode;  // 计算路径的编解码方式
+  };
+
+  bool SupportsCompute(vk::Format format) const;
+  void RecordBlits(vk::CommandBuffer commandBuffer,
+                   const std::vector<const Job*>& jobs);
+  void RecordCompute(vk::CommandBuffer commandBuffer,
+                     const std::vector<const Job*>& jobs);
+
+  vk::Device m_device;
+  vk::PhysicalDevice m_physicalDevice;
+  std::shared_ptr<VKDescriptorPool> m_descriptorPool;
+  Pipelines m_pipelines;
+
+  std::vector<Job> m_jobs;
+  // 本批的临时资源
+  std::vector<vk::ImageView> m_views;
+  std::vector<vk::DescriptorSet> m_sets;
+  vk::Buffer m_counterBuffer;
+  vk::DeviceMemory m_counterMemory;
+};
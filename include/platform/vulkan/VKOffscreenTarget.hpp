@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+/**
+ * @brief 离屏渲染目标（无窗口模式替代交换链）
+ *
+ * 每个飞行帧一张颜色图像和一个持久映射的回读缓冲。
+ * 帧N的图像复制到回读缓冲后，在该帧完成后写出文件，
+ * 同时后续帧继续渲染，回读与渲染重叠进行。
+ */
+class VKOffscreenTarget {
+ public:
+  enum class FileFormat { PNG, EXR };
+
+  VKOffscreenTarget(vk::Device device, vk::PhysicalDevice physicalDevice,
+                    vk::Extent2D extent, FileFormat fileFormat,
+                    uint32_t slotCount);
+  ~VKOffscreenTarget();
+
+  // 禁止拷贝
+  VKOffscreenTarget(const VKOffscreenTarget&) = delete;
+  VKOffscreenTarget& operator=(const VKOffscreenTarget&) = delete;
+
+  // PNG使用R8G8B8A8Unorm，EXR使用R16G16B16A16Sfloat（直接写出half）
+  static vk::Format GetFormatFor(FileFormat fileFormat);
+
+  // 将槽位的回读数据写出为文件（调用前须等待该槽位所在帧完成）
+  bool Save(uint32_t slot, const std::string& path) const;
+
+  vk::Image GetImage(uint32_t slot) const { return m_slots[slot].image; }
+  vk::ImageView GetImageView(uint32_t slot) const {
+    return m_slots[slot].view;
+  }
+  vk::Buffer GetReadbackBuffer(uint32_t slot) const {
+    return m_slots[slot].readbackBuffer;
+  }
+  vk::DeviceSize GetReadbackSize() const { return m_readbackSize; }
+  vk::Extent2D GetExtent() const { return m_extent; }
+  vk::Format GetFormat() const { return m_format; }
+  FileFormat GetFileFormat() const { return m_fileFormat; }
+  const char* GetFileExtension() const {
+    return m_fileFormat == FileFormat::PNG ? ".png" : ".exr";
+  }
+  uint32_t GetSlotCount() const {
+    return static_cast<uint32_t>(m_slots.size());
+  }
+
+ private:
+  struct Slot {
+    vk::Image image;
+    vk::DeviceMemory imageMemory;
+    vk::ImageView view;
+    vk::Buffer readbackBuffer;
+    vk::DeviceMemory readbackMemory;
+    void* mapped = nullptr;
+  };
+
+  vk::Device m_device;
+  vk::Extent2D m_extent;
+  vk::Format m_format;
+  FileFormat m_fileFormat;
+  vk::DeviceSize m_readbackSize = 0;
+  std::vector<Slot> m_slots;
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "core/ThreadPool.hpp"
+
+/**
+ * @brief 多线程二级命令缓冲录制器
+ *
+ * 每个录制线程在每个飞行帧拥有独立的命令池，帧开始时整池重置，
+ * 避免逐个重置命令缓冲和跨线程共享命令池。
+ * 绘制项按线程数切分为连续区间，切分只取决于数量和线程数，
+ * 返回的二级命令缓冲按区间顺序排列，拼接结果与线程调度无关。
+ */
+class VKParallelRecorder {
+ public:
+  // 录制[begin, end)区间内的绘制项
+  using RecordFunc =
+      std::function<void(vk::CommandBuffer, uint32_t begin, uint32_t end)>;
+
+  // threadCount为0时使用硬件并发数
+  VKParallelRecorder(vk::Device device, uint32_t queueFamilyIndex,
+                     uint32_t framesInFlight, uint32_t threadCount = 0);
+  ~VKParallelRecorder();
+
+  // 禁止拷贝
+  VKParallelRecorder(const VKParallelRecorder&) = delete;
+  VKParallelRecorder& operator=(const VKParallelRecorder&) = delete;
+
+  // 帧开始时调用（该帧槽位已等待）：整池重置该帧所有线程的命令池
+  void BeginFrame(uint32_t frameIndex);
+
+  // 并行录制itemCount个绘制项，返回按区间顺序排列的二级命令缓冲
+  // threadCount为0时使用全部线程
+  std::vector<vk::CommandBuffer> Record(
+      uint32_t frameIndex, uint32_t itemCount,
+      const vk::CommandBufferInheritanceInfo& inheritance,
+      const RecordFunc& record, uint32_t threadCount = 0);
+
+  uint32_t GetThreadCount() const { return m_threadCount; }
+
+  // 每个区间的最少绘制项数，过小的区间不值得分发到线程
+  static constexpr uint32_t kMinItemsPerChunk = 64;
+
+ private:
+  struct ThreadFrameData {
+    vk::CommandPool pool;
+    std::vector<vk::CommandBuffer> buffers;
+    uint32_t usedBuffers = 0;  // 本帧已使用的命令缓冲数
+  };
+
+  vk::CommandBuffer AcquireBuffer(ThreadFrameData& data);
+
+  vk::Device m_device;
+  uint32_t m_threadCount;
+  // m_frames[frame][thread]
+  std::vector<std::vector<ThreadFrameData>> m_frames;
+  // 调用线程录制最后一个区间，线程池只需threadCount-1个工作线程
+  std::unique_ptr<ThreadPool> m_threadPool;
+};
@@ -0,0 +1,111 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "core/ThreadPool.hpp"
+
+/**
+ * @brief 图形管线缓存
+ *
+ * 管线以描述的哈希为键：着色器代码、特化常量、顶点输入、光栅化、深度、
+ * 混合状态、附件格式与管线布局。Acquire不阻塞，缺失的管线提交到后台线程
+ * 编译；编译完成前返回同一兼容组（管线布局、附件格式与顶点输入相同，可在
+ * 同一次动态渲染中替换绑定）中最近就绪的可回退管线，没有时返回空，调用方
+ * 跳过本帧的相关绘制而不是等待编译。所有编译共享一个vk::PipelineCache
+ * （驱动内部同步）。
+ */
+class VKPipelineCache {
+ public:
+  struct GraphicsDesc {
+    vk::ShaderModule vertexModule;
+    vk::ShaderModule fragmentModule;
+    uint64_t shaderHash = 0;  // 两个阶段的SPIR-V内容哈希
+    // 片段阶段的特化常量
+    std::vector<vk::SpecializationMapEntry> specializationEntries;
+    std::vector<uint8_t> specializationData;
+    std::vector<vk::VertexInputBindingDescription> vertexBindings;
+    std::vector<vk::VertexInputAttributeDescription> vertexAttributes;
+    vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
+    vk::CullModeFlags cullMode = vk::CullModeFlagBits::eBack;
+    vk::FrontFace frontFace = vk::FrontFace::eCounterClockwise;
+    bool depthTest = true;
+    bool depthWrite = true;
+    vk::CompareOp depthCompare = vk::CompareOp::eLess;
+    bool blendEnable = false;  // 所有颜色附件相同
+    std::vector<vk::Format> colorFormats;
+    vk::Format depthFormat = vk::Format::eUndefined;
+    vk::PipelineLayout layout;
+    // 就绪后可作为兼容组中其他管线的回退（不参与哈希）；功能较少的特化
+    // 变体应置为false，以免替代需要更多功能的管线
+    bool servesAsFallback = true;
+
+    uint64_t Hash() const;
+    // 可互换绑定的兼容组哈希
+    uint64_t CompatibilityHash() const;
+  };
+
+  struct Stats {
+    uint32_t ready = 0;
+    uint32_t pending = 0;
+    uint32_t failed = 0;
+    uint32_t compiled = 0;   // 累计编译的管线数
+    uint64_t fallbacks = 0;  // Acquire返回兼容管线的次数
+    uint64_t misses = 0;     // Acquire返回空的次数
+    double compileMs = 0.0;  // 累计编译耗时（各线程之和）
+  };
+
+  // threadCount为后台编译线程数，0为硬件并发数的一半
+  VKPipelineCache(vk::Device device, uint32_t threadCount = 0);
+  // 等待后台编译结束并销毁全部管线
+  ~VKPipelineCache();
+
+  // 禁止拷贝
+  VKPipelineCache(const VKPipelineCache&) = delete;
+  VKPipelineCache& operator=(const VKPipelineCache&) = delete;
+
+  // 不阻塞：就绪时返回该管线，否则提交编译并返回兼容管线或空；
+  // allowCompatible为false时只接受精确命中（如特化变体需要回退到
+  // 指定的通用变体而不是兼容组中任意的管线）
+  vk::Pipeline Acquire(const GraphicsDesc& desc, bool allowCompatible = true);
+  // 阻塞：缺失时在调用线程编译（或等待进行中的编译），失败时抛出
+  // std::runtime_error
+  vk::Pipeline GetOrCreate(const GraphicsDesc& desc);
+  // 提前提交后台编译，不等待
+  void Prefetch(const GraphicsDesc& desc);
+  // 等待所有进行中的后台编译
+  void WaitIdle();
+
+  Stats GetStats() const;
+
+ private:
+  enum class State { Pending, Ready, Failed };
+
+  struct Entry {
+    State state = State::Pending;
+    vk::Pipeline pipeline;
+    uint64_t compatibility = 0;
+    bool servesAsFallback = true;
+  };
+
+  // 调用方持有m_mutex；新登记时返回true
+  bool Register(uint64_t key, const GraphicsDesc& desc);
+  void SubmitCompile(uint64_t key, const GraphicsDesc& desc);
+  vk::Pipeline Compile(const GraphicsDesc& desc);
+  void Complete(uint64_t key, vk::Pipeline pipeline, double elapsedMs);
+
+  vk::Device m_device;
+  vk::PipelineCache m_driverCache;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_completed;
+  std::unordered_map<uint64_t, Entry> m_entries;
+  // 兼容组中最近就绪的可回退管线
+  std::unordered_map<uint64_t, vk::Pipeline> m_latestCompatible;
+  Stats m_stats;
+  // 析构时先停止线程池（执行完队列中的编译），再销毁管线
+  std::unique_ptr<ThreadPool> m_threadPool;
+};
@@ -0,0 +1,163 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+/**
+ * @brief GPU时间戳与管线统计性能分析器
+ *
+ * 每个飞行帧一组查询池（环形复用），帧N的查询结果在该帧槽位等待之后、
+ * 下次复用该槽位时读取，不会阻塞CPU或GPU。
+ * 时间戳按timestampPeriod换算为纳秒，并按队列族的timestampValidBits截断。
+ * 可选地为作用域收集管线统计（顶点/片元着色器调用次数等）。
+ * GPU作用域与CPU作用域可合并导出为Chrome trace JSON（chrome://tracing）。
+ */
+class VKProfiler {
+ public:
+  enum class QueueType : uint32_t { Graphics = 0, Compute, Transfer, Count };
+
+  struct Config {
+    uint32_t maxScopesPerFrame = 128;
+    bool pipelineStatistics = false;  // 需设备支持pipelineStatisticsQuery
+    bool inheritedQueries = false;    // 二级命令缓冲可继承活动查询
+    size_t maxTraceEvents = 200000;   // 超出后丢弃最早的一半事件
+  };
+
+  // 与statisticFlags的位顺序一致
+  struct PipelineStatistics {
+    uint64_t inputAssemblyVertices = 0;
+    uint64_t vertexShaderInvocations = 0;
+    uint64_t clippingPrimitives = 0;
+    uint64_t fragmentShaderInvocations = 0;
+    uint64_t computeShaderInvocations = 0;
+  };
+
+  struct ScopeResult {
+    std::string name;
+    QueueType queue = QueueType::Graphics;
+    uint32_t depth = 0;
+    double gpuStartMs = 0.0;  // 相对本帧第一个时间戳
+    double gpuTimeMs = 0.0;
+    bool hasStatistics = false;
+    PipelineStatistics statistics;
+  };
+
+  /**
+   * @brief CPU作用域（RAII）
+   *
+   * 线程安全，可在录制线程中使用。
+   */
+  class CpuScope {
+   public:
+    CpuScope(VKProfiler* profiler, const char* name);
+    ~CpuScope();
+
+   private:
+    VKProfiler* m_profiler;
+    const char* m_name;
+    double m_startUs;
+  };
+
+  VKProfiler(vk::Device device, vk::PhysicalDevice physicalDevice,
+             const std::array<uint32_t, 3>& queueFamilies,
+             uint32_t framesInFlight, bool hostQueryReset,
+             const Config& config = {});
+  ~VKProfiler();
+
+  // 禁止拷贝
+  VKProfiler(const VKProfiler&) = delete;
+  VKProfiler& operator=(const VKProfiler&) = delete;
+
+  // 帧开始时调用（该帧槽位已等待）：读取该槽位上次的结果并重置查询池
+  void BeginFrame(uint32_t frameIndex);
+
+  // 设备不支持主机端重置时，须在本帧第一个命令缓冲开头录制重置
+  void RecordReset(vk::CommandBuffer commandBuffer);
+
+  // 本帧命令提交后调用，记录提交时刻用于对齐CPU/GPU时间线
+  void EndFrame();
+
+  // GPU作用域：返回作用域索引（查询已用尽或队列不支持时返回UINT32_MAX）
+  uint32_t BeginScope(vk::CommandBuffer commandBuffer, const std::string& name,
+                      QueueType queue = QueueType::Graphics,
+                      bool statistics = false);
+  void EndScope(vk::CommandBuffer commandBuffer, uint32_t scope);
+
+  // 最近一次读回的帧结果
+  const std::vector<ScopeResult>& GetLastFrameResults() const {
+    return m_lastResults;
+  }
+
+  // 二级命令缓冲继承管线统计查询时使用的标志
+  vk::QueryPipelineStatisticFlags GetActiveStatisticFlags() const;
+
+  // 统计查询活动期间能否执行二级命令缓冲
+  bool CanInheritQueries() const { return m_config.inheritedQueries; }
+
+  bool IsSupported(QueueType queue) const {
+    return m_validBits[static_cast<uint32_t>(queue)] > 0;
+  }
+  double GetTimestampPeriod() const { return m_timestampPeriod; }
+
+  // 导出CPU与GPU作用域为Chrome trace JSON
+  bool WriteChromeTrace(const std::string& path) const;
+
+ private:
+  friend class CpuScope;
+
+  struct PendingScope {
+    std::string name;
+    QueueType queue;
+    uint32_t depth;
+    uint32_t statisticsQuery;  // UINT32_MAX表示无统计
+  };
+
+  struct FrameSlot {
+    vk::QueryPool timestampPool;
+    vk::QueryPool statisticsPool;
+    std::vector<PendingScope> scopes;
+    uint32_t statisticsCount = 0;
+    double submitCpuUs = 0.0;  // 提交时刻（CPU时间线）
+    bool submitted = false;
+  };
+
+  struct TraceEvent {
+    std::string name;
+    uint32_t thread;  // CPU线程或GPU队列轨道
+    double startUs;
+    double durationUs;
+    bool gpu;
+    bool hasStatistics;
+    PipelineStatistics statistics;
+  };
+
+  void ReadResults(FrameSlot& slot);
+  void ResetSlot(FrameSlot& slot);
+  void AddTraceEvent(TraceEvent event);
+  double NowUs() const;
+  uint32_t CurrentThreadTrack();  // 调用方须持有m_traceMutex
+
+  vk::Device m_device;
+  Config m_config;
+  bool m_hostQueryReset;
+  double m_timestampPeriod = 1.0;  // 每个时间戳刻度的纳秒数
+  std::array<uint32_t, 3> m_validBits{};
+  vk::QueryPipelineStatisticFlags m_statisticFlags;
+
+  std::vector<FrameSlot> m_slots;
+  uint32_t m_currentSlot = 0;
+  uint32_t m_scopeDepth = 0;
+  bool m_statisticsActive = false;
+  bool m_needsReset = true;
+  std::vector<ScopeResult> m_lastResults;
+
+  std::chrono::steady_clock::time_point m_epoch;
+  mutable std::mutex m_traceMutex;
+  std::vector<TraceEvent> m_traceEvents;
+  std::vector<std::thread::id> m_threadIds;
+};
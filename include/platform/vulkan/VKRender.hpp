@@ -1,30 +1,193 @@
 #pragma once
+#include <array>
 #include <memory>
+#include <utility>
 
+#include "VKAsyncCompute.hpp"
 #include "VKContext.hpp"
+#include "VKDeferredLighting.hpp"
+#include "VKGpuCulling.hpp"
+#include "VKIndirectDrawList.hpp"
+#include "VKMaterialTable.hpp"
+#include "VKMipGenerator.hpp"
+#include "VKParallelRecorder.hpp"
+#include "VKProfiler.hpp"
+#include "VKRenderGraph.hpp"
 #include "VKShader.hpp"
+#include "VKTextureStreamer.hpp"
+#include "core/Timer.hpp"
 #include "core/interface/IRenderer.hpp"
+#include "rendering/ObjectTransform.hpp"
+#include "rendering/SceneBVH.hpp"
 #include "vkbasic/VKDescriptorPool.hpp"
 #include "vkbasic/VKDevice.hpp"
+#include "vkbasic/VKGeometryPool.hpp"
 #include "vkbasic/VKInstance.hpp"
 #include "vkbasic/VKSwapChain.hpp"
+#include "vkbasic/VKUniformArena.hpp"
 
 class VKRender : public IRenderer {
  public:
   VKRender() = default;
-  ~VKRender(){};
+  ~VKRender() { cleanup(); };
 
   bool init(Window* windowHandle) override;
+  // 无窗口离屏模式：渲染到离屏图像并回读写出文件
+  bool initHeadless(const VKContext::HeadlessConfig& config);
   void resize(int width, int height) override;
   void renderFrame() override;
 
   void setModel(const Model& model) override;
   void setMaterial(const Material& material) override;
   void setCamera() override;
+  // 指定渲染使用的相机（离屏模式没有窗口相机）
+  void setCamera(Camera* camera);
+
+  // 离屏模式：等待所有在途帧并写出剩余的回读结果
+  void flushReadbacks();
+
+  // 添加一个使用当前模型与当前材质的渲染对象，返回对象索引
+  // （setModel上传的每个模型都保留在几何池中，可被之后的对象引用）
+  uint32_t addRenderObject(const glm::mat4& transform);
+  // 更新对象的变换（包围体层次在下一帧增量重拟合）
+  void setRenderObjectTransform(uint32_t object, const glm::mat4& transform);
+
+  // 动态点光源（每帧上传，由分块延迟光照按屏幕块剔除），返回光源索引
+  uint32_t addPointLight(const VKDeferredLighting::PointLight& light);
+  void setPointLight(uint32_t index,
+                     const VKDeferredLighting::PointLight& light);
+  void clearPointLights() { m_pointLights.clear(); }
+  size_t getPointLightCount() const { return m_pointLights.size(); }
+  void setExposure(float exposure);
+  // 光照着色器缺失时呈现过程直接输出反照率
+  bool isDeferredLightingAvailable() const {
+    return m_deferredLighting != nullptr;
+  }
+
+  // 切换G-Buffer布局（紧凑布局由深度重建位置，法线八面体编码）
+  void setGBufferLayout(VKContext::GBufferLayout layout);
+  VKContext::GBufferLayout getGBufferLayout() const {
+    return m_vkContext->m_gbufferLayout;
+  }
+  uint32_t getGBufferBytesPerPixel() const {
+    return m_vkContext->m_gbufferFormats.BytesPerPixel();
+  }
+
+  // 切换CPU视锥剔除（BVH+SIMD，作用于未启用GPU剔除的绘制路径）
+  void setCpuCullingEnabled(bool enabled) { m_useCpuCulling = enabled; }
+  bool isCpuCullingEnabled() const { return m_useCpuCulling; }
+
+  // 切换无绑定材质路径（设备不支持时保持逐材质描述符集）
+  void setBindlessEnabled(bool enabled);
+  bool isBindlessEnabled() const { return m_useBindless; }
+
+  // 切换多命令间接绘制路径（着色器缺失时保持逐对象直接绘制）
+  void setIndirectEnabled(bool enabled);
+  bool isIndirectEnabled() const { return m_useIndirect; }
+
+  // 切换GPU剔除（视锥+两阶段层次Z遮挡，仅作用于间接绘制路径）
+  void setGpuCullingEnabled(bool enabled);
+  bool isGpuCullingEnabled() const { return m_useGpuCulling; }
+  // 最近一次读回的剔除计数（可见/视锥剔除/遮挡剔除）
+  VKGpuCulling::Stats getCullingStats() const {
+    return m_gpuCulling ? m_gpuCulling->GetLastStats() : VKGpuCulling::Stats{};
+  }
+
+  // 切换异步计算（光照与深度金字塔提交到独立的计算队列，
+  // 设备没有独立计算队列族或时间线信号量时保持单队列）
+  void setAsyncComputeEnabled(bool enabled);
+  bool isAsyncComputeEnabled() const { return m_useAsyncCompute; }
+
+  // 纹理mip流送：之后上传的大纹理只常驻低mip，其余按屏幕尺寸反馈流入
+  // （在setMaterial之前设置，已上传的纹理不受影响）
+  void setTextureStreamingEnabled(bool enabled) {
+    m_useTextureStreaming = enabled;
+  }
+  bool isTextureStreamingEnabled() const { return m_useTextureStreaming; }
+  // 流送纹理的常驻预算（默认为设备本地显存的四分之一）
+  void setTextureStreamingBudget(vk::DeviceSize bytes);
+  VKTextureStreamer::Stats getTextureStreamingStats() const {
+    return m_textureStreamer ? m_textureStreamer->GetStats()
+                             : VKTextureStreamer::Stats{};
+  }
+  // 从init到首帧提交的耗时（尚未渲染时为负）
+  double getTimeToFirstFrameMs() const { return m_timeToFirstFrameMs; }
+  VKPipelineCache::Stats getPipelineCacheStats() const {
+    return m_vkContext ? m_vkContext->m_pipelineCache->GetStats()
+                       : VKPipelineCache::Stats{};
+  }
+
+  // 绘制循环CPU耗时统计
+  struct DrawLoopStats {
+    double cpuTimeMs = 0.0;       // 最近一次绘制循环的CPU录制耗时
+    uint32_t drawCount = 0;       // 最近一次绘制循环的绘制调用数
+    bool bindless = false;        // 最近一次绘制循环使用的路径
+    uint32_t threadCount = 1;     // 录制线程数（1为内联录制）
+    uint32_t secondaryCount = 0;  // 拼接的二级命令缓冲数
+    bool indirect = false;        // 是否使用间接绘制路径
+    uint32_t batchCount = 0;      // 间接绘制批次数（即间接绘制命令数）
+    uint32_t cpuCulledCount = 0;  // CPU视锥剔除掉的对象数
+    double cpuCullMs = 0.0;       // CPU视锥剔除耗时
+  };
+  const DrawLoopStats& getDrawLoopStats() const { return m_drawLoopStats; }
+
+  // 几何绘制的录制线程数（1为直接录制到主命令缓冲）
+  void setRecordingThreadCount(uint32_t threadCount);
+  uint32_t getRecordingThreadCount() const { return m_recordingThreads; }
+
+  // 依次以不同线程数录制（不提交）当前帧，统计CPU录制耗时
+  struct RecordingBenchmarkResult {
+    uint32_t threadCount = 1;
+    double averageCpuTimeMs = 0.0;
+    uint32_t drawCount = 0;
+  };
+  std::vector<RecordingBenchmarkResult> benchmarkRecording(
+      const std::vector<uint32_t>& threadCounts, uint32_t iterations);
+
+  // GPU性能分析：每个渲染图过程的时间戳，可选管线统计
+  void setProfilingEnabled(bool enabled, bool pipelineStatistics = false);
+  VKProfiler* getProfiler() const { return m_profiler.get(); }
+  // 导出CPU与GPU作用域为Chrome trace JSON
+  bool writeProfilerTrace(const std::string& path) const;
+
+  // 最近一次编译的渲染图调度（过程、屏障、剔除与内存别名）
+  std::string dumpRenderGraph() const {
+    return m_renderGraph ? m_renderGraph->DumpSchedule() : std::string();
+  }
+
+  // 描述符缓存统计（命中/未命中/每帧更新次数）
+  const VKDescriptorCache::Stats& getDescriptorCacheStats() const {
+    return m_vkContext->m_descriptorCache->GetStats();
+  }
 
  private:
+  // 已上传到GPU的材质：六个绑定槽位对应的纹理索引
+  struct GpuMaterial {
+    std::string name;
+    std::array<uint32_t, VKDescriptorCache::kImageBindingCount> textureSlots;
+    uint32_t tableIndex = 0;  // GPU材质表中的索引（无绑定路径）
+    MaterialConstants constants;  // 特性位选择几何管线变体
+  };
+
+  // 几何池中的模型
+  struct GpuMesh {
+    std::string name;
+    VKGeometryPool::Allocation geometry;
+    glm::vec4 bounds{0.0f};  // 模型空间包围球：xyz为球心，w为半径
+  };
+
+  struct RenderObject {
+    glm::mat4 transform;
+    uint32_t materialIndex;
+    uint32_t meshIndex;
+    AABB localBounds;  // 模型空间包围盒
+    uint32_t bvhHandle;
+  };
+
   uint32_t m_currentFrame = 0;
   static const int MAX_FRAMES_IN_FLIGHT = 2;
+  uint32_t m_framesInFlight = MAX_FRAMES_IN_FLIGHT;  // 离屏模式可配置
+  static const uint32_t kMaxRecordingThreads = 8;
 
   //上下文
   std::shared_ptr<VKContext> m_vkContext;
@@ -33,15 +196,169 @@ class VKRender : public IRenderer {
   std::vector<vk::Image> m_textureImage;
   std::vector<vk::DeviceMemory> m_textureImageMemory;
   std::vector<vk::ImageView> m_textureImageView;
-  vk::Buffer m_vertexBuffer;
-  vk::DeviceMemory m_vertexBufferMemory;
-  vk::Buffer m_indexBuffer;
-  vk::DeviceMemory m_indexBufferMemory;
+  std::vector<uint32_t> m_textureBindlessIndex;  // 纹理在无绑定数组中的索引
+
+  // 纹理流送：流送纹理的图像由流送器持有，视图随常驻区间切换；
+  // 无绑定路径每个流送纹理两个槽位交替写入，不改写在途帧引用的槽位
+  static constexpr uint32_t kNotStreamed = UINT32_MAX;
+  bool m_useTextureStreaming = true;
+  vk::DeviceSize m_textureStreamingBudget = 0;  // 0为按显存自动选择
+  std::unique_ptr<VKTextureStreamer> m_textureStreamer;
+  std::vector<uint32_t> m_textureStreamHandles;  // 按纹理索引
+  std::vector<uint32_t> m_textureBindlessSpare;  // 流送纹理的备用槽位
+  std::vector<uint32_t> m_streamedTextureSlots;  // 按流送句柄
+  // 纹理上传批次：多张纹理的拷贝与mip生成录制在同一命令缓冲中，
+  // 缺少mip链的纹理由GPU生成其余各级
+  std::unique_ptr<VKMipGenerator> m_mipGenerator;
+  vk::CommandBuffer m_uploadCommandBuffer;
+  std::vector<std::pair<vk::Buffer, vk::DeviceMemory>> m_uploadStaging;
+  Timer m_startupTimer;
+  double m_timeToFirstFrameMs = -1.0;
+  std::unique_ptr<VKGeometryPool> m_geometryPool;
+  std::vector<GpuMesh> m_meshes;
+  uint32_t m_currentMeshIndex = 0;
+
+  // 逐帧线性uniform分配器：每个绘制一个变换块，以动态偏移绑定
+  static constexpr vk::DeviceSize kUniformArenaBytesPerFrame = 8 * 1024 * 1024;
+  std::unique_ptr<VKUniformArena> m_uniformArena;
+  vk::DescriptorSet m_frameDescriptorSet;  // 无绑定路径的set 0
+  glm::mat4 m_frameView{1.0f};
+  glm::mat4 m_frameProj{1.0f};
+
+  // 默认纹理索引（材质缺少贴图时使用）
+  std::array<uint32_t, VKDescriptorCache::kImageBindingCount>
+      m_defaultTextureSlots{};
+
+  std::vector<GpuMaterial> m_materials;
+  uint32_t m_currentMaterialIndex = 0;
+  std::vector<RenderObject> m_renderObjects;
+  // CPU剔除：世界空间包围盒的BVH，本帧要绘制的对象下标
+  SceneBVH m_sceneBVH;
+  std::vector<uint32_t> m_visibleObjects;
+  bool m_useCpuCulling = true;
+
+  bool m_useBindless = false;
+  // GPU材质表：无绑定路径的材质记录，改动在渲染图的上传过程中复制
+  std::unique_ptr<VKMaterialTable> m_materialTable;
+  // 本帧逐对象绘制时各材质使用的几何管线变体（未就绪时为空，跳过绘制）
+  std::vector<vk::Pipeline> m_materialPipelines;
+
+  // 间接绘制：逐帧绘制列表与逐绘制数据描述符集（set 1）
+  bool m_useIndirect = false;
+  std::unique_ptr<VKIndirectDrawList> m_drawList;
+  std::vector<VKIndirectDrawList::DrawItem> m_drawItems;
+  vk::DescriptorSet m_drawDescriptorSet;
+  uint32_t m_drawSetGeneration = 0;
+  double m_indirectBuildMs = 0.0;      // 本帧绘制列表构建耗时
+  DrawLoopStats m_drawLoopStats;
+
+  // GPU剔除：输出命令、批次计数与遮挡标记跨帧保留，深度金字塔导入渲染图
+  bool m_useGpuCulling = false;
+  std::unique_ptr<VKGpuCulling> m_gpuCulling;
+  uint32_t m_cullGeneration = 0;
+
+  // 分块延迟光照：光源列表逐帧上传，分块列表与HDR输出为瞬态资源
+  std::unique_ptr<VKDeferredLighting> m_deferredLighting;
+  std::vector<VKDeferredLighting::PointLight> m_pointLights;
+
+  // 多线程录制：每线程每帧独立命令池，本帧材质描述符集预先解析
+  std::unique_ptr<VKParallelRecorder> m_recorder;
+  uint32_t m_recordingThreads = 1;
+  std::vector<vk::DescriptorSet> m_materialSets;
+
+  // 离屏模式：每个飞行帧一个离屏图像与回读缓冲，记录待写出的帧序号
+  std::unique_ptr<VKOffscreenTarget> m_offscreenTarget;
+  std::vector<int64_t> m_pendingReadbacks;
+  uint64_t m_frameNumber = 0;
+  Camera* m_camera = nullptr;
+
+  std::unique_ptr<VKProfiler> m_profiler;
+
+  // 异步计算：渲染图按队列分批，由调度器逐批提交
+  bool m_useAsyncCompute = false;
+  std::unique_ptr<VKAsyncCompute> m_asyncCompute;
+
+  // 渲染图：G-Buffer为瞬态资源，输出图像逐帧导入
+  struct GBufferTargets {
+    RGResource position;  // 紧凑布局无效
+    RGResource normal;
+    RGResource albedo;
+    RGResource material;
+    RGResource depth;
+    // 按几何着色器输出顺序排列的颜色附件
+    std::vector<RGResource> Colors() const {
+      std::vector<RGResource> colors;
+      if (position.IsValid()) colors.push_back(position);
+      colors.insert(colors.end(), {normal, albedo, material});
+      return colors;
+    }
+  };
+  std::unique_ptr<VKRenderGraph> m_renderGraph;
+  RGResource m_outputTarget;  // 交换链图像或离屏图像
+  RGResource m_readbackTarget;
+  RGResource m_materialBuffer;  // GPU材质表，无绑定路径有效
+  GBufferTargets m_gbuffer;
+  struct CullingTargets {
+    RGResource commands;
+    RGResource counts;
+    RGResource occluded;
+    RGResource pyramid;
+  };
+  CullingTargets m_culling;
+  RGResource m_tileLights;
+  RGResource m_lightingOutput;
+  vk::Extent2D m_graphExtent;
 
   Model m_currentModel;
   Material m_currentMaterial;
+  bool m_materialDirty = false;
+  bool m_modelDirty = false;
   void uploadModelData();
   void uploadMaterialData();
-  void createTextureImage(Texture& T);
-  void createTextureImageView();
+  // 录制到上传批次，返回图像的mip级数
+  uint32_t createTextureImage(Texture& T);
+  // 提交上传批次，暂存缓冲等临时资源在批次完成后延迟销毁
+  void flushTextureUploads();
+  void createTextureImageView(vk::Format format, uint32_t mipLevels);
+  uint32_t createTexture(Texture& T);
+  std::array<uint32_t, VKDescriptorCache::kImageBindingCount>
+  bindlessTextureIndices(const GpuMaterial& material) const;
+  // 按对象的屏幕尺寸提交流送反馈，并应用完成的视图切换
+  void updateTextureStreaming();
+  void reportFirstFrame();
+  void createDefaultTextures();
+  void createUniformBuffers();
+  void createFrameDescriptorSets();
+  void createDeviceLocalBuffer(const void* data, vk::DeviceSize size,
+                               vk::BufferUsageFlags usage, vk::Buffer& buffer,
+                               vk::DeviceMemory& memory);
+  void prepareMaterialSets();
+  // [begin, end)为m_visibleObjects中的区间
+  void recordDrawRange(vk::CommandBuffer commandBuffer, uint32_t begin,
+                       uint32_t end) const;
+  void updateVisibleObjects();
+  void prepareIndirectDraws();
+  void recordIndirectDraws(vk::CommandBuffer commandBuffer,
+                           VKGpuCulling::Phase phase);
+  void recordDrawCommands(vk::CommandBuffer commandBuffer);
+  void updateDrawDescriptorSet();
+  // 几何过程的内容是否来自多线程录制的二级命令缓冲
+  bool usesSecondaryRecording() const {
+    return m_recordingThreads > 1 && !m_useIndirect;
+  }
+  // 渲染图是否包含剔除与两阶段几何过程
+  bool usesGpuCulling() const {
+    return m_useIndirect && m_useGpuCulling && m_gpuCulling;
+  }
+  bool usesAsyncCompute() const {
+    return m_renderGraph && m_renderGraph->GetBatches().size() > 1;
+  }
+  void addCullingPasses(VKGpuCulling::Phase phase);
+  void addLightingPasses();
+  void initResources();
+  void renderOffscreenFrame();
+  void saveReadback(uint32_t slot);
+  void buildRenderGraph();
+  void updateFrameUniforms();
+  void cleanup();
 };
\ No newline at end of file
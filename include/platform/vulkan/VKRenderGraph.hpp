@@ -0,0 +1,224 @@
+#pragma once
+#include <array>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "VKProfiler.hpp"
+#include "VKRenderProcess.hpp"
+
+/**
+ * @brief 渲染图
+ *
+ * 渲染过程声明对图像和缓冲的读写，渲染图编译时：
+ *  1. 从输出资源反向追踪，剔除对输出无贡献的过程；
+ *  2. 计算每个资源的生命周期，为瞬态图像分配内存，
+ *     生命周期不重叠的瞬态图像共享（别名）同一块内存；
+ *  3. 按资源状态推导最少的管线屏障与布局转换，同一过程的屏障合并提交；
+ *  4. 启用异步计算时按队列把过程切分为批次，跨队列访问由时间线信号量
+ *     等待衔接，导入资源（独占共享）在队列族间转移所有权，
+ *     两个队列都访问的瞬态资源以并发共享模式创建。
+ * 编译结果可重复执行，导入资源（如交换链图像）可逐帧替换句柄。
+ */
+class VKRenderGraph {
+ public:
+  struct ImageDesc {
+    vk::Format format = vk::Format::eUndefined;
+    vk::Extent2D extent;
+    vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor;
+    vk::ImageUsageFlags extraUsage;  // 访问声明之外额外需要的用途
+  };
+
+  struct BufferDesc {
+    vk::DeviceSize size = 0;
+    vk::BufferUsageFlags extraUsage;
+  };
+
+  // 一段提交到同一队列的连续过程，对应一次队列提交
+  struct Batch {
+    RGQueue queue = RGQueue::Graphics;
+    uint32_t firstPass = 0;  // 编译后调度中的区间
+    uint32_t passCount = 0;
+    int waitBatch = -1;  // 提交前需等待的另一队列上的批次，-1为无
+  };
+
+  VKRenderGraph(vk::Device device, vk::PhysicalDevice physicalDevice);
+  ~VKRenderGraph();
+
+  // 禁止拷贝
+  VKRenderGraph(const VKRenderGraph&) = delete;
+  VKRenderGraph& operator=(const VKRenderGraph&) = delete;
+
+  // 瞬态资源：由渲染图创建，生命周期仅限本图内
+  RGResource CreateImage(const std::string& name, const ImageDesc& desc);
+  RGResource CreateBuffer(const std::string& name, const BufferDesc& desc);
+
+  // 导入外部资源
+  RGResource ImportImage(const std::string& name, const ImageDesc& desc,
+                         vk::Image image, vk::ImageView view,
+                         vk::ImageLayout initialLayout,
+                         vk::ImageLayout finalLayout);
+  RGResource ImportBuffer(const std::string& name, vk::Buffer buffer,
+                          vk::DeviceSize size);
+
+  // 更新导入资源的句柄（如每帧获取的交换链图像）
+  void SetImportedImage(RGResource resource, vk::Image image,
+                        vk::ImageView view);
+  void SetImportedBuffer(RGResource resource, vk::Buffer buffer);
+
+  // 标记为图输出，决定剔除的起点（导入资源默认视为输出）
+  void MarkOutput(RGResource resource);
+
+  VKRenderProcess& AddPass(const std::string& name);
+
+  // 异步计算：标记为RGQueue::Compute的过程提交到计算队列族（须在Compile
+  // 之前设置）。两个队列族相同或未启用时所有过程录制到同一个命令缓冲
+  void SetAsyncCompute(bool enabled, uint32_t graphicsFamily,
+                       uint32_t computeFamily);
+  bool IsAsyncComputeEnabled() const { return m_asyncCompute; }
+
+  // 编译：剔除、生命周期、瞬态内存别名、屏障推导
+  void Compile();
+
+  // 按编译好的顺序录制所有过程；提供分析器时为每个过程记录GPU作用域
+  // （仅在只有一个批次时可用）
+  void Execute(vk::CommandBuffer commandBuffer,
+               VKProfiler* profiler = nullptr) const;
+
+  // 录制一个批次：过程、批次末尾的所有权释放，最后一个批次还包含
+  // 导入资源的最终布局转换。批次须按顺序提交到各自的队列
+  void ExecuteBatch(uint32_t batch, vk::CommandBuffer commandBuffer,
+                    VKProfiler* profiler = nullptr) const;
+  const std::vector<Batch>& GetBatches() const { return m_batches; }
+  // 首次访问资源的批次（如需等待交换链图像获取的批次）
+  uint32_t GetFirstBatch(RGResource resource) const;
+
+  // 清空所有过程和资源（释放瞬态资源）
+  void Reset();
+
+  // 输出编译后的调度（过程顺序、屏障、剔除、别名）
+  std::string DumpSchedule() const;
+
+  // 资源访问
+  vk::Image GetImage(RGResource resource) const;
+  vk::ImageView GetImageView(RGResource resource) const;
+  vk::Buffer GetBuffer(RGResource resource) const;
+  const ImageDesc& GetImageDesc(RGResource resource) const;
+
+  bool IsCompiled() const { return m_compiled; }
+  size_t GetCulledPassCount() const { return m_culledPasses.size(); }
+  vk::DeviceSize GetTransientMemorySize() const;
+  vk::DeviceSize GetTransientMemorySizeWithoutAliasing() const;
+
+ private:
+  enum class ResourceType { Image, Buffer };
+
+  struct ResourceState {
+    vk::PipelineStageFlags2 stages;
+    vk::AccessFlags2 access;
+    vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+    bool written = false;
+    // 最近一次访问所在的队列与批次（-1为上一帧，已由帧首批次等待）
+    RGQueue queue = RGQueue::Graphics;
+    int batch = -1;
+  };
+
+  struct Resource {
+    std::string name;
+    ResourceType type = ResourceType::Image;
+    bool imported = false;
+    bool output = false;
+
+    ImageDesc imageDesc;
+    BufferDesc bufferDesc;
+    vk::Image image;
+    vk::ImageView view;
+    vk::Buffer buffer;
+    vk::ImageUsageFlags imageUsage;
+    vk::BufferUsageFlags bufferUsage;
+    vk::ImageLayout initialLayout = vk::ImageLayout::eUndefined;
+    vk::ImageLayout finalLayout = vk::ImageLayout::eUndefined;
+
+    // 编译结果
+    int firstUse = -1;  // 编译后顺序中的首个/最后一个过程
+    int lastUse = -1;
+    int memoryBlock = -1;
+    vk::MemoryRequirements memoryRequirements;
+    int aliasPredecessor = -1;  // 同一内存块中的前一个占用者
+    bool sharedQueues = false;  // 同时被图形与计算队列访问
+  };
+
+  struct Barrier {
+    uint32_t resource;
+    vk::PipelineStageFlags2 srcStage;
+    vk::AccessFlags2 srcAccess;
+    vk::PipelineStageFlags2 dstStage;
+    vk::AccessFlags2 dstAccess;
+    vk::ImageLayout oldLayout;
+    vk::ImageLayout newLayout;
+    // 两者不同时为所有权转移的释放或获取
+    uint32_t srcFamily = VK_QUEUE_FAMILY_IGNORED;
+    uint32_t dstFamily = VK_QUEUE_FAMILY_IGNORED;
+  };
+
+  struct CompiledPass {
+    uint32_t pass;
+    std::vector<Barrier> barriers;
+    RGQueue queue = RGQueue::Graphics;
+    uint32_t batch = 0;
+  };
+
+  struct MemoryBlock {
+    vk::DeviceMemory memory;
+    vk::DeviceSize size = 0;
+    uint32_t memoryTypeBits = 0;
+    std::vector<uint32_t> resources;
+  };
+
+  struct AccessInfo {
+    vk::PipelineStageFlags2 stage;
+    vk::AccessFlags2 access;
+    vk::ImageLayout layout;
+    bool write;
+  };
+
+  static AccessInfo GetAccessInfo(RGAccess access, bool depth);
+  static vk::ImageUsageFlags GetImageUsage(RGAccess access);
+  static vk::BufferUsageFlags GetBufferUsage(RGAccess access);
+  // 计算队列上的屏障不能使用图形阶段
+  static vk::PipelineStageFlags2 GetQueueStages(
+      vk::PipelineStageFlags2 stages, RGQueue queue);
+
+  void CullPasses();
+  void AssignQueues();
+  void ComputeLifetimes();
+  void CreateTransientResources();
+  void AliasTransientMemory();
+  void BuildBarriers();
+  void DestroyTransientResources();
+
+  Resource& GetResource(RGResource resource);
+  const Resource& GetResource(RGResource resource) const;
+  uint32_t GetQueueFamily(RGQueue queue) const {
+    return m_queueFamilies[static_cast<uint32_t>(queue)];
+  }
+
+  vk::Device m_device;
+  vk::PhysicalDevice m_physicalDevice;
+
+  std::vector<Resource> m_resources;
+  std::deque<VKRenderProcess> m_passes;  // deque保证过程引用稳定
+
+  std::vector<CompiledPass> m_schedule;
+  std::vector<uint32_t> m_culledPasses;
+  std::vector<Barrier> m_finalBarriers;
+  std::vector<MemoryBlock> m_memoryBlocks;
+  bool m_compiled = false;
+
+  bool m_asyncCompute = false;
+  std::array<uint32_t, 2> m_queueFamilies{};  // 按RGQueue索引
+  std::vector<Batch> m_batches;
+  std::vector<std::vector<Barrier>> m_releaseBarriers;  // 每个批次末尾
+};
@@ -1 +1,155 @@
-class VKRenderProcess {};
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+class VKRenderGraph;
+
+/**
+ * @brief 渲染图资源句柄
+ */
+struct RGResource {
+  uint32_t index = UINT32_MAX;
+  bool IsValid() const { return index != UINT32_MAX; }
+  bool operator==(const RGResource& other) const {
+    return index == other.index;
+  }
+};
+
+/**
+ * @brief 渲染过程对资源的访问方式
+ *
+ * 每种访问方式对应确定的管线阶段、访问掩码和图像布局，
+ * 渲染图据此自动推导屏障与布局转换。
+ */
+enum class RGAccess {
+  ColorAttachmentWrite,   // 颜色附件写入
+  DepthAttachmentWrite,   // 深度附件读写
+  DepthAttachmentRead,    // 只读深度测试
+  FragmentSampledRead,    // 片元着色器采样
+  ComputeSampledRead,     // 计算着色器采样
+  ComputeStorageRead,     // 计算着色器存储读取
+  ComputeStorageWrite,    // 计算着色器存储写入
+  TransferRead,           // 传输源
+  TransferWrite,          // 传输目标
+  VertexShaderRead,       // 顶点着色器存储/uniform读取
+  FragmentShaderRead,     // 片元着色器存储/uniform读取
+  IndirectRead,           // 间接绘制参数
+  Present,                // 交换链呈现
+};
+
+/**
+ * @brief 渲染过程提交的队列
+ *
+ * 标记为计算的过程只在渲染图启用异步计算时提交到计算队列，
+ * 否则与其余过程一起录制到图形命令缓冲。
+ */
+enum class RGQueue : uint32_t {
+  Graphics = 0,
+  Compute,
+};
+
+/**
+ * @brief 渲染过程（渲染图中的一个pass）
+ *
+ * 声明本过程读写的图像和缓冲以及录制回调。
+ * 带颜色/深度附件的过程由渲染图自动开始和结束动态渲染。
+ */
+class VKRenderProcess {
+ public:
+  using ExecuteFunc =
+      std::function<void(vk::CommandBuffer, const VKRenderGraph&)>;
+
+  struct Access {
+    RGResource resource;
+    RGAccess access;
+  };
+
+  struct ColorAttachment {
+    RGResource resource;
+    vk::AttachmentLoadOp loadOp = vk::AttachmentLoadOp::eClear;
+    vk::ClearColorValue clearValue = vk::ClearColorValue(
+        std::array<float, 4>{0.0f, 0.0f, 0.0f, 0.0f});
+  };
+
+  struct DepthAttachment {
+    RGResource resource;
+    vk::AttachmentLoadOp loadOp = vk::AttachmentLoadOp::eClear;
+    vk::ClearDepthStencilValue clearValue = vk::ClearDepthStencilValue(1.0f, 0);
+    bool readOnly = false;
+  };
+
+  explicit VKRenderProcess(const std::string& name) : m_name(name) {}
+
+  // 资源访问声明
+  VKRenderProcess& Read(RGResource resource, RGAccess access);
+  VKRenderProcess& Write(RGResource resource, RGAccess access);
+
+  // 附件声明（同时登记对应的写访问）
+  VKRenderProcess& AddColorAttachment(
+      RGResource resource,
+      vk::AttachmentLoadOp loadOp = vk::AttachmentLoadOp::eClear,
+      vk::ClearColorValue clearValue = vk::ClearColorValue(
+          std::array<float, 4>{0.0f, 0.0f, 0.0f, 0.0f}));
+  VKRenderProcess& SetDepthAttachment(
+      RGResource resource,
+      vk::AttachmentLoadOp loadOp = vk::AttachmentLoadOp::eClear,
+      bool readOnly = false);
+
+  // 具有外部副作用的过程（如回读）不会被剔除
+  VKRenderProcess& SetSideEffect(bool sideEffect = true) {
+    m_sideEffect = sideEffect;
+    return *this;
+  }
+
+  // 渲染内容由二级命令缓冲提供（回调中只能调用executeCommands）
+  VKRenderProcess& SetSecondaryCommandBuffers(bool secondary = true) {
+    m_secondaryCommandBuffers = secondary;
+    return *this;
+  }
+
+  // 只含计算与传输命令的过程可标记为异步计算
+  VKRenderProcess& SetQueue(RGQueue queue) {
+    m_queue = queue;
+    return *this;
+  }
+
+  VKRenderProcess& SetExecute(ExecuteFunc execute) {
+    m_execute = std::move(execute);
+    return *this;
+  }
+
+  const std::string& GetName() const { return m_name; }
+  const std::vector<Access>& GetReads() const { return m_reads; }
+  const std::vector<Access>& GetWrites() const { return m_writes; }
+  const std::vector<ColorAttachment>& GetColorAttachments() const {
+    return m_colorAttachments;
+  }
+  const std::optional<DepthAttachment>& GetDepthAttachment() const {
+    return m_depthAttachment;
+  }
+  bool HasSideEffect() const { return m_sideEffect; }
+  bool UsesSecondaryCommandBuffers() const {
+    return m_secondaryCommandBuffers;
+  }
+  bool IsRendering() const {
+    return !m_colorAttachments.empty() || m_depthAttachment.has_value();
+  }
+  RGQueue GetQueue() const { return m_queue; }
+  const ExecuteFunc& GetExecute() const { return m_execute; }
+
+ private:
+  std::string m_name;
+  std::vector<Access> m_reads;
+  std::vector<Access> m_writes;
+  std::vector<ColorAttachment> m_colorAttachments;
+  std::optional<DepthAttachment> m_depthAttachment;
+  bool m_sideEffect = false;
+  bool m_secondaryCommandBuffers = false;
+  RGQueue m_queue = RGQueue::Graphics;
+  ExecuteFunc m_execute;
+};
@@ -1,21 +1,27 @@
 #pragma once
+#include <cstdint>
+#include <span>
 #include <string>
 #include <vulkan/vulkan.hpp>
 
 class VKShader {
  public:
   std::string name;
-  VKShader(const std::string& name, const std::string& vertexPath,
-           const std::string& fragmentPath);
+  // 阶段以着色器名称给出（如geometry_vert），见ShaderLoader::Load
+  VKShader(vk::Device device, const std::string& name,
+           const std::string& vertexShader, const std::string& fragmentShader);
   ~VKShader();
 
   vk::ShaderModule GetVertexModule() const;
   vk::ShaderModule GetFragmentModule() const;
+  // 两个阶段SPIR-V内容的哈希（管线缓存键）
+  uint64_t GetCodeHash() const { return m_codeHash; }
 
  private:
   vk::Device m_device;
   vk::ShaderModule m_vertexModule;
   vk::ShaderModule m_fragmentModule;
+  uint64_t m_codeHash = 0;
 
-  vk::ShaderModule CreateShaderModule(const std::vector<uint32_t>& code);
+  vk::ShaderModule CreateShaderModule(std::span<const uint32_t> code);
 };
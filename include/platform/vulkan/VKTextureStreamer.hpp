@@ -0,0 +1,142 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "VKFrameScheduler.hpp"
+#include "resource/Texture.hpp"
+
+/**
+ * @brief 纹理mip流送
+ *
+ * 纹理登记时只上传边长不超过initialSize的低mip，其余mip按渲染器的
+ * 屏幕空间反馈（对象包围球的投影尺寸）经传输队列异步流入，
+ * 常驻总量超出预算时驱逐长时间未被需要的高mip。
+ * 部分常驻以重新分配实现：图像只包含[firstMip, mipLevels)，
+ * 等价于把minLod钳制到firstMip，且不为未常驻的mip占用显存。
+ * 上传完成（传输队列时间线到达提交值）后才切换视图，旧图像在切换前
+ * 已提交的图形工作完成后销毁；同一纹理上一次切换的旧图像退休前
+ * 不发起新的上传。
+ */
+class VKTextureStreamer {
+ public:
+  struct Config {
+    vk::DeviceSize budgetBytes = 512ull << 20;  // 流送纹理的常驻预算
+    vk::DeviceSize uploadBytesPerFrame = 16ull << 20;  // 每帧发起的上传量
+    uint32_t initialSize = 128;  // 登记时常驻的最高mip边长
+    uint32_t evictAfterFrames = 120;  // 超过该帧数未被请求的mip可被驱逐
+  };
+
+  struct Stats {
+    vk::DeviceSize residentBytes = 0;  // 当前图像占用的显存
+    vk::DeviceSize budgetBytes = 0;
+    vk::DeviceSize uploadedBytes = 0;  // 累计上传的纹素字节
+    uint32_t textureCount = 0;
+    uint32_t pendingUploads = 0;
+    uint32_t streamIns = 0;  // 累计流入次数
+    uint32_t evictions = 0;  // 累计驱逐次数
+  };
+
+  struct UpdateResult {
+    std::vector<uint32_t> swapped;       // 本次切换了视图的纹理
+    std::vector<vk::ImageView> retired;  // 本次销毁的旧视图
+  };
+
+  VKTextureStreamer(vk::Device device, vk::PhysicalDevice physicalDevice,
+                    VKFrameScheduler& scheduler, uint32_t transferFamily,
+                    uint32_t graphicsFamily, const Config& config);
+  // 调用方需保证设备空闲
+  ~VKTextureStreamer();
+
+  // 禁止拷贝
+  VKTextureStreamer(const VKTextureStreamer&) = delete;
+  VKTextureStreamer& operator=(const VKTextureStreamer&) = delete;
+
+  // 登记带完整mip链的纹理并同步上传低mip，返回流送句柄
+  uint32_t Register(const Texture& cooked, vk::Format format);
+
+  // 纹理是否值得流送（小纹理整体常驻）
+  bool ShouldStream(const Texture& texture) const {
+    return static_cast<uint32_t>(std::max(texture.width, texture.height)) >
+           m_config.initialSize;
+  }
+
+  // 反馈：纹理在屏幕上覆盖的像素尺寸，本帧取最大值换算为所需mip
+  void RequestScreenSize(uint32_t handle, float pixels);
+
+  // 每帧在帧槽位等待之后、录制之前调用：退休旧图像，切换完成的上传，
+  // 按反馈与预算发起新的流入与驱逐
+  UpdateResult Update();
+
+  vk::ImageView GetView(uint32_t handle) const {
+    return m_textures[handle].current.view;
+  }
+  uint32_t GetResidentMip(uint32_t handle) const {
+    return m_textures[handle].current.firstMip;
+  }
+  void SetBudget(vk::DeviceSize bytes) { m_config.budgetBytes = bytes; }
+  const Stats& GetStats() const { return m_stats; }
+
+ private:
+  // 一个常驻区间的图像
+  struct Allocation {
+    vk::Image image;
+    vk::DeviceMemory memory;
+    vk::ImageView view;
+    uint32_t firstMip = 0;
+    vk::DeviceSize bytes = 0;
+  };
+
+  struct StreamedTexture {
+    Texture source;  // 烘焙后的完整mip链
+    vk::Format format;
+    Allocation current;
+    bool uploading = false;
+    uint32_t retiring = 0;  // 尚未销毁的旧图像数
+    uint32_t requestedMip = UINT32_MAX;  // 本帧请求的最高精度mip
+    uint32_t wantedMip = 0;              // 最近一次请求的mip
+    uint64_t lastRequestFrame = 0;
+  };
+
+  struct Upload {
+    uint32_t handle;
+    Allocation allocation;
+    vk::Buffer staging;
+    vk::DeviceMemory stagingMemory;
+    vk::CommandBuffer commandBuffer;
+    uint64_t value = 0;  // 传输队列时间线的触发值
+  };
+
+  struct Retired {
+    uint32_t handle;
+    Allocation allocation;
+    uint64_t graphicsValue;  // 被替换时已提交的图形时间线值
+  };
+
+  // 纹理[firstMip, mipLevels)的纹素字节数
+  static vk::DeviceSize MipRangeBytes(const Texture& texture,
+                                      uint32_t firstMip);
+  Allocation CreateAllocation(const StreamedTexture& texture,
+                              uint32_t firstMip);
+  void DestroyAllocation(Allocation& allocation);
+  // 录制并提交[firstMip, mipLevels)的上传
+  Upload BeginUpload(uint32_t handle, uint32_t firstMip);
+  void FinishUpload(Upload& upload);
+  // 本帧期望的常驻mip（长时间未被请求时回落到初始mip）
+  uint32_t TargetMip(const StreamedTexture& texture) const;
+  uint32_t InitialMip(const Texture& texture) const;
+
+  vk::Device m_device;
+  vk::PhysicalDevice m_physicalDevice;
+  VKFrameScheduler& m_scheduler;
+  std::vector<uint32_t> m_queueFamilies;  // 两个队列族不同时并发共享
+  Config m_config;
+  vk::CommandPool m_commandPool;
+
+  std::vector<StreamedTexture> m_textures;
+  std::vector<Upload> m_uploads;
+  std::vector<Retired> m_retired;
+  uint64_t m_frame = 0;
+  Stats m_stats;
+};
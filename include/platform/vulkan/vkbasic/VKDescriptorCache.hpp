@@ -0,0 +1,88 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+#include "VKDescriptorPool.hpp"
+
+/**
+ * @brief 材质描述符集缓存类
+ *
+ * 以材质绑定的资源（UBO与六张纹理）的哈希为键缓存描述符集，
+ * 绑定完全相同的材质跨帧复用同一个描述符集。
+ * 未命中时通过描述符更新模板一次性写入全部绑定。
+ * 提供命中/未命中计数以及每帧更新次数统计。
+ */
+class VKDescriptorCache {
+ public:
+  // 与geometry.frag中binding 1~6的采样器一一对应
+  static constexpr uint32_t kImageBindingCount = 6;
+
+  /**
+   * @brief 一个材质描述符集所绑定的全部资源
+   *
+   * 内存布局即为更新模板的数据布局，可直接传给
+   * vkUpdateDescriptorSetWithTemplate。
+   */
+  struct Bindings {
+    vk::DescriptorBufferInfo uniformBuffer;  // binding 0（动态UBO）
+    std::array<vk::DescriptorImageInfo, kImageBindingCount>
+        images;  // binding 1~6
+
+    bool operator==(const Bindings& other) const;
+  };
+
+  struct Stats {
+    uint64_t hits = 0;           // 累计命中次数
+    uint64_t misses = 0;         // 累计未命中次数
+    uint32_t frameLookups = 0;   // 本帧查询次数
+    uint32_t frameUpdates = 0;   // 本帧描述符集写入次数
+    size_t cachedSets = 0;       // 当前缓存的描述符集数量
+  };
+
+  VKDescriptorCache(vk::Device device,
+                    std::shared_ptr<VKDescriptorPool> descriptorPool,
+                    vk::DescriptorSetLayout layout);
+  ~VKDescriptorCache();
+
+  // 禁止拷贝
+  VKDescriptorCache(const VKDescriptorCache&) = delete;
+  VKDescriptorCache& operator=(const VKDescriptorCache&) = delete;
+
+  // 获取与绑定资源匹配的描述符集，不存在时分配并写入
+  vk::DescriptorSet GetOrCreate(const Bindings& bindings);
+
+  // 每帧开始时调用，清零本帧统计
+  void BeginFrame();
+
+  // 释放所有缓存的描述符集（资源销毁或重建时调用）
+  void Clear();
+
+  // 释放引用该图像视图的描述符集（视图销毁时调用，
+  // 调用方保证这些描述符集不再被在途命令使用）
+  void Evict(vk::ImageView imageView);
+
+  const Stats& GetStats() const { return m_stats; }
+  vk::DescriptorSetLayout GetLayout() const { return m_layout; }
+
+  static size_t Hash(const Bindings& bindings);
+
+ private:
+  struct Entry {
+    Bindings bindings;
+    vk::DescriptorSet set;
+  };
+
+  void CreateUpdateTemplate();
+
+  vk::Device m_device;
+  std::shared_ptr<VKDescriptorPool> m_descriptorPool;
+  vk::DescriptorSetLayout m_layout;
+  vk::DescriptorUpdateTemplate m_updateTemplate;
+
+  // 哈希 -> 条目列表（处理哈希冲突）
+  std::unordered_map<size_t, std::vector<Entry>> m_sets;
+  Stats m_stats;
+};
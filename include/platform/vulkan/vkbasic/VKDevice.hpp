@@ -34,6 +34,21 @@ class VKDevice {
   vk::Queue m_computeQueue;
   QueueFamilyIndices m_queueFamilyIndices;
 
+  // 可选特性支持情况（在创建逻辑设备前探测）
+  struct FeatureSupport {
+    bool descriptorIndexing = false;  // 无绑定纹理所需的描述符索引特性
+    uint32_t maxBindlessTextures = 0;  // update-after-bind采样图像上限
+    bool dynamicRendering = false;     // 动态渲染（渲染图使用）
+    bool synchronization2 = false;     // 同步2（渲染图屏障使用）
+    bool hostQueryReset = false;       // 主机端重置查询池（性能分析使用）
+    bool pipelineStatistics = false;   // 管线统计查询
+    bool inheritedQueries = false;     // 二级命令缓冲继承查询
+    bool multiDrawIndirect = false;    // 单次间接绘制提交多条命令
+    bool drawIndirectFirstInstance = false;  // 间接命令的firstInstance非零
+    bool drawIndirectCount = false;  // 绘制数量由GPU写入缓冲
+    bool timelineSemaphore = false;  // 时间线信号量（跨队列调度使用）
+  };
+
   // 扩展管理相关成员
   std::vector<std::string> m_requiredExtensions;
   std::vector<vk::ExtensionProperties> m_availableExtensions;
@@ -73,6 +88,32 @@ class VKDevice {
   void printAvailableExtensions() const;
   void printEnabledExtensions() const;
 
+  // 特性探测与启用方法（需在createLogicalDevice之前调用）
+  bool queryDescriptorIndexingSupport();
+  void enableDescriptorIndexing();
+  bool isDescriptorIndexingEnabled() const {
+    return m_descriptorIndexingEnabled;
+  }
+  bool queryVulkan13Support();
+  void enableVulkan13Features();
+  // 性能分析：主机端查询重置、管线统计与查询继承（均为可选，按支持情况启用）
+  void queryProfilingSupport();
+  void enableProfilingFeatures();
+  // 间接绘制：多命令间接绘制、firstInstance与间接数量（可选，按支持情况启用）
+  void queryIndirectDrawSupport();
+  void enableIndirectDrawFeatures();
+  // 时间线信号量：异步计算的跨队列同步（可选，按支持情况启用）
+  bool queryTimelineSemaphoreSupport();
+  void enableTimelineSemaphore();
+  const FeatureSupport& GetFeatureSupport() const { return m_featureSupport; }
+
+  // 计算队列族是否独立于图形队列族（异步计算的前提）
+  bool HasDedicatedComputeQueue() const {
+    return m_queueFamilyIndices.computeFamily.has_value() &&
+           m_queueFamilyIndices.computeFamily !=
+               m_queueFamilyIndices.graphicQueue;
+  }
+
   // 设备操作方法
   void waitIdle() { m_device.waitIdle(); }
   vk::Device& GetHandle() { return m_device; }
@@ -81,4 +122,20 @@ class VKDevice {
   vk::Format findSupportedFormat(const std::vector<vk::Format>& candidates,
                                  vk::ImageTiling tiling,
                                  vk::FormatFeatureFlags features);
+
+ private:
+  // 将特性结构体挂到创建设备时的pNext链上
+  void appendFeatureChain(void* feature);
+
+  FeatureSupport m_featureSupport;
+  bool m_descriptorIndexingEnabled = false;
+  vk::PhysicalDeviceDescriptorIndexingFeatures m_descriptorIndexingFeatures;
+  bool m_vulkan13Enabled = false;
+  vk::PhysicalDeviceVulkan13Features m_vulkan13Features;
+  bool m_profilingEnabled = false;
+  vk::PhysicalDeviceHostQueryResetFeatures m_hostQueryResetFeatures;
+  bool m_indirectDrawEnabled = false;
+  bool m_timelineSemaphoreEnabled = false;
+  vk::PhysicalDeviceTimelineSemaphoreFeatures m_timelineSemaphoreFeatures;
+  void* m_featureChain = nullptr;
 };
\ No newline at end of file
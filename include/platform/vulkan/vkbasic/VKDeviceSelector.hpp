@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+/**
+ * @brief 物理设备能力档案
+ *
+ * 在创建逻辑设备之前探测，渲染器据此选择设备支持的最快路径。
+ */
+struct DeviceCapabilities {
+  std::string name;
+  vk::PhysicalDeviceType type = vk::PhysicalDeviceType::eOther;
+  uint32_t apiVersion = 0;
+  vk::DeviceSize deviceLocalBytes = 0;  // 最大的设备本地内存堆
+  bool graphicsQueue = false;
+  bool presentSupport = false;    // 离屏模式恒为true
+  bool dedicatedCompute = false;  // 独立于图形的计算队列族（异步计算）
+  bool dedicatedTransfer = false;  // 独立的传输队列族（后台上传）
+  bool swapchain = false;          // VK_KHR_swapchain
+  bool dynamicRendering = false;
+  bool synchronization2 = false;
+  bool timelineSemaphore = false;
+  bool descriptorIndexing = false;  // 无绑定纹理所需的子特性
+  bool drawIndirectCount = false;
+  bool multiDrawIndirect = false;
+  bool textureCompressionBC = false;
+
+  bool IsSoftware() const {
+    return type == vk::PhysicalDeviceType::eCpu;
+  }
+  std::string ToString() const;
+};
+
+/**
+ * @brief 物理设备打分选择
+ *
+ * 不满足渲染器最低要求（Vulkan 1.3动态渲染与synchronization2、图形队列，
+ * 窗口模式下的呈现支持与交换链扩展）的设备不参与选择；其余按设备类型、
+ * 设备本地显存、独立计算/传输队列与可选特性打分，取最高分。
+ * 软件设备（如lavapipe）类型分最低，只在没有可用硬件设备时被选中。
+ * 环境变量PBR_DEVICE可强制选择：设备序号、设备类型
+ * （discrete/integrated/virtual/cpu）或名称子串（不区分大小写）。
+ */
+class VKDeviceSelector {
+ public:
+  static constexpr const char* kOverrideVariable = "PBR_DEVICE";
+
+  struct Candidate {
+    vk::PhysicalDevice device;
+    uint32_t index = 0;  // 枚举顺序
+    DeviceCapabilities capabilities;
+    bool suitable = false;
+    std::string rejectReason;  // 不满足最低要求的原因
+    int64_t score = 0;
+  };
+
+  // surface为空时按离屏模式评估（不要求呈现与交换链）
+  static DeviceCapabilities QueryCapabilities(vk::PhysicalDevice device,
+                                              vk::SurfaceKHR surface);
+
+  // 枚举并评估所有设备，按分数降序排列（不合格的设备排在最后）
+  static std::vector<Candidate> RankDevices(vk::Instance instance,
+                                            vk::SurfaceKHR surface);
+
+  // 从RankDevices的结果中选择：override非空时优先取匹配的合格设备，
+  // 匹配不到时退回最高分。没有合格设备时抛出std::runtime_error
+  static Candidate Select(const std::vector<Candidate>& candidates,
+                          const std::string& override);
+
+  // 读取PBR_DEVICE，未设置时返回空串
+  static std::string GetOverrideFromEnvironment();
+
+  // 纯数字按枚举序号匹配，其次匹配设备类型，再按名称子串匹配
+  static bool Matches(const Candidate& candidate,
+                      const std::string& override);
+
+ private:
+  static int64_t Score(const DeviceCapabilities& capabilities);
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+/**
+ * @brief 合并几何缓冲池
+ *
+ * 所有模型的顶点与索引子分配到少量大块设备本地缓冲中，
+ * 同一块内的模型共用一次顶点/索引缓冲绑定，可由一条多命令间接绘制提交。
+ * 每块维护顶点与索引两个空闲区间表（首次适配，释放时合并相邻区间）；
+ * 现有块放不下时新建一块，超过默认块大小的模型独占一块。
+ * 上传通过暂存缓冲与一次性命令完成，调用方负责在释放前确认GPU不再使用。
+ */
+class VKGeometryPool {
+ public:
+  struct Allocation {
+    uint32_t block = UINT32_MAX;
+    int32_t vertexOffset = 0;  // 以顶点为单位（drawIndexed的vertexOffset）
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex = 0;   // 以索引为单位
+    uint32_t indexCount = 0;
+    bool IsValid() const { return block != UINT32_MAX; }
+  };
+
+  struct Stats {
+    uint32_t blockCount = 0;
+    uint32_t allocationCount = 0;
+    vk::DeviceSize vertexBytesUsed = 0;
+    vk::DeviceSize indexBytesUsed = 0;
+    vk::DeviceSize capacityBytes = 0;  // 所有块的顶点与索引缓冲总容量
+  };
+
+  VKGeometryPool(vk::Device device, vk::PhysicalDevice physicalDevice,
+                 vk::Queue queue, vk::CommandPool commandPool,
+                 uint32_t vertexStride, uint32_t verticesPerBlock = 1u << 20,
+                 uint32_t indicesPerBlock = 1u << 22);
+  ~VKGeometryPool();
+
+  // 禁止拷贝
+  VKGeometryPool(const VKGeometryPool&) = delete;
+  VKGeometryPool& operator=(const VKGeometryPool&) = delete;
+
+  // 分配并上传一个模型的顶点与索引（索引为模型内的局部索引）
+  Allocation Upload(const void* vertices, uint32_t vertexCount,
+                    const uint32_t* indices, uint32_t indexCount);
+
+  // 归还区间（调用方保证使用该几何的命令已执行完毕）
+  void Free(const Allocation& allocation);
+
+  vk::Buffer GetVertexBuffer(uint32_t block) const {
+    return m_blocks[block].vertexBuffer;
+  }
+  vk::Buffer GetIndexBuffer(uint32_t block) const {
+    return m_blocks[block].indexBuffer;
+  }
+  uint32_t GetBlockCount() const {
+    return static_cast<uint32_t>(m_blocks.size());
+  }
+  const Stats& GetStats() const { return m_stats; }
+
+ private:
+  struct Range {
+    uint32_t offset;
+    uint32_t count;
+  };
+
+  struct Block {
+    vk::Buffer vertexBuffer;
+    vk::DeviceMemory vertexMemory;
+    vk::Buffer indexBuffer;
+    vk::DeviceMemory indexMemory;
+    uint32_t vertexCapacity = 0;
+    uint32_t indexCapacity = 0;
+    std::vector<Range> freeVertices;  // 按偏移排序
+    std::vector<Range> freeIndices;
+  };
+
+  uint32_t CreateBlock(uint32_t vertexCapacity, uint32_t indexCapacity);
+  static bool AllocateRange(std::vector<Range>& freeList, uint32_t count,
+                            uint32_t& offset);
+  static void ReleaseRange(std::vector<Range>& freeList, Range range);
+
+  vk::Device m_device;
+  vk::PhysicalDevice m_physicalDevice;
+  vk::Queue m_queue;
+  vk::CommandPool m_commandPool;
+  uint32_t m_vertexStride;
+  uint32_t m_verticesPerBlock;
+  uint32_t m_indicesPerBlock;
+  std::vector<Block> m_blocks;
+  Stats m_stats;
+};
@@ -20,6 +20,7 @@ class VKInstance {
     std::vector<const char*> optionalExtensions =
         {};  // 可选扩展（自动跳过不支持的）
     std::vector<const char*> validationLayers = {};  // 留空则禁用验证层
+    bool headless = false;  // 离屏模式：不启用任何表面扩展
   };
 
   explicit VKInstance(const CreateInfo& info = {});
@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+/**
+ * @brief 逐帧线性uniform分配器
+ *
+ * 一个持久映射的uniform缓冲按飞行帧划分为等大的区域，
+ * 每帧开始时将该帧区域的游标归零，之后按
+ * minUniformBufferOffsetAlignment对齐线性分配（原子操作，可多线程分配）。
+ * 分配结果以eUniformBufferDynamic的动态偏移绑定，
+ * 帧N+1写入时帧N的数据仍可在GPU上使用，仅依赖现有的帧槽位同步。
+ */
+class VKUniformArena {
+ public:
+  struct Allocation {
+    void* mapped = nullptr;  // 写入地址
+    uint32_t offset = 0;     // 动态偏移（相对缓冲起始）
+  };
+
+  VKUniformArena(vk::Device device, vk::PhysicalDevice physicalDevice,
+                 uint32_t framesInFlight, vk::DeviceSize bytesPerFrame);
+  ~VKUniformArena();
+
+  // 禁止拷贝
+  VKUniformArena(const VKUniformArena&) = delete;
+  VKUniformArena& operator=(const VKUniformArena&) = delete;
+
+  // 帧开始时调用（该帧槽位已等待）：回收该帧区域
+  void BeginFrame(uint32_t frameIndex);
+
+  // 分配count个连续的size字节块，每块起始均满足对齐要求，返回首块
+  Allocation Allocate(vk::DeviceSize size, uint32_t count = 1);
+
+  // 分配并写入一个uniform块，返回动态偏移
+  template <typename T>
+  uint32_t Push(const T& data) {
+    Allocation allocation = Allocate(sizeof(T));
+    std::memcpy(allocation.mapped, &data, sizeof(T));
+    return allocation.offset;
+  }
+
+  // 按对齐要求取整后的块大小（连续分配时相邻块的间距）
+  vk::DeviceSize AlignedSize(vk::DeviceSize size) const {
+    return (size + m_alignment - 1) & ~(m_alignment - 1);
+  }
+
+  vk::Buffer GetBuffer() const { return m_buffer; }
+  vk::DeviceSize GetAlignment() const { return m_alignment; }
+  vk::DeviceSize GetBytesPerFrame() const { return m_bytesPerFrame; }
+  // 当前帧已使用的字节数与历史峰值
+  vk::DeviceSize GetFrameUsage() const { return m_frameOffset.load(); }
+  vk::DeviceSize GetPeakUsage() const { return m_peakUsage; }
+
+ private:
+  vk::Device m_device;
+  vk::Buffer m_buffer;
+  vk::DeviceMemory m_memory;
+  uint8_t* m_mapped = nullptr;
+
+  vk::DeviceSize m_alignment = 256;
+  vk::DeviceSize m_bytesPerFrame = 0;
+  vk::DeviceSize m_frameBase = 0;  // 当前帧区域的起始偏移
+  std::atomic<vk::DeviceSize> m_frameOffset{0};
+  vk::DeviceSize m_peakUsage = 0;
+};
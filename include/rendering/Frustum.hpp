@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+/**
+ * @brief 轴对齐包围盒
+ */
+struct AABB {
+  glm::vec3 min{0.0f};
+  glm::vec3 max{0.0f};
+
+  // 空包围盒（与任何包围盒合并后等于对方）
+  static AABB Empty();
+
+  bool IsEmpty() const {
+    return min.x > max.x || min.y > max.y || min.z > max.z;
+  }
+  glm::vec3 Center() const { return (min + max) * 0.5f; }
+  glm::vec3 Extent() const { return max - min; }
+  float SurfaceArea() const;
+
+  AABB Merged(const AABB& other) const {
+    return {glm::min(min, other.min), glm::max(max, other.max)};
+  }
+  bool Contains(const AABB& other) const {
+    return glm::all(glm::lessThanEqual(min, other.min)) &&
+           glm::all(glm::greaterThanEqual(max, other.max));
+  }
+  bool operator==(const AABB& other) const {
+    return min == other.min && max == other.max;
+  }
+
+  // 变换后的包围盒（按矩阵元素绝对值展开半尺寸，结果仍为轴对齐）
+  AABB Transformed(const glm::mat4& transform) const;
+};
+
+/**
+ * @brief 视锥的六个平面
+ *
+ * 平面法线指向视锥内侧并已归一化，点p在内侧当且仅当dot(n, p) + w >= 0。
+ */
+struct Frustum {
+  enum class Result { Outside, Intersect, Inside };
+
+  glm::vec4 planes[6];  // 左、右、下、上、近、远
+
+  // 从视图投影矩阵提取（裁剪空间深度范围为Vulkan的[0, w]）
+  static Frustum FromViewProjection(const glm::mat4& viewProjection);
+
+  // 单个包围盒的分类（用于BVH内部节点，完全在内侧时可跳过子树测试）
+  Result Classify(const AABB& box) const;
+  bool Intersects(const AABB& box) const {
+    return Classify(box) != Result::Outside;
+  }
+};
+
+/**
+ * @brief 以SoA布局存放的包围盒数组
+ *
+ * 六个分量各自连续存放，容量按8对齐，SIMD路径每次加载8个盒。
+ */
+struct AABBArray {
+  std::vector<float> minX, minY, minZ;
+  std::vector<float> maxX, maxY, maxZ;
+  size_t count = 0;
+
+  void Resize(size_t size);
+  void Set(size_t index, const AABB& box);
+  AABB Get(size_t index) const;
+};
+
+/**
+ * @brief 包围盒的批量视锥测试
+ *
+ * 标量路径逐盒测试；SSE路径每次4个、AVX2路径每次8个，
+ * 平面法线的符号对同一批盒相同，逐平面选取正顶点后一次比较得到可见掩码。
+ * 非x86平台或CPU不支持时回退到较窄的路径。
+ */
+namespace FrustumCulling {
+
+enum class Path { Scalar, SSE, AVX2 };
+
+// 当前CPU支持的最宽路径（首次调用时检测）
+Path GetBestPath();
+const char* GetPathName(Path path);
+
+// 测试8个盒（各分量指针至少可读8个元素），返回可见位掩码
+uint32_t TestBoxes8(const Frustum& frustum, const float* minX,
+                    const float* minY, const float* minZ, const float* maxX,
+                    const float* maxY, const float* maxZ, Path path);
+
+// 测试[begin, end)内的盒，可见盒的下标追加到visible
+void CullBoxes(const Frustum& frustum, const AABBArray& boxes, size_t begin,
+               size_t end, Path path, std::vector<uint32_t>& visible);
+
+}  // namespace FrustumCulling
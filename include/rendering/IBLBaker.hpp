@@ -0,0 +1,134 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "resource/Texture.hpp"
+
+class ThreadPool;
+
+// 立方体贴图的一级：6个面依次为+X、-X、+Y、-Y、+Z、-Z，
+// 每面size*size个RGBA32F纹素，行优先
+struct CubeMipLevel {
+  uint32_t size = 0;
+  std::vector<float> texels;
+
+  float* Face(uint32_t face) {
+    return texels.data() + static_cast<size_t>(face) * size * size * 4;
+  }
+  const float* Face(uint32_t face) const {
+    return texels.data() + static_cast<size_t>(face) * size * size * 4;
+  }
+};
+
+/**
+ * @brief 基于图像的光照的预计算结果
+ *
+ * - 漫反射：辐照度的三阶球谐系数（已与余弦核卷积），
+ *   E(n) / π即为朗伯表面的出射辐亮度（除去反照率）。
+ * - 镜面反射：GGX预过滤的立方体贴图mip链，第i级的粗糙度为
+ *   i / (mipCount - 1)。
+ * - 分离求和近似的BRDF查找表：横轴为NdotV，纵轴为粗糙度，
+ *   两个通道为F0的缩放与偏移。
+ */
+struct IBLData {
+  uint64_t sourceKey = 0;  // 源图像与烘焙参数的哈希
+  std::array<glm::vec3, 9> irradianceSH{};
+  std::vector<CubeMipLevel> prefiltered;
+  uint32_t brdfLutSize = 0;
+  std::vector<float> brdfLut;  // RG32F，行优先
+
+  bool IsValid() const { return !prefiltered.empty() && !brdfLut.empty(); }
+  glm::vec3 EvaluateIrradiance(const glm::vec3& normal) const;
+};
+
+/**
+ * @brief IBL烘焙器
+ *
+ * 输入为HDR等距柱状投影贴图（TextureType::HDR），或把6个面自上而下
+ * 依次排列的立方体贴图（TextureType::CubeMap，宽 x 6宽）；
+ * 8位数据按sRGB解码为线性值。
+ * 源图像先重采样为立方体并盒式降采样出mip链，球谐投影、GGX预过滤
+ * （按采样概率密度选择源mip的过滤重要性采样）与BRDF查找表均按面与
+ * 行分块在线程池中并行。设置计算后端时预过滤与查找表在GPU上完成，
+ * 后端失败时回退到CPU。
+ * 指定缓存目录时以源图像内容与烘焙参数的哈希为键读写结果，
+ * 只有首次运行付出烘焙开销。
+ */
+class IBLBaker {
+ public:
+  struct Settings {
+    uint32_t cubeSize = 128;      // 预过滤立方体第0级的边长
+    uint32_t mipCount = 6;        // 不超过边长的完整mip链长度
+    uint32_t sampleCount = 256;   // 预过滤每纹素的重要性采样数
+    uint32_t brdfLutSize = 128;
+    uint32_t brdfSampleCount = 512;
+  };
+
+  // 预过滤与BRDF查找表的加速实现（返回false时回退到CPU）
+  class ComputeBackend {
+   public:
+    virtual ~ComputeBackend() = default;
+    // environment为源立方体的完整mip链，输出的第0级直接取源第0级
+    virtual bool Prefilter(const std::vector<CubeMipLevel>& environment,
+                           const Settings& settings,
+                           std::vector<CubeMipLevel>& prefiltered) = 0;
+    virtual bool BakeBrdfLut(const Settings& settings,
+                             std::vector<float>& lut) = 0;
+  };
+
+  struct Stats {
+    bool cacheHit = false;
+    bool usedCompute = false;
+    double totalMs = 0.0;
+    double resampleMs = 0.0;  // 重采样到立方体与mip链
+    double irradianceMs = 0.0;
+    double prefilterMs = 0.0;
+    double brdfLutMs = 0.0;
+  };
+
+  // pool为空时使用硬件并发数的内部线程池
+  explicit IBLBaker(ThreadPool* pool = nullptr);
+  ~IBLBaker();
+
+  // 禁止拷贝
+  IBLBaker(const IBLBaker&) = delete;
+  IBLBaker& operator=(const IBLBaker&) = delete;
+
+  void SetComputeBackend(ComputeBackend* backend) { m_backend = backend; }
+
+  // cacheDirectory为空时不读写缓存；源图像无效时抛出std::runtime_error
+  IBLData Bake(const Texture& source, const Settings& settings,
+               const std::string& cacheDirectory = "");
+  const Stats& GetLastStats() const { return m_stats; }
+
+  static uint64_t ComputeKey(const Texture& source, const Settings& settings);
+  static std::string GetCachePath(const std::string& cacheDirectory,
+                                  uint64_t key);
+  // 读取失败或键不一致时返回false
+  static bool LoadCache(const std::string& path, uint64_t key,
+                        IBLData& data);
+  static bool SaveCache(const std::string& path, const IBLData& data);
+
+ private:
+  // 把工作按[0, count)拆分到线程池并等待完成
+  void ParallelFor(uint32_t count,
+                   const std::function<void(uint32_t)>& body) const;
+
+  CubeMipLevel ResampleToCube(const Texture& source, uint32_t size) const;
+  std::vector<CubeMipLevel> BuildMipChain(CubeMipLevel base) const;
+  std::array<glm::vec3, 9> ProjectIrradiance(const CubeMipLevel& level) const;
+  std::vector<CubeMipLevel> Prefilter(
+      const std::vector<CubeMipLevel>& environment,
+      const Settings& settings) const;
+  std::vector<float> BakeBrdfLut(const Settings& settings) const;
+
+  ThreadPool* m_pool;
+  std::unique_ptr<ThreadPool> m_ownedPool;
+  ComputeBackend* m_backend = nullptr;
+  Stats m_stats;
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+#include "resource/Material.hpp"
+
+/**
+ * @brief 材质特性位与常量参数
+ *
+ * 第i位表示第i个输入（顺序同geometry.frag的binding 1~6）采样贴图，
+ * 未置位的输入使用常量值。几何片段着色器以特化常量kMaterialFeatures
+ * 接收特性掩码，未置位输入的采样在编译时消除；着色器还会按材质自身的
+ * 掩码选择贴图或常量，因此置位更多的变体（直至kAll的通用变体）也能
+ * 正确绘制该材质，作为专用变体编译完成前的回退。
+ * 着色器一侧的位定义与UseMap在gbuffer_common.glsl中，修改时需同步。
+ */
+struct MaterialFeatures {
+  static constexpr uint32_t kAlbedoMap = 1u << 0;
+  static constexpr uint32_t kNormalMap = 1u << 1;
+  static constexpr uint32_t kMetallicMap = 1u << 2;
+  static constexpr uint32_t kRoughnessMap = 1u << 3;
+  static constexpr uint32_t kAOMap = 1u << 4;
+  static constexpr uint32_t kEmissiveMap = 1u << 5;
+  static constexpr uint32_t kAll = 0x3Fu;
+  static constexpr size_t kSlotCount = 6;
+
+  static constexpr uint32_t SlotBit(size_t slot) { return 1u << slot; }
+};
+
+/**
+ * @brief 材质常量（与几何片段着色器的MaterialConstants一致，48字节）
+ *
+ * 逐材质描述符集路径作为片段推送常量，无绑定路径存于GPU材质表的记录。
+ */
+struct MaterialConstants {
+  glm::vec4 baseColor{1.0f};
+  // 金属度、粗糙度、AO、自发光强度，输入没有贴图时使用
+  glm::vec4 factors{1.0f, 1.0f, 1.0f, 0.0f};
+  uint32_t features = 0;  // MaterialFeatures位
+  float heightScale = 0.0f;  // 高度图缩放，0表示不使用高度
+  uint32_t padding[2] = {0, 0};
+
+  // 输入有可用的贴图且未指定UseFallback时置位；常量取UseFallback的值，
+  // 否则与默认贴图一致（白色基础色/金属度/粗糙度/AO，无自发光）
+  static MaterialConstants FromMaterial(const Material& material);
+};
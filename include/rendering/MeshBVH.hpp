@@ -0,0 +1,116 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "rendering/Frustum.hpp"
+#include "resource/Model.hpp"
+
+class ThreadPool;
+
+/**
+ * @brief 三角形网格的4宽包围体层次（射线查询）
+ *
+ * 构建：按16个分箱的表面积启发式（SAH）自顶向下划分二叉树，叶节点至多
+ * kMaxLeafSize个三角形。提供线程池时先串行划分顶层，子树数量足以均衡
+ * 各线程后各子树并行构建，再合并。二叉树随后折叠为4宽树：反复展开
+ * 表面积最大的内部子节点，直到填满4个槽位。
+ * 布局：节点128字节对齐到缓存行，4个子节点的包围盒按分量SoA存放，
+ * 节点按深度优先顺序排列；叶节点的三角形以4个一组的SoA块（顶点与两条
+ * 边）连续存放，不足4个的槽位以退化三角形填充。
+ * 遍历：SSE路径一次测试4个子包围盒与一个三角形块（Möller-Trumbore），
+ * 命中的子节点按进入距离由远到近入栈；非x86平台回退到标量路径，
+ * 两条路径的结果一致。
+ */
+class MeshBVH {
+ public:
+  static constexpr uint32_t kWidth = 4;
+  static constexpr uint32_t kMaxLeafSize = 8;
+  static constexpr uint32_t kInvalid = UINT32_MAX;
+
+  enum class Path { Scalar, SSE };
+
+  // 当前平台支持的最宽路径
+  static Path GetBestPath();
+  static const char* GetPathName(Path path);
+
+  struct Hit {
+    float t = 0.0f;
+    float u = 0.0f;  // 重心坐标，交点 = v0 + u * (v1 - v0) + v * (v2 - v0)
+    float v = 0.0f;
+    uint32_t triangle = kInvalid;  // 输入索引中的三角形序号
+  };
+
+  struct Stats {
+    uint32_t triangleCount = 0;
+    uint32_t nodeCount = 0;  // 4宽节点数
+    uint32_t leafCount = 0;
+    uint32_t depth = 0;
+    uint32_t subtreeTasks = 0;  // 并行构建的子树数
+    float sahCost = 0.0f;       // 以根包围盒表面积归一化的SAH代价
+    double buildMs = 0.0;
+  };
+
+  MeshBVH() = default;
+  ~MeshBVH() = default;
+
+  // 禁止拷贝
+  MeshBVH(const MeshBVH&) = delete;
+  MeshBVH& operator=(const MeshBVH&) = delete;
+
+  // 以indices中每三个顶点为一个三角形构建（替换已有的树）
+  void Build(const std::vector<Vertex>& vertices,
+             const std::vector<uint32_t>& indices, ThreadPool* pool = nullptr);
+  void Build(const Model& model, ThreadPool* pool = nullptr) {
+    Build(model.vertices, model.indices, pool);
+  }
+  void Clear();
+  bool IsEmpty() const { return m_nodes.empty(); }
+
+  // 最近交点（t位于(0, tMax)），未命中返回false
+  bool Intersect(const glm::vec3& origin, const glm::vec3& direction,
+                 float tMax, Hit& hit, Path path = GetBestPath()) const;
+  // 任一交点即返回，用于阴影光线
+  bool Occluded(const glm::vec3& origin, const glm::vec3& direction,
+                float tMax, Path path = GetBestPath()) const;
+
+  const AABB& GetBounds() const { return m_bounds; }
+  const Stats& GetStats() const { return m_stats; }
+
+ private:
+  // 子槽位：count为0时child为内部节点下标（空槽位为kInvalid），
+  // 否则为叶节点，child为首个三角形块，count为块数
+  struct alignas(64) Node {
+    float minX[kWidth];
+    float minY[kWidth];
+    float minZ[kWidth];
+    float maxX[kWidth];
+    float maxY[kWidth];
+    float maxZ[kWidth];
+    uint32_t child[kWidth];
+    uint32_t count[kWidth];
+  };
+  static_assert(sizeof(Node) == 128, "Node must span two cache lines");
+
+  // 4个三角形的顶点与两条边（SoA），triangle为输入中的序号
+  struct alignas(16) TriangleBlock {
+    float v0x[4], v0y[4], v0z[4];
+    float e1x[4], e1y[4], e1z[4];
+    float e2x[4], e2y[4], e2z[4];
+    uint32_t triangle[4];
+  };
+
+  class Builder;
+
+  template <bool kAnyHit>
+  bool TraverseScalar(const glm::vec3& origin, const glm::vec3& direction,
+                      float tMax, Hit& hit) const;
+  template <bool kAnyHit>
+  bool TraverseSSE(const glm::vec3& origin, const glm::vec3& direction,
+                   float tMax, Hit& hit) const;
+
+  std::vector<Node> m_nodes;  // m_nodes[0]为根
+  std::vector<TriangleBlock> m_blocks;
+  AABB m_bounds = AABB::Empty();
+  Stats m_stats;
+};
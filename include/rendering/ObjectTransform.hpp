@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <glm/glm.hpp>
+
+/**
+ * @brief 逐对象变换（与geometry.vert的ObjectTransform一致，176字节）
+ *
+ * 模型矩阵、法线矩阵（模型矩阵左上3x3的逆转置）与MVP在CPU上每对象
+ * 计算一次，顶点着色器只做矩阵向量乘法，不再逐顶点求逆。
+ * std140与std430下GLSL的mat3均按三个vec4列存放。
+ */
+struct ObjectTransform {
+  glm::mat4 model{1.0f};
+  glm::vec4 normalMatrix[3] = {{1.0f, 0.0f, 0.0f, 0.0f},
+                               {0.0f, 1.0f, 0.0f, 0.0f},
+                               {0.0f, 0.0f, 1.0f, 0.0f}};
+  glm::mat4 modelViewProjection{1.0f};
+};
+static_assert(sizeof(ObjectTransform) == 176,
+              "ObjectTransform must match the GLSL layout");
+
+/**
+ * @brief 逐对象变换的计算
+ *
+ * 法线矩阵以伴随矩阵计算：三列为模型矩阵前三列两两的叉积除以行列式，
+ * 行列式为0时不缩放（着色器会归一化法线）。SSE路径一个寄存器容纳一列，
+ * 矩阵乘法逐列广播，叉积以两次重排完成；非x86平台回退到标量路径。
+ */
+namespace ObjectTransforms {
+
+enum class Path { Scalar, SSE };
+
+// 当前平台支持的最宽路径
+Path GetBestPath();
+const char* GetPathName(Path path);
+
+void Compute(const glm::mat4& viewProjection, const glm::mat4& model,
+             ObjectTransform& out, Path path = GetBestPath());
+
+// 连续的count个模型矩阵，视图投影矩阵只加载一次
+void Compute(const glm::mat4& viewProjection, const glm::mat4* models,
+             size_t count, ObjectTransform* out, Path path = GetBestPath());
+
+}  // namespace ObjectTransforms
@@ -0,0 +1,129 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rendering/MaterialFeatures.hpp"
+#include "rendering/MeshBVH.hpp"
+#include "resource/Model.hpp"
+#include "resource/Texture.hpp"
+
+class Camera;
+class ThreadPool;
+
+/**
+ * @brief CPU参考路径追踪器
+ *
+ * 用于无GPU环境下生成金标准图像与离线渲染，输入与光栅化路径相同的
+ * Model、Material与Camera。材质按MaterialConstants的特性位选择贴图或
+ * 常量（与geometry.frag一致），BRDF与光源衰减同deferred_lighting.comp：
+ * GGX法线分布、Smith-Schlick几何项、Schlick菲涅尔，点光源做直接光照
+ * 采样并追踪阴影光线，间接光按镜面/漫反射波瓣混合重要性采样。
+ * 逃逸光线取常量环境辐亮度（对应光栅路径的环境光项）；AO贴图描述的
+ * 遮蔽由路径追踪自身求得，不再相乘。
+ * 图像按分块分发到线程池，各线程从原子计数器领取下一块；
+ * 每次RenderPass向累积缓冲追加样本，随机数只由像素、样本序号与种子
+ * 决定，结果与线程数无关。
+ */
+class PathTracer {
+ public:
+  // 与VKDeferredLighting::PointLight语义一致
+  struct PointLight {
+    glm::vec3 position{0.0f};
+    float radius = 10.0f;  // 影响范围，之外的贡献截断为0
+    glm::vec3 color{1.0f};
+    float intensity = 1.0f;
+  };
+
+  struct Settings {
+    uint32_t width = 800;
+    uint32_t height = 600;
+    uint32_t tileSize = 16;
+    uint32_t samplesPerPass = 1;  // 每次RenderPass每像素的样本数
+    uint32_t maxBounces = 4;
+    glm::vec3 environment{0.03f};  // 逃逸光线的辐亮度
+    float exposure = 1.0f;
+    uint32_t seed = 1;
+  };
+
+  struct Stats {
+    uint32_t triangleCount = 0;
+    uint32_t nodeCount = 0;
+    double buildMs = 0.0;
+    uint32_t samplesPerPixel = 0;  // 已累积的每像素样本数
+    // 以下为最近一次RenderPass
+    uint64_t raysTraced = 0;  // 含阴影光线
+    double passMs = 0.0;
+    double samplesPerSecond = 0.0;
+  };
+
+  // pool为空时使用硬件并发数的内部线程池
+  explicit PathTracer(ThreadPool* pool = nullptr);
+  ~PathTracer();
+
+  // 禁止拷贝
+  PathTracer(const PathTracer&) = delete;
+  PathTracer& operator=(const PathTracer&) = delete;
+
+  // 同一模型与材质的各实例展开到世界空间并构建BVH（并行构建）；
+  // 修改场景、相机、光源或设置后累积清空
+  void SetScene(const Model& model, const Material& material,
+                const std::vector<glm::mat4>& instances);
+  void SetCamera(const Camera& camera);
+  void AddPointLight(const PointLight& light);
+  void ClearPointLights();
+  void SetSettings(const Settings& settings);
+  const Settings& GetSettings() const { return m_settings; }
+
+  // 清空累积缓冲
+  void Reset();
+  // 每像素追加settings.samplesPerPass个样本
+  void RenderPass();
+
+  // 累积的平均辐亮度乘以曝光（线性RGBA32F，行优先，首行为图像顶部）
+  std::vector<float> GetImage() const;
+  // PNG经ACES色调映射（同deferred_lighting.comp）后按sRGB编码；
+  // EXR写出未映射的线性值
+  bool SavePNG(const std::string& path) const;
+  bool SaveEXR(const std::string& path) const;
+
+  const Stats& GetStats() const { return m_stats; }
+
+ private:
+  // 材质输入的贴图（未置位的特性位不采样）
+  struct Map {
+    Texture texture;
+    bool srgb = false;
+  };
+
+  class Sampler;
+
+  glm::vec4 SampleMap(size_t slot, const glm::vec2& uv) const;
+  glm::vec3 TracePath(glm::vec3 origin, glm::vec3 direction,
+                      Sampler& sampler, uint64_t& rays) const;
+  void RenderTile(uint32_t tile, uint64_t& rays);
+
+  ThreadPool* m_pool;
+  std::unique_ptr<ThreadPool> m_ownedPool;
+  Settings m_settings;
+
+  // 场景：世界空间顶点（切线与法线已变换）与BVH
+  std::vector<Vertex> m_vertices;
+  std::vector<uint32_t> m_indices;
+  MeshBVH m_bvh;
+  MaterialConstants m_constants;
+  std::array<Map, MaterialFeatures::kSlotCount> m_maps;
+  std::vector<PointLight> m_lights;
+
+  // 相机基向量，tanHalfFov已乘到up与right上
+  glm::vec3 m_cameraPosition{0.0f};
+  glm::vec3 m_cameraForward{0.0f, 0.0f, -1.0f};
+  glm::vec3 m_cameraRight{1.0f, 0.0f, 0.0f};
+  glm::vec3 m_cameraUp{0.0f, 1.0f, 0.0f};
+
+  std::vector<glm::vec3> m_accumulation;  // 辐亮度之和
+  Stats m_stats;
+};
@@ -0,0 +1,128 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Frustum.hpp"
+
+class ThreadPool;
+
+/**
+ * @brief 场景实例的动态包围体层次
+ *
+ * 叶节点最多容纳8个实例，包围盒以SoA存放，视锥测试一次处理整个叶节点。
+ * - Update只改写叶节点中的包围盒并标记，Refit自下而上增量重拟合被修改
+ *   叶节点的祖先（祖先包围盒不变时提前停止）。
+ * - Insert下降到表面积增量最小的叶节点，叶节点已满时沿最长轴按中位数分裂；
+ *   Remove与叶节点末尾交换。
+ * - 重拟合使树质量（内部节点表面积之和）劣化到构建时的两倍以上时整体重建。
+ * 遍历时完全位于视锥内的子树直接输出，不再逐盒测试；
+ * 提供线程池时把顶层子树分发到各线程并行遍历。
+ */
+class SceneBVH {
+ public:
+  static constexpr uint32_t kLeafSize = 8;
+  static constexpr uint32_t kInvalid = UINT32_MAX;
+
+  struct Stats {
+    uint32_t objectCount = 0;
+    uint32_t nodeCount = 0;
+    uint32_t leafCount = 0;
+    uint32_t depth = 0;
+    uint32_t rebuildCount = 0;
+    uint32_t lastRefitNodes = 0;  // 最近一次Refit更新的节点数
+    float qualityRatio = 1.0f;    // 当前与构建时内部节点表面积之和的比值
+  };
+
+  SceneBVH() = default;
+  ~SceneBVH() = default;
+
+  // 禁止拷贝
+  SceneBVH(const SceneBVH&) = delete;
+  SceneBVH& operator=(const SceneBVH&) = delete;
+
+  // 插入实例，返回句柄；userData为遍历时输出的值（如对象下标）
+  uint32_t Insert(const AABB& bounds, uint32_t userData);
+  void Remove(uint32_t handle);
+  // 更新实例的包围盒，Refit后生效
+  void Update(uint32_t handle, const AABB& bounds);
+  void Clear();
+
+  // 重拟合被修改叶节点的祖先，必要时整体重建；遍历前调用
+  void Refit();
+  // 自顶向下按中位数重建
+  void Rebuild();
+
+  // 输出与视锥相交的实例的userData（visible先清空，顺序不保证）
+  void Cull(const Frustum& frustum, std::vector<uint32_t>& visible,
+            FrustumCulling::Path path = FrustumCulling::GetBestPath(),
+            ThreadPool* pool = nullptr) const;
+
+  Stats GetStats() const;
+  size_t GetObjectCount() const { return m_objectCount; }
+
+ private:
+  struct Node {
+    AABB bounds;
+    uint32_t parent = kInvalid;
+    uint32_t left = kInvalid;   // 内部节点的子节点
+    uint32_t right = kInvalid;
+    uint32_t leaf = kInvalid;   // 叶节点在m_leaves中的下标
+    bool IsLeaf() const { return leaf != kInvalid; }
+  };
+
+  // 8个实例的SoA包围盒，按32字节对齐供AVX加载
+  struct alignas(32) Leaf {
+    // 空槽位保持为0，整批加载时由count截掉
+    float minX[kLeafSize] = {};
+    float minY[kLeafSize] = {};
+    float minZ[kLeafSize] = {};
+    float maxX[kLeafSize] = {};
+    float maxY[kLeafSize] = {};
+    float maxZ[kLeafSize] = {};
+    uint32_t userData[kLeafSize] = {};
+    uint32_t handles[kLeafSize] = {};
+    uint32_t count = 0;
+    uint32_t node = kInvalid;
+    bool dirty = false;
+
+    AABB GetBox(uint32_t slot) const;
+    void SetBox(uint32_t slot, const AABB& box);
+    AABB ComputeBounds() const;
+  };
+
+  struct Object {
+    uint32_t leaf = kInvalid;
+    uint32_t slot = 0;
+    uint32_t userData = 0;
+    AABB bounds;
+  };
+
+  uint32_t BuildRecursive(std::vector<uint32_t>& handles, size_t begin,
+                          size_t end, uint32_t parent);
+  uint32_t CreateLeafNode(uint32_t parent);
+  void AddToLeaf(uint32_t leafIndex, uint32_t handle);
+  void SplitLeaf(uint32_t nodeIndex, uint32_t handle);
+  void MarkDirty(uint32_t leafIndex);
+  void RemoveFromLeaf(uint32_t handle);
+  bool RefitNode(uint32_t nodeIndex);
+  float ComputeInternalArea() const;
+
+  // 遍历栈中的节点；栈元素最高位表示祖先已完全位于视锥内
+  void CullEntries(const Frustum& frustum, std::vector<uint32_t>& stack,
+                   FrustumCulling::Path path,
+                   std::vector<uint32_t>& visible) const;
+  static constexpr uint32_t kInsideFlag = 0x80000000u;
+
+  std::vector<Node> m_nodes;
+  std::vector<Leaf> m_leaves;
+  std::vector<Object> m_objects;
+  std::vector<uint32_t> m_freeHandles;
+  std::vector<uint32_t> m_dirtyLeaves;
+  uint32_t m_root = kInvalid;
+  size_t m_objectCount = 0;
+
+  float m_builtArea = 0.0f;  // 构建时内部节点表面积之和
+  float m_currentArea = 0.0f;
+  uint32_t m_rebuildCount = 0;
+  uint32_t m_lastRefitNodes = 0;
+};
@@ -0,0 +1,16 @@
+#pragma once
+#include "resource/Texture.hpp"
+
+/**
+ * @brief 纹理烘焙：在CPU上生成完整的mip链
+ *
+ * 逐级2x2盒式滤波，奇数尺寸在边缘钳制。sRGB颜色纹理先解码到线性空间
+ * 再平均（alpha通道保持线性）；法线贴图解码为向量平均后重新归一化，
+ * 避免远处法线变短导致高光变暗。结果按Texture的mip布局紧密排列，
+ * 作为纹理流送的源数据。
+ */
+class TextureCooker {
+ public:
+  // 返回带完整mip链的纹理，源纹理已有多级mip时原样返回
+  static Texture BuildMipChain(const Texture& source);
+};
@@ -1,4 +1,10 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
 #include "Vertex.hpp"
 
 struct Model {
@@ -6,4 +12,80 @@ struct Model {
   bool isValid = false;
   std::vector<Vertex> vertices;
   std::vector<uint32_t> indices;
-};
\ No newline at end of file
+
+  // 模型空间包围体（由ComputeBounds计算）
+  glm::vec3 boundsMin{0.0f};
+  glm::vec3 boundsMax{0.0f};
+  glm::vec4 boundingSphere{0.0f};  // xyz为球心，w为半径
+};
+
+/**
+ * @brief 计算模型空间的包围盒与包围球
+ * @param model 需要计算包围体的模型
+ *
+ * 包围球以包围盒中心为球心，半径取到最远顶点的距离。
+ */
+inline void ComputeBounds(Model& model) {
+  if (model.vertices.empty()) {
+    model.boundsMin = model.boundsMax = glm::vec3(0.0f);
+    model.boundingSphere = glm::vec4(0.0f);
+    return;
+  }
+
+  glm::vec3 boundsMin(std::numeric_limits<float>::max());
+  glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+  for (const auto& vertex : model.vertices) {
+    boundsMin = glm::min(boundsMin, vertex.position);
+    boundsMax = glm::max(boundsMax, vertex.position);
+  }
+  model.boundsMin = boundsMin;
+  model.boundsMax = boundsMax;
+
+  glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+  float radiusSquared = 0.0f;
+  for (const auto& vertex : model.vertices) {
+    glm::vec3 offset = vertex.position - center;
+    radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+  }
+  model.boundingSphere = glm::vec4(center, std::sqrt(radiusSquared));
+}
+
+/**
+ * @brief 按三角形UV梯度累加计算顶点切线（geometry.vert的inTangent）
+ * @param model 需要计算切线的模型
+ */
+inline void ComputeTangents(Model& model) {
+  for (auto& vertex : model.vertices) {
+    vertex.tangent = glm::vec3(0.0f);
+  }
+
+  for (size_t i = 0; i + 2 < model.indices.size(); i += 3) {
+    Vertex& v0 = model.vertices[model.indices[i + 0]];
+    Vertex& v1 = model.vertices[model.indices[i + 1]];
+    Vertex& v2 = model.vertices[model.indices[i + 2]];
+
+    glm::vec3 edge1 = v1.position - v0.position;
+    glm::vec3 edge2 = v2.position - v0.position;
+    glm::vec2 deltaUV1 = v1.texCoord - v0.texCoord;
+    glm::vec2 deltaUV2 = v2.texCoord - v0.texCoord;
+
+    float det = deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y;
+    if (std::abs(det) < 1e-8f) continue;
+    glm::vec3 tangent = (edge1 * deltaUV2.y - edge2 * deltaUV1.y) / det;
+
+    v0.tangent += tangent;
+    v1.tangent += tangent;
+    v2.tangent += tangent;
+  }
+
+  // 退化情况下构造一个与法线正交的任意切线
+  for (auto& vertex : model.vertices) {
+    if (glm::dot(vertex.tangent, vertex.tangent) < 1e-12f) {
+      glm::vec3 axis = std::abs(vertex.normal.x) < 0.9f
+                           ? glm::vec3(1.0f, 0.0f, 0.0f)
+                           : glm::vec3(0.0f, 1.0f, 0.0f);
+      vertex.tangent = glm::cross(vertex.normal, axis);
+    }
+    vertex.tangent = glm::normalize(vertex.tangent);
+  }
+}
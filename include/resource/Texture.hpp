@@ -1,4 +1,5 @@
 #pragma once
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -48,6 +49,9 @@ struct Texture {
   TextureType type = TextureType::None;
   TextureFilter filter = TextureFilter::None;
   ChannelType channelType = ChannelType::None;
+  bool floatData = false;  // 32-bit float channels (HDR), otherwise 8-bit
+  // Mip levels stored in data, packed tightly from level 0 downwards
+  int mipLevels = 1;
 
   std::shared_ptr<uint8_t[]> data = nullptr;
 
@@ -65,11 +69,51 @@ struct Texture {
   bool IsValid() const { return width > 0 && height > 0; }
 
   // Get bytes per pixel
-  int GetBytesPerPixel() const { return static_cast<int>(channelType); }
+  int GetBytesPerPixel() const {
+    int channels = static_cast<int>(channelType);
+    return floatData ? channels * static_cast<int>(sizeof(float)) : channels;
+  }
+
+  // Get the size of a mip level (never smaller than 1)
+  int GetMipWidth(int level) const { return std::max(width >> level, 1); }
+  int GetMipHeight(int level) const { return std::max(height >> level, 1); }
+
+  // Get bytes of a single mip level
+  size_t GetMipBytes(int level) const {
+    return static_cast<size_t>(GetMipWidth(level)) * GetMipHeight(level) *
+           GetBytesPerPixel();
+  }
+
+  // Get byte offset of a mip level inside data
+  size_t GetMipOffset(int level) const {
+    size_t offset = 0;
+    for (int i = 0; i < level; i++) offset += GetMipBytes(i);
+    return offset;
+  }
+
+  // Get total bytes of all stored mip levels
+  size_t GetTotalBytes() const { return GetMipOffset(mipLevels); }
+
+  // Get the level count of a full mip chain down to 1x1
+  int GetFullMipLevels() const {
+    int levels = 1;
+    while ((std::max(width, height) >> levels) > 0) levels++;
+    return levels;
+  }
 
-  // Get total bytes
-  size_t GetTotalBytes() const {
-    return static_cast<size_t>(width) * height * GetBytesPerPixel();
+  // Check if texels are sRGB-encoded color (sampled with an sRGB format)
+  bool IsSRGB() const {
+    if (floatData) return false;
+    switch (type) {
+      case TextureType::Normal:
+      case TextureType::Roughness:
+      case TextureType::Metallic:
+      case TextureType::AmbientOcclusion:
+      case TextureType::HeightMap:
+        return false;
+      default:
+        return true;
+    }
   }
 
   // Check if has alpha channel
@@ -7,6 +7,7 @@ struct Vertex {
   glm::vec3 position;  // 顶点位置
   glm::vec3 normal;    // 顶点法线
   glm::vec2 texCoord;  // 纹理坐标
+  glm::vec3 tangent;   // 切线（由ComputeTangents计算）
 
   //
   static std::array<vk::VertexInputBindingDescription, 1>
@@ -15,15 +16,17 @@ struct Vertex {
                                               vk::VertexInputRate::eVertex}};
   }
 
-  static std::array<vk::VertexInputAttributeDescription, 3>
+  static std::array<vk::VertexInputAttributeDescription, 4>
   getAttributeDescriptions() {
-    return std::array<vk::VertexInputAttributeDescription, 3>{
+    return std::array<vk::VertexInputAttributeDescription, 4>{
         vk::VertexInputAttributeDescription{0, 0, vk::Format::eR32G32B32Sfloat,
                                             offsetof(Vertex, position)},
         vk::VertexInputAttributeDescription{1, 0, vk::Format::eR32G32B32Sfloat,
                                             offsetof(Vertex, normal)},
         vk::VertexInputAttributeDescription{2, 0, vk::Format::eR32G32Sfloat,
-                                            offsetof(Vertex, texCoord)}};
+                                            offsetof(Vertex, texCoord)},
+        vk::VertexInputAttributeDescription{3, 0, vk::Format::eR32G32B32Sfloat,
+                                            offsetof(Vertex, tangent)}};
   }
 
   bool operator==(const Vertex& other) const {
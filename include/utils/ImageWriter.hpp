@@ -0,0 +1,219 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 无外部依赖的图像写出工具
+ *
+ * PNG：8位RGBA，zlib使用不压缩的stored块；
+ * EXR：无压缩扫描线，RGBA四通道，支持half与float像素。
+ * 用于离屏渲染结果回读与离线渲染输出。
+ */
+namespace ImageWriter {
+
+namespace detail {
+
+inline uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+  static const auto table = []() {
+    std::array<uint32_t, 256> result{};
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) {
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      }
+      result[i] = c;
+    }
+    return result;
+  }();
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++) {
+    crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+inline void AppendBE32(std::vector<uint8_t>& out, uint32_t value) {
+  out.push_back(static_cast<uint8_t>(value >> 24));
+  out.push_back(static_cast<uint8_t>(value >> 16));
+  out.push_back(static_cast<uint8_t>(value >> 8));
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+template <typename T>
+inline void AppendLE(std::vector<uint8_t>& out, T value) {
+  for (size_t i = 0; i < sizeof(T); i++) {
+    out.push_back(static_cast<uint8_t>(
+        static_cast<uint64_t>(value) >> (8 * i)));
+  }
+}
+
+inline void AppendPngChunk(std::vector<uint8_t>& out, const char* type,
+                           const std::vector<uint8_t>& data) {
+  AppendBE32(out, static_cast<uint32_t>(data.size()));
+  size_t typeStart = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+  AppendBE32(out, Crc32(out.data() + typeStart, out.size() - typeStart));
+}
+
+inline void AppendString(std::vector<uint8_t>& out, const char* str) {
+  out.insert(out.end(), str, str + std::strlen(str) + 1);
+}
+
+inline void AppendExrAttribute(std::vector<uint8_t>& out, const char* name,
+                               const char* type,
+                               const std::vector<uint8_t>& value) {
+  AppendString(out, name);
+  AppendString(out, type);
+  AppendLE<int32_t>(out, static_cast<int32_t>(value.size()));
+  out.insert(out.end(), value.begin(), value.end());
+}
+
+inline bool WriteFile(const std::string& path,
+                      const std::vector<uint8_t>& data) {
+  std::ofstream file(path, std::ios::binary);
+  if (!file.is_open()) return false;
+  file.write(reinterpret_cast<const char*>(data.data()),
+             static_cast<std::streamsize>(data.size()));
+  return file.good();
+}
+
+// EXR像素类型：1为half，2为float
+inline bool WriteExr(const std::string& path, uint32_t width,
+                     uint32_t height, const uint8_t* rgba,
+                     uint32_t bytesPerChannel, int32_t pixelType) {
+  std::vector<uint8_t> out;
+  AppendLE<uint32_t>(out, 20000630u);  // 魔数
+  AppendLE<uint32_t>(out, 2u);         // 版本2，单部分扫描线
+
+  // 通道按名称字母序存放：A、B、G、R
+  const char* channelNames[4] = {"A", "B", "G", "R"};
+  const uint32_t channelSource[4] = {3, 2, 1, 0};
+  std::vector<uint8_t> channels;
+  for (const char* name : channelNames) {
+    AppendString(channels, name);
+    AppendLE<int32_t>(channels, pixelType);
+    AppendLE<uint32_t>(channels, 0u);  // pLinear + 保留字节
+    AppendLE<int32_t>(channels, 1);    // xSampling
+    AppendLE<int32_t>(channels, 1);    // ySampling
+  }
+  channels.push_back(0);
+
+  std::vector<uint8_t> window;
+  AppendLE<int32_t>(window, 0);
+  AppendLE<int32_t>(window, 0);
+  AppendLE<int32_t>(window, static_cast<int32_t>(width) - 1);
+  AppendLE<int32_t>(window, static_cast<int32_t>(height) - 1);
+
+  std::vector<uint8_t> one;
+  float oneValue = 1.0f;
+  one.resize(sizeof(float));
+  std::memcpy(one.data(), &oneValue, sizeof(float));
+
+  AppendExrAttribute(out, "channels", "chlist", channels);
+  AppendExrAttribute(out, "compression", "compression", {0});
+  AppendExrAttribute(out, "dataWindow", "box2i", window);
+  AppendExrAttribute(out, "displayWindow", "box2i", window);
+  AppendExrAttribute(out, "lineOrder", "lineOrder", {0});
+  AppendExrAttribute(out, "pixelAspectRatio", "float", one);
+  AppendExrAttribute(out, "screenWindowCenter", "v2f",
+                     std::vector<uint8_t>(8, 0));
+  AppendExrAttribute(out, "screenWindowWidth", "float", one);
+  out.push_back(0);  // 头部结束
+
+  // 无压缩时每个块为一条扫描线
+  const uint64_t lineBytes =
+      static_cast<uint64_t>(width) * 4 * bytesPerChannel;
+  const uint64_t blockBytes = 8 + lineBytes;
+  const uint64_t tableStart = out.size();
+  for (uint32_t y = 0; y < height; y++) {
+    AppendLE<uint64_t>(out, tableStart + 8ull * height + y * blockBytes);
+  }
+
+  for (uint32_t y = 0; y < height; y++) {
+    AppendLE<int32_t>(out, static_cast<int32_t>(y));
+    AppendLE<int32_t>(out, static_cast<int32_t>(lineBytes));
+    const uint8_t* row =
+        rgba + static_cast<size_t>(y) * width * 4 * bytesPerChannel;
+    for (uint32_t channel : channelSource) {
+      for (uint32_t x = 0; x < width; x++) {
+        const uint8_t* value = row + (x * 4 + channel) * bytesPerChannel;
+        out.insert(out.end(), value, value + bytesPerChannel);
+      }
+    }
+  }
+  return WriteFile(path, out);
+}
+
+}  // namespace detail
+
+/**
+ * @brief 写出8位RGBA图像为PNG
+ * @param rowPitch 源数据每行字节数（0表示紧密排列）
+ */
+inline bool WritePNG(const std::string& path, uint32_t width, uint32_t height,
+                     const uint8_t* rgba, uint32_t rowPitch = 0) {
+  if (rowPitch == 0) rowPitch = width * 4;
+
+  // 每行前加过滤类型字节（0：无过滤）
+  std::vector<uint8_t> raw;
+  raw.reserve(static_cast<size_t>(height) * (width * 4 + 1));
+  for (uint32_t y = 0; y < height; y++) {
+    raw.push_back(0);
+    const uint8_t* row = rgba + static_cast<size_t>(y) * rowPitch;
+    raw.insert(raw.end(), row, row + width * 4);
+  }
+
+  // zlib流：stored块每块最多65535字节
+  std::vector<uint8_t> zlib = {0x78, 0x01};
+  size_t offset = 0;
+  do {
+    size_t blockSize = std::min<size_t>(raw.size() - offset, 65535);
+    bool last = offset + blockSize == raw.size();
+    zlib.push_back(last ? 1 : 0);
+    detail::AppendLE<uint16_t>(zlib, static_cast<uint16_t>(blockSize));
+    detail::AppendLE<uint16_t>(zlib, static_cast<uint16_t>(~blockSize));
+    zlib.insert(zlib.end(), raw.begin() + offset,
+                raw.begin() + offset + blockSize);
+    offset += blockSize;
+  } while (offset < raw.size());
+
+  uint32_t a = 1, b = 0;
+  for (uint8_t byte : raw) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  detail::AppendBE32(zlib, (b << 16) | a);
+
+  std::vector<uint8_t> ihdr;
+  detail::AppendBE32(ihdr, width);
+  detail::AppendBE32(ihdr, height);
+  ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0});  // 8位、RGBA、无隔行
+
+  std::vector<uint8_t> out = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  detail::AppendPngChunk(out, "IHDR", ihdr);
+  detail::AppendPngChunk(out, "IDAT", zlib);
+  detail::AppendPngChunk(out, "IEND", {});
+  return detail::WriteFile(path, out);
+}
+
+// 写出RGBA half像素（如R16G16B16A16Sfloat回读数据）为EXR
+inline bool WriteEXR(const std::string& path, uint32_t width, uint32_t height,
+                     const uint16_t* rgbaHalf) {
+  return detail::WriteExr(path, width, height,
+                          reinterpret_cast<const uint8_t*>(rgbaHalf), 2, 1);
+}
+
+// 写出RGBA float像素为EXR
+inline bool WriteEXR(const std::string& path, uint32_t width, uint32_t height,
+                     const float* rgba) {
+  return detail::WriteExr(path, width, height,
+                          reinterpret_cast<const uint8_t*>(rgba), 4, 2);
+}
+
+}  // namespace ImageWriter
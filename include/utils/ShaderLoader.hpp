@@ -1,8 +1,19 @@
 #pragma once
+#include <cstdint>
+#include <cstdlib>
 #include <fstream>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "utils/ShaderRegistry.hpp"
+
+// 未嵌入的着色器从该目录读取（由cmake/Shaders.cmake设置为构建目录）
+#ifndef PBR_SHADER_DIR
+#define PBR_SHADER_DIR "shaders/"
+#endif
+
 namespace ShaderLoader {
 
 inline std::string LoadGLSL(const std::string& path) {
@@ -30,4 +41,37 @@ inline std::vector<uint32_t> LoadSPIRV(const std::string& path) {
   return result;
 }
 
+// 开发覆盖：设置该环境变量时从其目录读取着色器，不重新构建即可替换
+constexpr const char* kOverrideVariable = "PBR_SHADER_OVERRIDE_DIR";
+
+// 着色器代码：嵌入的SPIR-V直接引用注册表，从文件读取时由storage持有
+struct SPIRVCode {
+  std::span<const uint32_t> embedded;
+  std::vector<uint32_t> storage;
+
+  std::span<const uint32_t> Words() const {
+    return storage.empty() ? embedded : std::span<const uint32_t>(storage);
+  }
+};
+
+// 按名称（<文件名>_<阶段>，如geometry_frag）与排列取得SPIR-V：
+// 覆盖目录优先，其次为构建时嵌入的代码，最后从PBR_SHADER_DIR读取
+inline SPIRVCode Load(const std::string& name,
+                      const std::string& permutation = "") {
+  const std::string fileName =
+      name + (permutation.empty() ? "" : "." + permutation) + ".spv";
+  SPIRVCode result;
+  if (const char* overrideDir = std::getenv(kOverrideVariable)) {
+    result.storage = LoadSPIRV(std::string(overrideDir) + "/" + fileName);
+    return result;
+  }
+  if (const ShaderRegistry::Entry* entry =
+          ShaderRegistry::Find(name, permutation)) {
+    result.embedded = {entry->code, entry->wordCount};
+    return result;
+  }
+  result.storage = LoadSPIRV(PBR_SHADER_DIR + fileName);
+  return result;
+}
+
 }  // namespace ShaderLoader
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+/**
+ * @brief 构建时嵌入的SPIR-V注册表
+ *
+ * 由cmake/Shaders.cmake编译shaders/vulkan下的全部着色器，
+ * EmbedShaders.cmake生成ShaderRegistry.cpp，以constexpr数组存放代码。
+ * 以名称（<文件名>_<阶段>，如geometry_frag）与排列（默认为空）查找。
+ */
+namespace ShaderRegistry {
+
+struct Entry {
+  const char* name;
+  const char* permutation;
+  const uint32_t* code;
+  size_t wordCount;
+};
+
+// 全部嵌入的着色器（生成代码提供，未嵌入时为空）
+std::span<const Entry> Entries();
+
+// 未嵌入时返回nullptr
+inline const Entry* Find(std::string_view name,
+                         std::string_view permutation = {}) {
+  for (const Entry& entry : Entries()) {
+    if (name == entry.name && permutation == entry.permutation) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace ShaderRegistry
@@ -1,5 +1,6 @@
 #pragma once
 #include <stdexcept>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 
 #include "resource/Texture.hpp"
@@ -44,23 +45,11 @@ inline vk::Format ChannelTypeToVkFormat(ChannelType channelType,
  * @return 对应的Vulkan格式
  */
 inline vk::Format TextureToVkFormat(const Texture& texture) {
-  bool useSRGB = true;
-
-  // 线性格式优先的特殊情况
-  switch (texture.type) {
-    case TextureType::Normal:
-    case TextureType::Roughness:
-    case TextureType::Metallic:
-    case TextureType::AmbientOcclusion:
-    case TextureType::HeightMap:
-      useSRGB = false;
-      break;
-    default:
-      useSRGB = true;
-      break;
-  }
+  // HDR浮点数据按RGBA32F上传（加载时已扩展为四通道）
+  if (texture.floatData) return vk::Format::eR32G32B32A32Sfloat;
 
-  return ChannelTypeToVkFormat(texture.channelType, useSRGB);
+  // 法线与材质参数等数据纹理使用线性格式
+  return ChannelTypeToVkFormat(texture.channelType, texture.IsSRGB());
 }
 
 /**
@@ -86,4 +75,178 @@ inline uint32_t FindMemoryType(vk::PhysicalDevice physicalDevice,
   throw std::runtime_error("无法找到合适的内存类型!");
 }
 
+/**
+ * @brief 创建缓冲并分配、绑定内存
+ * @param device 逻辑设备
+ * @param physicalDevice 物理设备
+ * @param size 缓冲大小
+ * @param usage 缓冲用途
+ * @param properties 内存属性
+ * @param buffer 输出的缓冲句柄
+ * @param memory 输出的内存句柄
+ */
+inline void CreateBuffer(vk::Device device, vk::PhysicalDevice physicalDevice,
+                         vk::DeviceSize size, vk::BufferUsageFlags usage,
+                         vk::MemoryPropertyFlags properties,
+                         vk::Buffer& buffer, vk::DeviceMemory& memory) {
+  vk::BufferCreateInfo bufferInfo;
+  bufferInfo.size = size;
+  bufferInfo.usage = usage;
+  bufferInfo.sharingMode = vk::SharingMode::eExclusive;
+  buffer = device.createBuffer(bufferInfo);
+
+  vk::MemoryRequirements memRequirements =
+      device.getBufferMemoryRequirements(buffer);
+
+  vk::MemoryAllocateInfo allocInfo;
+  allocInfo.allocationSize = memRequirements.size;
+  allocInfo.memoryTypeIndex = FindMemoryType(
+      physicalDevice, memRequirements.memoryTypeBits, properties);
+  memory = device.allocateMemory(allocInfo);
+  device.bindBufferMemory(buffer, memory, 0);
+}
+
+/**
+ * @brief 分配并开始一个一次性命令缓冲
+ * @param device 逻辑设备
+ * @param commandPool 命令池
+ * @return 处于录制状态的命令缓冲
+ */
+inline vk::CommandBuffer BeginSingleTimeCommands(vk::Device device,
+                                                 vk::CommandPool commandPool) {
+  vk::CommandBufferAllocateInfo allocInfo;
+  allocInfo.level = vk::CommandBufferLevel::ePrimary;
+  allocInfo.commandPool = commandPool;
+  allocInfo.commandBufferCount = 1;
+  vk::CommandBuffer commandBuffer = device.allocateCommandBuffers(allocInfo)[0];
+
+  vk::CommandBufferBeginInfo beginInfo;
+  beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+  commandBuffer.begin(beginInfo);
+  return commandBuffer;
+}
+
+/**
+ * @brief 结束一次性命令缓冲，提交并等待执行完成
+ * @param device 逻辑设备
+ * @param commandPool 命令池
+ * @param queue 提交队列
+ * @param commandBuffer 由BeginSingleTimeCommands返回的命令缓冲
+ */
+inline void EndSingleTimeCommands(vk::Device device,
+                                  vk::CommandPool commandPool, vk::Queue queue,
+                                  vk::CommandBuffer commandBuffer) {
+  commandBuffer.end();
+
+  vk::SubmitInfo submitInfo;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &commandBuffer;
+  queue.submit(submitInfo);
+  queue.waitIdle();
+
+  device.freeCommandBuffers(commandPool, commandBuffer);
+}
+
+/**
+ * @brief 录制图像布局转换屏障
+ * @param commandBuffer 命令缓冲
+ * @param image 目标图像
+ * @param oldLayout 旧布局
+ * @param newLayout 新布局
+ * @param mipLevels 需要转换的mip层数
+ */
+inline void TransitionImageLayout(vk::CommandBuffer commandBuffer,
+                                  vk::Image image, vk::ImageLayout oldLayout,
+                                  vk::ImageLayout newLayout,
+                                  uint32_t mipLevels = 1) {
+  vk::ImageMemoryBarrier barrier;
+  barrier.oldLayout = oldLayout;
+  barrier.newLayout = newLayout;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = image;
+  barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+  barrier.subresourceRange.baseMipLevel = 0;
+  barrier.subresourceRange.levelCount = mipLevels;
+  barrier.subresourceRange.baseArrayLayer = 0;
+  barrier.subresourceRange.layerCount = 1;
+
+  vk::PipelineStageFlags srcStage;
+  vk::PipelineStageFlags dstStage;
+  if (oldLayout == vk::ImageLayout::eUndefined &&
+      newLayout == vk::ImageLayout::eTransferDstOptimal) {
+    barrier.srcAccessMask = {};
+    barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+    srcStage = vk::PipelineStageFlagBits::eTopOfPipe;
+    dstStage = vk::PipelineStageFlagBits::eTransfer;
+  } else if (oldLayout == vk::ImageLayout::eTransferDstOptimal &&
+             newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
+    barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    srcStage = vk::PipelineStageFlagBits::eTransfer;
+    dstStage = vk::PipelineStageFlagBits::eFragmentShader;
+  } else {
+    throw std::invalid_argument("Unsupported image layout transition");
+  }
+
+  commandBuffer.pipelineBarrier(srcStage, dstStage, {}, nullptr, nullptr,
+                                barrier);
+}
+
+/**
+ * @brief 录制缓冲到图像的拷贝命令（拷贝到mip 0）
+ * @param commandBuffer 命令缓冲
+ * @param buffer 源缓冲
+ * @param image 目标图像（需处于TransferDstOptimal布局）
+ * @param width 图像宽度
+ * @param height 图像高度
+ */
+inline void CopyBufferToImage(vk::CommandBuffer commandBuffer,
+                              vk::Buffer buffer, vk::Image image,
+                              uint32_t width, uint32_t height) {
+  vk::BufferImageCopy region;
+  region.bufferOffset = 0;
+  region.bufferRowLength = 0;
+  region.bufferImageHeight = 0;
+  region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+  region.imageSubresource.mipLevel = 0;
+  region.imageSubresource.baseArrayLayer = 0;
+  region.imageSubresource.layerCount = 1;
+  region.imageOffset = vk::Offset3D{0, 0, 0};
+  region.imageExtent = vk::Extent3D{width, height, 1};
+
+  commandBuffer.copyBufferToImage(buffer, image,
+                                  vk::ImageLayout::eTransferDstOptimal, region);
+}
+
+/**
+ * @brief 录制纹理mip区间到图像的拷贝命令
+ * @param commandBuffer 命令缓冲
+ * @param buffer 源缓冲（自firstMip起按Texture的mip布局紧密排列）
+ * @param image 目标图像（需处于TransferDstOptimal布局）
+ * @param texture 提供各级尺寸的纹理
+ * @param firstMip 拷贝到图像第0级的纹理mip级别
+ */
+inline void CopyMipsToImage(vk::CommandBuffer commandBuffer,
+                            vk::Buffer buffer, vk::Image image,
+                            const Texture& texture, uint32_t firstMip) {
+  std::vector<vk::BufferImageCopy> regions;
+  const size_t baseOffset = texture.GetMipOffset(firstMip);
+  for (int level = firstMip; level < texture.mipLevels; level++) {
+    vk::BufferImageCopy region;
+    region.bufferOffset = texture.GetMipOffset(level) - baseOffset;
+    region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+    region.imageSubresource.mipLevel = level - firstMip;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent =
+        vk::Extent3D{static_cast<uint32_t>(texture.GetMipWidth(level)),
+                     static_cast<uint32_t>(texture.GetMipHeight(level)), 1};
+    regions.push_back(region);
+  }
+  commandBuffer.copyBufferToImage(buffer, image,
+                                  vk::ImageLayout::eTransferDstOptimal,
+                                  regions);
+}
+
 }  // namespace vkutil
\ No newline at end of file
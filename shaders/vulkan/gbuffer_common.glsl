@@ -0,0 +1,65 @@
+// 几何片段着色器共用的G-Buffer输出与材质特性位
+// （geometry.frag及其无绑定变体包含）
+#ifndef GBUFFER_COMMON_GLSL
+#define GBUFFER_COMMON_GLSL
+
+// G-Buffer输出（与VKContext::GBufferLayout一致）
+// 完整布局：世界空间位置、世界空间法线、反照率、材质参数；
+// 紧凑布局不写位置（由深度重建），八面体编码的法线与其余输出依次前移
+layout(location = 0) out vec4 outTarget0;
+layout(location = 1) out vec4 outTarget1;
+layout(location = 2) out vec4 outTarget2;
+layout(location = 3) out vec4 outTarget3;
+
+layout(constant_id = 0) const bool kLeanGBuffer = false;
+
+// 八面体编码：单位向量投影到|x|+|y|+|z|=1上，下半球沿对角线翻折到
+// [-1, 1]^2（deferred_lighting.comp的OctDecode为其逆）
+vec2 OctEncode(vec3 n) {
+  n /= abs(n.x) + abs(n.y) + abs(n.z);
+  vec2 encoded = n.xy;
+  if (n.z < 0.0) {
+    vec2 signs = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    encoded = (1.0 - abs(n.yx)) * signs;
+  }
+  return encoded;
+}
+
+// albedo的alpha为自发光强度，material为金属度(R)、粗糙度(G)和AO(B)
+void WriteGBuffer(vec3 worldPos, vec3 normal, vec4 albedo, vec4 material) {
+  if (kLeanGBuffer) {
+    outTarget0 = vec4(OctEncode(normal), 0.0, 0.0);
+    outTarget1 = albedo;
+    outTarget2 = material;
+    outTarget3 = vec4(0.0);  // 紧凑布局没有第四个附件，写入被丢弃
+  } else {
+    outTarget0 = vec4(worldPos, 1.0);
+    outTarget1 = vec4(normal, 1.0);
+    outTarget2 = albedo;
+    outTarget3 = material;
+  }
+}
+
+// 材质特性位（与MaterialFeatures一致）：未置位输入的采样在编译时消除，
+// 置位的输入再按材质自身的掩码选择贴图或常量（通用变体可绘制任意材质）
+const uint kAlbedoBit = 0x01u;
+const uint kNormalBit = 0x02u;
+const uint kMetallicBit = 0x04u;
+const uint kRoughnessBit = 0x08u;
+const uint kAOBit = 0x10u;
+const uint kEmissiveBit = 0x20u;
+
+layout(constant_id = 1) const uint kMaterialFeatures = 0x3F;
+const bool kAlbedoMap = (kMaterialFeatures & kAlbedoBit) != 0u;
+const bool kNormalMap = (kMaterialFeatures & kNormalBit) != 0u;
+const bool kMetallicMap = (kMaterialFeatures & kMetallicBit) != 0u;
+const bool kRoughnessMap = (kMaterialFeatures & kRoughnessBit) != 0u;
+const bool kAOMap = (kMaterialFeatures & kAOBit) != 0u;
+const bool kEmissiveMap = (kMaterialFeatures & kEmissiveBit) != 0u;
+
+// compiled为变体编译进的特性，features为材质自身的掩码
+bool UseMap(bool compiled, uint features, uint bit) {
+  return compiled && (features & bit) != 0u;
+}
+
+#endif  // GBUFFER_COMMON_GLSL
@@ -0,0 +1,83 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_GOOGLE_include_directive : require
+#extension GL_EXT_nonuniform_qualifier : require
+
+// 输入
+layout(location = 0) in vec3 inWorldPos;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in mat3 inTBN;
+
+#include "gbuffer_common.glsl"
+
+// 无绑定纹理数组 - 与VKBindlessTable的布局一致
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+// 材质记录 - 与VKMaterialTable::Record一致：MaterialConstants与六个
+// 纹理数组索引（顺序同geometry.frag的binding 1~6）
+struct MaterialRecord {
+  vec4 baseColor;
+  vec4 factors;  // 金属度、粗糙度、AO、自发光强度
+  uint features;
+  float heightScale;
+  uint padding0;
+  uint padding1;
+  uint albedo;
+  uint normal;
+  uint metallic;
+  uint roughness;
+  uint ao;
+  uint emissive;
+  uint padding2;
+  uint padding3;
+};
+
+layout(std430, set = 1, binding = 1) readonly buffer MaterialBuffer {
+  MaterialRecord materials[];
+};
+
+// 每次绘制推送的材质索引
+layout(push_constant) uniform PushConstants {
+  uint materialIndex;
+}
+pc;
+
+vec4 Sample(uint index) {
+  return texture(textures[nonuniformEXT(index)], inTexCoord);
+}
+
+void main() {
+  MaterialRecord material = materials[pc.materialIndex];
+
+  // 法线贴图处理 - 从切线空间转换到世界空间，没有贴图时使用插值法线
+  vec3 normal = normalize(inNormal);
+  if (UseMap(kNormalMap, material.features, kNormalBit)) {
+    vec3 tangentNormal = Sample(material.normal).rgb;
+    tangentNormal = normalize(tangentNormal * 2.0 - 1.0);
+    normal = normalize(inTBN * tangentNormal);
+  }
+
+  // 反照率 + 自发光（alpha通道用于自发光强度）
+  vec3 albedo = UseMap(kAlbedoMap, material.features, kAlbedoBit)
+                    ? Sample(material.albedo).rgb
+                    : material.baseColor.rgb;
+  float emissiveIntensity =
+      UseMap(kEmissiveMap, material.features, kEmissiveBit)
+          ? Sample(material.emissive).r
+          : material.factors.w;
+
+  // PBR材质参数
+  float metallic = UseMap(kMetallicMap, material.features, kMetallicBit)
+                       ? Sample(material.metallic).r
+                       : material.factors.x;
+  float roughness = UseMap(kRoughnessMap, material.features, kRoughnessBit)
+                        ? Sample(material.roughness).r
+                        : material.factors.y;
+  float ao = UseMap(kAOMap, material.features, kAOBit)
+                 ? Sample(material.ao).r
+                 : material.factors.z;
+
+  WriteGBuffer(inWorldPos, normal, vec4(albedo, emissiveIntensity),
+               vec4(metallic, roughness, ao, 1.0));
+}
@@ -0,0 +1,56 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// 输入
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in vec3 inTangent;
+
+// 输出
+layout(location = 0) out vec3 outWorldPos;
+layout(location = 1) out vec3 outNormal;
+layout(location = 2) out vec2 outTexCoord;
+layout(location = 3) out mat3 outTBN;
+layout(location = 6) flat out uint outMaterialIndex;
+
+// 逐绘制数据 - 与VKIndirectDrawList::DrawData一致，
+// 前三项为ObjectTransform（法线矩阵与MVP由CPU预先计算）
+struct DrawData {
+  mat4 model;
+  mat3 normalMatrix;
+  mat4 modelViewProjection;
+  uint materialIndex;
+  uint padding0;
+  uint padding1;
+  uint padding2;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer DrawDataBuffer {
+  DrawData draws[];
+};
+
+void main() {
+  // 间接命令的firstInstance为绘制序号
+  DrawData draw = draws[gl_InstanceIndex];
+
+  // 计算世界坐标位置
+  outWorldPos = (draw.model * vec4(inPosition, 1.0)).xyz;
+
+  // 法线变换到世界空间
+  outNormal = draw.normalMatrix * inNormal;
+
+  // 传递纹理坐标与材质索引
+  outTexCoord = inTexCoord;
+  outMaterialIndex = draw.materialIndex;
+
+  // 计算切线空间到世界空间的变换矩阵
+  vec3 N = normalize(outNormal);
+  vec3 T = normalize(mat3(draw.model) * inTangent);
+  T = normalize(T - dot(T, N) * N);  // 施密特正交化
+  vec3 B = cross(N, T);
+  outTBN = mat3(T, B, N);
+
+  // 输出裁剪空间坐标
+  gl_Position = draw.modelViewProjection * vec4(inPosition, 1.0);
+}
@@ -0,0 +1,43 @@
+#include "core/ThreadPool.hpp"
+
+ThreadPool::ThreadPool(uint32_t threadCount) {
+  if (threadCount == 0) {
+    threadCount = HardwareConcurrency();
+  }
+  m_workers.reserve(threadCount);
+  for (uint32_t i = 0; i < threadCount; i++) {
+    m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = true;
+  }
+  m_condition.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+uint32_t ThreadPool::HardwareConcurrency() {
+  uint32_t count = std::thread::hardware_concurrency();
+  return count > 0 ? count : 1;
+}
+
+void ThreadPool::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_condition.wait(lock,
+                       [this]() { return m_stopping || !m_tasks.empty(); });
+      // 停止前先执行完队列中剩余的任务
+      if (m_tasks.empty()) return;
+      task = std::move(m_tasks.front());
+      m_tasks.pop();
+    }
+    task();
+  }
+}
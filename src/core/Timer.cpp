@@ -0,0 +1,21 @@
+#include "core/Timer.hpp"
+
+void Timer::Reset() { m_start = std::chrono::steady_clock::now(); }
+
+double Timer::ElapsedSeconds() const {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       m_start)
+      .count();
+}
+
+double Timer::ElapsedMilliseconds() const {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - m_start)
+      .count();
+}
+
+double Timer::ElapsedMicroseconds() const {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - m_start)
+      .count();
+}
@@ -0,0 +1,109 @@
+#include "platform/vulkan/VKAsyncCompute.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+uint32_t QueueIndex(RGQueue queue) { return static_cast<uint32_t>(queue); }
+
+VKFrameScheduler::QueueType SchedulerQueue(RGQueue queue) {
+  return queue == RGQueue::Compute ? VKFrameScheduler::QueueType::Compute
+                                   : VKFrameScheduler::QueueType::Graphics;
+}
+}  // namespace
+
+VKAsyncCompute::VKAsyncCompute(vk::Device device, VKFrameScheduler& scheduler,
+                               uint32_t graphicsFamily,
+                               uint32_t computeFamily,
+                               uint32_t framesInFlight)
+    : m_device(device), m_scheduler(scheduler) {
+  const std::array<uint32_t, 2> families = {graphicsFamily, computeFamily};
+  try {
+    // 不设置eResetCommandBuffer：命令缓冲只随命令池整体重置
+    m_frames.resize(framesInFlight);
+    for (auto& queues : m_frames) {
+      for (uint32_t q = 0; q < queues.size(); q++) {
+        vk::CommandPoolCreateInfo poolInfo;
+        poolInfo.flags = vk::CommandPoolCreateFlagBits::eTransient;
+        poolInfo.queueFamilyIndex = families[q];
+        queues[q].pool = m_device.createCommandPool(poolInfo);
+      }
+    }
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create async compute scheduler: " +
+                             std::string(err.what()));
+  }
+}
+
+VKAsyncCompute::~VKAsyncCompute() {
+  for (auto& queues : m_frames) {
+    for (auto& data : queues) {
+      if (data.pool) m_device.destroyCommandPool(data.pool);
+    }
+  }
+}
+
+void VKAsyncCompute::BeginFrame(uint32_t frameIndex) {
+  m_frameIndex = frameIndex;
+  for (auto& data : m_frames[frameIndex]) {
+    m_device.resetCommandPool(data.pool);
+    data.usedBuffers = 0;
+  }
+}
+
+vk::CommandBuffer VKAsyncCompute::AcquireBuffer(QueueFrameData& data) {
+  if (data.usedBuffers == data.buffers.size()) {
+    vk::CommandBufferAllocateInfo allocInfo;
+    allocInfo.commandPool = data.pool;
+    allocInfo.level = vk::CommandBufferLevel::ePrimary;
+    allocInfo.commandBufferCount = 1;
+    data.buffers.push_back(m_device.allocateCommandBuffers(allocInfo)[0]);
+  }
+  return data.buffers[data.usedBuffers++];
+}
+
+void VKAsyncCompute::Execute(const VKRenderGraph& graph, VKProfiler* profiler,
+                             const FrameSync& sync) {
+  const auto& batches = graph.GetBatches();
+  std::vector<vk::CommandBuffer> commandBuffers(batches.size());
+  {
+    VKProfiler::CpuScope recordScope(profiler, "Record");
+    for (uint32_t b = 0; b < batches.size(); b++) {
+      auto& data = m_frames[m_frameIndex][QueueIndex(batches[b].queue)];
+      vk::CommandBuffer commandBuffer = AcquireBuffer(data);
+      commandBuffer.begin(vk::CommandBufferBeginInfo(
+          vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+      // 计算批次都等待首个批次，查询重置先于所有作用域执行
+      if (b == 0 && profiler) profiler->RecordReset(commandBuffer);
+      graph.ExecuteBatch(b, commandBuffer, profiler);
+      commandBuffer.end();
+      commandBuffers[b] = commandBuffer;
+    }
+  }
+
+  VKProfiler::CpuScope submitScope(profiler, "Submit");
+  std::vector<uint64_t> signalValues(batches.size());
+  for (uint32_t b = 0; b < batches.size(); b++) {
+    const VKRenderGraph::Batch& batch = batches[b];
+    bool last = b + 1 == batches.size();
+
+    std::vector<vk::SemaphoreSubmitInfo> waits;
+    if (batch.waitBatch >= 0) {
+      const auto& source = batches[batch.waitBatch];
+      waits.emplace_back(m_scheduler.GetTimeline(SchedulerQueue(source.queue)),
+                         signalValues[batch.waitBatch],
+                         vk::PipelineStageFlagBits2::eAllCommands);
+    }
+    if (sync.waitSemaphore && b == sync.waitBatch) {
+      waits.emplace_back(sync.waitSemaphore, 0, sync.waitStage);
+    }
+
+    std::vector<vk::SemaphoreSubmitInfo> signals;
+    if (last && sync.signalSemaphore) {
+      signals.emplace_back(sync.signalSemaphore, 0,
+                           vk::PipelineStageFlagBits2::eAllCommands);
+    }
+    signalValues[b] = m_scheduler.Submit(SchedulerQueue(batch.queue),
+                                         commandBuffers[b], waits, signals);
+  }
+}
@@ -0,0 +1,139 @@
+#include "platform/vulkan/VKBindlessTable.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include "utils/vkutil.hpp"
+
+VKBindlessTable::VKBindlessTable(vk::Device device,
+                                 vk::PhysicalDevice physicalDevice,
+                                 uint32_t deviceTextureLimit,
+                                 const Config& config)
+    : m_device(device), m_physicalDevice(physicalDevice), m_config(config) {
+  // 为材质UBO等其他描述符预留少量额度
+  if (deviceTextureLimit > 16) {
+    m_config.maxTextures =
+        std::min(m_config.maxTextures, deviceTextureLimit - 16);
+  }
+  CreateLayout();
+  CreatePool();
+  AllocateSet();
+}
+
+VKBindlessTable::~VKBindlessTable() {
+  if (m_pool) m_device.destroyDescriptorPool(m_pool);
+  if (m_layout) m_device.destroyDescriptorSetLayout(m_layout);
+}
+
+void VKBindlessTable::CreateLayout() {
+  std::array<vk::DescriptorSetLayoutBinding, 2> bindings;
+  // binding 0: 纹理数组（部分绑定）
+  bindings[0].binding = 0;
+  bindings[0].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+  bindings[0].descriptorCount = m_config.maxTextures;
+  bindings[0].stageFlags = vk::ShaderStageFlagBits::eFragment;
+  // binding 1: 材质记录
+  bindings[1].binding = 1;
+  bindings[1].descriptorType = vk::DescriptorType::eStorageBuffer;
+  bindings[1].descriptorCount = 1;
+  bindings[1].stageFlags = vk::ShaderStageFlagBits::eFragment;
+
+  // 未注册的槽位保持未写入状态（部分绑定），新纹理可在绑定后写入
+  std::array<vk::DescriptorBindingFlags, 2> bindingFlags = {
+      vk::DescriptorBindingFlagBits::ePartiallyBound |
+          vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+          vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending,
+      vk::DescriptorBindingFlags{}};
+
+  vk::DescriptorSetLayoutBindingFlagsCreateInfo flagsInfo;
+  flagsInfo.bindingCount = static_cast<uint32_t>(bindingFlags.size());
+  flagsInfo.pBindingFlags = bindingFlags.data();
+
+  vk::DescriptorSetLayoutCreateInfo layoutInfo;
+  layoutInfo.pNext = &flagsInfo;
+  layoutInfo.flags =
+      vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool;
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+
+  try {
+    m_layout = m_device.createDescriptorSetLayout(layoutInfo);
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create bindless set layout: " +
+                             std::string(err.what()));
+  }
+}
+
+void VKBindlessTable::CreatePool() {
+  std::array<vk::DescriptorPoolSize, 2> poolSizes = {
+      vk::DescriptorPoolSize{vk::DescriptorType::eCombinedImageSampler,
+                             m_config.maxTextures},
+      vk::DescriptorPoolSize{vk::DescriptorType::eStorageBuffer, 1}};
+
+  vk::DescriptorPoolCreateInfo poolInfo;
+  poolInfo.flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind;
+  poolInfo.maxSets = 1;
+  poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+  poolInfo.pPoolSizes = poolSizes.data();
+
+  try {
+    m_pool = m_device.createDescriptorPool(poolInfo);
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create bindless descriptor pool: " +
+                             std::string(err.what()));
+  }
+}
+
+void VKBindlessTable::AllocateSet() {
+  vk::DescriptorSetAllocateInfo allocInfo;
+  allocInfo.descriptorPool = m_pool;
+  allocInfo.descriptorSetCount = 1;
+  allocInfo.pSetLayouts = &m_layout;
+  m_set = m_device.allocateDescriptorSets(allocInfo)[0];
+}
+
+void VKBindlessTable::SetMaterialBuffer(vk::Buffer buffer,
+                                        vk::DeviceSize size) {
+  vk::DescriptorBufferInfo bufferInfo;
+  bufferInfo.buffer = buffer;
+  bufferInfo.offset = 0;
+  bufferInfo.range = size;
+
+  vk::WriteDescriptorSet write;
+  write.dstSet = m_set;
+  write.dstBinding = 1;
+  write.dstArrayElement = 0;
+  write.descriptorCount = 1;
+  write.descriptorType = vk::DescriptorType::eStorageBuffer;
+  write.pBufferInfo = &bufferInfo;
+  m_device.updateDescriptorSets(write, nullptr);
+}
+
+uint32_t VKBindlessTable::RegisterTexture(vk::ImageView imageView,
+                                          vk::Sampler sampler) {
+  if (m_textureCount >= m_config.maxTextures) {
+    throw std::runtime_error("Bindless texture table is full");
+  }
+
+  // 新槽位不会被在途命令引用，可直接写入（UpdateUnusedWhilePending）
+  UpdateTexture(m_textureCount, imageView, sampler);
+  return m_textureCount++;
+}
+
+void VKBindlessTable::UpdateTexture(uint32_t index, vk::ImageView imageView,
+                                    vk::Sampler sampler) {
+  vk::DescriptorImageInfo imageInfo;
+  imageInfo.sampler = sampler;
+  imageInfo.imageView = imageView;
+  imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+
+  vk::WriteDescriptorSet write;
+  write.dstSet = m_set;
+  write.dstBinding = 0;
+  write.dstArrayElement = index;
+  write.descriptorCount = 1;
+  write.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+  write.pImageInfo = &imageInfo;
+  m_device.updateDescriptorSets(write, nullptr);
+}
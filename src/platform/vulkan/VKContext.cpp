@@ -1,37 +1,156 @@
 #include "platform/vulkan/VKContext.hpp"
+
+#include <cstring>
+
+#include "resource/Vertex.hpp"
+#include "utils/ShaderLoader.hpp"
+
 void VKContext::Init() {
   createInstance();
+  // 表面先于设备选择创建，以便按呈现支持筛选设备
+  if (!m_headless) {
+    createSurface();
+  }
   selectPhysicalDevice();
-  createSurface();
   createDevice();
-  createSwapChain();
+  if (!m_headless) {
+    createSwapChain();
+  }
   createDescriptorPool();
+  createDescriptorSetLayout();
+  createDescriptorCache();
+  createPipelineLayout();
+  createTextureSampler();
+  createBindlessResources();
+  createIndirectResources();
+  createCullingResources();
+  createLightingResources();
+  createIBLResources();
+  createMipGenResources();
+  createGBufferFormats();
+  createGraphicsPipelines();
+  createIndirectPipelines();
+  createCullingPipelines();
+  createLightingPipelines();
+  createIBLPipelines();
+  createMipGenPipelines();
   createCommandPools();
 }
 
+VKContext::~VKContext() {
+  if (!m_device) return;
+  m_device->waitIdle();
+  vk::Device device = m_device->GetHandle();
+
+  for (auto semaphore : m_imageAvailableSemaphores) {
+    device.destroySemaphore(semaphore);
+  }
+  for (auto semaphore : m_renderFinishedSemaphores) {
+    device.destroySemaphore(semaphore);
+  }
+  m_frameScheduler.reset();
+  // 管线缓存等待后台编译结束，需在着色器模块之前释放
+  m_pipelineCache.reset();
+  if (m_cullPipeline) device.destroyPipeline(m_cullPipeline);
+  if (m_pyramidPipeline) device.destroyPipeline(m_pyramidPipeline);
+  if (m_lightCullPipeline) device.destroyPipeline(m_lightCullPipeline);
+  if (m_lightingPipeline) device.destroyPipeline(m_lightingPipeline);
+  if (m_iblPrefilterPipeline) device.destroyPipeline(m_iblPrefilterPipeline);
+  if (m_brdfLutPipeline) device.destroyPipeline(m_brdfLutPipeline);
+  if (m_mipDownsamplePipeline) device.destroyPipeline(m_mipDownsamplePipeline);
+  m_shader.reset();
+  m_bindlessShader.reset();
+  m_indirectShader.reset();
+  m_indirectBindlessShader.reset();
+
+  // 描述符缓存需在描述符池之前释放
+  m_descriptorCache.reset();
+  m_bindlessTable.reset();
+
+  if (m_bindlessPipelineLayout) {
+    device.destroyPipelineLayout(m_bindlessPipelineLayout);
+  }
+  if (m_indirectPipelineLayout) {
+    device.destroyPipelineLayout(m_indirectPipelineLayout);
+  }
+  if (m_indirectBindlessPipelineLayout) {
+    device.destroyPipelineLayout(m_indirectBindlessPipelineLayout);
+  }
+  if (m_cullPipelineLayout) device.destroyPipelineLayout(m_cullPipelineLayout);
+  if (m_pyramidPipelineLayout) {
+    device.destroyPipelineLayout(m_pyramidPipelineLayout);
+  }
+  if (m_cullSetLayout) device.destroyDescriptorSetLayout(m_cullSetLayout);
+  if (m_pyramidSetLayout) {
+    device.destroyDescriptorSetLayout(m_pyramidSetLayout);
+  }
+  if (m_lightingPipelineLayout) {
+    device.destroyPipelineLayout(m_lightingPipelineLayout);
+  }
+  if (m_lightingSetLayout) {
+    device.destroyDescriptorSetLayout(m_lightingSetLayout);
+  }
+  if (m_iblPipelineLayout) device.destroyPipelineLayout(m_iblPipelineLayout);
+  if (m_iblSetLayout) device.destroyDescriptorSetLayout(m_iblSetLayout);
+  if (m_mipGenPipelineLayout) {
+    device.destroyPipelineLayout(m_mipGenPipelineLayout);
+  }
+  if (m_mipGenSetLayout) device.destroyDescriptorSetLayout(m_mipGenSetLayout);
+  if (m_drawSetLayout) device.destroyDescriptorSetLayout(m_drawSetLayout);
+  if (m_frameSetLayout) device.destroyDescriptorSetLayout(m_frameSetLayout);
+  if (m_textureSampler) device.destroySampler(m_textureSampler);
+  if (m_pipelineLayout) device.destroyPipelineLayout(m_pipelineLayout);
+  if (m_descriptorSetLayout) {
+    device.destroyDescriptorSetLayout(m_descriptorSetLayout);
+  }
+  if (m_graphicsCommandPool) device.destroyCommandPool(*m_graphicsCommandPool);
+  if (m_transferCommandPool) device.destroyCommandPool(*m_transferCommandPool);
+  if (m_computeCommandPool) device.destroyCommandPool(*m_computeCommandPool);
+}
+
 void VKContext::createInstance() {
   VKInstance::CreateInfo createInfo;
   createInfo.appName = "PBRRender";
   createInfo.appVersion = VK_MAKE_VERSION(1, 3, 0);
-  createInfo.validationLayers = {"VK_LAYER_KHRONOS_validation"};
+  // 离屏模式常运行于无验证层的容器中（如lavapipe），不启用表面扩展
+  createInfo.headless = m_headless;
+  if (!m_headless) {
+    createInfo.validationLayers = {"VK_LAYER_KHRONOS_validation"};
+  }
   m_instance = std::make_shared<VKInstance>(createInfo);
   Log::LogMessage(Log::Level::Info, "Vulkan instance created successfully.");
-
-  m_surface = m_windowHandle->createVulkanSurface(m_instance->GetHandle());
-  if (!m_surface) {
-    Log::LogMessage(Log::Level::Error, "Failed to create Vulkan surface.");
-  }
 }
 
 void VKContext::selectPhysicalDevice() {
-  const auto& devices = m_instance->GetHandle().enumeratePhysicalDevices();
-  for (const auto& device : devices) {
-    if (device.getProperties().deviceType ==
-        vk::PhysicalDeviceType::eDiscreteGpu) {
-      m_physicalDevice = device;
-      break;
-    }
+  std::string override = VKDeviceSelector::GetOverrideFromEnvironment();
+  auto candidates =
+      VKDeviceSelector::RankDevices(m_instance->GetHandle(), m_surface);
+  for (const auto& candidate : candidates) {
+    std::string line = "#" + std::to_string(candidate.index) + " " +
+                       candidate.capabilities.ToString();
+    line += candidate.suitable
+                ? " score " + std::to_string(candidate.score)
+                : " unsuitable: " + candidate.rejectReason;
+    Log::LogMessage(Log::Level::Info, "Physical device " + line);
+  }
+
+  VKDeviceSelector::Candidate selected =
+      VKDeviceSelector::Select(candidates, override);
+  if (!override.empty() && !VKDeviceSelector::Matches(selected, override)) {
+    Log::LogMessage(Log::Level::Warning,
+                    std::string(VKDeviceSelector::kOverrideVariable) + "=" +
+                        override +
+                        " matches no suitable device, using best score.");
+  }
+  m_physicalDevice = selected.device;
+  m_deviceCapabilities = selected.capabilities;
+  if (m_deviceCapabilities.IsSoftware()) {
+    Log::LogMessage(Log::Level::Warning,
+                    "Selected a software rasterizer, expect low "
+                    "performance.");
   }
+  Log::LogMessage(Log::Level::Info,
+                  "Using physical device: " + m_deviceCapabilities.name);
 }
 
 void VKContext::createSurface() {
@@ -48,7 +167,31 @@ void VKContext::createDevice() {
                                         m_physicalDevice);
 
   // 添加必需的设备扩展
-  m_device->addRequiredExtension("VK_KHR_swapchain");
+  if (!m_headless) {
+    m_device->addRequiredExtension("VK_KHR_swapchain");
+  }
+
+  // 动态渲染与synchronization2（渲染图依赖）
+  m_device->enableVulkan13Features();
+
+  // 可选：性能分析所需的查询特性
+  m_device->enableProfilingFeatures();
+
+  // 可选：多命令间接绘制（几何池合批提交）
+  m_device->enableIndirectDrawFeatures();
+
+  // 时间线信号量（帧调度与异步计算，Vulkan 1.2起为核心特性）
+  m_device->enableTimelineSemaphore();
+
+  // 可选：描述符索引（无绑定材质纹理）
+  m_bindlessSupported = m_device->queryDescriptorIndexingSupport();
+  if (m_bindlessSupported) {
+    m_device->enableDescriptorIndexing();
+  } else {
+    Log::LogMessage(Log::Level::Warning,
+                    "Descriptor indexing not supported, bindless textures "
+                    "disabled.");
+  }
 
   m_device->createLogicalDevice();
   m_device->getQueue();
@@ -65,6 +208,8 @@ void VKContext::createSwapChain() {
   config.preferredFormat = vk::Format::eB8G8R8A8Srgb;
   config.preferredColorSpace = vk::ColorSpaceKHR::eSrgbNonlinear;
   config.preferredPresentMode = vk::PresentModeKHR::eMailbox;
+  // 渲染图通过blit将结果写入交换链图像
+  config.imageUsage |= vk::ImageUsageFlagBits::eTransferDst;
 
   vk::Extent2D windowExtent =
       vk::Extent2D(m_windowHandle->getWidth(), m_windowHandle->getHeight());
@@ -74,7 +219,626 @@ void VKContext::createSwapChain() {
 }
 
 void VKContext::createDescriptorPool() {
-  m_descriptorPool = std::make_shared<VKDescriptorPool>(m_device->GetHandle());
+  // 材质集与帧集的binding 0均为动态UBO，绘制集为动态SSBO，
+  // 深度金字塔逐级归约、光照输出与mip生成使用存储图像
+  VKDescriptorPool::Config config;
+  config.sizeRatios = {{vk::DescriptorType::eUniformBufferDynamic, 0.3f},
+                       {vk::DescriptorType::eUniformBuffer, 0.1f},
+                       {vk::DescriptorType::eCombinedImageSampler, 0.5f},
+                       {vk::DescriptorType::eStorageBuffer, 0.05f},
+                       {vk::DescriptorType::eStorageBufferDynamic, 0.05f},
+                       {vk::DescriptorType::eStorageImage, 0.1f}};
+  m_descriptorPool =
+      std::make_shared<VKDescriptorPool>(m_device->GetHandle(), config);
+}
+
+void VKContext::createDescriptorSetLayout() {
+  // binding 0: 变换UBO（动态偏移）；binding 1~6: 材质贴图（与geometry.frag一致）
+  std::vector<vk::DescriptorSetLayoutBinding> bindings;
+  vk::DescriptorSetLayoutBinding uboBinding;
+  uboBinding.binding = 0;
+  uboBinding.descriptorType = vk::DescriptorType::eUniformBufferDynamic;
+  uboBinding.descriptorCount = 1;
+  uboBinding.stageFlags =
+      vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+  bindings.push_back(uboBinding);
+
+  for (uint32_t i = 0; i < VKDescriptorCache::kImageBindingCount; i++) {
+    vk::DescriptorSetLayoutBinding samplerBinding;
+    samplerBinding.binding = i + 1;
+    samplerBinding.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    samplerBinding.descriptorCount = 1;
+    samplerBinding.stageFlags = vk::ShaderStageFlagBits::eFragment;
+    bindings.push_back(samplerBinding);
+  }
+
+  vk::DescriptorSetLayoutCreateInfo layoutInfo;
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+  m_descriptorSetLayout =
+      m_device->GetHandle().createDescriptorSetLayout(layoutInfo);
+  Log::LogMessage(Log::Level::Info,
+                  "Descriptor set layout created successfully.");
+}
+
+void VKContext::createDescriptorCache() {
+  m_descriptorCache = std::make_shared<VKDescriptorCache>(
+      m_device->GetHandle(), m_descriptorPool, m_descriptorSetLayout);
+}
+
+void VKContext::createPipelineLayout() {
+  // 逐材质描述符集路径以推送常量提供材质常量
+  vk::PushConstantRange pushConstant(vk::ShaderStageFlagBits::eFragment, 0,
+                                     sizeof(MaterialConstants));
+  vk::PipelineLayoutCreateInfo layoutInfo;
+  layoutInfo.setLayoutCount = 1;
+  layoutInfo.pSetLayouts = &m_descriptorSetLayout;
+  layoutInfo.pushConstantRangeCount = 1;
+  layoutInfo.pPushConstantRanges = &pushConstant;
+  m_pipelineLayout = m_device->GetHandle().createPipelineLayout(layoutInfo);
+}
+
+void VKContext::createTextureSampler() {
+  vk::SamplerCreateInfo samplerInfo;
+  samplerInfo.magFilter = vk::Filter::eLinear;
+  samplerInfo.minFilter = vk::Filter::eLinear;
+  samplerInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
+  samplerInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
+  samplerInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
+  samplerInfo.anisotropyEnable = VK_TRUE;
+  samplerInfo.maxAnisotropy =
+      m_physicalDevice.getProperties().limits.maxSamplerAnisotropy;
+  samplerInfo.borderColor = vk::BorderColor::eIntOpaqueBlack;
+  samplerInfo.unnormalizedCoordinates = VK_FALSE;
+  samplerInfo.compareEnable = VK_FALSE;
+  samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
+  samplerInfo.minLod = 0.0f;
+  samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+  m_textureSampler = m_device->GetHandle().createSampler(samplerInfo);
+}
+
+void VKContext::createBindlessResources() {
+  if (!m_bindlessSupported) return;
+
+  m_bindlessTable = std::make_shared<VKBindlessTable>(
+      m_device->GetHandle(), m_physicalDevice,
+      m_device->GetFeatureSupport().maxBindlessTextures);
+
+  // set 0: 逐对象变换UBO（与geometry.vert共用），set 1: 无绑定纹理表
+  vk::DescriptorSetLayoutBinding uboBinding;
+  uboBinding.binding = 0;
+  uboBinding.descriptorType = vk::DescriptorType::eUniformBufferDynamic;
+  uboBinding.descriptorCount = 1;
+  uboBinding.stageFlags =
+      vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+
+  vk::DescriptorSetLayoutCreateInfo frameLayoutInfo;
+  frameLayoutInfo.bindingCount = 1;
+  frameLayoutInfo.pBindings = &uboBinding;
+  m_frameSetLayout =
+      m_device->GetHandle().createDescriptorSetLayout(frameLayoutInfo);
+
+  std::array<vk::DescriptorSetLayout, 2> setLayouts = {
+      m_frameSetLayout, m_bindlessTable->GetLayout()};
+
+  vk::PushConstantRange pushConstant;
+  pushConstant.stageFlags = vk::ShaderStageFlagBits::eFragment;
+  pushConstant.offset = 0;
+  pushConstant.size = sizeof(uint32_t);
+
+  vk::PipelineLayoutCreateInfo layoutInfo;
+  layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+  layoutInfo.pSetLayouts = setLayouts.data();
+  layoutInfo.pushConstantRangeCount = 1;
+  layoutInfo.pPushConstantRanges = &pushConstant;
+  m_bindlessPipelineLayout =
+      m_device->GetHandle().createPipelineLayout(layoutInfo);
+  Log::LogMessage(Log::Level::Info, "Bindless texture table created.");
+}
+
+void VKContext::createIndirectResources() {
+  vk::Device device = m_device->GetHandle();
+
+  // 逐绘制数据：所有飞行帧共用一个缓冲，以动态偏移选择帧区域
+  vk::DescriptorSetLayoutBinding drawBinding;
+  drawBinding.binding = 0;
+  drawBinding.descriptorType = vk::DescriptorType::eStorageBufferDynamic;
+  drawBinding.descriptorCount = 1;
+  drawBinding.stageFlags = vk::ShaderStageFlagBits::eVertex;
+
+  vk::DescriptorSetLayoutCreateInfo drawLayoutInfo;
+  drawLayoutInfo.bindingCount = 1;
+  drawLayoutInfo.pBindings = &drawBinding;
+  m_drawSetLayout = device.createDescriptorSetLayout(drawLayoutInfo);
+
+  // set 0: 材质集（binding 0为每帧UBO），set 1: 逐绘制数据
+  std::array<vk::DescriptorSetLayout, 2> setLayouts = {m_descriptorSetLayout,
+                                                       m_drawSetLayout};
+  // 材质常量逐批次推送（与geometry.frag一致）
+  vk::PushConstantRange pushConstant(vk::ShaderStageFlagBits::eFragment, 0,
+                                     sizeof(MaterialConstants));
+  vk::PipelineLayoutCreateInfo layoutInfo;
+  layoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+  layoutInfo.pSetLayouts = setLayouts.data();
+  layoutInfo.pushConstantRangeCount = 1;
+  layoutInfo.pPushConstantRanges = &pushConstant;
+  m_indirectPipelineLayout = device.createPipelineLayout(layoutInfo);
+
+  if (!m_bindlessSupported) return;
+  // set 0: 每帧UBO，set 1: 逐绘制数据，set 2: 无绑定纹理表（含材质常量）
+  std::array<vk::DescriptorSetLayout, 3> bindlessLayouts = {
+      m_frameSetLayout, m_drawSetLayout, m_bindlessTable->GetLayout()};
+  layoutInfo.setLayoutCount = static_cast<uint32_t>(bindlessLayouts.size());
+  layoutInfo.pSetLayouts = bindlessLayouts.data();
+  layoutInfo.pushConstantRangeCount = 0;
+  layoutInfo.pPushConstantRanges = nullptr;
+  m_indirectBindlessPipelineLayout = device.createPipelineLayout(layoutInfo);
+}
+
+void VKContext::createCullingResources() {
+  vk::Device device = m_device->GetHandle();
+
+  // 剔除集：0 参数UBO，1 输入命令，2 包围球，3 输出命令，4 批次计数，
+  // 5 阶段一遮挡标记，6 统计计数，7 深度金字塔（与cull.comp一致）
+  using Type = vk::DescriptorType;
+  const std::array<Type, 8> cullTypes = {
+      Type::eUniformBufferDynamic, Type::eStorageBufferDynamic,
+      Type::eStorageBufferDynamic, Type::eStorageBuffer,
+      Type::eStorageBuffer,        Type::eStorageBuffer,
+      Type::eStorageBufferDynamic, Type::eCombinedImageSampler};
+  std::vector<vk::DescriptorSetLayoutBinding> bindings;
+  for (uint32_t i = 0; i < cullTypes.size(); i++) {
+    bindings.push_back(vk::DescriptorSetLayoutBinding(
+        i, cullTypes[i], 1, vk::ShaderStageFlagBits::eCompute));
+  }
+  vk::DescriptorSetLayoutCreateInfo layoutInfo;
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+  m_cullSetLayout = device.createDescriptorSetLayout(layoutInfo);
+
+  vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
+  pipelineLayoutInfo.setLayoutCount = 1;
+  pipelineLayoutInfo.pSetLayouts = &m_cullSetLayout;
+  m_cullPipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
+
+  // 金字塔集：0 深度纹理，1 上一级（存储图像），2 当前级（存储图像）
+  bindings = {vk::DescriptorSetLayoutBinding(
+                  0, Type::eCombinedImageSampler, 1,
+                  vk::ShaderStageFlagBits::eCompute),
+              vk::DescriptorSetLayoutBinding(
+                  1, Type::eStorageImage, 1,
+                  vk::ShaderStageFlagBits::eCompute),
+              vk::DescriptorSetLayoutBinding(
+                  2, Type::eStorageImage, 1,
+                  vk::ShaderStageFlagBits::eCompute)};
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+  m_pyramidSetLayout = device.createDescriptorSetLayout(layoutInfo);
+
+  vk::PushConstantRange pushConstant;
+  pushConstant.stageFlags = vk::ShaderStageFlagBits::eCompute;
+  pushConstant.offset = 0;
+  pushConstant.size = sizeof(VKGpuCulling::PyramidPushConstants);
+  pipelineLayoutInfo.pSetLayouts = &m_pyramidSetLayout;
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pushConstant;
+  m_pyramidPipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
+}
+
+void VKContext::createLightingResources() {
+  vk::Device device = m_device->GetHandle();
+
+  // 光照集：0 参数UBO，1 光源数组，2 分块光源列表，3 深度，
+  // 4-7 G-Buffer，8 HDR输出（与light_cull.comp、deferred_lighting.comp一致）
+  using Type = vk::DescriptorType;
+  const std::array<Type, 9> types = {
+      Type::eUniformBufferDynamic,  Type::eStorageBufferDynamic,
+      Type::eStorageBuffer,         Type::eCombinedImageSampler,
+      Type::eCombinedImageSampler,  Type::eCombinedImageSampler,
+      Type::eCombinedImageSampler,  Type::eCombinedImageSampler,
+      Type::eStorageImage};
+  std::vector<vk::DescriptorSetLayoutBinding> bindings;
+  for (uint32_t i = 0; i < types.size(); i++) {
+    bindings.push_back(vk::DescriptorSetLayoutBinding(
+        i, types[i], 1, vk::ShaderStageFlagBits::eCompute));
+  }
+  vk::DescriptorSetLayoutCreateInfo layoutInfo;
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+  m_lightingSetLayout = device.createDescriptorSetLayout(layoutInfo);
+
+  vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
+  pipelineLayoutInfo.setLayoutCount = 1;
+  pipelineLayoutInfo.pSetLayouts = &m_lightingSetLayout;
+  m_lightingPipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
+}
+
+void VKContext::createIBLResources() {
+  vk::Device device = m_device->GetHandle();
+
+  // IBL集：0 源环境立方体，1 输出缓冲（与ibl_prefilter.comp、brdf_lut.comp一致）
+  std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {
+      vk::DescriptorSetLayoutBinding(0,
+                                     vk::DescriptorType::eCombinedImageSampler,
+                                     1, vk::ShaderStageFlagBits::eCompute),
+      vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBuffer, 1,
+                                     vk::ShaderStageFlagBits::eCompute)};
+  vk::DescriptorSetLayoutCreateInfo layoutInfo;
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+  m_iblSetLayout = device.createDescriptorSetLayout(layoutInfo);
+
+  vk::PushConstantRange pushConstantRange(vk::ShaderStageFlagBits::eCompute, 0,
+                                          sizeof(VKIBLBaker::PushConstants));
+  vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
+  pipelineLayoutInfo.setLayoutCount = 1;
+  pipelineLayoutInfo.pSetLayouts = &m_iblSetLayout;
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+  m_iblPipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
+}
+
+void VKContext::createMipGenResources() {
+  vk::Device device = m_device->GetHandle();
+
+  // 与mip_downsample.comp一致：0 各级存储图像，1 工作组完成计数
+  std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {
+      vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eStorageImage,
+                                     VKMipGenerator::kMaxComputeLevels,
+                                     vk::ShaderStageFlagBits::eCompute),
+      vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBuffer, 1,
+                                     vk::ShaderStageFlagBits::eCompute)};
+  vk::DescriptorSetLayoutCreateInfo layoutInfo;
+  layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+  layoutInfo.pBindings = bindings.data();
+  m_mipGenSetLayout = device.createDescriptorSetLayout(layoutInfo);
+
+  vk::PushConstantRange pushConstantRange(
+      vk::ShaderStageFlagBits::eCompute, 0,
+      sizeof(VKMipGenerator::PushConstants));
+  vk::PipelineLayoutCreateInfo pipelineLayoutInfo;
+  pipelineLayoutInfo.setLayoutCount = 1;
+  pipelineLayoutInfo.pSetLayouts = &m_mipGenSetLayout;
+  pipelineLayoutInfo.pushConstantRangeCount = 1;
+  pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+  m_mipGenPipelineLayout = device.createPipelineLayout(pipelineLayoutInfo);
+}
+
+void VKContext::createGBufferFormats() {
+  const auto colorFeatures = vk::FormatFeatureFlagBits::eColorAttachment |
+                             vk::FormatFeatureFlagBits::eSampledImage;
+  vk::Format highPrecision = m_device->findSupportedFormat(
+      {vk::Format::eR16G16B16A16Sfloat, vk::Format::eR32G32B32A32Sfloat},
+      vk::ImageTiling::eOptimal, colorFeatures);
+  vk::Format lowPrecision = m_device->findSupportedFormat(
+      {vk::Format::eR8G8B8A8Unorm}, vk::ImageTiling::eOptimal, colorFeatures);
+
+  // 与geometry.frag的输出顺序一致
+  if (m_gbufferLayout == GBufferLayout::Lean) {
+    // 八面体编码的两个分量位于[-1, 1]，优先有符号归一化格式
+    vk::Format octNormal = m_device->findSupportedFormat(
+        {vk::Format::eR16G16Snorm, vk::Format::eR16G16Sfloat, highPrecision},
+        vk::ImageTiling::eOptimal, colorFeatures);
+    m_gbufferFormats.color = {octNormal, lowPrecision, lowPrecision};
+  } else {
+    m_gbufferFormats.color = {highPrecision, highPrecision, lowPrecision,
+                              lowPrecision};
+  }
+  // 光源分块、深度金字塔与紧凑布局的位置重建均采样深度
+  m_gbufferFormats.depth = m_device->findSupportedFormat(
+      {vk::Format::eD32Sfloat, vk::Format::eX8D24UnormPack32,
+       vk::Format::eD16Unorm},
+      vk::ImageTiling::eOptimal,
+      vk::FormatFeatureFlagBits::eDepthStencilAttachment |
+          vk::FormatFeatureFlagBits::eSampledImage);
+}
+
+uint32_t VKContext::GBufferFormats::BytesPerPixel() const {
+  auto size = [](vk::Format format) -> uint32_t {
+    switch (format) {
+      case vk::Format::eR32G32B32A32Sfloat:
+        return 16;
+      case vk::Format::eR16G16B16A16Sfloat:
+        return 8;
+      case vk::Format::eD16Unorm:
+        return 2;
+      default:
+        // RGBA8、RG16与32位深度格式
+        return 4;
+    }
+  };
+  uint32_t bytes = size(depth);
+  for (vk::Format format : color) bytes += size(format);
+  return bytes;
+}
+
+void VKContext::setGBufferLayout(GBufferLayout layout) {
+  if (layout == m_gbufferLayout) return;
+  m_device->waitIdle();
+  m_gbufferLayout = layout;
+  createGBufferFormats();
+
+  // 附件格式与特化常量都在管线描述中，新布局对应新的缓存键；
+  // 布局切换是显式配置操作，已启用路径的通用变体在此同步编译，
+  // 材质专用变体在绘制时按需后台编译，切回原布局时复用
+  for (GeometryPipeline kind :
+       {GeometryPipeline::Direct, GeometryPipeline::Bindless,
+        GeometryPipeline::Indirect, GeometryPipeline::IndirectBindless}) {
+    VKPipelineCache::GraphicsDesc desc = geometryPipelineDesc(kind);
+    if (desc.vertexModule) m_pipelineCache->GetOrCreate(desc);
+  }
+  if (m_deferredLightingSupported) createLightingPipelines();
+
+  Log::LogMessage(Log::Level::Info,
+                  std::string("G-Buffer layout: ") +
+                      (layout == GBufferLayout::Lean ? "lean" : "full") +
+                      ", " + std::to_string(m_gbufferFormats.BytesPerPixel()) +
+                      " bytes per pixel.");
+}
+
+void VKContext::createGraphicsPipelines() {
+  vk::Device device = m_device->GetHandle();
+  m_pipelineCache = std::make_unique<VKPipelineCache>(device);
+
+  m_shader = std::make_shared<VKShader>(device, "geometry", "geometry_vert",
+                                        "geometry_frag");
+  m_pipelineCache->GetOrCreate(geometryPipelineDesc(GeometryPipeline::Direct));
+  Log::LogMessage(Log::Level::Info, "Geometry pipeline created successfully.");
+
+  if (!m_bindlessSupported) return;
+  try {
+    m_bindlessShader = std::make_shared<VKShader>(
+        device, "geometry_bindless", "geometry_vert", "geometry_bindless_frag");
+    m_pipelineCache->Prefetch(
+        geometryPipelineDesc(GeometryPipeline::Bindless));
+  } catch (const std::exception& err) {
+    // 缺少无绑定着色器时退回逐材质描述符集
+    Log::LogMessage(Log::Level::Warning,
+                    "Bindless pipeline unavailable: " +
+                        std::string(err.what()));
+    m_bindlessSupported = false;
+  }
+}
+
+void VKContext::createIndirectPipelines() {
+  vk::Device device = m_device->GetHandle();
+
+  try {
+    m_indirectShader = std::make_shared<VKShader>(
+        device, "geometry_indirect", "geometry_indirect_vert", "geometry_frag");
+    m_pipelineCache->Prefetch(
+        geometryPipelineDesc(GeometryPipeline::Indirect));
+    m_indirectSupported = true;
+
+    if (m_bindlessSupported) {
+      m_indirectBindlessShader = std::make_shared<VKShader>(
+          device, "geometry_indirect_bindless", "geometry_indirect_vert",
+          "geometry_indirect_bindless_frag");
+      m_pipelineCache->Prefetch(
+          geometryPipelineDesc(GeometryPipeline::IndirectBindless));
+    }
+  } catch (const std::exception& err) {
+    // 缺少间接绘制着色器时保留逐对象直接绘制
+    Log::LogMessage(Log::Level::Warning,
+                    "Indirect draw pipeline unavailable: " +
+                        std::string(err.what()));
+  }
+}
+
+void VKContext::createCullingPipelines() {
+  // 压缩命令保留firstInstance作为逐绘制数据索引，并以多命令间接绘制提交
+  const auto& features = m_device->GetFeatureSupport();
+  if (!m_indirectSupported || !features.multiDrawIndirect ||
+      !features.drawIndirectFirstInstance) {
+    Log::LogMessage(Log::Level::Info,
+                    "GPU culling requires multi-draw indirect with "
+                    "firstInstance, disabled.");
+    return;
+  }
+
+  try {
+    m_cullPipeline = createComputePipeline("cull_comp", m_cullPipelineLayout);
+    m_pyramidPipeline = createComputePipeline(
+        "depth_pyramid_comp", m_pyramidPipelineLayout);
+    m_gpuCullingSupported = true;
+  } catch (const std::exception& err) {
+    // 缺少剔除着色器时绘制全部对象
+    Log::LogMessage(Log::Level::Warning,
+                    "GPU culling unavailable: " + std::string(err.what()));
+  }
+}
+
+void VKContext::createLightingPipelines() {
+  vk::Device device = m_device->GetHandle();
+  if (m_lightCullPipeline) device.destroyPipeline(m_lightCullPipeline);
+  if (m_lightingPipeline) device.destroyPipeline(m_lightingPipeline);
+  m_lightCullPipeline = nullptr;
+  m_lightingPipeline = nullptr;
+  m_deferredLightingSupported = false;
+
+  // 着色过程按G-Buffer布局特化
+  const VkBool32 lean = m_gbufferLayout == GBufferLayout::Lean;
+  vk::SpecializationMapEntry entry(0, 0, sizeof(VkBool32));
+  vk::SpecializationInfo specialization(1, &entry, sizeof(lean), &lean);
+
+  try {
+    m_lightCullPipeline = createComputePipeline(
+        "light_cull_comp", m_lightingPipelineLayout);
+    m_lightingPipeline = createComputePipeline(
+        "deferred_lighting_comp", m_lightingPipelineLayout, &specialization);
+    m_deferredLightingSupported = true;
+  } catch (const std::exception& err) {
+    // 缺少光照着色器时呈现反照率
+    Log::LogMessage(Log::Level::Warning,
+                    "Deferred lighting unavailable: " +
+                        std::string(err.what()));
+  }
+}
+
+void VKContext::createIBLPipelines() {
+  try {
+    m_iblPrefilterPipeline = createComputePipeline(
+        "ibl_prefilter_comp", m_iblPipelineLayout);
+    m_brdfLutPipeline =
+        createComputePipeline("brdf_lut_comp", m_iblPipelineLayout);
+    m_iblBakeSupported = true;
+  } catch (const std::exception& err) {
+    Log::LogMessage(Log::Level::Warning,
+                    "Compute IBL baking unavailable: " +
+                        std::string(err.what()));
+  }
+}
+
+VKIBLBaker::Pipelines VKContext::getIBLPipelines() const {
+  if (!m_iblBakeSupported) return {};
+  return {m_iblSetLayout, m_iblPipelineLayout, m_iblPrefilterPipeline,
+          m_brdfLutPipeline};
+}
+
+void VKContext::createMipGenPipelines() {
+  try {
+    m_mipDownsamplePipeline = createComputePipeline(
+        "mip_downsample_comp", m_mipGenPipelineLayout);
+    m_mipGenComputeSupported = true;
+  } catch (const std::exception& err) {
+    Log::LogMessage(Log::Level::Warning,
+                    "Compute mip generation unavailable: " +
+                        std::string(err.what()));
+  }
+}
+
+VKMipGenerator::Pipelines VKContext::getMipGenPipelines() const {
+  if (!m_mipGenComputeSupported) return {};
+  return {m_mipGenSetLayout, m_mipGenPipelineLayout, m_mipDownsamplePipeline};
+}
+
+vk::Pipeline VKContext::createComputePipeline(
+    const std::string& shader, vk::PipelineLayout layout,
+    const vk::SpecializationInfo* specialization) {
+  vk::Device device = m_device->GetHandle();
+  ShaderLoader::SPIRVCode code = ShaderLoader::Load(shader);
+  vk::ShaderModuleCreateInfo moduleInfo;
+  moduleInfo.codeSize = code.Words().size_bytes();
+  moduleInfo.pCode = code.Words().data();
+  vk::ShaderModule module = device.createShaderModule(moduleInfo);
+
+  vk::ComputePipelineCreateInfo pipelineInfo;
+  pipelineInfo.stage.stage = vk::ShaderStageFlagBits::eCompute;
+  pipelineInfo.stage.module = module;
+  pipelineInfo.stage.pName = "main";
+  pipelineInfo.stage.pSpecializationInfo = specialization;
+  pipelineInfo.layout = layout;
+  auto result = device.createComputePipeline(nullptr, pipelineInfo);
+  device.destroyShaderModule(module);
+  if (result.result != vk::Result::eSuccess) {
+    throw std::runtime_error("Failed to create compute pipeline: " +
+                             vk::to_string(result.result));
+  }
+  return result.value;
+}
+
+VKPipelineCache::GraphicsDesc VKContext::geometryPipelineDesc(
+    GeometryPipeline kind, uint32_t materialFeatures) const {
+  VKPipelineCache::GraphicsDesc desc;
+  const VKShader* shader = nullptr;
+  switch (kind) {
+    case GeometryPipeline::Direct:
+      shader = m_shader.get();
+      desc.layout = m_pipelineLayout;
+      break;
+    case GeometryPipeline::Bindless:
+      shader = m_bindlessShader.get();
+      desc.layout = m_bindlessPipelineLayout;
+      break;
+    case GeometryPipeline::Indirect:
+      shader = m_indirectShader.get();
+      desc.layout = m_indirectPipelineLayout;
+      break;
+    case GeometryPipeline::IndirectBindless:
+      shader = m_indirectBindlessShader.get();
+      desc.layout = m_indirectBindlessPipelineLayout;
+      break;
+  }
+  if (!shader) return desc;
+  desc.vertexModule = shader->GetVertexModule();
+  desc.fragmentModule = shader->GetFragmentModule();
+  desc.shaderHash = shader->GetCodeHash();
+
+  // 片段着色器按G-Buffer布局特化输出，按材质特性位消除多余的采样
+  const VkBool32 lean = m_gbufferLayout == GBufferLayout::Lean;
+  desc.specializationEntries = {
+      vk::SpecializationMapEntry(0, 0, sizeof(VkBool32)),
+      vk::SpecializationMapEntry(1, sizeof(VkBool32), sizeof(uint32_t))};
+  desc.specializationData.resize(sizeof(lean) + sizeof(materialFeatures));
+  std::memcpy(desc.specializationData.data(), &lean, sizeof(lean));
+  std::memcpy(desc.specializationData.data() + sizeof(lean),
+              &materialFeatures, sizeof(materialFeatures));
+  // 特化常量不影响兼容组，只有通用变体可回退：专用变体消除了采样，
+  // 不能替代通用变体绘制任意材质
+  desc.servesAsFallback = materialFeatures == MaterialFeatures::kAll;
+
+  auto bindings = Vertex::getBindingDescriptions();
+  auto attributes = Vertex::getAttributeDescriptions();
+  desc.vertexBindings.assign(bindings.begin(), bindings.end());
+  desc.vertexAttributes.assign(attributes.begin(), attributes.end());
+  desc.colorFormats = m_gbufferFormats.color;
+  desc.depthFormat = m_gbufferFormats.depth;
+  return desc;
+}
+
+vk::Pipeline VKContext::acquireGeometryPipeline(
+    GeometryPipeline kind, uint32_t materialFeatures) const {
+  VKPipelineCache::GraphicsDesc desc =
+      geometryPipelineDesc(kind, materialFeatures);
+  if (!desc.vertexModule) return nullptr;
+  if (materialFeatures == MaterialFeatures::kAll) {
+    return m_pipelineCache->Acquire(desc);
+  }
+  // 专用变体只接受精确命中：兼容组中的其他变体可能缺少该材质需要的采样
+  vk::Pipeline pipeline = m_pipelineCache->Acquire(desc, false);
+  if (pipeline) return pipeline;
+  return m_pipelineCache->Acquire(
+      geometryPipelineDesc(kind, MaterialFeatures::kAll));
+}
+
+void VKContext::createFrameResources(uint32_t framesInFlight) {
+  vk::Device device = m_device->GetHandle();
+
+  vk::CommandBufferAllocateInfo allocInfo;
+  allocInfo.commandPool = *m_graphicsCommandPool;
+  allocInfo.level = vk::CommandBufferLevel::ePrimary;
+  allocInfo.commandBufferCount = framesInFlight;
+  m_commandBuffers = device.allocateCommandBuffers(allocInfo);
+
+  m_frameScheduler = std::make_unique<VKFrameScheduler>(
+      device,
+      std::array<vk::Queue, VKFrameScheduler::kQueueCount>{
+          m_device->GetGraphicsQueue(), m_device->GetComputeQueue(),
+          m_device->GetTransferQueue()},
+      framesInFlight);
+  // 离屏模式只用时间线同步
+  if (!m_swapChain) return;
+
+  for (uint32_t i = 0; i < framesInFlight; i++) {
+    m_imageAvailableSemaphores.push_back(device.createSemaphore({}));
+  }
+  syncRenderFinishedSemaphores();
+}
+
+void VKContext::syncRenderFinishedSemaphores() {
+  // 呈现引擎按图像释放信号量，故数量须与交换链图像一致
+  size_t imageCount = m_swapChain->GetImageCount();
+  if (m_renderFinishedSemaphores.size() == imageCount) return;
+
+  vk::Device device = m_device->GetHandle();
+  // 交换链重建时已等待设备空闲，多余的信号量不再被呈现引用
+  while (m_renderFinishedSemaphores.size() > imageCount) {
+    device.destroySemaphore(m_renderFinishedSemaphores.back());
+    m_renderFinishedSemaphores.pop_back();
+  }
+  while (m_renderFinishedSemaphores.size() < imageCount) {
+    m_renderFinishedSemaphores.push_back(device.createSemaphore({}));
+  }
 }
 
 void VKContext::createCommandPools() {
@@ -0,0 +1,229 @@
+#include "platform/vulkan/VKDeferredLighting.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "core/Log.hpp"
+#include "utils/vkutil.hpp"
+
+namespace {
+vk::DeviceSize AlignUp(vk::DeviceSize size, vk::DeviceSize alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+uint32_t TileCount(uint32_t pixels) {
+  return (pixels + VKDeferredLighting::kTileSize - 1) /
+         VKDeferredLighting::kTileSize;
+}
+}  // namespace
+
+VKDeferredLighting::VKDeferredLighting(
+    vk::Device device, vk::PhysicalDevice physicalDevice,
+    std::shared_ptr<VKDescriptorPool> descriptorPool,
+    const Pipelines& pipelines, uint32_t framesInFlight)
+    : m_device(device),
+      m_physicalDevice(physicalDevice),
+      m_descriptorPool(std::move(descriptorPool)),
+      m_pipelines(pipelines),
+      m_framesInFlight(framesInFlight) {
+  const auto limits = physicalDevice.getProperties().limits;
+  m_paramsStride = AlignUp(sizeof(LightingParams),
+                           limits.minUniformBufferOffsetAlignment);
+  try {
+    vkutil::CreateBuffer(device, physicalDevice,
+                         m_paramsStride * framesInFlight,
+                         vk::BufferUsageFlagBits::eUniformBuffer,
+                         vk::MemoryPropertyFlagBits::eHostVisible |
+                             vk::MemoryPropertyFlagBits::eHostCoherent,
+                         m_paramsBuffer, m_paramsMemory);
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create lighting parameters: " +
+                             std::string(err.what()));
+  }
+  m_paramsMapped = static_cast<uint8_t*>(
+      device.mapMemory(m_paramsMemory, 0, m_paramsStride * framesInFlight));
+
+  vk::SamplerCreateInfo samplerInfo;
+  samplerInfo.magFilter = vk::Filter::eNearest;
+  samplerInfo.minFilter = vk::Filter::eNearest;
+  samplerInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
+  samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+  m_sampler = device.createSampler(samplerInfo);
+
+  m_set = m_descriptorPool->AllocateSet(m_pipelines.setLayout);
+  CreateLightBuffer(256);
+  UpdateBufferDescriptors();
+}
+
+VKDeferredLighting::~VKDeferredLighting() {
+  DestroyLightBuffer();
+  if (m_set) m_descriptorPool->FreeSet(m_set);
+  if (m_sampler) m_device.destroySampler(m_sampler);
+  if (m_paramsBuffer) {
+    m_device.unmapMemory(m_paramsMemory);
+    m_device.destroyBuffer(m_paramsBuffer);
+    m_device.freeMemory(m_paramsMemory);
+  }
+}
+
+vk::DeviceSize VKDeferredLighting::GetTileBufferSize(vk::Extent2D extent) {
+  return static_cast<vk::DeviceSize>(TileCount(extent.width)) *
+         TileCount(extent.height) * (kMaxLightsPerTile + 1) * sizeof(uint32_t);
+}
+
+void VKDeferredLighting::CreateLightBuffer(uint32_t capacity) {
+  const auto limits = m_physicalDevice.getProperties().limits;
+  m_lightCapacity = capacity;
+  m_lightStride = AlignUp(sizeof(PointLight) * capacity,
+                          limits.minStorageBufferOffsetAlignment);
+  try {
+    vkutil::CreateBuffer(m_device, m_physicalDevice,
+                         m_lightStride * m_framesInFlight,
+                         vk::BufferUsageFlagBits::eStorageBuffer,
+                         vk::MemoryPropertyFlagBits::eHostVisible |
+                             vk::MemoryPropertyFlagBits::eHostCoherent,
+                         m_lightBuffer, m_lightMemory);
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create light buffer: " +
+                             std::string(err.what()));
+  }
+  m_lightMapped = static_cast<uint8_t*>(
+      m_device.mapMemory(m_lightMemory, 0, m_lightStride * m_framesInFlight));
+}
+
+void VKDeferredLighting::DestroyLightBuffer() {
+  if (!m_lightBuffer) return;
+  m_device.unmapMemory(m_lightMemory);
+  m_device.destroyBuffer(m_lightBuffer);
+  m_device.freeMemory(m_lightMemory);
+  m_lightBuffer = nullptr;
+  m_lightMemory = nullptr;
+  m_lightMapped = nullptr;
+}
+
+void VKDeferredLighting::UpdateBufferDescriptors() {
+  std::array<vk::DescriptorBufferInfo, 2> buffers = {
+      vk::DescriptorBufferInfo(m_paramsBuffer, 0, sizeof(LightingParams)),
+      vk::DescriptorBufferInfo(m_lightBuffer, 0, m_lightStride)};
+  std::array<vk::WriteDescriptorSet, 2> writes;
+  writes[0].dstSet = m_set;
+  writes[0].dstBinding = 0;
+  writes[0].descriptorCount = 1;
+  writes[0].descriptorType = vk::DescriptorType::eUniformBufferDynamic;
+  writes[0].pBufferInfo = &buffers[0];
+  writes[1] = writes[0];
+  writes[1].dstBinding = 1;
+  writes[1].descriptorType = vk::DescriptorType::eStorageBufferDynamic;
+  writes[1].pBufferInfo = &buffers[1];
+  m_device.updateDescriptorSets(writes, nullptr);
+}
+
+void VKDeferredLighting::SetTargets(vk::Extent2D extent,
+                                    const Targets& targets) {
+  m_extent = extent;
+  m_tileBuffer = targets.tileLights;
+  m_tileBytes = GetTileBufferSize(extent);
+
+  // 布局与渲染图的访问类型一致：采样读取深度为只读深度模板，
+  // 颜色为着色器只读，存储写入为通用布局。
+  // 紧凑G-Buffer的着色器不读取位置，以法线占位保持绑定有效
+  const auto readOnly = vk::ImageLayout::eShaderReadOnlyOptimal;
+  vk::ImageView position = targets.position ? targets.position
+                                            : targets.normal;
+  std::array<vk::DescriptorImageInfo, 6> images = {
+      vk::DescriptorImageInfo(m_sampler, targets.depth,
+                              vk::ImageLayout::eDepthStencilReadOnlyOptimal),
+      vk::DescriptorImageInfo(m_sampler, position, readOnly),
+      vk::DescriptorImageInfo(m_sampler, targets.normal, readOnly),
+      vk::DescriptorImageInfo(m_sampler, targets.albedo, readOnly),
+      vk::DescriptorImageInfo(m_sampler, targets.material, readOnly),
+      vk::DescriptorImageInfo(nullptr, targets.output,
+                              vk::ImageLayout::eGeneral)};
+  vk::DescriptorBufferInfo tileInfo(m_tileBuffer, 0, m_tileBytes);
+
+  std::vector<vk::WriteDescriptorSet> writes(images.size() + 1);
+  writes[0].dstSet = m_set;
+  writes[0].dstBinding = 2;
+  writes[0].descriptorCount = 1;
+  writes[0].descriptorType = vk::DescriptorType::eStorageBuffer;
+  writes[0].pBufferInfo = &tileInfo;
+  for (uint32_t i = 0; i < images.size(); i++) {
+    auto& write = writes[i + 1];
+    write.dstSet = m_set;
+    write.dstBinding = 3 + i;
+    write.descriptorCount = 1;
+    write.descriptorType = i + 1 < images.size()
+                               ? vk::DescriptorType::eCombinedImageSampler
+                               : vk::DescriptorType::eStorageImage;
+    write.pImageInfo = &images[i];
+  }
+  m_device.updateDescriptorSets(writes, nullptr);
+}
+
+void VKDeferredLighting::BeginFrame(uint32_t frameIndex,
+                                    const std::vector<PointLight>& lights,
+                                    const glm::mat4& view,
+                                    const glm::mat4& projection) {
+  m_frameIndex = frameIndex;
+
+  // 其余飞行帧仍在读取光源缓冲，扩容前等待设备空闲
+  uint32_t lightCount = static_cast<uint32_t>(lights.size());
+  if (lightCount > m_lightCapacity) {
+    m_device.waitIdle();
+    DestroyLightBuffer();
+    uint32_t capacity = m_lightCapacity;
+    while (capacity < lightCount) capacity *= 2;
+    CreateLightBuffer(capacity);
+    UpdateBufferDescriptors();
+    Log::LogMessage(Log::Level::Info, "Light buffer grown to " +
+                                          std::to_string(capacity) +
+                                          " lights.");
+  }
+  if (lightCount > 0) {
+    std::memcpy(m_lightMapped + m_lightStride * frameIndex, lights.data(),
+                sizeof(PointLight) * lightCount);
+  }
+
+  LightingParams params{};
+  params.view = view;
+  params.inverseProjection = glm::inverse(projection);
+  params.inverseViewProjection = glm::inverse(projection * view);
+  params.cameraPosition = glm::vec4(glm::vec3(glm::inverse(view)[3]),
+                                    m_exposure);
+  params.ambient = glm::vec4(m_ambient, 0.0f);
+  params.lightCount = lightCount;
+  params.tileCountX = TileCount(m_extent.width);
+  params.width = m_extent.width;
+  params.height = m_extent.height;
+  std::memcpy(m_paramsMapped + m_paramsStride * frameIndex, &params,
+              sizeof(params));
+}
+
+void VKDeferredLighting::Dispatch(vk::CommandBuffer commandBuffer,
+                                  vk::Pipeline pipeline) const {
+  std::array<uint32_t, 2> dynamicOffsets = {
+      static_cast<uint32_t>(m_paramsStride * m_frameIndex),
+      static_cast<uint32_t>(m_lightStride * m_frameIndex)};
+  commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline);
+  commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+                                   m_pipelines.layout, 0, m_set,
+                                   dynamicOffsets);
+  commandBuffer.dispatch(TileCount(m_extent.width),
+                         TileCount(m_extent.height), 1);
+}
+
+void VKDeferredLighting::RecordLightCulling(
+    vk::CommandBuffer commandBuffer) const {
+  Dispatch(commandBuffer, m_pipelines.lightCull);
+}
+
+void VKDeferredLighting::RecordLighting(
+    vk::CommandBuffer commandBuffer) const {
+  Dispatch(commandBuffer, m_pipelines.lighting);
+}
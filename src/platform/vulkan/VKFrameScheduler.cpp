@@ -0,0 +1,127 @@
+#include "platform/vulkan/VKFrameScheduler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+VKFrameScheduler::VKFrameScheduler(
+    vk::Device device, const std::array<vk::Queue, kQueueCount>& queues,
+    uint32_t framesInFlight)
+    : m_device(device),
+      m_queues(queues),
+      m_frameValues(std::max(framesInFlight, 1u), 0) {
+  try {
+    vk::SemaphoreTypeCreateInfo typeInfo(vk::SemaphoreType::eTimeline, 0);
+    vk::SemaphoreCreateInfo semaphoreInfo;
+    semaphoreInfo.pNext = &typeInfo;
+    for (auto& timeline : m_timelines) {
+      timeline = m_device.createSemaphore(semaphoreInfo);
+    }
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create frame scheduler: " +
+                             std::string(err.what()));
+  }
+}
+
+VKFrameScheduler::~VKFrameScheduler() {
+  for (auto& deferred : m_deferred) deferred.destroy();
+  for (auto timeline : m_timelines) {
+    if (timeline) m_device.destroySemaphore(timeline);
+  }
+}
+
+void VKFrameScheduler::BeginFrame(uint32_t frameIndex) {
+  m_frameIndex = frameIndex;
+  Wait(QueueType::Graphics, m_frameValues[frameIndex]);
+  Collect();
+}
+
+void VKFrameScheduler::EndFrame() {
+  m_frameValues[m_frameIndex] = m_submitted[Index(QueueType::Graphics)];
+}
+
+uint64_t VKFrameScheduler::Submit(
+    QueueType queue, vk::CommandBuffer commandBuffer,
+    const std::vector<vk::SemaphoreSubmitInfo>& waits,
+    const std::vector<vk::SemaphoreSubmitInfo>& signals) {
+  const uint32_t index = Index(queue);
+  const uint64_t value = m_submitted[index] + 1;
+  std::vector<vk::SemaphoreSubmitInfo> signalInfos = signals;
+  signalInfos.emplace_back(m_timelines[index], value,
+                           vk::PipelineStageFlagBits2::eAllCommands);
+
+  vk::CommandBufferSubmitInfo commandBufferInfo(commandBuffer);
+  vk::SubmitInfo2 submitInfo;
+  submitInfo.waitSemaphoreInfoCount = static_cast<uint32_t>(waits.size());
+  submitInfo.pWaitSemaphoreInfos = waits.data();
+  submitInfo.commandBufferInfoCount = 1;
+  submitInfo.pCommandBufferInfos = &commandBufferInfo;
+  submitInfo.signalSemaphoreInfoCount =
+      static_cast<uint32_t>(signalInfos.size());
+  submitInfo.pSignalSemaphoreInfos = signalInfos.data();
+  m_queues[index].submit2(submitInfo);
+  // 提交失败时抛出异常，计数不前进
+  m_submitted[index] = value;
+  return value;
+}
+
+uint64_t VKFrameScheduler::GetCompletedValue(QueueType queue) const {
+  return m_device.getSemaphoreCounterValue(m_timelines[Index(queue)]);
+}
+
+bool VKFrameScheduler::IsComplete(const Point& point) const {
+  for (uint32_t q = 0; q < kQueueCount; q++) {
+    if (point[q] > 0 &&
+        m_device.getSemaphoreCounterValue(m_timelines[q]) < point[q]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void VKFrameScheduler::Wait(QueueType queue, uint64_t value) const {
+  if (value == 0) return;
+  vk::Semaphore timeline = m_timelines[Index(queue)];
+  vk::SemaphoreWaitInfo waitInfo({}, timeline, value);
+  (void)m_device.waitSemaphores(waitInfo, UINT64_MAX);
+}
+
+void VKFrameScheduler::WaitIdle() {
+  std::vector<vk::Semaphore> semaphores;
+  std::vector<uint64_t> values;
+  for (uint32_t q = 0; q < kQueueCount; q++) {
+    if (m_submitted[q] == 0) continue;
+    semaphores.push_back(m_timelines[q]);
+    values.push_back(m_submitted[q]);
+  }
+  if (!semaphores.empty()) {
+    vk::SemaphoreWaitInfo waitInfo({}, semaphores, values);
+    (void)m_device.waitSemaphores(waitInfo, UINT64_MAX);
+  }
+  Collect();
+}
+
+void VKFrameScheduler::DeferDestroy(std::function<void()> destroy) {
+  m_deferred.push_back({m_submitted, std::move(destroy)});
+}
+
+void VKFrameScheduler::Collect() {
+  if (m_deferred.empty()) return;
+  Point completed;
+  for (uint32_t q = 0; q < kQueueCount; q++) {
+    completed[q] = m_device.getSemaphoreCounterValue(m_timelines[q]);
+  }
+  // 快照随追加单调不减，遇到第一个未完成项即可停止
+  size_t done = 0;
+  for (; done < m_deferred.size(); done++) {
+    const Point& point = m_deferred[done].point;
+    bool complete = true;
+    for (uint32_t q = 0; q < kQueueCount; q++) {
+      complete = complete && completed[q] >= point[q];
+    }
+    if (!complete) break;
+    m_deferred[done].destroy();
+  }
+  m_deferred.erase(m_deferred.begin(), m_deferred.begin() + done);
+}
@@ -0,0 +1,482 @@
+#include "platform/vulkan/VKGpuCulling.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "core/Log.hpp"
+#include "rendering/Frustum.hpp"
+#include "utils/vkutil.hpp"
+
+namespace {
+constexpr uint32_t kCullGroupSize = 64;     // 与cull.comp的local_size_x一致
+constexpr uint32_t kPyramidGroupSize = 8;   // 与depth_pyramid.comp一致
+
+vk::DeviceSize AlignUp(vk::DeviceSize size, vk::DeviceSize alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+}  // namespace
+
+VKGpuCulling::VKGpuCulling(vk::Device device, vk::PhysicalDevice physicalDevice,
+                           std::shared_ptr<VKDescriptorPool> descriptorPool,
+                           const Pipelines& pipelines, uint32_t framesInFlight,
+                           bool drawIndirectCount)
+    : m_device(device),
+      m_physicalDevice(physicalDevice),
+      m_descriptorPool(std::move(descriptorPool)),
+      m_pipelines(pipelines),
+      m_framesInFlight(framesInFlight),
+      m_slots(framesInFlight) {
+  // 静态分派只导出核心函数，扩展命令从设备查询
+  if (drawIndirectCount) {
+    m_drawIndexedIndirectCount =
+        reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+            device.getProcAddr("vkCmdDrawIndexedIndirectCountKHR"));
+  }
+
+  const auto limits = physicalDevice.getProperties().limits;
+  m_paramsStride = AlignUp(sizeof(CullParams),
+                           limits.minUniformBufferOffsetAlignment);
+  m_statsStride =
+      AlignUp(sizeof(GpuStats), limits.minStorageBufferOffsetAlignment);
+
+  const auto hostVisible = vk::MemoryPropertyFlagBits::eHostVisible |
+                           vk::MemoryPropertyFlagBits::eHostCoherent;
+  try {
+    vkutil::CreateBuffer(device, physicalDevice,
+                         m_paramsStride * 2 * framesInFlight,
+                         vk::BufferUsageFlagBits::eUniformBuffer, hostVisible,
+                         m_paramsBuffer, m_paramsMemory);
+    vkutil::CreateBuffer(device, physicalDevice, m_statsStride * framesInFlight,
+                         vk::BufferUsageFlagBits::eStorageBuffer, hostVisible,
+                         m_statsBuffer, m_statsMemory);
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create culling buffers: " +
+                             std::string(err.what()));
+  }
+  m_paramsMapped = static_cast<uint8_t*>(device.mapMemory(
+      m_paramsMemory, 0, m_paramsStride * 2 * framesInFlight));
+  m_statsMapped = static_cast<uint8_t*>(
+      device.mapMemory(m_statsMemory, 0, m_statsStride * framesInFlight));
+  std::memset(m_statsMapped, 0, m_statsStride * framesInFlight);
+
+  // 金字塔按texelFetch逐级读取，采样器只需最近邻与边缘钳制
+  vk::SamplerCreateInfo samplerInfo;
+  samplerInfo.magFilter = vk::Filter::eNearest;
+  samplerInfo.minFilter = vk::Filter::eNearest;
+  samplerInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
+  samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+  m_sampler = device.createSampler(samplerInfo);
+
+  m_cullSet = m_descriptorPool->AllocateSet(m_pipelines.cullSetLayout);
+  CreateBuffers(4096);
+}
+
+VKGpuCulling::~VKGpuCulling() {
+  DestroyPyramid();
+  DestroyBuffers();
+  if (m_cullSet) m_descriptorPool->FreeSet(m_cullSet);
+  if (m_sampler) m_device.destroySampler(m_sampler);
+  if (m_paramsBuffer) {
+    m_device.unmapMemory(m_paramsMemory);
+    m_device.destroyBuffer(m_paramsBuffer);
+    m_device.freeMemory(m_paramsMemory);
+  }
+  if (m_statsBuffer) {
+    m_device.unmapMemory(m_statsMemory);
+    m_device.destroyBuffer(m_statsBuffer);
+    m_device.freeMemory(m_statsMemory);
+  }
+}
+
+void VKGpuCulling::CreateBuffers(uint32_t capacity) {
+  m_capacity = capacity;
+  m_commandBytes =
+      2ull * capacity * sizeof(vk::DrawIndexedIndirectCommand);
+  m_countBytes = 2ull * capacity * sizeof(uint32_t);
+  m_occludedBytes = static_cast<vk::DeviceSize>(capacity) * sizeof(uint32_t);
+
+  const auto deviceLocal = vk::MemoryPropertyFlagBits::eDeviceLocal;
+  const auto storage = vk::BufferUsageFlagBits::eStorageBuffer;
+  try {
+    vkutil::CreateBuffer(m_device, m_physicalDevice, m_commandBytes,
+                         storage | vk::BufferUsageFlagBits::eIndirectBuffer,
+                         deviceLocal, m_commandBuffer, m_commandMemory);
+    vkutil::CreateBuffer(m_device, m_physicalDevice, m_countBytes,
+                         storage | vk::BufferUsageFlagBits::eIndirectBuffer |
+                             vk::BufferUsageFlagBits::eTransferDst,
+                         deviceLocal, m_countBuffer, m_countMemory);
+    vkutil::CreateBuffer(m_device, m_physicalDevice, m_occludedBytes, storage,
+                         deviceLocal, m_occludedBuffer, m_occludedMemory);
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create culling output buffers: " +
+                             std::string(err.what()));
+  }
+  m_generation++;
+}
+
+void VKGpuCulling::DestroyBuffers() {
+  auto destroy = [&](vk::Buffer& buffer, vk::DeviceMemory& memory) {
+    if (!buffer) return;
+    m_device.destroyBuffer(buffer);
+    m_device.freeMemory(memory);
+    buffer = nullptr;
+    memory = nullptr;
+  };
+  destroy(m_commandBuffer, m_commandMemory);
+  destroy(m_countBuffer, m_countMemory);
+  destroy(m_occludedBuffer, m_occludedMemory);
+}
+
+void VKGpuCulling::DestroyPyramid() {
+  for (auto set : m_pyramidSets) m_descriptorPool->FreeSet(set);
+  m_pyramidSets.clear();
+  for (auto view : m_pyramidMipViews) m_device.destroyImageView(view);
+  m_pyramidMipViews.clear();
+  if (m_pyramidView) m_device.destroyImageView(m_pyramidView);
+  if (m_pyramidImage) m_device.destroyImage(m_pyramidImage);
+  if (m_pyramidMemory) m_device.freeMemory(m_pyramidMemory);
+  m_pyramidView = nullptr;
+  m_pyramidImage = nullptr;
+  m_pyramidMemory = nullptr;
+  m_pyramidLevels = 0;
+}
+
+vk::Extent2D VKGpuCulling::GetMipExtent(uint32_t level) const {
+  // 与图像的mip尺寸一致（向下取整减半）；奇数尺寸的最后一行/列
+  // 由归约着色器并入相邻纹素
+  return vk::Extent2D(std::max(m_pyramidExtent.width >> level, 1u),
+                      std::max(m_pyramidExtent.height >> level, 1u));
+}
+
+void VKGpuCulling::Resize(vk::Extent2D extent, vk::Queue queue,
+                          vk::CommandPool commandPool) {
+  if (m_pyramidImage && extent == m_pyramidExtent) return;
+  DestroyPyramid();
+  m_pyramidExtent = extent;
+  m_pyramidLevels = static_cast<uint32_t>(std::floor(std::log2(
+                        std::max(extent.width, extent.height)))) +
+                    1;
+
+  vk::ImageCreateInfo imageInfo;
+  imageInfo.imageType = vk::ImageType::e2D;
+  imageInfo.format = kPyramidFormat;
+  imageInfo.extent = vk::Extent3D(extent.width, extent.height, 1);
+  imageInfo.mipLevels = m_pyramidLevels;
+  imageInfo.arrayLayers = 1;
+  imageInfo.samples = vk::SampleCountFlagBits::e1;
+  imageInfo.tiling = vk::ImageTiling::eOptimal;
+  imageInfo.usage = vk::ImageUsageFlagBits::eStorage |
+                    vk::ImageUsageFlagBits::eSampled |
+                    vk::ImageUsageFlagBits::eTransferDst;
+  imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+  try {
+    m_pyramidImage = m_device.createImage(imageInfo);
+    vk::MemoryRequirements requirements =
+        m_device.getImageMemoryRequirements(m_pyramidImage);
+    vk::MemoryAllocateInfo allocInfo(
+        requirements.size,
+        vkutil::FindMemoryType(m_physicalDevice, requirements.memoryTypeBits,
+                               vk::MemoryPropertyFlagBits::eDeviceLocal));
+    m_pyramidMemory = m_device.allocateMemory(allocInfo);
+    m_device.bindImageMemory(m_pyramidImage, m_pyramidMemory, 0);
+
+    vk::ImageViewCreateInfo viewInfo;
+    viewInfo.image = m_pyramidImage;
+    viewInfo.viewType = vk::ImageViewType::e2D;
+    viewInfo.format = kPyramidFormat;
+    viewInfo.subresourceRange = vk::ImageSubresourceRange(
+        vk::ImageAspectFlagBits::eColor, 0, m_pyramidLevels, 0, 1);
+    m_pyramidView = m_device.createImageView(viewInfo);
+    for (uint32_t level = 0; level < m_pyramidLevels; level++) {
+      viewInfo.subresourceRange.baseMipLevel = level;
+      viewInfo.subresourceRange.levelCount = 1;
+      m_pyramidMipViews.push_back(m_device.createImageView(viewInfo));
+    }
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create depth pyramid: " +
+                             std::string(err.what()));
+  }
+
+  // 初始为最远深度（首帧阶段一全部通过），之后始终以采样布局交给渲染图
+  vk::CommandBuffer commandBuffer =
+      vkutil::BeginSingleTimeCommands(m_device, commandPool);
+  vk::ImageSubresourceRange range(vk::ImageAspectFlagBits::eColor, 0,
+                                  m_pyramidLevels, 0, 1);
+  vk::ImageMemoryBarrier barrier;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = m_pyramidImage;
+  barrier.subresourceRange = range;
+  barrier.oldLayout = vk::ImageLayout::eUndefined;
+  barrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
+  barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+  commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                                vk::PipelineStageFlagBits::eTransfer, {},
+                                nullptr, nullptr, barrier);
+  commandBuffer.clearColorImage(
+      m_pyramidImage, vk::ImageLayout::eTransferDstOptimal,
+      vk::ClearColorValue(std::array<float, 4>{1.0f, 1.0f, 1.0f, 1.0f}),
+      range);
+  barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+  barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+  barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+  barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+  commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                vk::PipelineStageFlagBits::eComputeShader, {},
+                                nullptr, nullptr, barrier);
+  vkutil::EndSingleTimeCommands(m_device, commandPool, queue, commandBuffer);
+
+  // 每级一个归约描述符集：binding 1为上一级，binding 2为当前级
+  m_pyramidSets = m_descriptorPool->AllocateSets(m_pipelines.pyramidSetLayout,
+                                                 m_pyramidLevels);
+  for (uint32_t level = 0; level < m_pyramidLevels; level++) {
+    vk::DescriptorImageInfo source(nullptr,
+                                   m_pyramidMipViews[level ? level - 1 : 0],
+                                   vk::ImageLayout::eGeneral);
+    vk::DescriptorImageInfo destination(nullptr, m_pyramidMipViews[level],
+                                        vk::ImageLayout::eGeneral);
+    std::array<vk::WriteDescriptorSet, 2> writes;
+    writes[0].dstSet = m_pyramidSets[level];
+    writes[0].dstBinding = 1;
+    writes[0].descriptorCount = 1;
+    writes[0].descriptorType = vk::DescriptorType::eStorageImage;
+    writes[0].pImageInfo = &source;
+    writes[1] = writes[0];
+    writes[1].dstBinding = 2;
+    writes[1].pImageInfo = &destination;
+    m_device.updateDescriptorSets(writes, nullptr);
+  }
+
+  // 金字塔与剔除集的binding 7一起更新；旧金字塔的内容不再可信
+  m_cullSetGeneration = 0;
+  m_historyValid = false;
+}
+
+void VKGpuCulling::SetDepthSource(vk::ImageView depthView) {
+  // 渲染图以ComputeSampledRead访问深度，布局为只读深度模板
+  vk::DescriptorImageInfo depthInfo(
+      m_sampler, depthView, vk::ImageLayout::eDepthStencilReadOnlyOptimal);
+  std::vector<vk::WriteDescriptorSet> writes(m_pyramidSets.size());
+  for (size_t level = 0; level < m_pyramidSets.size(); level++) {
+    writes[level].dstSet = m_pyramidSets[level];
+    writes[level].dstBinding = 0;
+    writes[level].descriptorCount = 1;
+    writes[level].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    writes[level].pImageInfo = &depthInfo;
+  }
+  m_device.updateDescriptorSets(writes, nullptr);
+}
+
+void VKGpuCulling::UpdateCullSet(const VKIndirectDrawList& drawList) {
+  std::array<vk::DescriptorBufferInfo, 7> buffers = {
+      vk::DescriptorBufferInfo(m_paramsBuffer, 0, sizeof(CullParams)),
+      drawList.GetCommandDescriptor(),
+      drawList.GetCullDataDescriptor(),
+      vk::DescriptorBufferInfo(m_commandBuffer, 0, m_commandBytes),
+      vk::DescriptorBufferInfo(m_countBuffer, 0, m_countBytes),
+      vk::DescriptorBufferInfo(m_occludedBuffer, 0, m_occludedBytes),
+      vk::DescriptorBufferInfo(m_statsBuffer, 0, sizeof(GpuStats))};
+  using Type = vk::DescriptorType;
+  const std::array<Type, 7> types = {
+      Type::eUniformBufferDynamic, Type::eStorageBufferDynamic,
+      Type::eStorageBufferDynamic, Type::eStorageBuffer,
+      Type::eStorageBuffer,        Type::eStorageBuffer,
+      Type::eStorageBufferDynamic};
+  vk::DescriptorImageInfo pyramidInfo(m_sampler, m_pyramidView,
+                                      vk::ImageLayout::eShaderReadOnlyOptimal);
+
+  std::vector<vk::WriteDescriptorSet> writes(buffers.size() + 1);
+  for (uint32_t i = 0; i < buffers.size(); i++) {
+    writes[i].dstSet = m_cullSet;
+    writes[i].dstBinding = i;
+    writes[i].descriptorCount = 1;
+    writes[i].descriptorType = types[i];
+    writes[i].pBufferInfo = &buffers[i];
+  }
+  writes.back().dstSet = m_cullSet;
+  writes.back().dstBinding = 7;
+  writes.back().descriptorCount = 1;
+  writes.back().descriptorType = Type::eCombinedImageSampler;
+  writes.back().pImageInfo = &pyramidInfo;
+  m_device.updateDescriptorSets(writes, nullptr);
+
+  m_drawListGeneration = drawList.GetGeneration();
+  m_cullSetGeneration = m_generation;
+}
+
+void VKGpuCulling::BeginFrame(uint32_t frameIndex,
+                              const VKIndirectDrawList& drawList,
+                              const glm::mat4& viewProjection) {
+  m_frameIndex = frameIndex;
+  FrameSlot& slot = m_slots[frameIndex];
+
+  // 该槽位上次提交已完成，读回统计后清零
+  auto* stats =
+      reinterpret_cast<GpuStats*>(m_statsMapped + m_statsStride * frameIndex);
+  if (slot.submitted) {
+    m_lastStats.drawCount = slot.drawCount;
+    m_lastStats.frustumCulled = stats->frustumCulled;
+    m_lastStats.visibleEarly = stats->visibleEarly;
+    m_lastStats.visibleLate = stats->visibleLate;
+    m_lastStats.occlusionCulled =
+        stats->occludedEarly - std::min(stats->visibleLate,
+                                        stats->occludedEarly);
+  }
+  std::memset(stats, 0, sizeof(GpuStats));
+
+  // 其余飞行帧仍在使用输出缓冲，扩容前等待设备空闲
+  if (drawList.GetCapacity() > m_capacity) {
+    m_device.waitIdle();
+    DestroyBuffers();
+    CreateBuffers(drawList.GetCapacity());
+    Log::LogMessage(Log::Level::Info, "GPU culling buffers grown to " +
+                                          std::to_string(m_capacity) +
+                                          " draws.");
+  }
+  // 绘制列表扩容时已等待设备空闲，可直接更新描述符集
+  if (m_cullSetGeneration != m_generation ||
+      m_drawListGeneration != drawList.GetGeneration()) {
+    UpdateCullSet(drawList);
+  }
+
+  slot.drawCount = drawList.GetDrawCount();
+  slot.commandOffset = drawList.GetCommandFrameOffset();
+  slot.cullDataOffset = drawList.GetCullDataOffset();
+  slot.submitted = true;
+
+  // 阶段一以上一帧的视图投影查询上一帧金字塔，阶段二使用本帧的
+  CullParams params{};
+  Frustum frustum = Frustum::FromViewProjection(viewProjection);
+  std::copy(std::begin(frustum.planes), std::end(frustum.planes),
+            params.frustumPlanes);
+  params.pyramidSize =
+      glm::vec4(static_cast<float>(m_pyramidExtent.width),
+                static_cast<float>(m_pyramidExtent.height),
+                static_cast<float>(m_pyramidLevels), 0.0f);
+  params.drawCount = slot.drawCount;
+  params.compact = IsCompacting() ? 1 : 0;
+
+  for (uint32_t phase = 0; phase < 2; phase++) {
+    params.phase = phase;
+    params.occlusionViewProjection =
+        phase == 0 ? m_previousViewProjection : viewProjection;
+    params.occlusionEnabled = phase == 0 ? (m_historyValid ? 1 : 0) : 1;
+    params.commandBase = phase * m_capacity;
+    params.countBase = phase * m_capacity;
+    std::memcpy(m_paramsMapped + m_paramsStride * (frameIndex * 2 + phase),
+                &params, sizeof(params));
+  }
+  m_previousViewProjection = viewProjection;
+  m_historyValid = m_pyramidImage != nullptr;
+}
+
+void VKGpuCulling::RecordResetCounts(vk::CommandBuffer commandBuffer) const {
+  commandBuffer.fillBuffer(m_countBuffer, 0, VK_WHOLE_SIZE, 0);
+}
+
+void VKGpuCulling::RecordCull(vk::CommandBuffer commandBuffer,
+                              Phase phase) const {
+  const FrameSlot& slot = m_slots[m_frameIndex];
+  if (slot.drawCount > 0) {
+    uint32_t phaseIndex = static_cast<uint32_t>(phase);
+    // 动态偏移按绑定序号排列：参数、输入命令、包围球、统计
+    std::array<uint32_t, 4> dynamicOffsets = {
+        static_cast<uint32_t>(m_paramsStride * (m_frameIndex * 2 + phaseIndex)),
+        slot.commandOffset, slot.cullDataOffset,
+        static_cast<uint32_t>(m_statsStride * m_frameIndex)};
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute,
+                               m_pipelines.cull);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+                                     m_pipelines.cullLayout, 0, m_cullSet,
+                                     dynamicOffsets);
+    commandBuffer.dispatch(
+        (slot.drawCount + kCullGroupSize - 1) / kCullGroupSize, 1, 1);
+  }
+
+  // 阶段二之后统计不再变化，使其对帧槽位等待后的主机读取可见
+  if (phase == Phase::Late) {
+    vk::MemoryBarrier2 hostBarrier;
+    hostBarrier.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+    hostBarrier.srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite;
+    hostBarrier.dstStageMask = vk::PipelineStageFlagBits2::eHost;
+    hostBarrier.dstAccessMask = vk::AccessFlagBits2::eHostRead;
+    vk::DependencyInfo dependencyInfo;
+    dependencyInfo.memoryBarrierCount = 1;
+    dependencyInfo.pMemoryBarriers = &hostBarrier;
+    commandBuffer.pipelineBarrier2(dependencyInfo);
+  }
+}
+
+void VKGpuCulling::RecordBuildPyramid(vk::CommandBuffer commandBuffer) const {
+  commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute,
+                             m_pipelines.pyramid);
+  for (uint32_t level = 0; level < m_pyramidLevels; level++) {
+    vk::Extent2D source = GetMipExtent(level ? level - 1 : 0);
+    vk::Extent2D destination = GetMipExtent(level);
+    PyramidPushConstants constants{};
+    constants.srcWidth = static_cast<int32_t>(source.width);
+    constants.srcHeight = static_cast<int32_t>(source.height);
+    constants.dstWidth = static_cast<int32_t>(destination.width);
+    constants.dstHeight = static_cast<int32_t>(destination.height);
+    constants.level = level;
+
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+                                     m_pipelines.pyramidLayout, 0,
+                                     m_pyramidSets[level], nullptr);
+    commandBuffer.pushConstants<PyramidPushConstants>(
+        m_pipelines.pyramidLayout, vk::ShaderStageFlagBits::eCompute, 0,
+        constants);
+    commandBuffer.dispatch(
+        (destination.width + kPyramidGroupSize - 1) / kPyramidGroupSize,
+        (destination.height + kPyramidGroupSize - 1) / kPyramidGroupSize, 1);
+
+    // 渲染图只跟踪整张图像，级间依赖在过程内部逐级同步
+    if (level + 1 == m_pyramidLevels) break;
+    vk::ImageMemoryBarrier2 barrier;
+    barrier.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+    barrier.srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite;
+    barrier.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+    barrier.dstAccessMask = vk::AccessFlagBits2::eShaderStorageRead;
+    barrier.oldLayout = vk::ImageLayout::eGeneral;
+    barrier.newLayout = vk::ImageLayout::eGeneral;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = m_pyramidImage;
+    barrier.subresourceRange = vk::ImageSubresourceRange(
+        vk::ImageAspectFlagBits::eColor, level, 1, 0, 1);
+    vk::DependencyInfo dependencyInfo;
+    dependencyInfo.imageMemoryBarrierCount = 1;
+    dependencyInfo.pImageMemoryBarriers = &barrier;
+    commandBuffer.pipelineBarrier2(dependencyInfo);
+  }
+}
+
+void VKGpuCulling::DrawBatch(vk::CommandBuffer commandBuffer, Phase phase,
+                             uint32_t batchIndex,
+                             const VKIndirectDrawList::Batch& batch) const {
+  const uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand);
+  const uint32_t base =
+      static_cast<uint32_t>(phase) * m_capacity;  // 阶段二使用后半部分
+  vk::DeviceSize offset =
+      static_cast<vk::DeviceSize>(base + batch.firstDraw) * stride;
+  if (m_drawIndexedIndirectCount) {
+    vk::DeviceSize countOffset =
+        static_cast<vk::DeviceSize>(base + batchIndex) * sizeof(uint32_t);
+    m_drawIndexedIndirectCount(commandBuffer, m_commandBuffer, offset,
+                               m_countBuffer, countOffset, batch.drawCount,
+                               stride);
+  } else {
+    // 被剔除命令的instanceCount为0，仍按批次提交全部命令
+    commandBuffer.drawIndexedIndirect(m_commandBuffer, offset, batch.drawCount,
+                                      stride);
+  }
+}
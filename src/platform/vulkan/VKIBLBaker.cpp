@@ -0,0 +1,322 @@
+#include "platform/vulkan/VKIBLBaker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <glm/gtc/packing.hpp>
+#include <string>
+#include <utility>
+
+#include "core/Log.hpp"
+#include "utils/vkutil.hpp"
+
+namespace {
+constexpr vk::Format kEnvironmentFormat = vk::Format::eR16G16B16A16Sfloat;
+
+uint32_t GroupCount(uint32_t size) {
+  return (size + VKIBLBaker::kGroupSize - 1) / VKIBLBaker::kGroupSize;
+}
+
+size_t CubeTexelCount(uint32_t size) {
+  return static_cast<size_t>(size) * size * 6;
+}
+}  // namespace
+
+VKIBLBaker::Resources::~Resources() {
+  if (commandBuffer) device.freeCommandBuffers(commandPool, commandBuffer);
+  if (set) descriptorPool->FreeSet(set);
+  if (sampler) device.destroySampler(sampler);
+  if (view) device.destroyImageView(view);
+  if (image) device.destroyImage(image);
+  if (imageMemory) device.freeMemory(imageMemory);
+  if (staging) device.destroyBuffer(staging);
+  if (stagingMemory) device.freeMemory(stagingMemory);
+  if (output) device.destroyBuffer(output);
+  if (outputMemory) device.freeMemory(outputMemory);
+}
+
+VKIBLBaker::VKIBLBaker(vk::Device device, vk::PhysicalDevice physicalDevice,
+                       std::shared_ptr<VKDescriptorPool> descriptorPool,
+                       const Pipelines& pipelines, vk::Queue queue,
+                       vk::CommandPool commandPool)
+    : m_device(device),
+      m_physicalDevice(physicalDevice),
+      m_descriptorPool(std::move(descriptorPool)),
+      m_pipelines(pipelines),
+      m_queue(queue),
+      m_commandPool(commandPool) {}
+
+void VKIBLBaker::CreateOutputBuffer(Resources& resources,
+                                    vk::DeviceSize size) const {
+  vkutil::CreateBuffer(m_device, m_physicalDevice, size,
+                       vk::BufferUsageFlagBits::eStorageBuffer,
+                       vk::MemoryPropertyFlagBits::eHostVisible |
+                           vk::MemoryPropertyFlagBits::eHostCoherent,
+                       resources.output, resources.outputMemory);
+}
+
+void VKIBLBaker::BeginCommands(Resources& resources) const {
+  resources.commandPool = m_commandPool;
+  resources.commandBuffer =
+      vkutil::BeginSingleTimeCommands(m_device, m_commandPool);
+}
+
+void VKIBLBaker::SubmitAndWait(Resources& resources) const {
+  vk::BufferMemoryBarrier barrier;
+  barrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+  barrier.dstAccessMask = vk::AccessFlagBits::eHostRead;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.buffer = resources.output;
+  barrier.offset = 0;
+  barrier.size = VK_WHOLE_SIZE;
+  resources.commandBuffer.pipelineBarrier(
+      vk::PipelineStageFlagBits::eComputeShader,
+      vk::PipelineStageFlagBits::eHost, {}, nullptr, barrier, nullptr);
+
+  vk::CommandBuffer commandBuffer = resources.commandBuffer;
+  resources.commandBuffer = nullptr;
+  vkutil::EndSingleTimeCommands(m_device, m_commandPool, m_queue,
+                                commandBuffer);
+}
+
+void VKIBLBaker::UploadEnvironment(
+    Resources& resources, const std::vector<CubeMipLevel>& environment) const {
+  const uint32_t size = environment[0].size;
+  const uint32_t levels = static_cast<uint32_t>(environment.size());
+
+  // 各级依次紧密排列，同一级的6个面连续（与拷贝区域的层一致）
+  size_t texelCount = 0;
+  for (const auto& level : environment) {
+    texelCount += CubeTexelCount(level.size);
+  }
+  const vk::DeviceSize stagingSize = texelCount * 4 * sizeof(uint16_t);
+  vkutil::CreateBuffer(m_device, m_physicalDevice, stagingSize,
+                       vk::BufferUsageFlagBits::eTransferSrc,
+                       vk::MemoryPropertyFlagBits::eHostVisible |
+                           vk::MemoryPropertyFlagBits::eHostCoherent,
+                       resources.staging, resources.stagingMemory);
+  auto* mapped = static_cast<uint16_t*>(
+      m_device.mapMemory(resources.stagingMemory, 0, stagingSize));
+  std::vector<vk::BufferImageCopy> regions;
+  size_t offset = 0;
+  for (uint32_t mip = 0; mip < levels; mip++) {
+    const CubeMipLevel& level = environment[mip];
+    vk::BufferImageCopy region;
+    region.bufferOffset = offset * sizeof(uint16_t);
+    region.imageSubresource = vk::ImageSubresourceLayers(
+        vk::ImageAspectFlagBits::eColor, mip, 0, 6);
+    region.imageExtent = vk::Extent3D{level.size, level.size, 1};
+    regions.push_back(region);
+    for (float value : level.texels) {
+      mapped[offset++] = glm::packHalf1x16(value);
+    }
+  }
+  m_device.unmapMemory(resources.stagingMemory);
+
+  vk::ImageCreateInfo imageInfo;
+  imageInfo.flags = vk::ImageCreateFlagBits::eCubeCompatible;
+  imageInfo.imageType = vk::ImageType::e2D;
+  imageInfo.format = kEnvironmentFormat;
+  imageInfo.extent = vk::Extent3D{size, size, 1};
+  imageInfo.mipLevels = levels;
+  imageInfo.arrayLayers = 6;
+  imageInfo.samples = vk::SampleCountFlagBits::e1;
+  imageInfo.tiling = vk::ImageTiling::eOptimal;
+  imageInfo.usage =
+      vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+  imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+  resources.image = m_device.createImage(imageInfo);
+
+  vk::MemoryRequirements requirements =
+      m_device.getImageMemoryRequirements(resources.image);
+  vk::MemoryAllocateInfo allocInfo;
+  allocInfo.allocationSize = requirements.size;
+  allocInfo.memoryTypeIndex = vkutil::FindMemoryType(
+      m_physicalDevice, requirements.memoryTypeBits,
+      vk::MemoryPropertyFlagBits::eDeviceLocal);
+  resources.imageMemory = m_device.allocateMemory(allocInfo);
+  m_device.bindImageMemory(resources.image, resources.imageMemory, 0);
+
+  vk::ImageSubresourceRange range(vk::ImageAspectFlagBits::eColor, 0, levels,
+                                  0, 6);
+  vk::ImageViewCreateInfo viewInfo;
+  viewInfo.image = resources.image;
+  viewInfo.viewType = vk::ImageViewType::eCube;
+  viewInfo.format = kEnvironmentFormat;
+  viewInfo.subresourceRange = range;
+  resources.view = m_device.createImageView(viewInfo);
+
+  vk::SamplerCreateInfo samplerInfo;
+  samplerInfo.magFilter = vk::Filter::eLinear;
+  samplerInfo.minFilter = vk::Filter::eLinear;
+  samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
+  samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+  samplerInfo.maxLod = static_cast<float>(levels);
+  resources.sampler = m_device.createSampler(samplerInfo);
+
+  // vkutil::TransitionImageLayout只处理单层，立方体的6层在此转换
+  vk::ImageMemoryBarrier barrier;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = resources.image;
+  barrier.subresourceRange = range;
+  barrier.oldLayout = vk::ImageLayout::eUndefined;
+  barrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
+  barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+  vk::CommandBuffer commandBuffer = resources.commandBuffer;
+  commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe,
+                                vk::PipelineStageFlagBits::eTransfer, {},
+                                nullptr, nullptr, barrier);
+  commandBuffer.copyBufferToImage(resources.staging, resources.image,
+                                  vk::ImageLayout::eTransferDstOptimal,
+                                  regions);
+  barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+  barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+  barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+  barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+  commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                vk::PipelineStageFlagBits::eComputeShader, {},
+                                nullptr, nullptr, barrier);
+}
+
+bool VKIBLBaker::Prefilter(const std::vector<CubeMipLevel>& environment,
+                           const IBLBaker::Settings& settings,
+                           std::vector<CubeMipLevel>& prefiltered) {
+  if (!m_pipelines.prefilter || environment.empty()) return false;
+
+  // 第0级（粗糙度0）即源立方体，其余各级在输出缓冲中依次排列
+  std::vector<CubeMipLevel> result(settings.mipCount);
+  result[0] = environment[0];
+  std::vector<uint32_t> offsets(settings.mipCount, 0);
+  size_t texelCount = 0;
+  for (uint32_t mip = 1; mip < settings.mipCount; mip++) {
+    result[mip].size = std::max(environment[0].size >> mip, 1u);
+    offsets[mip] = static_cast<uint32_t>(texelCount);
+    texelCount += CubeTexelCount(result[mip].size);
+  }
+  if (texelCount == 0) {
+    prefiltered = std::move(result);
+    return true;
+  }
+
+  Resources resources;
+  resources.device = m_device;
+  resources.descriptorPool = m_descriptorPool;
+  try {
+    const vk::DeviceSize outputSize = texelCount * 4 * sizeof(float);
+    CreateOutputBuffer(resources, outputSize);
+    BeginCommands(resources);
+    UploadEnvironment(resources, environment);
+
+    resources.set = m_descriptorPool->AllocateSet(m_pipelines.setLayout);
+    vk::DescriptorImageInfo imageInfo(resources.sampler, resources.view,
+                                      vk::ImageLayout::eShaderReadOnlyOptimal);
+    vk::DescriptorBufferInfo bufferInfo(resources.output, 0, outputSize);
+    std::array<vk::WriteDescriptorSet, 2> writes;
+    writes[0].dstSet = resources.set;
+    writes[0].dstBinding = 0;
+    writes[0].descriptorCount = 1;
+    writes[0].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    writes[0].pImageInfo = &imageInfo;
+    writes[1].dstSet = resources.set;
+    writes[1].dstBinding = 1;
+    writes[1].descriptorCount = 1;
+    writes[1].descriptorType = vk::DescriptorType::eStorageBuffer;
+    writes[1].pBufferInfo = &bufferInfo;
+    m_device.updateDescriptorSets(writes, nullptr);
+
+    vk::CommandBuffer commandBuffer = resources.commandBuffer;
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute,
+                               m_pipelines.prefilter);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+                                     m_pipelines.layout, 0, resources.set,
+                                     nullptr);
+    for (uint32_t mip = 1; mip < settings.mipCount; mip++) {
+      PushConstants constants{};
+      constants.size = result[mip].size;
+      constants.sampleCount = settings.sampleCount;
+      constants.outputOffset = offsets[mip];
+      constants.sourceSize = environment[0].size;
+      constants.roughness = static_cast<float>(mip) /
+                            static_cast<float>(settings.mipCount - 1);
+      constants.sourceMaxLod = static_cast<float>(environment.size() - 1);
+      commandBuffer.pushConstants(m_pipelines.layout,
+                                  vk::ShaderStageFlagBits::eCompute, 0,
+                                  sizeof(constants), &constants);
+      commandBuffer.dispatch(GroupCount(constants.size),
+                             GroupCount(constants.size), 6);
+    }
+    SubmitAndWait(resources);
+
+    const auto* mapped = static_cast<const float*>(
+        m_device.mapMemory(resources.outputMemory, 0, outputSize));
+    for (uint32_t mip = 1; mip < settings.mipCount; mip++) {
+      const float* begin = mapped + static_cast<size_t>(offsets[mip]) * 4;
+      result[mip].texels.assign(
+          begin, begin + CubeTexelCount(result[mip].size) * 4);
+    }
+    m_device.unmapMemory(resources.outputMemory);
+  } catch (const std::exception& err) {
+    Log::LogMessage(Log::Level::Warning,
+                    "Compute IBL prefilter failed, using CPU: " +
+                        std::string(err.what()));
+    return false;
+  }
+  prefiltered = std::move(result);
+  return true;
+}
+
+bool VKIBLBaker::BakeBrdfLut(const IBLBaker::Settings& settings,
+                             std::vector<float>& lut) {
+  if (!m_pipelines.brdfLut) return false;
+
+  const uint32_t size = settings.brdfLutSize;
+  const vk::DeviceSize outputSize =
+      static_cast<vk::DeviceSize>(size) * size * 2 * sizeof(float);
+  Resources resources;
+  resources.device = m_device;
+  resources.descriptorPool = m_descriptorPool;
+  try {
+    CreateOutputBuffer(resources, outputSize);
+    BeginCommands(resources);
+
+    // brdf_lut.comp只使用binding 1，binding 0保持未写入
+    resources.set = m_descriptorPool->AllocateSet(m_pipelines.setLayout);
+    vk::DescriptorBufferInfo bufferInfo(resources.output, 0, outputSize);
+    vk::WriteDescriptorSet write;
+    write.dstSet = resources.set;
+    write.dstBinding = 1;
+    write.descriptorCount = 1;
+    write.descriptorType = vk::DescriptorType::eStorageBuffer;
+    write.pBufferInfo = &bufferInfo;
+    m_device.updateDescriptorSets(write, nullptr);
+
+    PushConstants constants{};
+    constants.size = size;
+    constants.sampleCount = settings.brdfSampleCount;
+    vk::CommandBuffer commandBuffer = resources.commandBuffer;
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute,
+                               m_pipelines.brdfLut);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+                                     m_pipelines.layout, 0, resources.set,
+                                     nullptr);
+    commandBuffer.pushConstants(m_pipelines.layout,
+                                vk::ShaderStageFlagBits::eCompute, 0,
+                                sizeof(constants), &constants);
+    commandBuffer.dispatch(GroupCount(size), GroupCount(size), 1);
+    SubmitAndWait(resources);
+
+    const auto* mapped = static_cast<const float*>(
+        m_device.mapMemory(resources.outputMemory, 0, outputSize));
+    lut.assign(mapped, mapped + static_cast<size_t>(size) * size * 2);
+    m_device.unmapMemory(resources.outputMemory);
+  } catch (const std::exception& err) {
+    Log::LogMessage(Log::Level::Warning,
+                    "Compute BRDF LUT failed, using CPU: " +
+                        std::string(err.what()));
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,151 @@
+#include "platform/vulkan/VKIndirectDrawList.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "core/Log.hpp"
+#include "utils/vkutil.hpp"
+
+VKIndirectDrawList::VKIndirectDrawList(vk::Device device,
+                                       vk::PhysicalDevice physicalDevice,
+                                       uint32_t framesInFlight,
+                                       uint32_t initialCapacity)
+    : m_device(device),
+      m_physicalDevice(physicalDevice),
+      m_framesInFlight(framesInFlight) {
+  m_storageAlignment = std::max<vk::DeviceSize>(
+      physicalDevice.getProperties().limits.minStorageBufferOffsetAlignment,
+      1);
+  CreateBuffers(std::max(initialCapacity, 1u));
+}
+
+VKIndirectDrawList::~VKIndirectDrawList() { DestroyBuffers(); }
+
+void VKIndirectDrawList::CreateBuffers(uint32_t capacity) {
+  auto align = [](vk::DeviceSize size, vk::DeviceSize alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+  };
+  m_capacity = capacity;
+  // 命令区域也以存储缓冲动态偏移绑定，按存储缓冲偏移对齐
+  m_commandFrameBytes = align(
+      capacity * sizeof(vk::DrawIndexedIndirectCommand), m_storageAlignment);
+  m_drawDataFrameBytes =
+      align(capacity * sizeof(DrawData), m_storageAlignment);
+  m_cullDataFrameBytes =
+      align(capacity * sizeof(CullData), m_storageAlignment);
+
+  const auto hostVisible = vk::MemoryPropertyFlagBits::eHostVisible |
+                           vk::MemoryPropertyFlagBits::eHostCoherent;
+  try {
+    vkutil::CreateBuffer(m_device, m_physicalDevice,
+                         m_commandFrameBytes * m_framesInFlight,
+                         vk::BufferUsageFlagBits::eIndirectBuffer |
+                             vk::BufferUsageFlagBits::eStorageBuffer,
+                         hostVisible, m_commandBuffer, m_commandMemory);
+    vkutil::CreateBuffer(m_device, m_physicalDevice,
+                         m_drawDataFrameBytes * m_framesInFlight,
+                         vk::BufferUsageFlagBits::eStorageBuffer, hostVisible,
+                         m_drawDataBuffer, m_drawDataMemory);
+    vkutil::CreateBuffer(m_device, m_physicalDevice,
+                         m_cullDataFrameBytes * m_framesInFlight,
+                         vk::BufferUsageFlagBits::eStorageBuffer, hostVisible,
+                         m_cullDataBuffer, m_cullDataMemory);
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create indirect draw buffers: " +
+                             std::string(err.what()));
+  }
+  m_commandMapped = static_cast<uint8_t*>(m_device.mapMemory(
+      m_commandMemory, 0, m_commandFrameBytes * m_framesInFlight));
+  m_drawDataMapped = static_cast<uint8_t*>(m_device.mapMemory(
+      m_drawDataMemory, 0, m_drawDataFrameBytes * m_framesInFlight));
+  m_cullDataMapped = static_cast<uint8_t*>(m_device.mapMemory(
+      m_cullDataMemory, 0, m_cullDataFrameBytes * m_framesInFlight));
+  m_generation++;
+}
+
+void VKIndirectDrawList::DestroyBuffers() {
+  if (m_commandBuffer) {
+    m_device.unmapMemory(m_commandMemory);
+    m_device.destroyBuffer(m_commandBuffer);
+    m_device.freeMemory(m_commandMemory);
+    m_commandBuffer = nullptr;
+  }
+  if (m_drawDataBuffer) {
+    m_device.unmapMemory(m_drawDataMemory);
+    m_device.destroyBuffer(m_drawDataBuffer);
+    m_device.freeMemory(m_drawDataMemory);
+    m_drawDataBuffer = nullptr;
+  }
+  if (m_cullDataBuffer) {
+    m_device.unmapMemory(m_cullDataMemory);
+    m_device.destroyBuffer(m_cullDataBuffer);
+    m_device.freeMemory(m_cullDataMemory);
+    m_cullDataBuffer = nullptr;
+  }
+}
+
+const std::vector<VKIndirectDrawList::Batch>& VKIndirectDrawList::Build(
+    uint32_t frameIndex, const std::vector<DrawItem>& items,
+    const glm::mat4& viewProjection) {
+  m_frameIndex = frameIndex;
+  m_batches.clear();
+  m_drawCount = static_cast<uint32_t>(items.size());
+  if (items.empty()) return m_batches;
+
+  // 其余飞行帧仍在读取旧缓冲，扩容前等待设备空闲
+  if (m_drawCount > m_capacity) {
+    m_device.waitIdle();
+    DestroyBuffers();
+    CreateBuffers(std::max(m_drawCount, m_capacity * 2));
+    Log::LogMessage(Log::Level::Info,
+                    "Indirect draw list grown to " +
+                        std::to_string(m_capacity) + " draws.");
+  }
+
+  // 按（块, 批次键）排序，相同状态的绘制连续存放
+  m_sortKeys.resize(items.size());
+  for (uint32_t i = 0; i < m_drawCount; i++) {
+    uint64_t key = (static_cast<uint64_t>(items[i].geometry->block) << 32) |
+                   items[i].batchKey;
+    m_sortKeys[i] = {key, i};
+  }
+  std::sort(m_sortKeys.begin(), m_sortKeys.end());
+
+  auto* commands = reinterpret_cast<vk::DrawIndexedIndirectCommand*>(
+      m_commandMapped + m_commandFrameBytes * frameIndex);
+  auto* drawData = reinterpret_cast<DrawData*>(
+      m_drawDataMapped + m_drawDataFrameBytes * frameIndex);
+  auto* cullData = reinterpret_cast<CullData*>(
+      m_cullDataMapped + m_cullDataFrameBytes * frameIndex);
+
+  const auto path = ObjectTransforms::GetBestPath();
+  for (uint32_t i = 0; i < m_drawCount; i++) {
+    const DrawItem& item = items[m_sortKeys[i].second];
+    const VKGeometryPool::Allocation& geometry = *item.geometry;
+
+    vk::DrawIndexedIndirectCommand command;
+    command.indexCount = geometry.indexCount;
+    command.instanceCount = 1;
+    command.firstIndex = geometry.firstIndex;
+    command.vertexOffset = geometry.vertexOffset;
+    command.firstInstance = i;  // gl_InstanceIndex即逐绘制数据索引
+    commands[i] = command;
+
+    ObjectTransforms::Compute(viewProjection, *item.transform,
+                              drawData[i].transform, path);
+    drawData[i].materialIndex = item.materialIndex;
+
+    if (m_batches.empty() || m_batches.back().block != geometry.block ||
+        m_batches.back().batchKey != item.batchKey) {
+      m_batches.push_back({geometry.block, item.batchKey, i, 0});
+    }
+    m_batches.back().drawCount++;
+
+    cullData[i].sphere = item.bounds;
+    cullData[i].batch = static_cast<uint32_t>(m_batches.size() - 1);
+    cullData[i].batchFirstDraw = m_batches.back().firstDraw;
+  }
+  return m_batches;
+}
@@ -0,0 +1,98 @@
+#include "platform/vulkan/VKMaterialTable.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "utils/vkutil.hpp"
+
+VKMaterialTable::VKMaterialTable(vk::Device device,
+                                 vk::PhysicalDevice physicalDevice,
+                                 uint32_t framesInFlight, uint32_t capacity)
+    : m_device(device),
+      m_framesInFlight(std::max(framesInFlight, 1u)),
+      m_capacity(std::max(capacity, 1u)) {
+  m_records.reserve(m_capacity);
+  try {
+    vkutil::CreateBuffer(m_device, physicalDevice, GetSize(),
+                         vk::BufferUsageFlagBits::eStorageBuffer |
+                             vk::BufferUsageFlagBits::eTransferDst,
+                         vk::MemoryPropertyFlagBits::eDeviceLocal, m_buffer,
+                         m_memory);
+    // 每帧的暂存区域可容纳整张表，脏区间再大也只需一次复制
+    vkutil::CreateBuffer(m_device, physicalDevice,
+                         GetSize() * m_framesInFlight,
+                         vk::BufferUsageFlagBits::eTransferSrc,
+                         vk::MemoryPropertyFlagBits::eHostVisible |
+                             vk::MemoryPropertyFlagBits::eHostCoherent,
+                         m_stagingBuffer, m_stagingMemory);
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create material table: " +
+                             std::string(err.what()));
+  }
+  m_stagingMapped = static_cast<uint8_t*>(
+      m_device.mapMemory(m_stagingMemory, 0, GetSize() * m_framesInFlight));
+}
+
+VKMaterialTable::~VKMaterialTable() {
+  if (m_stagingMapped) m_device.unmapMemory(m_stagingMemory);
+  if (m_stagingBuffer) m_device.destroyBuffer(m_stagingBuffer);
+  if (m_stagingMemory) m_device.freeMemory(m_stagingMemory);
+  if (m_buffer) m_device.destroyBuffer(m_buffer);
+  if (m_memory) m_device.freeMemory(m_memory);
+}
+
+uint32_t VKMaterialTable::Add(const Record& record) {
+  if (m_records.size() >= m_capacity) {
+    throw std::runtime_error("Material table is full");
+  }
+  m_records.push_back(record);
+  uint32_t index = static_cast<uint32_t>(m_records.size() - 1);
+  MarkDirty(index);
+  return index;
+}
+
+void VKMaterialTable::Update(uint32_t index, const Record& record) {
+  m_records[index] = record;
+  MarkDirty(index);
+}
+
+void VKMaterialTable::UpdateTextureIndices(
+    uint32_t index,
+    const std::array<uint32_t, MaterialFeatures::kSlotCount>& indices) {
+  std::copy(indices.begin(), indices.end(),
+            m_records[index].textureIndices);
+  MarkDirty(index);
+}
+
+void VKMaterialTable::MarkDirty(uint32_t index) {
+  if (!HasPendingUpload()) {
+    m_dirtyBegin = index;
+    m_dirtyEnd = index + 1;
+    return;
+  }
+  m_dirtyBegin = std::min(m_dirtyBegin, index);
+  m_dirtyEnd = std::max(m_dirtyEnd, index + 1);
+}
+
+void VKMaterialTable::RecordUpload(vk::CommandBuffer commandBuffer,
+                                   uint32_t frameIndex) {
+  if (!HasPendingUpload()) return;
+
+  const vk::DeviceSize offset = m_dirtyBegin * sizeof(Record);
+  const vk::DeviceSize size = (m_dirtyEnd - m_dirtyBegin) * sizeof(Record);
+  const vk::DeviceSize stagingOffset =
+      GetSize() * (frameIndex % m_framesInFlight) + offset;
+  std::memcpy(m_stagingMapped + stagingOffset, &m_records[m_dirtyBegin],
+              size);
+
+  vk::BufferCopy region;
+  region.srcOffset = stagingOffset;
+  region.dstOffset = offset;
+  region.size = size;
+  commandBuffer.copyBuffer(m_stagingBuffer, m_buffer, region);
+
+  m_uploadedBytes += size;
+  m_dirtyBegin = m_dirtyEnd = 0;
+}
@@ -0,0 +1,328 @@
+#include "platform/vulkan/VKMipGenerator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "utils/vkutil.hpp"
+
+namespace {
+// 与mip_downsample.comp的mode一致
+constexpr uint32_t kModeLinear = 0;
+constexpr uint32_t kModeSrgb = 1;
+constexpr uint32_t kModeNormal = 2;
+
+// 计算路径以RGBA8 UNORM视图读写（通道顺序对逐通道滤波无影响）
+constexpr vk::Format kStorageFormat = vk::Format::eR8G8B8A8Unorm;
+
+bool IsFourByteColor(vk::Format format) {
+  switch (format) {
+    case vk::Format::eR8G8B8A8Unorm:
+    case vk::Format::eR8G8B8A8Srgb:
+    case vk::Format::eB8G8R8A8Unorm:
+    case vk::Format::eB8G8R8A8Srgb:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsSrgbFormat(vk::Format format) {
+  return format == vk::Format::eR8G8B8A8Srgb ||
+         format == vk::Format::eB8G8R8A8Srgb;
+}
+
+vk::ImageMemoryBarrier LevelBarrier(vk::Image image, uint32_t baseLevel,
+                                    uint32_t levelCount,
+                                    vk::ImageLayout oldLayout,
+                                    vk::ImageLayout newLayout,
+                                    vk::AccessFlags srcAccess,
+                                    vk::AccessFlags dstAccess) {
+  vk::ImageMemoryBarrier barrier;
+  barrier.srcAccessMask = srcAccess;
+  barrier.dstAccessMask = dstAccess;
+  barrier.oldLayout = oldLayout;
+  barrier.newLayout = newLayout;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = image;
+  barrier.subresourceRange = vk::ImageSubresourceRange(
+      vk::ImageAspectFlagBits::eColor, baseLevel, levelCount, 0, 1);
+  return barrier;
+}
+
+int32_t MipExtent(uint32_t size, uint32_t level) {
+  return static_cast<int32_t>(std::max(size >> level, 1u));
+}
+}  // namespace
+
+VKMipGenerator::VKMipGenerator(
+    vk::Device device, vk::PhysicalDevice physicalDevice,
+    std::shared_ptr<VKDescriptorPool> descriptorPool,
+    const Pipelines& pipelines)
+    : m_device(device),
+      m_physicalDevice(physicalDevice),
+      m_descriptorPool(std::move(descriptorPool)),
+      m_pipelines(pipelines) {}
+
+VKMipGenerator::~VKMipGenerator() { ReleaseBatch(); }
+
+bool VKMipGenerator::SupportsCompute(vk::Format format) const {
+  if (!m_pipelines.downsample || !IsFourByteColor(format)) return false;
+  vk::FormatProperties properties =
+      m_physicalDevice.getFormatProperties(kStorageFormat);
+  return static_cast<bool>(properties.optimalTilingFeatures &
+                           vk::FormatFeatureFlagBits::eStorageImage);
+}
+
+VKMipGenerator::Plan VKMipGenerator::PlanFor(const Texture& texture,
+                                             vk::Format format) const {
+  Plan plan;
+  const uint32_t fullLevels =
+      static_cast<uint32_t>(texture.GetFullMipLevels());
+  if (fullLevels <= 1) return plan;
+
+  vk::FormatFeatureFlags features =
+      m_physicalDevice.getFormatProperties(format).optimalTilingFeatures;
+  const bool blit = (features & vk::FormatFeatureFlagBits::eBlitSrc) &&
+                    (features & vk::FormatFeatureFlagBits::eBlitDst);
+  const bool linear = static_cast<bool>(
+      features & vk::FormatFeatureFlagBits::eSampledImageFilterLinear);
+  const bool compute = SupportsCompute(format) &&
+                       fullLevels <= kMaxComputeLevels;
+
+  // 法线贴图优先走计算路径以重新归一化，其次是线性blit
+  if (compute && (texture.type == TextureType::Normal || !(blit && linear))) {
+    plan.method = Method::Compute;
+    plan.usage = vk::ImageUsageFlagBits::eStorage;
+    // 以UNORM视图写入sRGB/BGRA图像，且允许图像本身的格式不支持存储
+    if (format != kStorageFormat) {
+      plan.flags = vk::ImageCreateFlagBits::eMutableFormat |
+                   vk::ImageCreateFlagBits::eExtendedUsage;
+    }
+  } else if (blit) {
+    plan.method = Method::Blit;
+    plan.usage = vk::ImageUsageFlagBits::eTransferSrc;
+  } else {
+    return plan;
+  }
+  plan.mipLevels = fullLevels;
+  return plan;
+}
+
+void VKMipGenerator::Enqueue(vk::Image image, vk::Format format,
+                             const Texture& texture, const Plan& plan) {
+  if (plan.method == Method::None) return;
+  Job job;
+  job.image = image;
+  job.format = format;
+  job.width = static_cast<uint32_t>(texture.width);
+  job.height = static_cast<uint32_t>(texture.height);
+  job.mipLevels = plan.mipLevels;
+  job.method = plan.method;
+  job.mode = texture.type == TextureType::Normal ? kModeNormal
+             : IsSrgbFormat(format)              ? kModeSrgb
+                                                 : kModeLinear;
+  m_jobs.push_back(job);
+}
+
+void VKMipGenerator::Record(vk::CommandBuffer commandBuffer) {
+  std::vector<const Job*> blits;
+  std::vector<const Job*> computes;
+  for (const Job& job : m_jobs) {
+    (job.method == Method::Compute ? computes : blits).push_back(&job);
+  }
+  try {
+    if (!blits.empty()) RecordBlits(commandBuffer, blits);
+    if (!computes.empty()) RecordCompute(commandBuffer, computes);
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to record mip generation: " +
+                             std::string(err.what()));
+  }
+  m_jobs.clear();
+}
+
+void VKMipGenerator::RecordBlits(vk::CommandBuffer commandBuffer,
+                                 const std::vector<const Job*>& jobs) {
+  uint32_t maxLevels = 0;
+  for (const Job* job : jobs) maxLevels = std::max(maxLevels, job->mipLevels);
+
+  // 逐级推进，同一级的屏障与blit对全部纹理合并录制
+  std::vector<vk::ImageMemoryBarrier> barriers;
+  for (uint32_t level = 1; level < maxLevels; level++) {
+    barriers.clear();
+    for (const Job* job : jobs) {
+      if (level >= job->mipLevels) continue;
+      barriers.push_back(LevelBarrier(
+          job->image, level - 1, 1, vk::ImageLayout::eTransferDstOptimal,
+          vk::ImageLayout::eTransferSrcOptimal,
+          vk::AccessFlagBits::eTransferWrite,
+          vk::AccessFlagBits::eTransferRead));
+    }
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                  vk::PipelineStageFlagBits::eTransfer, {},
+                                  nullptr, nullptr, barriers);
+
+    for (const Job* job : jobs) {
+      if (level >= job->mipLevels) continue;
+      vk::FormatFeatureFlags features =
+          m_physicalDevice.getFormatProperties(job->format)
+              .optimalTilingFeatures;
+      vk::Filter filter =
+          features & vk::FormatFeatureFlagBits::eSampledImageFilterLinear
+              ? vk::Filter::eLinear
+              : vk::Filter::eNearest;
+      vk::ImageBlit region;
+      region.srcSubresource = vk::ImageSubresourceLayers(
+          vk::ImageAspectFlagBits::eColor, level - 1, 0, 1);
+      region.srcOffsets[1] = vk::Offset3D(MipExtent(job->width, level - 1),
+                                          MipExtent(job->height, level - 1),
+                                          1);
+      region.dstSubresource = vk::ImageSubresourceLayers(
+          vk::ImageAspectFlagBits::eColor, level, 0, 1);
+      region.dstOffsets[1] = vk::Offset3D(MipExtent(job->width, level),
+                                          MipExtent(job->height, level), 1);
+      commandBuffer.blitImage(job->image, vk::ImageLayout::eTransferSrcOptimal,
+                              job->image, vk::ImageLayout::eTransferDstOptimal,
+                              region, filter);
+    }
+  }
+
+  // 源级处于TransferSrc，最后一级仍处于TransferDst
+  barriers.clear();
+  for (const Job* job : jobs) {
+    barriers.push_back(LevelBarrier(
+        job->image, 0, job->mipLevels - 1,
+        vk::ImageLayout::eTransferSrcOptimal,
+        vk::ImageLayout::eShaderReadOnlyOptimal,
+        vk::AccessFlagBits::eTransferRead, vk::AccessFlagBits::eShaderRead));
+    barriers.push_back(LevelBarrier(
+        job->image, job->mipLevels - 1, 1,
+        vk::ImageLayout::eTransferDstOptimal,
+        vk::ImageLayout::eShaderReadOnlyOptimal,
+        vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead));
+  }
+  commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                vk::PipelineStageFlagBits::eFragmentShader, {},
+                                nullptr, nullptr, barriers);
+}
+
+void VKMipGenerator::RecordCompute(vk::CommandBuffer commandBuffer,
+                                   const std::vector<const Job*>& jobs) {
+  // 每张纹理一个完成计数器，录制前清零
+  const vk::DeviceSize counterBytes = sizeof(uint32_t) * jobs.size();
+  vkutil::CreateBuffer(m_device, m_physicalDevice, counterBytes,
+                       vk::BufferUsageFlagBits::eStorageBuffer |
+                           vk::BufferUsageFlagBits::eTransferDst,
+                       vk::MemoryPropertyFlagBits::eDeviceLocal,
+                       m_counterBuffer, m_counterMemory);
+  commandBuffer.fillBuffer(m_counterBuffer, 0, counterBytes, 0);
+
+  vk::BufferMemoryBarrier counterBarrier;
+  counterBarrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+  counterBarrier.dstAccessMask =
+      vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
+  counterBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  counterBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  counterBarrier.buffer = m_counterBuffer;
+  counterBarrier.offset = 0;
+  counterBarrier.size = VK_WHOLE_SIZE;
+
+  std::vector<vk::ImageMemoryBarrier> barriers;
+  for (const Job* job : jobs) {
+    barriers.push_back(LevelBarrier(
+        job->image, 0, job->mipLevels, vk::ImageLayout::eTransferDstOptimal,
+        vk::ImageLayout::eGeneral, vk::AccessFlagBits::eTransferWrite,
+        vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite));
+  }
+  commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                vk::PipelineStageFlagBits::eComputeShader, {},
+                                nullptr, counterBarrier, barriers);
+
+  commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute,
+                             m_pipelines.downsample);
+  for (uint32_t j = 0; j < jobs.size(); j++) {
+    const Job& job = *jobs[j];
+    // 每级一个单级存储视图，超出级数的数组元素重复最后一级（不会被访问）
+    std::array<vk::DescriptorImageInfo, kMaxComputeLevels> imageInfos;
+    for (uint32_t level = 0; level < kMaxComputeLevels; level++) {
+      if (level < job.mipLevels) {
+        vk::ImageViewCreateInfo viewInfo;
+        viewInfo.image = job.image;
+        viewInfo.viewType = vk::ImageViewType::e2D;
+        viewInfo.format = kStorageFormat;
+        viewInfo.subresourceRange = vk::ImageSubresourceRange(
+            vk::ImageAspectFlagBits::eColor, level, 1, 0, 1);
+        m_views.push_back(m_device.createImageView(viewInfo));
+      }
+      imageInfos[level] = vk::DescriptorImageInfo(
+          nullptr, m_views.back(), vk::ImageLayout::eGeneral);
+    }
+    vk::DescriptorBufferInfo counterInfo(m_counterBuffer, 0, VK_WHOLE_SIZE);
+
+    vk::DescriptorSet set = m_descriptorPool->AllocateSet(
+        m_pipelines.setLayout);
+    m_sets.push_back(set);
+    std::array<vk::WriteDescriptorSet, 2> writes;
+    writes[0].dstSet = set;
+    writes[0].dstBinding = 0;
+    writes[0].descriptorCount = kMaxComputeLevels;
+    writes[0].descriptorType = vk::DescriptorType::eStorageImage;
+    writes[0].pImageInfo = imageInfos.data();
+    writes[1].dstSet = set;
+    writes[1].dstBinding = 1;
+    writes[1].descriptorCount = 1;
+    writes[1].descriptorType = vk::DescriptorType::eStorageBuffer;
+    writes[1].pBufferInfo = &counterInfo;
+    m_device.updateDescriptorSets(writes, nullptr);
+
+    const uint32_t groupsX =
+        (MipExtent(job.width, 1) + kTileSize - 1) / kTileSize;
+    const uint32_t groupsY =
+        (MipExtent(job.height, 1) + kTileSize - 1) / kTileSize;
+    PushConstants push;
+    push.width = static_cast<int32_t>(job.width);
+    push.height = static_cast<int32_t>(job.height);
+    push.levelCount = job.mipLevels;
+    push.mode = job.mode;
+    push.groupCount = groupsX * groupsY;
+    push.counterIndex = j;
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+                                     m_pipelines.layout, 0, set, nullptr);
+    commandBuffer.pushConstants(m_pipelines.layout,
+                                vk::ShaderStageFlagBits::eCompute, 0,
+                                sizeof(PushConstants), &push);
+    commandBuffer.dispatch(groupsX, groupsY, 1);
+  }
+
+  barriers.clear();
+  for (const Job* job : jobs) {
+    barriers.push_back(LevelBarrier(
+        job->image, 0, job->mipLevels, vk::ImageLayout::eGeneral,
+        vk::ImageLayout::eShaderReadOnlyOptimal,
+        vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eShaderRead));
+  }
+  commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                                vk::PipelineStageFlagBits::eFragmentShader, {},
+                                nullptr, nullptr, barriers);
+}
+
+void VKMipGenerator::ReleaseBatch() { DetachBatch()(); }
+
+std::function<void()> VKMipGenerator::DetachBatch() {
+  auto release = [device = m_device, pool = m_descriptorPool,
+                  sets = std::move(m_sets), views = std::move(m_views),
+                  buffer = m_counterBuffer, memory = m_counterMemory]() {
+    for (vk::DescriptorSet set : sets) pool->FreeSet(set);
+    for (vk::ImageView view : views) device.destroyImageView(view);
+    if (buffer) device.destroyBuffer(buffer);
+    if (memory) device.freeMemory(memory);
+  };
+  m_sets.clear();
+  m_views.clear();
+  m_counterBuffer = nullptr;
+  m_counterMemory = nullptr;
+  return release;
+}
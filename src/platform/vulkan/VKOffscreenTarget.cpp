@@ -0,0 +1,85 @@
+#include "platform/vulkan/VKOffscreenTarget.hpp"
+
+#include "utils/ImageWriter.hpp"
+#include "utils/vkutil.hpp"
+
+VKOffscreenTarget::VKOffscreenTarget(vk::Device device,
+                                     vk::PhysicalDevice physicalDevice,
+                                     vk::Extent2D extent,
+                                     FileFormat fileFormat,
+                                     uint32_t slotCount)
+    : m_device(device),
+      m_extent(extent),
+      m_format(GetFormatFor(fileFormat)),
+      m_fileFormat(fileFormat) {
+  const vk::DeviceSize bytesPerPixel = fileFormat == FileFormat::PNG ? 4 : 8;
+  m_readbackSize = bytesPerPixel * extent.width * extent.height;
+
+  m_slots.resize(slotCount);
+  for (auto& slot : m_slots) {
+    vk::ImageCreateInfo imageInfo;
+    imageInfo.imageType = vk::ImageType::e2D;
+    imageInfo.format = m_format;
+    imageInfo.extent = vk::Extent3D{extent.width, extent.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = vk::SampleCountFlagBits::e1;
+    imageInfo.tiling = vk::ImageTiling::eOptimal;
+    imageInfo.usage = vk::ImageUsageFlagBits::eColorAttachment |
+                      vk::ImageUsageFlagBits::eTransferDst |
+                      vk::ImageUsageFlagBits::eTransferSrc;
+    imageInfo.sharingMode = vk::SharingMode::eExclusive;
+    imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+    slot.image = m_device.createImage(imageInfo);
+
+    vk::MemoryRequirements requirements =
+        m_device.getImageMemoryRequirements(slot.image);
+    vk::MemoryAllocateInfo allocInfo;
+    allocInfo.allocationSize = requirements.size;
+    allocInfo.memoryTypeIndex = vkutil::FindMemoryType(
+        physicalDevice, requirements.memoryTypeBits,
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+    slot.imageMemory = m_device.allocateMemory(allocInfo);
+    m_device.bindImageMemory(slot.image, slot.imageMemory, 0);
+
+    vk::ImageViewCreateInfo viewInfo;
+    viewInfo.image = slot.image;
+    viewInfo.viewType = vk::ImageViewType::e2D;
+    viewInfo.format = m_format;
+    viewInfo.subresourceRange = {vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1};
+    slot.view = m_device.createImageView(viewInfo);
+
+    vkutil::CreateBuffer(m_device, physicalDevice, m_readbackSize,
+                         vk::BufferUsageFlagBits::eTransferDst,
+                         vk::MemoryPropertyFlagBits::eHostVisible |
+                             vk::MemoryPropertyFlagBits::eHostCoherent,
+                         slot.readbackBuffer, slot.readbackMemory);
+    slot.mapped = m_device.mapMemory(slot.readbackMemory, 0, m_readbackSize);
+  }
+}
+
+VKOffscreenTarget::~VKOffscreenTarget() {
+  for (auto& slot : m_slots) {
+    m_device.unmapMemory(slot.readbackMemory);
+    m_device.destroyBuffer(slot.readbackBuffer);
+    m_device.freeMemory(slot.readbackMemory);
+    m_device.destroyImageView(slot.view);
+    m_device.destroyImage(slot.image);
+    m_device.freeMemory(slot.imageMemory);
+  }
+}
+
+vk::Format VKOffscreenTarget::GetFormatFor(FileFormat fileFormat) {
+  return fileFormat == FileFormat::PNG ? vk::Format::eR8G8B8A8Unorm
+                                       : vk::Format::eR16G16B16A16Sfloat;
+}
+
+bool VKOffscreenTarget::Save(uint32_t slot, const std::string& path) const {
+  const void* data = m_slots[slot].mapped;
+  if (m_fileFormat == FileFormat::PNG) {
+    return ImageWriter::WritePNG(path, m_extent.width, m_extent.height,
+                                 static_cast<const uint8_t*>(data));
+  }
+  return ImageWriter::WriteEXR(path, m_extent.width, m_extent.height,
+                               static_cast<const uint16_t*>(data));
+}
@@ -0,0 +1,119 @@
+#include "platform/vulkan/VKParallelRecorder.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <stdexcept>
+
+VKParallelRecorder::VKParallelRecorder(vk::Device device,
+                                       uint32_t queueFamilyIndex,
+                                       uint32_t framesInFlight,
+                                       uint32_t threadCount)
+    : m_device(device),
+      m_threadCount(threadCount > 0 ? threadCount
+                                    : ThreadPool::HardwareConcurrency()) {
+  // 不设置eResetCommandBuffer：命令缓冲只随命令池整体重置
+  vk::CommandPoolCreateInfo poolInfo;
+  poolInfo.flags = vk::CommandPoolCreateFlagBits::eTransient;
+  poolInfo.queueFamilyIndex = queueFamilyIndex;
+
+  m_frames.resize(framesInFlight);
+  for (auto& threads : m_frames) {
+    threads.resize(m_threadCount);
+    for (auto& data : threads) {
+      try {
+        data.pool = m_device.createCommandPool(poolInfo);
+      } catch (const vk::SystemError& err) {
+        throw std::runtime_error("Failed to create recording command pool: " +
+                                 std::string(err.what()));
+      }
+    }
+  }
+
+  if (m_threadCount > 1) {
+    m_threadPool = std::make_unique<ThreadPool>(m_threadCount - 1);
+  }
+}
+
+VKParallelRecorder::~VKParallelRecorder() {
+  m_threadPool.reset();
+  for (auto& threads : m_frames) {
+    for (auto& data : threads) {
+      // 销毁命令池会同时释放其中的命令缓冲
+      m_device.destroyCommandPool(data.pool);
+    }
+  }
+}
+
+void VKParallelRecorder::BeginFrame(uint32_t frameIndex) {
+  for (auto& data : m_frames[frameIndex]) {
+    m_device.resetCommandPool(data.pool);
+    data.usedBuffers = 0;
+  }
+}
+
+vk::CommandBuffer VKParallelRecorder::AcquireBuffer(ThreadFrameData& data) {
+  if (data.usedBuffers == data.buffers.size()) {
+    vk::CommandBufferAllocateInfo allocInfo;
+    allocInfo.commandPool = data.pool;
+    allocInfo.level = vk::CommandBufferLevel::eSecondary;
+    allocInfo.commandBufferCount = 1;
+    data.buffers.push_back(m_device.allocateCommandBuffers(allocInfo)[0]);
+  }
+  return data.buffers[data.usedBuffers++];
+}
+
+std::vector<vk::CommandBuffer> VKParallelRecorder::Record(
+    uint32_t frameIndex, uint32_t itemCount,
+    const vk::CommandBufferInheritanceInfo& inheritance,
+    const RecordFunc& record, uint32_t threadCount) {
+  if (threadCount == 0 || threadCount > m_threadCount) {
+    threadCount = m_threadCount;
+  }
+  uint32_t chunkCount = std::clamp(
+      (itemCount + kMinItemsPerChunk - 1) / kMinItemsPerChunk, 1u,
+      threadCount);
+  uint32_t chunkSize = (itemCount + chunkCount - 1) / chunkCount;
+
+  // 命令缓冲在调用线程上按区间顺序分配，保证拼接顺序确定
+  auto& threads = m_frames[frameIndex];
+  std::vector<vk::CommandBuffer> buffers(chunkCount);
+  for (uint32_t i = 0; i < chunkCount; i++) {
+    buffers[i] = AcquireBuffer(threads[i]);
+  }
+
+  auto recordChunk = [&](uint32_t chunk) {
+    uint32_t begin = std::min(chunk * chunkSize, itemCount);
+    uint32_t end = std::min(begin + chunkSize, itemCount);
+
+    vk::CommandBufferBeginInfo beginInfo;
+    beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit |
+                      vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+    beginInfo.pInheritanceInfo = &inheritance;
+    buffers[chunk].begin(beginInfo);
+    record(buffers[chunk], begin, end);
+    buffers[chunk].end();
+  };
+
+  std::vector<std::future<void>> futures;
+  futures.reserve(chunkCount);
+  for (uint32_t i = 0; i + 1 < chunkCount; i++) {
+    futures.push_back(m_threadPool->Submit([&, i]() { recordChunk(i); }));
+  }
+  // 任务引用了本函数的局部变量，出错时也要等待全部任务结束
+  std::exception_ptr error;
+  try {
+    recordChunk(chunkCount - 1);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  for (auto& future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) error = std::current_exception();
+    }
+  }
+  if (error) std::rethrow_exception(error);
+  return buffers;
+}
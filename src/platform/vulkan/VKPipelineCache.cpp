@@ -0,0 +1,339 @@
+#include "platform/vulkan/VKPipelineCache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+
+#include "core/Log.hpp"
+#include "core/Timer.hpp"
+
+namespace {
+// FNV-1a 64位，结果与进程无关
+class Fnv1a {
+ public:
+  void Mix(const void* bytes, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(bytes);
+    for (size_t i = 0; i < size; i++) {
+      m_hash ^= p[i];
+      m_hash *= 0x100000001b3ull;
+    }
+  }
+  void Mix(uint64_t value) { Mix(&value, sizeof(value)); }
+  template <typename T>
+  void MixHandle(T handle) {
+    Mix((uint64_t)(static_cast<typename T::CType>(handle)));
+  }
+  uint64_t Get() const { return m_hash; }
+
+ private:
+  uint64_t m_hash = 0xcbf29ce484222325ull;
+};
+
+void MixCompatibility(Fnv1a& hash,
+                      const VKPipelineCache::GraphicsDesc& desc) {
+  hash.MixHandle(desc.layout);
+  hash.Mix(desc.colorFormats.size());
+  for (vk::Format format : desc.colorFormats) {
+    hash.Mix(static_cast<uint64_t>(format));
+  }
+  hash.Mix(static_cast<uint64_t>(desc.depthFormat));
+  for (const auto& binding : desc.vertexBindings) {
+    hash.Mix(binding.binding);
+    hash.Mix(binding.stride);
+    hash.Mix(static_cast<uint64_t>(binding.inputRate));
+  }
+  for (const auto& attribute : desc.vertexAttributes) {
+    hash.Mix(attribute.location);
+    hash.Mix(attribute.binding);
+    hash.Mix(static_cast<uint64_t>(attribute.format));
+    hash.Mix(attribute.offset);
+  }
+}
+}  // namespace
+
+uint64_t VKPipelineCache::GraphicsDesc::Hash() const {
+  Fnv1a hash;
+  MixCompatibility(hash, *this);
+  // 有内容哈希时相同代码的不同模块共用管线（如重新加载的着色器）
+  hash.Mix(shaderHash);
+  if (shaderHash == 0) {
+    hash.MixHandle(vertexModule);
+    hash.MixHandle(fragmentModule);
+  }
+  for (const auto& entry : specializationEntries) {
+    hash.Mix(entry.constantID);
+    hash.Mix(entry.offset);
+    hash.Mix(entry.size);
+  }
+  hash.Mix(specializationData.data(), specializationData.size());
+  hash.Mix(static_cast<uint64_t>(topology));
+  hash.Mix(static_cast<uint64_t>(static_cast<uint32_t>(cullMode)));
+  hash.Mix(static_cast<uint64_t>(frontFace));
+  hash.Mix(depthTest);
+  hash.Mix(depthWrite);
+  hash.Mix(static_cast<uint64_t>(depthCompare));
+  hash.Mix(blendEnable);
+  return hash.Get();
+}
+
+uint64_t VKPipelineCache::GraphicsDesc::CompatibilityHash() const {
+  Fnv1a hash;
+  MixCompatibility(hash, *this);
+  return hash.Get();
+}
+
+VKPipelineCache::VKPipelineCache(vk::Device device, uint32_t threadCount)
+    : m_device(device) {
+  try {
+    m_driverCache = m_device.createPipelineCache({});
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create pipeline cache: " +
+                             std::string(err.what()));
+  }
+  if (threadCount == 0) {
+    threadCount = std::max(ThreadPool::HardwareConcurrency() / 2, 1u);
+  }
+  m_threadPool = std::make_unique<ThreadPool>(threadCount);
+}
+
+VKPipelineCache::~VKPipelineCache() {
+  m_threadPool.reset();
+  for (auto& [key, entry] : m_entries) {
+    if (entry.pipeline) m_device.destroyPipeline(entry.pipeline);
+  }
+  if (m_driverCache) m_device.destroyPipelineCache(m_driverCache);
+}
+
+bool VKPipelineCache::Register(uint64_t key, const GraphicsDesc& desc) {
+  auto [it, inserted] = m_entries.try_emplace(key);
+  if (inserted) {
+    it->second.compatibility = desc.CompatibilityHash();
+    it->second.servesAsFallback = desc.servesAsFallback;
+  }
+  return inserted;
+}
+
+void VKPipelineCache::SubmitCompile(uint64_t key, const GraphicsDesc& desc) {
+  // 描述按值捕获，特化数据在编译期间保持有效
+  m_threadPool->Submit([this, key, desc]() {
+    Timer timer;
+    vk::Pipeline pipeline;
+    try {
+      pipeline = Compile(desc);
+    } catch (const std::exception& err) {
+      Log::LogMessage(Log::Level::Warning,
+                      "Background pipeline compilation failed: " +
+                          std::string(err.what()));
+    }
+    Complete(key, pipeline, timer.ElapsedMilliseconds());
+  });
+}
+
+void VKPipelineCache::Complete(uint64_t key, vk::Pipeline pipeline,
+                               double elapsedMs) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry& entry = m_entries[key];
+    entry.pipeline = pipeline;
+    entry.state = pipeline ? State::Ready : State::Failed;
+    if (pipeline) {
+      if (entry.servesAsFallback) {
+        m_latestCompatible[entry.compatibility] = pipeline;
+      }
+      m_stats.compiled++;
+    }
+    m_stats.compileMs += elapsedMs;
+  }
+  m_completed.notify_all();
+}
+
+vk::Pipeline VKPipelineCache::Acquire(const GraphicsDesc& desc,
+                                      bool allowCompatible) {
+  const uint64_t key = desc.Hash();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (Register(key, desc)) SubmitCompile(key, desc);
+  const Entry& entry = m_entries[key];
+  if (entry.state == State::Ready) return entry.pipeline;
+  // 调用方自行回退，不计入统计
+  if (!allowCompatible) return nullptr;
+
+  auto fallback = m_latestCompatible.find(entry.compatibility);
+  if (fallback != m_latestCompatible.end()) {
+    m_stats.fallbacks++;
+    return fallback->second;
+  }
+  m_stats.misses++;
+  return nullptr;
+}
+
+vk::Pipeline VKPipelineCache::GetOrCreate(const GraphicsDesc& desc) {
+  const uint64_t key = desc.Hash();
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!Register(key, desc)) {
+      // 已登记：等待进行中的编译
+      m_completed.wait(lock, [this, key]() {
+        return m_entries[key].state != State::Pending;
+      });
+      const Entry& entry = m_entries[key];
+      if (entry.state == State::Failed) {
+        throw std::runtime_error("Pipeline compilation failed earlier");
+      }
+      return entry.pipeline;
+    }
+  }
+
+  Timer timer;
+  vk::Pipeline pipeline;
+  try {
+    pipeline = Compile(desc);
+  } catch (...) {
+    Complete(key, nullptr, timer.ElapsedMilliseconds());
+    throw;
+  }
+  Complete(key, pipeline, timer.ElapsedMilliseconds());
+  return pipeline;
+}
+
+void VKPipelineCache::Prefetch(const GraphicsDesc& desc) {
+  const uint64_t key = desc.Hash();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (Register(key, desc)) SubmitCompile(key, desc);
+}
+
+void VKPipelineCache::WaitIdle() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_completed.wait(lock, [this]() {
+    return std::none_of(m_entries.begin(), m_entries.end(),
+                        [](const auto& item) {
+                          return item.second.state == State::Pending;
+                        });
+  });
+}
+
+VKPipelineCache::Stats VKPipelineCache::GetStats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Stats stats = m_stats;
+  for (const auto& [key, entry] : m_entries) {
+    switch (entry.state) {
+      case State::Ready:
+        stats.ready++;
+        break;
+      case State::Pending:
+        stats.pending++;
+        break;
+      case State::Failed:
+        stats.failed++;
+        break;
+    }
+  }
+  return stats;
+}
+
+vk::Pipeline VKPipelineCache::Compile(const GraphicsDesc& desc) {
+  std::array<vk::PipelineShaderStageCreateInfo, 2> stages;
+  stages[0].stage = vk::ShaderStageFlagBits::eVertex;
+  stages[0].module = desc.vertexModule;
+  stages[0].pName = "main";
+  stages[1].stage = vk::ShaderStageFlagBits::eFragment;
+  stages[1].module = desc.fragmentModule;
+  stages[1].pName = "main";
+  vk::SpecializationInfo specialization(
+      static_cast<uint32_t>(desc.specializationEntries.size()),
+      desc.specializationEntries.data(), desc.specializationData.size(),
+      desc.specializationData.data());
+  if (!desc.specializationEntries.empty()) {
+    stages[1].pSpecializationInfo = &specialization;
+  }
+
+  vk::PipelineVertexInputStateCreateInfo vertexInput;
+  vertexInput.vertexBindingDescriptionCount =
+      static_cast<uint32_t>(desc.vertexBindings.size());
+  vertexInput.pVertexBindingDescriptions = desc.vertexBindings.data();
+  vertexInput.vertexAttributeDescriptionCount =
+      static_cast<uint32_t>(desc.vertexAttributes.size());
+  vertexInput.pVertexAttributeDescriptions = desc.vertexAttributes.data();
+
+  vk::PipelineInputAssemblyStateCreateInfo inputAssembly;
+  inputAssembly.topology = desc.topology;
+
+  // 视口与裁剪矩形为动态状态，窗口大小变化时无需重建管线
+  vk::PipelineViewportStateCreateInfo viewportState;
+  viewportState.viewportCount = 1;
+  viewportState.scissorCount = 1;
+
+  vk::PipelineRasterizationStateCreateInfo rasterizer;
+  rasterizer.polygonMode = vk::PolygonMode::eFill;
+  rasterizer.cullMode = desc.cullMode;
+  rasterizer.frontFace = desc.frontFace;
+  rasterizer.lineWidth = 1.0f;
+
+  vk::PipelineMultisampleStateCreateInfo multisampling;
+  multisampling.rasterizationSamples = vk::SampleCountFlagBits::e1;
+
+  vk::PipelineDepthStencilStateCreateInfo depthStencil;
+  depthStencil.depthTestEnable = desc.depthTest;
+  depthStencil.depthWriteEnable = desc.depthWrite;
+  depthStencil.depthCompareOp = desc.depthCompare;
+
+  // 混合开启时按预乘alpha混合
+  std::vector<vk::PipelineColorBlendAttachmentState> blendAttachments(
+      desc.colorFormats.size());
+  for (auto& attachment : blendAttachments) {
+    attachment.blendEnable = desc.blendEnable;
+    attachment.srcColorBlendFactor = vk::BlendFactor::eOne;
+    attachment.dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
+    attachment.colorBlendOp = vk::BlendOp::eAdd;
+    attachment.srcAlphaBlendFactor = vk::BlendFactor::eOne;
+    attachment.dstAlphaBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
+    attachment.alphaBlendOp = vk::BlendOp::eAdd;
+    attachment.colorWriteMask =
+        vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+        vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+  }
+  vk::PipelineColorBlendStateCreateInfo colorBlending;
+  colorBlending.attachmentCount =
+      static_cast<uint32_t>(blendAttachments.size());
+  colorBlending.pAttachments = blendAttachments.data();
+
+  std::array<vk::DynamicState, 2> dynamicStates = {vk::DynamicState::eViewport,
+                                                   vk::DynamicState::eScissor};
+  vk::PipelineDynamicStateCreateInfo dynamicState;
+  dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+  dynamicState.pDynamicStates = dynamicStates.data();
+
+  // 动态渲染：附件格式在管线中声明，无需RenderPass
+  vk::PipelineRenderingCreateInfo renderingInfo;
+  renderingInfo.colorAttachmentCount =
+      static_cast<uint32_t>(desc.colorFormats.size());
+  renderingInfo.pColorAttachmentFormats = desc.colorFormats.data();
+  renderingInfo.depthAttachmentFormat = desc.depthFormat;
+
+  vk::GraphicsPipelineCreateInfo pipelineInfo;
+  pipelineInfo.pNext = &renderingInfo;
+  pipelineInfo.stageCount = static_cast<uint32_t>(stages.size());
+  pipelineInfo.pStages = stages.data();
+  pipelineInfo.pVertexInputState = &vertexInput;
+  pipelineInfo.pInputAssemblyState = &inputAssembly;
+  pipelineInfo.pViewportState = &viewportState;
+  pipelineInfo.pRasterizationState = &rasterizer;
+  pipelineInfo.pMultisampleState = &multisampling;
+  pipelineInfo.pDepthStencilState = &depthStencil;
+  pipelineInfo.pColorBlendState = &colorBlending;
+  pipelineInfo.pDynamicState = &dynamicState;
+  pipelineInfo.layout = desc.layout;
+
+  vk::ResultValue<vk::Pipeline> result(vk::Result::eSuccess, nullptr);
+  try {
+    result = m_device.createGraphicsPipeline(m_driverCache, pipelineInfo);
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create graphics pipeline: " +
+                             std::string(err.what()));
+  }
+  if (result.result != vk::Result::eSuccess) {
+    throw std::runtime_error("Failed to create graphics pipeline: " +
+                             vk::to_string(result.result));
+  }
+  return result.value;
+}
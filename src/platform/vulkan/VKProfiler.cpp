@@ -0,0 +1,334 @@
+#include "platform/vulkan/VKProfiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+const char* QueueName(VKProfiler::QueueType queue) {
+  switch (queue) {
+    case VKProfiler::QueueType::Graphics:
+      return "GPU Graphics";
+    case VKProfiler::QueueType::Compute:
+      return "GPU Compute";
+    case VKProfiler::QueueType::Transfer:
+      return "GPU Transfer";
+    default:
+      return "GPU";
+  }
+}
+
+// Chrome trace中GPU队列的轨道编号，与CPU线程编号区分
+constexpr uint32_t kGpuTrackBase = 1000;
+
+std::string EscapeJson(const std::string& text) {
+  std::string result;
+  for (char c : text) {
+    if (c == '"' || c == '\\') result.push_back('\\');
+    result.push_back(c);
+  }
+  return result;
+}
+
+}  // namespace
+
+VKProfiler::CpuScope::CpuScope(VKProfiler* profiler, const char* name)
+    : m_profiler(profiler), m_name(name) {
+  m_startUs = m_profiler ? m_profiler->NowUs() : 0.0;
+}
+
+VKProfiler::CpuScope::~CpuScope() {
+  if (!m_profiler) return;
+  TraceEvent event{};
+  event.name = m_name;
+  event.startUs = m_startUs;
+  event.durationUs = m_profiler->NowUs() - m_startUs;
+  event.gpu = false;
+  m_profiler->AddTraceEvent(std::move(event));
+}
+
+VKProfiler::VKProfiler(vk::Device device, vk::PhysicalDevice physicalDevice,
+                       const std::array<uint32_t, 3>& queueFamilies,
+                       uint32_t framesInFlight, bool hostQueryReset,
+                       const Config& config)
+    : m_device(device),
+      m_config(config),
+      m_hostQueryReset(hostQueryReset),
+      m_epoch(std::chrono::steady_clock::now()) {
+  m_timestampPeriod =
+      physicalDevice.getProperties().limits.timestampPeriod;
+  auto families = physicalDevice.getQueueFamilyProperties();
+  for (size_t i = 0; i < queueFamilies.size(); i++) {
+    m_validBits[i] = families[queueFamilies[i]].timestampValidBits;
+  }
+
+  if (m_config.pipelineStatistics) {
+    m_statisticFlags =
+        vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices |
+        vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+        vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+        vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations |
+        vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+  }
+
+  m_slots.resize(framesInFlight);
+  for (auto& slot : m_slots) {
+    vk::QueryPoolCreateInfo poolInfo;
+    poolInfo.queryType = vk::QueryType::eTimestamp;
+    poolInfo.queryCount = m_config.maxScopesPerFrame * 2;
+    try {
+      slot.timestampPool = m_device.createQueryPool(poolInfo);
+      if (m_config.pipelineStatistics) {
+        vk::QueryPoolCreateInfo statsInfo;
+        statsInfo.queryType = vk::QueryType::ePipelineStatistics;
+        statsInfo.queryCount = m_config.maxScopesPerFrame;
+        statsInfo.pipelineStatistics = m_statisticFlags;
+        slot.statisticsPool = m_device.createQueryPool(statsInfo);
+      }
+    } catch (const vk::SystemError& err) {
+      throw std::runtime_error("Failed to create profiler query pool: " +
+                               std::string(err.what()));
+    }
+    ResetSlot(slot);
+  }
+}
+
+VKProfiler::~VKProfiler() {
+  for (auto& slot : m_slots) {
+    if (slot.timestampPool) m_device.destroyQueryPool(slot.timestampPool);
+    if (slot.statisticsPool) m_device.destroyQueryPool(slot.statisticsPool);
+  }
+}
+
+double VKProfiler::NowUs() const {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - m_epoch)
+      .count();
+}
+
+void VKProfiler::ResetSlot(FrameSlot& slot) {
+  slot.scopes.clear();
+  slot.statisticsCount = 0;
+  slot.submitted = false;
+  if (!m_hostQueryReset) return;
+  m_device.resetQueryPool(slot.timestampPool, 0,
+                          m_config.maxScopesPerFrame * 2);
+  if (slot.statisticsPool) {
+    m_device.resetQueryPool(slot.statisticsPool, 0,
+                            m_config.maxScopesPerFrame);
+  }
+}
+
+void VKProfiler::BeginFrame(uint32_t frameIndex) {
+  m_currentSlot = frameIndex;
+  FrameSlot& slot = m_slots[frameIndex];
+  if (slot.submitted) {
+    ReadResults(slot);
+  }
+  ResetSlot(slot);
+  m_scopeDepth = 0;
+  m_statisticsActive = false;
+  m_needsReset = !m_hostQueryReset;
+}
+
+void VKProfiler::RecordReset(vk::CommandBuffer commandBuffer) {
+  if (!m_needsReset) return;
+  FrameSlot& slot = m_slots[m_currentSlot];
+  commandBuffer.resetQueryPool(slot.timestampPool, 0,
+                               m_config.maxScopesPerFrame * 2);
+  if (slot.statisticsPool) {
+    commandBuffer.resetQueryPool(slot.statisticsPool, 0,
+                                 m_config.maxScopesPerFrame);
+  }
+  m_needsReset = false;
+}
+
+void VKProfiler::EndFrame() {
+  FrameSlot& slot = m_slots[m_currentSlot];
+  slot.submitCpuUs = NowUs();
+  slot.submitted = !slot.scopes.empty();
+}
+
+uint32_t VKProfiler::BeginScope(vk::CommandBuffer commandBuffer,
+                                const std::string& name, QueueType queue,
+                                bool statistics) {
+  FrameSlot& slot = m_slots[m_currentSlot];
+  if (!IsSupported(queue) || slot.scopes.size() >= m_config.maxScopesPerFrame) {
+    return UINT32_MAX;
+  }
+
+  uint32_t scope = static_cast<uint32_t>(slot.scopes.size());
+  PendingScope pending{name, queue, m_scopeDepth++, UINT32_MAX};
+
+  // 同一时刻只能有一个管线统计查询处于活动状态，且只在图形队列上收集
+  if (statistics && slot.statisticsPool && !m_statisticsActive &&
+      queue == QueueType::Graphics) {
+    pending.statisticsQuery = slot.statisticsCount++;
+    commandBuffer.beginQuery(slot.statisticsPool, pending.statisticsQuery, {});
+    m_statisticsActive = true;
+  }
+  commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands,
+                                slot.timestampPool, scope * 2);
+  slot.scopes.push_back(std::move(pending));
+  return scope;
+}
+
+void VKProfiler::EndScope(vk::CommandBuffer commandBuffer, uint32_t scope) {
+  if (scope == UINT32_MAX) return;
+  FrameSlot& slot = m_slots[m_currentSlot];
+  const PendingScope& pending = slot.scopes[scope];
+
+  commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands,
+                                slot.timestampPool, scope * 2 + 1);
+  if (pending.statisticsQuery != UINT32_MAX) {
+    commandBuffer.endQuery(slot.statisticsPool, pending.statisticsQuery);
+    m_statisticsActive = false;
+  }
+  m_scopeDepth--;
+}
+
+vk::QueryPipelineStatisticFlags VKProfiler::GetActiveStatisticFlags() const {
+  return m_statisticsActive ? m_statisticFlags
+                            : vk::QueryPipelineStatisticFlags{};
+}
+
+void VKProfiler::ReadResults(FrameSlot& slot) {
+  uint32_t queryCount = static_cast<uint32_t>(slot.scopes.size()) * 2;
+  std::vector<uint64_t> timestamps(queryCount);
+  // 不等待：帧槽位已等待，结果理应可用；若尚不可用则丢弃本帧
+  vk::Result result = m_device.getQueryPoolResults(
+      slot.timestampPool, 0, queryCount, timestamps.size() * sizeof(uint64_t),
+      timestamps.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+  if (result != vk::Result::eSuccess) return;
+
+  std::vector<PipelineStatistics> statistics(slot.statisticsCount);
+  bool hasStatistics = false;
+  if (slot.statisticsCount > 0) {
+    result = m_device.getQueryPoolResults(
+        slot.statisticsPool, 0, slot.statisticsCount,
+        statistics.size() * sizeof(PipelineStatistics), statistics.data(),
+        sizeof(PipelineStatistics), vk::QueryResultFlagBits::e64);
+    hasStatistics = result == vk::Result::eSuccess;
+  }
+
+  auto mask = [this](QueueType queue) -> uint64_t {
+    uint32_t bits = m_validBits[static_cast<uint32_t>(queue)];
+    return bits >= 64 ? UINT64_MAX : (uint64_t(1) << bits) - 1;
+  };
+
+  uint64_t frameStart = UINT64_MAX;
+  for (size_t i = 0; i < slot.scopes.size(); i++) {
+    frameStart =
+        std::min(frameStart, timestamps[i * 2] & mask(slot.scopes[i].queue));
+  }
+
+  const double msPerTick = m_timestampPeriod / 1.0e6;
+  m_lastResults.clear();
+  for (size_t i = 0; i < slot.scopes.size(); i++) {
+    const PendingScope& pending = slot.scopes[i];
+    uint64_t queueMask = mask(pending.queue);
+    uint64_t begin = timestamps[i * 2] & queueMask;
+    uint64_t end = timestamps[i * 2 + 1] & queueMask;
+
+    ScopeResult scope;
+    scope.name = pending.name;
+    scope.queue = pending.queue;
+    scope.depth = pending.depth;
+    scope.gpuStartMs = ((begin - frameStart) & queueMask) * msPerTick;
+    scope.gpuTimeMs = ((end - begin) & queueMask) * msPerTick;
+    if (hasStatistics && pending.statisticsQuery != UINT32_MAX) {
+      scope.hasStatistics = true;
+      scope.statistics = statistics[pending.statisticsQuery];
+    }
+    m_lastResults.push_back(scope);
+
+    // GPU时间线以提交时刻为起点近似对齐到CPU时间线
+    TraceEvent event{};
+    event.name = scope.name;
+    event.thread = kGpuTrackBase + static_cast<uint32_t>(scope.queue);
+    event.startUs = slot.submitCpuUs + scope.gpuStartMs * 1000.0;
+    event.durationUs = scope.gpuTimeMs * 1000.0;
+    event.gpu = true;
+    event.hasStatistics = scope.hasStatistics;
+    event.statistics = scope.statistics;
+    AddTraceEvent(std::move(event));
+  }
+}
+
+uint32_t VKProfiler::CurrentThreadTrack() {
+  std::thread::id id = std::this_thread::get_id();
+  auto it = std::find(m_threadIds.begin(), m_threadIds.end(), id);
+  if (it != m_threadIds.end()) {
+    return static_cast<uint32_t>(it - m_threadIds.begin());
+  }
+  m_threadIds.push_back(id);
+  return static_cast<uint32_t>(m_threadIds.size() - 1);
+}
+
+void VKProfiler::AddTraceEvent(TraceEvent event) {
+  std::lock_guard<std::mutex> lock(m_traceMutex);
+  if (!event.gpu) {
+    event.thread = CurrentThreadTrack();
+  }
+  if (m_traceEvents.size() >= m_config.maxTraceEvents) {
+    m_traceEvents.erase(m_traceEvents.begin(),
+                        m_traceEvents.begin() + m_traceEvents.size() / 2);
+  }
+  m_traceEvents.push_back(std::move(event));
+}
+
+bool VKProfiler::WriteChromeTrace(const std::string& path) const {
+  std::lock_guard<std::mutex> lock(m_traceMutex);
+  std::ostringstream json;
+  json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+  // 轨道名称元数据
+  bool first = true;
+  auto separator = [&]() {
+    if (!first) json << ",\n";
+    first = false;
+  };
+  for (size_t i = 0; i < m_threadIds.size(); i++) {
+    separator();
+    json << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i
+         << ",\"args\":{\"name\":\"CPU Thread " << i << "\"}}";
+  }
+  for (uint32_t q = 0; q < static_cast<uint32_t>(QueueType::Count); q++) {
+    separator();
+    json << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+         << kGpuTrackBase + q << ",\"args\":{\"name\":\""
+         << QueueName(static_cast<QueueType>(q)) << "\"}}";
+  }
+
+  char number[64];
+  for (const auto& event : m_traceEvents) {
+    separator();
+    json << "{\"name\":\"" << EscapeJson(event.name) << "\",\"cat\":\""
+         << (event.gpu ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+         << event.thread;
+    std::snprintf(number, sizeof(number), ",\"ts\":%.3f,\"dur\":%.3f",
+                  event.startUs, event.durationUs);
+    json << number;
+    if (event.hasStatistics) {
+      const auto& stats = event.statistics;
+      json << ",\"args\":{\"inputAssemblyVertices\":"
+           << stats.inputAssemblyVertices
+           << ",\"vertexShaderInvocations\":" << stats.vertexShaderInvocations
+           << ",\"clippingPrimitives\":" << stats.clippingPrimitives
+           << ",\"fragmentShaderInvocations\":"
+           << stats.fragmentShaderInvocations
+           << ",\"computeShaderInvocations\":"
+           << stats.computeShaderInvocations << "}";
+    }
+    json << "}";
+  }
+  json << "\n]}\n";
+
+  std::ofstream file(path);
+  if (!file.is_open()) return false;
+  file << json.str();
+  return file.good();
+}
@@ -1,9 +1,19 @@
 #include "platform/vulkan/VKRender.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+
 #include "core/Log.hpp"
+#include "rendering/TextureCooker.hpp"
 #include "utils/vkutil.hpp"
 
 bool VKRender::init(Window* windowHandle) {
+  m_startupTimer.Reset();
   m_windowHandle = windowHandle;
   m_vkContext = std::make_shared<VKContext>(windowHandle);
   if (!m_vkContext) {
@@ -11,49 +21,840 @@ bool VKRender::init(Window* windowHandle) {
     return false;
   }
   Log::LogMessage(Log::Level::Info, "VKContext created successfully.");
+  initResources();
+  return true;
+}
+
+bool VKRender::initHeadless(const VKContext::HeadlessConfig& config) {
+  m_startupTimer.Reset();
+  m_vkContext = std::make_shared<VKContext>(config);
+  m_framesInFlight = std::max(config.framesInFlight, 1u);
+  m_offscreenTarget = std::make_unique<VKOffscreenTarget>(
+      m_vkContext->m_device->GetHandle(), m_vkContext->m_physicalDevice,
+      vk::Extent2D(config.width, config.height), config.fileFormat,
+      m_framesInFlight);
+  m_pendingReadbacks.assign(m_framesInFlight, -1);
+  Log::LogMessage(Log::Level::Info,
+                  "Headless VKContext created (" +
+                      std::to_string(m_framesInFlight) + " frames in flight).");
+  initResources();
+  // 离屏输出逐帧写出，等待后台编译的几何管线就绪，首帧起不跳过绘制
+  m_vkContext->m_pipelineCache->WaitIdle();
   return true;
 }
 
-void VKRender::resize(int width, int height) {}
+void VKRender::initResources() {
+  m_useBindless = m_vkContext->m_bindlessSupported;
+  m_useIndirect = m_vkContext->m_indirectSupported;
+  m_vkContext->createFrameResources(m_framesInFlight);
+  m_geometryPool = std::make_unique<VKGeometryPool>(
+      m_vkContext->m_device->GetHandle(), m_vkContext->m_physicalDevice,
+      m_vkContext->m_device->GetGraphicsQueue(),
+      *m_vkContext->m_graphicsCommandPool, sizeof(Vertex));
+  m_drawList = std::make_unique<VKIndirectDrawList>(
+      m_vkContext->m_device->GetHandle(), m_vkContext->m_physicalDevice,
+      m_framesInFlight);
+  if (m_vkContext->m_bindlessTable) {
+    m_materialTable = std::make_unique<VKMaterialTable>(
+        m_vkContext->m_device->GetHandle(), m_vkContext->m_physicalDevice,
+        m_framesInFlight);
+    m_vkContext->m_bindlessTable->SetMaterialBuffer(
+        m_materialTable->GetBuffer(), m_materialTable->GetSize());
+  }
+  if (m_vkContext->m_gpuCullingSupported) {
+    VKGpuCulling::Pipelines pipelines;
+    pipelines.cullSetLayout = m_vkContext->m_cullSetLayout;
+    pipelines.cullLayout = m_vkContext->m_cullPipelineLayout;
+    pipelines.cull = m_vkContext->m_cullPipeline;
+    pipelines.pyramidSetLayout = m_vkContext->m_pyramidSetLayout;
+    pipelines.pyramidLayout = m_vkContext->m_pyramidPipelineLayout;
+    pipelines.pyramid = m_vkContext->m_pyramidPipeline;
+    m_gpuCulling = std::make_unique<VKGpuCulling>(
+        m_vkContext->m_device->GetHandle(), m_vkContext->m_physicalDevice,
+        m_vkContext->m_descriptorPool, pipelines, m_framesInFlight,
+        m_vkContext->m_device->GetFeatureSupport().drawIndirectCount);
+    m_useGpuCulling = true;
+  }
+  if (m_vkContext->m_deferredLightingSupported) {
+    VKDeferredLighting::Pipelines pipelines;
+    pipelines.setLayout = m_vkContext->m_lightingSetLayout;
+    pipelines.layout = m_vkContext->m_lightingPipelineLayout;
+    pipelines.lightCull = m_vkContext->m_lightCullPipeline;
+    pipelines.lighting = m_vkContext->m_lightingPipeline;
+    m_deferredLighting = std::make_unique<VKDeferredLighting>(
+        m_vkContext->m_device->GetHandle(), m_vkContext->m_physicalDevice,
+        m_vkContext->m_descriptorPool, pipelines, m_framesInFlight);
+  }
+  m_recorder = std::make_unique<VKParallelRecorder>(
+      m_vkContext->m_device->GetHandle(),
+      m_vkContext->m_device->m_queueFamilyIndices.graphicQueue.value(),
+      m_framesInFlight, kMaxRecordingThreads);
+  m_recordingThreads = m_recorder->GetThreadCount();
+  // 异步计算需要独立的计算队列族，否则保持单队列
+  VKDevice& vkDevice = *m_vkContext->m_device;
+  const DeviceCapabilities& caps = m_vkContext->m_deviceCapabilities;
+  VKFrameScheduler& scheduler = *m_vkContext->m_frameScheduler;
+  if (caps.dedicatedCompute && vkDevice.HasDedicatedComputeQueue()) {
+    const auto& families = vkDevice.m_queueFamilyIndices;
+    m_asyncCompute = std::make_unique<VKAsyncCompute>(
+        vkDevice.GetHandle(), scheduler, families.graphicQueue.value(),
+        families.computeFamily.value(), m_framesInFlight);
+  }
+  VKTextureStreamer::Config streamingConfig;
+  if (caps.deviceLocalBytes > 0) {
+    streamingConfig.budgetBytes = caps.deviceLocalBytes / 4;
+  }
+  if (m_textureStreamingBudget > 0) {
+    streamingConfig.budgetBytes = m_textureStreamingBudget;
+  }
+  const auto& queueFamilies = vkDevice.m_queueFamilyIndices;
+  m_textureStreamer = std::make_unique<VKTextureStreamer>(
+      vkDevice.GetHandle(), m_vkContext->m_physicalDevice, scheduler,
+      queueFamilies.transferFamily.value(), queueFamilies.graphicQueue.value(),
+      streamingConfig);
+  m_mipGenerator = std::make_unique<VKMipGenerator>(
+      vkDevice.GetHandle(), m_vkContext->m_physicalDevice,
+      m_vkContext->m_descriptorPool, m_vkContext->getMipGenPipelines());
+  createDefaultTextures();
+  createUniformBuffers();
+  createFrameDescriptorSets();
+  buildRenderGraph();
+  if (m_modelDirty) {
+    uploadModelData();
+  }
+  if (m_materialDirty) {
+    uploadMaterialData();
+  }
+}
+
+void VKRender::resize(int width, int height) {
+  // 离屏目标尺寸固定
+  if (!m_vkContext || m_vkContext->m_headless) return;
+  if (width == 0 || height == 0) return;
+  m_vkContext->m_swapChain->Recreate(vk::Extent2D(
+      static_cast<uint32_t>(width), static_cast<uint32_t>(height)));
+  buildRenderGraph();
+}
+
+void VKRender::renderFrame() {
+  if (!m_vkContext) return;
+  if (m_vkContext->m_headless) {
+    renderOffscreenFrame();
+    return;
+  }
+  auto& swapChain = m_vkContext->m_swapChain;
+  VKFrameScheduler& scheduler = *m_vkContext->m_frameScheduler;
+
+  // 等待该槽位上一次提交的图形时间线值，并回收到期的延迟销毁
+  scheduler.BeginFrame(m_currentFrame);
+
+  vk::Semaphore imageAvailable =
+      m_vkContext->m_imageAvailableSemaphores[m_currentFrame];
+  swapChain->AcquireNextImage(imageAvailable);
+  uint32_t imageIndex = swapChain->CurrentImageIndex();
+
+  // 交换链在获取或呈现时可能被重建：图像数量变化后同步信号量，
+  // 尺寸变化后重新编译渲染图
+  m_vkContext->syncRenderFinishedSemaphores();
+  if (swapChain->GetExtent() != m_graphExtent) {
+    buildRenderGraph();
+  }
+  // 该帧上次提交已完成，可回收其命令池与uniform区域并读取查询结果
+  if (m_profiler) m_profiler->BeginFrame(m_currentFrame);
+  m_recorder->BeginFrame(m_currentFrame);
+  if (m_asyncCompute) m_asyncCompute->BeginFrame(m_currentFrame);
+  m_uniformArena->BeginFrame(m_currentFrame);
+
+  updateFrameUniforms();
+  if (m_deferredLighting) {
+    m_deferredLighting->BeginFrame(m_currentFrame, m_pointLights,
+                                   m_frameView, m_frameProj);
+  }
+  m_vkContext->m_descriptorCache->BeginFrame();
+  updateVisibleObjects();
+  updateTextureStreaming();
+  if (m_useIndirect) prepareIndirectDraws();
+  m_renderGraph->SetImportedImage(m_outputTarget,
+                                  swapChain->GetImage(imageIndex),
+                                  swapChain->GetImageViews()[imageIndex]);
+
+  vk::Semaphore renderFinished =
+      m_vkContext->m_renderFinishedSemaphores[imageIndex];
+  if (usesAsyncCompute()) {
+    VKAsyncCompute::FrameSync sync;
+    sync.waitSemaphore = imageAvailable;
+    sync.waitStage = vk::PipelineStageFlagBits2::eTransfer;
+    sync.waitBatch = m_renderGraph->GetFirstBatch(m_outputTarget);
+    sync.signalSemaphore = renderFinished;
+    m_asyncCompute->Execute(*m_renderGraph, m_profiler.get(), sync);
+  } else {
+    vk::CommandBuffer commandBuffer =
+        m_vkContext->m_commandBuffers[m_currentFrame];
+    commandBuffer.reset();
+    {
+      VKProfiler::CpuScope recordScope(m_profiler.get(), "Record");
+      commandBuffer.begin(vk::CommandBufferBeginInfo(
+          vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+      if (m_profiler) m_profiler->RecordReset(commandBuffer);
+      m_renderGraph->Execute(commandBuffer, m_profiler.get());
+      commandBuffer.end();
+    }
+
+    // 交换链图像仅在呈现blit中被写入；获取与呈现仍使用二值信号量
+    VKProfiler::CpuScope submitScope(m_profiler.get(), "Submit");
+    scheduler.Submit(VKFrameScheduler::QueueType::Graphics, commandBuffer,
+                     {{imageAvailable, 0,
+                       vk::PipelineStageFlagBits2::eTransfer}},
+                     {{renderFinished, 0,
+                       vk::PipelineStageFlagBits2::eAllCommands}});
+  }
+  scheduler.EndFrame();
+  if (m_profiler) m_profiler->EndFrame();
+  reportFirstFrame();
+
+  swapChain->Present(m_vkContext->m_device->GetPresentQueue(), imageIndex,
+                     renderFinished);
+  m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
+}
+
+void VKRender::renderOffscreenFrame() {
+  VKFrameScheduler& scheduler = *m_vkContext->m_frameScheduler;
+  scheduler.BeginFrame(m_currentFrame);
+
+  // 该槽位N帧前的结果已完成，写出文件后复用；其余槽位的帧仍在GPU上渲染
+  {
+    VKProfiler::CpuScope saveScope(m_profiler.get(), "SaveReadback");
+    saveReadback(m_currentFrame);
+  }
+  if (m_profiler) m_profiler->BeginFrame(m_currentFrame);
+  m_recorder->BeginFrame(m_currentFrame);
+  if (m_asyncCompute) m_asyncCompute->BeginFrame(m_currentFrame);
+  m_uniformArena->BeginFrame(m_currentFrame);
+
+  updateFrameUniforms();
+  if (m_deferredLighting) {
+    m_deferredLighting->BeginFrame(m_currentFrame, m_pointLights,
+                                   m_frameView, m_frameProj);
+  }
+  m_vkContext->m_descriptorCache->BeginFrame();
+  updateVisibleObjects();
+  updateTextureStreaming();
+  if (m_useIndirect) prepareIndirectDraws();
+  m_renderGraph->SetImportedImage(
+      m_outputTarget, m_offscreenTarget->GetImage(m_currentFrame),
+      m_offscreenTarget->GetImageView(m_currentFrame));
+  m_renderGraph->SetImportedBuffer(
+      m_readbackTarget, m_offscreenTarget->GetReadbackBuffer(m_currentFrame));
+
+  if (usesAsyncCompute()) {
+    m_asyncCompute->Execute(*m_renderGraph, m_profiler.get(), {});
+  } else {
+    vk::CommandBuffer commandBuffer =
+        m_vkContext->m_commandBuffers[m_currentFrame];
+    commandBuffer.reset();
+    {
+      VKProfiler::CpuScope recordScope(m_profiler.get(), "Record");
+      commandBuffer.begin(vk::CommandBufferBeginInfo(
+          vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+      if (m_profiler) m_profiler->RecordReset(commandBuffer);
+      m_renderGraph->Execute(commandBuffer, m_profiler.get());
+      commandBuffer.end();
+    }
+
+    VKProfiler::CpuScope submitScope(m_profiler.get(), "Submit");
+    scheduler.Submit(VKFrameScheduler::QueueType::Graphics, commandBuffer);
+  }
+  scheduler.EndFrame();
+  if (m_profiler) m_profiler->EndFrame();
+  reportFirstFrame();
+
+  m_pendingReadbacks[m_currentFrame] = static_cast<int64_t>(m_frameNumber++);
+  m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
+}
+
+void VKRender::saveReadback(uint32_t slot) {
+  int64_t frameNumber = m_pendingReadbacks[slot];
+  if (frameNumber < 0) return;
+  m_pendingReadbacks[slot] = -1;
+
+  const std::string& directory =
+      m_vkContext->m_headlessConfig.outputDirectory;
+  if (directory.empty()) return;
+
+  char name[32];
+  std::snprintf(name, sizeof(name), "frame_%05lld",
+                static_cast<long long>(frameNumber));
+  std::string path = directory + "/" + name +
+                     m_offscreenTarget->GetFileExtension();
+  if (!m_offscreenTarget->Save(slot, path)) {
+    Log::LogMessage(Log::Level::Error, "Failed to write " + path);
+  }
+}
+
+void VKRender::flushReadbacks() {
+  if (!m_offscreenTarget) return;
+  m_vkContext->m_frameScheduler->WaitIdle();
+  // 按提交顺序写出剩余帧
+  for (uint32_t i = 0; i < m_framesInFlight; i++) {
+    saveReadback((m_currentFrame + i) % m_framesInFlight);
+  }
+}
+
+void VKRender::buildRenderGraph() {
+  vk::Device device = m_vkContext->m_device->GetHandle();
+  device.waitIdle();
+
+  const auto& formats = m_vkContext->m_gbufferFormats;
+
+  if (!m_renderGraph) {
+    m_renderGraph = std::make_unique<VKRenderGraph>(
+        device, m_vkContext->m_physicalDevice);
+  }
+  m_renderGraph->Reset();
+  const auto& families = m_vkContext->m_device->m_queueFamilyIndices;
+  m_renderGraph->SetAsyncCompute(
+      m_useAsyncCompute && m_asyncCompute, families.graphicQueue.value(),
+      families.computeFamily.value_or(families.graphicQueue.value()));
+
+  // 输出目标：窗口模式为交换链图像，离屏模式为离屏图像（逐帧替换句柄）
+  VKRenderGraph::ImageDesc outputDesc;
+  if (m_offscreenTarget) {
+    m_graphExtent = m_offscreenTarget->GetExtent();
+    outputDesc.format = m_offscreenTarget->GetFormat();
+    outputDesc.extent = m_graphExtent;
+    m_outputTarget = m_renderGraph->ImportImage(
+        "Offscreen", outputDesc, m_offscreenTarget->GetImage(0),
+        m_offscreenTarget->GetImageView(0), vk::ImageLayout::eUndefined,
+        vk::ImageLayout::eTransferSrcOptimal);
+  } else {
+    auto& swapChain = m_vkContext->m_swapChain;
+    m_graphExtent = swapChain->GetExtent();
+    outputDesc.format = swapChain->getImageFormat();
+    outputDesc.extent = m_graphExtent;
+    m_outputTarget = m_renderGraph->ImportImage(
+        "Swapchain", outputDesc, swapChain->GetImage(0),
+        swapChain->GetImageViews()[0], vk::ImageLayout::eUndefined,
+        vk::ImageLayout::ePresentSrcKHR);
+  }
+
+  auto createTarget = [&](const std::string& name, vk::Format format,
+                          vk::ImageAspectFlags aspect) {
+    VKRenderGraph::ImageDesc desc;
+    desc.format = format;
+    desc.extent = m_graphExtent;
+    desc.aspect = aspect;
+    return m_renderGraph->CreateImage(name, desc);
+  };
+  // 颜色目标与VKContext::m_gbufferFormats一一对应，紧凑布局没有位置
+  const auto color = vk::ImageAspectFlagBits::eColor;
+  size_t formatIndex = 0;
+  m_gbuffer = GBufferTargets{};
+  if (m_vkContext->m_gbufferLayout == VKContext::GBufferLayout::Full) {
+    m_gbuffer.position =
+        createTarget("GBuffer.Position", formats.color[formatIndex++], color);
+  }
+  m_gbuffer.normal =
+      createTarget("GBuffer.Normal", formats.color[formatIndex++], color);
+  m_gbuffer.albedo =
+      createTarget("GBuffer.Albedo", formats.color[formatIndex++], color);
+  m_gbuffer.material =
+      createTarget("GBuffer.Material", formats.color[formatIndex++], color);
+  m_gbuffer.depth = createTarget("GBuffer.Depth", formats.depth,
+                                 vk::ImageAspectFlagBits::eDepth);
+
+  // GPU剔除：阶段一剔除 -> G-Buffer -> 金字塔 -> 阶段二剔除 -> 补绘 -> 金字塔
+  const bool culling = usesGpuCulling();
+  if (culling) addCullingPasses(VKGpuCulling::Phase::Early);
+
+  // 材质改动复制到GPU材质表，上一帧的读取由导入资源的初始屏障隔开
+  m_materialBuffer = RGResource{};
+  if (m_materialTable) {
+    m_materialBuffer = m_renderGraph->ImportBuffer(
+        "MaterialTable", m_materialTable->GetBuffer(),
+        m_materialTable->GetSize());
+    m_renderGraph->AddPass("MaterialUpload")
+        .Write(m_materialBuffer, RGAccess::TransferWrite)
+        .SetExecute([this](vk::CommandBuffer commandBuffer,
+                           const VKRenderGraph&) {
+          m_materialTable->RecordUpload(commandBuffer, m_currentFrame);
+        });
+  }
+
+  auto& gbufferPass = m_renderGraph->AddPass("GBuffer");
+  for (RGResource target : m_gbuffer.Colors()) {
+    gbufferPass.AddColorAttachment(target);
+  }
+  gbufferPass.SetDepthAttachment(m_gbuffer.depth)
+      .SetSecondaryCommandBuffers(usesSecondaryRecording())
+      .SetExecute([this](vk::CommandBuffer commandBuffer,
+                         const VKRenderGraph&) {
+        recordDrawCommands(commandBuffer);
+      });
+  if (m_materialBuffer.IsValid()) {
+    gbufferPass.Read(m_materialBuffer, RGAccess::FragmentShaderRead);
+  }
+  if (culling) {
+    gbufferPass.Read(m_culling.commands, RGAccess::IndirectRead)
+        .Read(m_culling.counts, RGAccess::IndirectRead);
+    addCullingPasses(VKGpuCulling::Phase::Late);
+  }
+
+  // 光照结果（光照着色器缺失时为反照率）复制到输出目标
+  RGResource presentSource = m_gbuffer.albedo;
+  if (m_deferredLighting) {
+    addLightingPasses();
+    presentSource = m_lightingOutput;
+  }
+  m_renderGraph->AddPass("Present")
+      .Read(presentSource, RGAccess::TransferRead)
+      .Write(m_outputTarget, RGAccess::TransferWrite)
+      .SetExecute([this, presentSource](vk::CommandBuffer commandBuffer,
+                                        const VKRenderGraph& graph) {
+        vk::ImageBlit blit;
+        blit.srcSubresource = {vk::ImageAspectFlagBits::eColor, 0, 0, 1};
+        blit.srcOffsets[1] = vk::Offset3D{
+            static_cast<int32_t>(m_graphExtent.width),
+            static_cast<int32_t>(m_graphExtent.height), 1};
+        blit.dstSubresource = blit.srcSubresource;
+        blit.dstOffsets[1] = blit.srcOffsets[1];
+        commandBuffer.blitImage(
+            graph.GetImage(presentSource),
+            vk::ImageLayout::eTransferSrcOptimal,
+            graph.GetImage(m_outputTarget),
+            vk::ImageLayout::eTransferDstOptimal, blit, vk::Filter::eNearest);
+      });
+
+  // 离屏模式：复制到回读缓冲，并使传输写入对主机可见
+  if (m_offscreenTarget) {
+    m_readbackTarget = m_renderGraph->ImportBuffer(
+        "Readback", m_offscreenTarget->GetReadbackBuffer(0),
+        m_offscreenTarget->GetReadbackSize());
+    m_renderGraph->AddPass("Readback")
+        .Read(m_outputTarget, RGAccess::TransferRead)
+        .Write(m_readbackTarget, RGAccess::TransferWrite)
+        .SetSideEffect()
+        .SetExecute([this](vk::CommandBuffer commandBuffer,
+                           const VKRenderGraph& graph) {
+          vk::BufferImageCopy region;
+          region.imageSubresource = {vk::ImageAspectFlagBits::eColor, 0, 0,
+                                     1};
+          region.imageExtent =
+              vk::Extent3D{m_graphExtent.width, m_graphExtent.height, 1};
+          commandBuffer.copyImageToBuffer(
+              graph.GetImage(m_outputTarget),
+              vk::ImageLayout::eTransferSrcOptimal,
+              graph.GetBuffer(m_readbackTarget), region);
+
+          vk::MemoryBarrier2 hostBarrier;
+          hostBarrier.srcStageMask = vk::PipelineStageFlagBits2::eTransfer;
+          hostBarrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+          hostBarrier.dstStageMask = vk::PipelineStageFlagBits2::eHost;
+          hostBarrier.dstAccessMask = vk::AccessFlagBits2::eHostRead;
+          vk::DependencyInfo dependencyInfo;
+          dependencyInfo.memoryBarrierCount = 1;
+          dependencyInfo.pMemoryBarriers = &hostBarrier;
+          commandBuffer.pipelineBarrier2(dependencyInfo);
+        });
+  }
+
+  m_renderGraph->Compile();
+  // 瞬态深度图像随编译重建，更新金字塔的深度源
+  if (culling) {
+    m_gpuCulling->SetDepthSource(m_renderGraph->GetImageView(m_gbuffer.depth));
+  }
+  if (m_deferredLighting) {
+    VKDeferredLighting::Targets targets;
+    targets.depth = m_renderGraph->GetImageView(m_gbuffer.depth);
+    if (m_gbuffer.position.IsValid()) {
+      targets.position = m_renderGraph->GetImageView(m_gbuffer.position);
+    }
+    targets.normal = m_renderGraph->GetImageView(m_gbuffer.normal);
+    targets.albedo = m_renderGraph->GetImageView(m_gbuffer.albedo);
+    targets.material = m_renderGraph->GetImageView(m_gbuffer.material);
+    targets.output = m_renderGraph->GetImageView(m_lightingOutput);
+    targets.tileLights = m_renderGraph->GetBuffer(m_tileLights);
+    m_deferredLighting->SetTargets(m_graphExtent, targets);
+  }
+}
+
+void VKRender::addLightingPasses() {
+  VKRenderGraph::BufferDesc tileDesc;
+  tileDesc.size = VKDeferredLighting::GetTileBufferSize(m_graphExtent);
+  m_tileLights = m_renderGraph->CreateBuffer("Lighting.Tiles", tileDesc);
+  VKRenderGraph::ImageDesc outputDesc;
+  outputDesc.format = VKDeferredLighting::kOutputFormat;
+  outputDesc.extent = m_graphExtent;
+  m_lightingOutput = m_renderGraph->CreateImage("Lighting.HDR", outputDesc);
+
+  // 启用异步计算时光照在计算队列上执行
+  m_renderGraph->AddPass("LightCull")
+      .SetQueue(RGQueue::Compute)
+      .Read(m_gbuffer.depth, RGAccess::ComputeSampledRead)
+      .Write(m_tileLights, RGAccess::ComputeStorageWrite)
+      .SetExecute([this](vk::CommandBuffer commandBuffer,
+                         const VKRenderGraph&) {
+        m_deferredLighting->RecordLightCulling(commandBuffer);
+      });
+  // 紧凑布局由深度重建位置
+  auto& lightingPass =
+      m_renderGraph->AddPass("Lighting").SetQueue(RGQueue::Compute);
+  if (m_gbuffer.position.IsValid()) {
+    lightingPass.Read(m_gbuffer.position, RGAccess::ComputeSampledRead);
+  }
+  lightingPass.Read(m_gbuffer.depth, RGAccess::ComputeSampledRead)
+      .Read(m_gbuffer.normal, RGAccess::ComputeSampledRead)
+      .Read(m_gbuffer.albedo, RGAccess::ComputeSampledRead)
+      .Read(m_gbuffer.material, RGAccess::ComputeSampledRead)
+      .Read(m_tileLights, RGAccess::ComputeStorageRead)
+      .Write(m_lightingOutput, RGAccess::ComputeStorageWrite)
+      .SetExecute([this](vk::CommandBuffer commandBuffer,
+                         const VKRenderGraph&) {
+        m_deferredLighting->RecordLighting(commandBuffer);
+      });
+}
+
+void VKRender::addCullingPasses(VKGpuCulling::Phase phase) {
+  auto addPyramidPass = [this](const std::string& name, RGQueue queue) {
+    m_renderGraph->AddPass(name)
+        .SetQueue(queue)
+        .Read(m_gbuffer.depth, RGAccess::ComputeSampledRead)
+        .Write(m_culling.pyramid, RGAccess::ComputeStorageWrite)
+        .SetExecute([this](vk::CommandBuffer commandBuffer,
+                           const VKRenderGraph&) {
+          m_gpuCulling->RecordBuildPyramid(commandBuffer);
+        });
+  };
+
+  if (phase == VKGpuCulling::Phase::Early) {
+    // 剔除输出与金字塔跨帧保留，作为导入资源由渲染图生成屏障
+    m_gpuCulling->Resize(m_graphExtent,
+                         m_vkContext->m_device->GetGraphicsQueue(),
+                         *m_vkContext->m_graphicsCommandPool);
+    m_culling.commands = m_renderGraph->ImportBuffer(
+        "Cull.Commands", m_gpuCulling->GetCommandBuffer(),
+        m_gpuCulling->GetCommandBufferSize());
+    m_culling.counts = m_renderGraph->ImportBuffer(
+        "Cull.Counts", m_gpuCulling->GetCountBuffer(),
+        m_gpuCulling->GetCountBufferSize());
+    m_culling.occluded = m_renderGraph->ImportBuffer(
+        "Cull.Occluded", m_gpuCulling->GetOccludedBuffer(),
+        m_gpuCulling->GetOccludedBufferSize());
+    m_cullGeneration = m_gpuCulling->GetGeneration();
+
+    VKRenderGraph::ImageDesc pyramidDesc;
+    pyramidDesc.format = VKGpuCulling::kPyramidFormat;
+    pyramidDesc.extent = m_gpuCulling->GetPyramidExtent();
+    m_culling.pyramid = m_renderGraph->ImportImage(
+        "DepthPyramid", pyramidDesc, m_gpuCulling->GetPyramidImage(),
+        m_gpuCulling->GetPyramidView(),
+        vk::ImageLayout::eShaderReadOnlyOptimal,
+        vk::ImageLayout::eShaderReadOnlyOptimal);
+
+    m_renderGraph->AddPass("CullReset")
+        .Write(m_culling.counts, RGAccess::TransferWrite)
+        .SetExecute([this](vk::CommandBuffer commandBuffer,
+                           const VKRenderGraph&) {
+          m_gpuCulling->RecordResetCounts(commandBuffer);
+        });
+    m_renderGraph->AddPass("CullEarly")
+        .Read(m_culling.pyramid, RGAccess::ComputeSampledRead)
+        .Write(m_culling.commands, RGAccess::ComputeStorageWrite)
+        .Write(m_culling.counts, RGAccess::ComputeStorageWrite)
+        .Write(m_culling.occluded, RGAccess::ComputeStorageWrite)
+        .SetExecute([this](vk::CommandBuffer commandBuffer,
+                           const VKRenderGraph&) {
+          m_gpuCulling->RecordCull(commandBuffer, VKGpuCulling::Phase::Early);
+        });
+    return;
+  }
 
-void VKRender::renderFrame() {}
+  addPyramidPass("DepthPyramidEarly", RGQueue::Graphics);
+  m_renderGraph->AddPass("CullLate")
+      .Read(m_culling.pyramid, RGAccess::ComputeSampledRead)
+      .Read(m_culling.occluded, RGAccess::ComputeStorageRead)
+      .Write(m_culling.commands, RGAccess::ComputeStorageWrite)
+      .Write(m_culling.counts, RGAccess::ComputeStorageWrite)
+      .SetExecute([this](vk::CommandBuffer commandBuffer,
+                         const VKRenderGraph&) {
+        m_gpuCulling->RecordCull(commandBuffer, VKGpuCulling::Phase::Late);
+      });
 
-void VKRender::setModel(const Model& model) { m_currentModel = model; }
+  // 补绘在阶段一的结果之上继续绘制
+  const auto load = vk::AttachmentLoadOp::eLoad;
+  auto& latePass = m_renderGraph->AddPass("GBufferLate");
+  for (RGResource target : m_gbuffer.Colors()) {
+    latePass.AddColorAttachment(target, load);
+  }
+  latePass.SetDepthAttachment(m_gbuffer.depth, load)
+      .Read(m_culling.commands, RGAccess::IndirectRead)
+      .Read(m_culling.counts, RGAccess::IndirectRead)
+      .SetExecute([this](vk::CommandBuffer commandBuffer,
+                         const VKRenderGraph&) {
+        if (m_drawList->GetBatchCount() > 0) {
+          recordIndirectDraws(commandBuffer, VKGpuCulling::Phase::Late);
+        }
+      });
+  if (m_materialBuffer.IsValid()) {
+    latePass.Read(m_materialBuffer, RGAccess::FragmentShaderRead);
+  }
+  // 包含补绘对象的完整深度，供下一帧阶段一使用。
+  // 阶段二剔除紧接着被补绘使用，留在图形队列；该金字塔本帧不再读取，
+  // 可放到计算队列
+  addPyramidPass("DepthPyramidLate", RGQueue::Compute);
+}
+
+void VKRender::updateFrameUniforms() {
+  Camera* camera = m_camera;
+  if (!camera && m_windowHandle) camera = m_windowHandle->GetCamera();
+  if (camera) {
+    m_frameView = camera->GetViewMatrix();
+    m_frameProj = camera->GetProjectionMatrix();
+  } else {
+    m_frameView = glm::mat4(1.0f);
+    m_frameProj = glm::mat4(1.0f);
+  }
+  // GLM按OpenGL约定生成投影矩阵，Vulkan的裁剪空间Y轴向下
+  m_frameProj[1][1] *= -1.0f;
+}
+
+void VKRender::setModel(const Model& model) {
+  m_currentModel = model;
+  // 剔除依赖模型包围体，调用方未计算时在此补齐
+  ComputeBounds(m_currentModel);
+  m_modelDirty = true;
+  if (m_vkContext) {
+    uploadModelData();
+  }
+}
 
 void VKRender::setMaterial(const Material& material) {
   m_currentMaterial = material;
+  m_materialDirty = true;
+  if (m_vkContext) {
+    uploadMaterialData();
+  }
 }
 
 void VKRender::setCamera() {}
 
-void VKRender::uploadModelData() {}
+void VKRender::setCamera(Camera* camera) { m_camera = camera; }
+
+uint32_t VKRender::addRenderObject(const glm::mat4& transform) {
+  uint32_t index = static_cast<uint32_t>(m_renderObjects.size());
+  AABB localBounds{m_currentModel.boundsMin, m_currentModel.boundsMax};
+  uint32_t handle =
+      m_sceneBVH.Insert(localBounds.Transformed(transform), index);
+  m_renderObjects.push_back({transform, m_currentMaterialIndex,
+                             m_currentMeshIndex, localBounds, handle});
+  return index;
+}
+
+void VKRender::setRenderObjectTransform(uint32_t object,
+                                        const glm::mat4& transform) {
+  RenderObject& renderObject = m_renderObjects[object];
+  renderObject.transform = transform;
+  m_sceneBVH.Update(renderObject.bvhHandle,
+                    renderObject.localBounds.Transformed(transform));
+}
+
+uint32_t VKRender::addPointLight(const VKDeferredLighting::PointLight& light) {
+  m_pointLights.push_back(light);
+  return static_cast<uint32_t>(m_pointLights.size() - 1);
+}
+
+void VKRender::setPointLight(uint32_t index,
+                             const VKDeferredLighting::PointLight& light) {
+  m_pointLights[index] = light;
+}
+
+void VKRender::setGBufferLayout(VKContext::GBufferLayout layout) {
+  if (!m_vkContext || layout == m_vkContext->m_gbufferLayout) return;
+  m_vkContext->setGBufferLayout(layout);
+  if (m_deferredLighting) {
+    if (m_vkContext->m_deferredLightingSupported) {
+      VKDeferredLighting::Pipelines pipelines;
+      pipelines.setLayout = m_vkContext->m_lightingSetLayout;
+      pipelines.layout = m_vkContext->m_lightingPipelineLayout;
+      pipelines.lightCull = m_vkContext->m_lightCullPipeline;
+      pipelines.lighting = m_vkContext->m_lightingPipeline;
+      m_deferredLighting->SetPipelines(pipelines);
+    } else {
+      m_deferredLighting.reset();
+    }
+  }
+  buildRenderGraph();
+}
+
+void VKRender::setExposure(float exposure) {
+  if (m_deferredLighting) m_deferredLighting->SetExposure(exposure);
+}
+
+void VKRender::updateVisibleObjects() {
+  Timer timer;
+  const uint32_t objectCount = static_cast<uint32_t>(m_renderObjects.size());
+  // GPU剔除路径需要所有对象的命令，由计算着色器剔除
+  if (!m_useCpuCulling || usesGpuCulling()) {
+    m_visibleObjects.resize(objectCount);
+    for (uint32_t i = 0; i < objectCount; i++) m_visibleObjects[i] = i;
+  } else {
+    m_sceneBVH.Refit();
+    m_sceneBVH.Cull(Frustum::FromViewProjection(m_frameProj * m_frameView),
+                    m_visibleObjects);
+    // 恢复添加顺序，保持逐对象路径的提交顺序稳定
+    std::sort(m_visibleObjects.begin(), m_visibleObjects.end());
+  }
+  m_drawLoopStats.cpuCulledCount =
+      objectCount - static_cast<uint32_t>(m_visibleObjects.size());
+  m_drawLoopStats.cpuCullMs = timer.ElapsedMilliseconds();
+}
+
+void VKRender::setBindlessEnabled(bool enabled) {
+  if (enabled && !m_vkContext->m_bindlessSupported) {
+    Log::LogMessage(Log::Level::Warning,
+                    "Bindless textures unavailable, keeping per-material "
+                    "descriptor sets.");
+    return;
+  }
+  m_useBindless = enabled;
+}
+
+void VKRender::setIndirectEnabled(bool enabled) {
+  if (enabled && !m_vkContext->m_indirectSupported) {
+    Log::LogMessage(Log::Level::Warning,
+                    "Indirect draw pipeline unavailable, keeping direct "
+                    "draws.");
+    return;
+  }
+  bool secondaryBefore = usesSecondaryRecording();
+  bool cullingBefore = usesGpuCulling();
+  m_useIndirect = enabled;
+  // 间接路径在主命令缓冲中内联录制，渲染开始标志随之改变；
+  // GPU剔除只作用于间接路径，剔除过程随之增删
+  if ((secondaryBefore != usesSecondaryRecording() ||
+       cullingBefore != usesGpuCulling()) &&
+      m_renderGraph) {
+    buildRenderGraph();
+  }
+}
+
+void VKRender::setAsyncComputeEnabled(bool enabled) {
+  if (enabled && !m_asyncCompute) {
+    Log::LogMessage(Log::Level::Warning,
+                    "Async compute unavailable (no dedicated compute queue "
+                    "family or timeline semaphores), keeping a single "
+                    "queue.");
+    return;
+  }
+  if (m_useAsyncCompute == enabled) return;
+  m_useAsyncCompute = enabled;
+  if (m_renderGraph) buildRenderGraph();
+}
+
+void VKRender::setGpuCullingEnabled(bool enabled) {
+  if (enabled && !m_gpuCulling) {
+    Log::LogMessage(Log::Level::Warning,
+                    "GPU culling unavailable, drawing all objects.");
+    return;
+  }
+  bool cullingBefore = usesGpuCulling();
+  m_useGpuCulling = enabled;
+  if (cullingBefore != usesGpuCulling() && m_renderGraph) {
+    buildRenderGraph();
+  }
+}
+
+void VKRender::uploadModelData() {
+  if (!m_currentModel.isValid || m_currentModel.vertices.empty() ||
+      m_currentModel.indices.empty()) {
+    return;
+  }
+
+  // 子分配到几何池，已有模型的数据与绑定不受影响
+  GpuMesh mesh;
+  mesh.name = m_currentModel.name;
+  mesh.bounds = m_currentModel.boundingSphere;
+  mesh.geometry = m_geometryPool->Upload(
+      m_currentModel.vertices.data(),
+      static_cast<uint32_t>(m_currentModel.vertices.size()),
+      m_currentModel.indices.data(),
+      static_cast<uint32_t>(m_currentModel.indices.size()));
+  m_meshes.push_back(mesh);
+  m_currentMeshIndex = static_cast<uint32_t>(m_meshes.size() - 1);
+  m_modelDirty = false;
+  Log::LogMessage(Log::Level::Info, "Model uploaded: " + m_currentModel.name);
+}
+
+void VKRender::uploadMaterialData() {
+  // 绑定槽位顺序与geometry.frag的binding 1~6一致
+  std::array<Texture*, VKDescriptorCache::kImageBindingCount> inputs = {
+      &m_currentMaterial.baseColor.texture,
+      &m_currentMaterial.normal.texture,
+      &m_currentMaterial.metallic.texture,
+      &m_currentMaterial.roughness.texture,
+      &m_currentMaterial.ao.texture,
+      &m_currentMaterial.emissiveIntensity.texture};
 
-void VKRender::uploadMaterialData() {}
+  GpuMaterial gpuMaterial;
+  gpuMaterial.name = m_currentMaterial.name;
+  gpuMaterial.constants = MaterialConstants::FromMaterial(m_currentMaterial);
+  // 使用常量的输入不上传贴图，槽位指向默认贴图（通用变体仍会绑定）
+  for (size_t i = 0; i < inputs.size(); i++) {
+    const uint32_t bit = MaterialFeatures::SlotBit(i);
+    gpuMaterial.textureSlots[i] = (gpuMaterial.constants.features & bit) != 0
+                                      ? createTexture(*inputs[i])
+                                      : m_defaultTextureSlots[i];
+  }
+  flushTextureUploads();
+
+  if (m_materialTable) {
+    VKMaterialTable::Record record;
+    record.constants = gpuMaterial.constants;
+    const auto indices = bindlessTextureIndices(gpuMaterial);
+    std::copy(indices.begin(), indices.end(), record.textureIndices);
+    gpuMaterial.tableIndex = m_materialTable->Add(record);
+  }
+
+  m_materials.push_back(gpuMaterial);
+  m_currentMaterialIndex = static_cast<uint32_t>(m_materials.size() - 1);
+  m_materialDirty = false;
+  Log::LogMessage(Log::Level::Info,
+                  "Material uploaded: " + m_currentMaterial.name);
+}
+
+uint32_t VKRender::createTextureImage(Texture& T) {
+  vk::Device device = m_vkContext->m_device->GetHandle();
+  const vk::Format format = vkutil::TextureToVkFormat(T);
+  // 只有第0级时按格式选择GPU生成方式，图像分配完整的mip链
+  VKMipGenerator::Plan mipPlan;
+  if (T.mipLevels == 1) mipPlan = m_mipGenerator->PlanFor(T, format);
+  const uint32_t mipLevels = mipPlan.method != VKMipGenerator::Method::None
+                                 ? mipPlan.mipLevels
+                                 : static_cast<uint32_t>(T.mipLevels);
 
-void VKRender::createTextureImage(Texture& T) {
   vk::ImageCreateInfo imageCreateInfo;
   // 设置图像创建信息
+  imageCreateInfo.flags = mipPlan.flags;
   imageCreateInfo.imageType = vk::ImageType::e2D;
-  imageCreateInfo.format = vkutil::TextureToVkFormat(T);
-  imageCreateInfo.extent.width = T.width;    // 示例宽度
-  imageCreateInfo.extent.height = T.height;  // 示例高度
+  imageCreateInfo.format = format;
+  imageCreateInfo.extent.width = T.width;
+  imageCreateInfo.extent.height = T.height;
   imageCreateInfo.extent.depth = 1;
-  imageCreateInfo.mipLevels = 1;
+  imageCreateInfo.mipLevels = mipLevels;
   imageCreateInfo.arrayLayers = 1;
   imageCreateInfo.samples = vk::SampleCountFlagBits::e1;
   imageCreateInfo.tiling = vk::ImageTiling::eOptimal;
-  imageCreateInfo.usage =
-      vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+  imageCreateInfo.usage = vk::ImageUsageFlagBits::eSampled |
+                          vk::ImageUsageFlagBits::eTransferDst |
+                          mipPlan.usage;
 
   imageCreateInfo.sharingMode = vk::SharingMode::eExclusive;
   imageCreateInfo.initialLayout = vk::ImageLayout::eUndefined;
 
-  m_vkContext->m_device->GetHandle().createImage(
-      &imageCreateInfo, nullptr, &m_textureImage.emplace_back());
+  device.createImage(&imageCreateInfo, nullptr,
+                     &m_textureImage.emplace_back());
 
   vk::MemoryRequirements memRequirements;
-  m_vkContext->m_device->GetHandle().getImageMemoryRequirements(
-      m_textureImage.back(), &memRequirements);
+  device.getImageMemoryRequirements(m_textureImage.back(), &memRequirements);
 
   vk::MemoryAllocateInfo allocInfo;
   allocInfo.allocationSize = memRequirements.size;
@@ -61,13 +862,773 @@ void VKRender::createTextureImage(Texture& T) {
       m_vkContext->m_physicalDevice, memRequirements.memoryTypeBits,
       vk::MemoryPropertyFlagBits::eDeviceLocal);
 
-  m_vkContext->m_device->GetHandle().allocateMemory(
-      &allocInfo, nullptr, &m_textureImageMemory.emplace_back());
+  device.allocateMemory(&allocInfo, nullptr,
+                        &m_textureImageMemory.emplace_back());
+
+  device.bindImageMemory(m_textureImage.back(), m_textureImageMemory.back(), 0);
+
+  // 通过暂存缓冲上传像素数据（含已有的全部mip），暂存缓冲随批次释放
+  vk::DeviceSize imageSize = T.GetTotalBytes();
+  vk::Buffer stagingBuffer;
+  vk::DeviceMemory stagingMemory;
+  vkutil::CreateBuffer(device, m_vkContext->m_physicalDevice, imageSize,
+                       vk::BufferUsageFlagBits::eTransferSrc,
+                       vk::MemoryPropertyFlagBits::eHostVisible |
+                           vk::MemoryPropertyFlagBits::eHostCoherent,
+                       stagingBuffer, stagingMemory);
+  void* data = device.mapMemory(stagingMemory, 0, imageSize);
+  std::memcpy(data, T.data.get(), static_cast<size_t>(imageSize));
+  device.unmapMemory(stagingMemory);
+  m_uploadStaging.emplace_back(stagingBuffer, stagingMemory);
+
+  if (!m_uploadCommandBuffer) {
+    m_uploadCommandBuffer = vkutil::BeginSingleTimeCommands(
+        device, *m_vkContext->m_graphicsCommandPool);
+  }
+  vkutil::TransitionImageLayout(m_uploadCommandBuffer, m_textureImage.back(),
+                                vk::ImageLayout::eUndefined,
+                                vk::ImageLayout::eTransferDstOptimal,
+                                mipLevels);
+  vkutil::CopyMipsToImage(m_uploadCommandBuffer, stagingBuffer,
+                          m_textureImage.back(), T, 0);
+  if (mipPlan.method != VKMipGenerator::Method::None) {
+    // 生成器在批次提交前录制，并负责转换到着色器只读布局
+    m_mipGenerator->Enqueue(m_textureImage.back(), format, T, mipPlan);
+  } else {
+    vkutil::TransitionImageLayout(m_uploadCommandBuffer,
+                                  m_textureImage.back(),
+                                  vk::ImageLayout::eTransferDstOptimal,
+                                  vk::ImageLayout::eShaderReadOnlyOptimal,
+                                  mipLevels);
+  }
+  return mipLevels;
+}
+
+void VKRender::flushTextureUploads() {
+  if (!m_uploadCommandBuffer) return;
+  vk::Device device = m_vkContext->m_device->GetHandle();
+  m_mipGenerator->Record(m_uploadCommandBuffer);
+  m_uploadCommandBuffer.end();
+  // 不等待队列空闲：之后的帧在同一队列上按提交顺序执行，
+  // 批次末尾的布局转换屏障已覆盖片元着色器的采样
+  VKFrameScheduler& scheduler = *m_vkContext->m_frameScheduler;
+  scheduler.Submit(VKFrameScheduler::QueueType::Graphics,
+                   m_uploadCommandBuffer);
+  scheduler.DeferDestroy(
+      [device, pool = *m_vkContext->m_graphicsCommandPool,
+       commandBuffer = m_uploadCommandBuffer,
+       staging = std::move(m_uploadStaging),
+       releaseMips = m_mipGenerator->DetachBatch()]() {
+        releaseMips();
+        for (auto& [buffer, memory] : staging) {
+          device.destroyBuffer(buffer);
+          device.freeMemory(memory);
+        }
+        device.freeCommandBuffers(pool, commandBuffer);
+      });
+  m_uploadCommandBuffer = nullptr;
+  m_uploadStaging.clear();
+}
+
+void VKRender::createTextureImageView(vk::Format format,
+                                      uint32_t mipLevels) {
+  vk::ImageViewCreateInfo viewInfo;
+  viewInfo.image = m_textureImage.back();
+  viewInfo.viewType = vk::ImageViewType::e2D;
+  viewInfo.format = format;
+  viewInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+  viewInfo.subresourceRange.baseMipLevel = 0;
+  viewInfo.subresourceRange.levelCount = mipLevels;
+  viewInfo.subresourceRange.baseArrayLayer = 0;
+  viewInfo.subresourceRange.layerCount = 1;
+
+  m_textureImageView.push_back(
+      m_vkContext->m_device->GetHandle().createImageView(viewInfo));
+}
+
+uint32_t VKRender::createTexture(Texture& T) {
+  const vk::Format format = vkutil::TextureToVkFormat(T);
+  uint32_t streamHandle = kNotStreamed;
+  if (m_useTextureStreaming && m_textureStreamer->ShouldStream(T)) {
+    // 烘焙完整mip链，同步上传低mip，其余由反馈驱动流入
+    streamHandle = m_textureStreamer->Register(
+        TextureCooker::BuildMipChain(T), format);
+    m_textureImage.emplace_back();
+    m_textureImageMemory.emplace_back();
+    m_textureImageView.push_back(m_textureStreamer->GetView(streamHandle));
+    m_streamedTextureSlots.push_back(
+        static_cast<uint32_t>(m_textureImageView.size() - 1));
+  } else {
+    createTextureImageView(format, createTextureImage(T));
+  }
+  m_textureStreamHandles.push_back(streamHandle);
+
+  // 同时登记到无绑定纹理数组（流送纹理多登记一个备用槽位）
+  uint32_t bindlessIndex = 0;
+  uint32_t spareIndex = 0;
+  if (m_vkContext->m_bindlessTable) {
+    bindlessIndex = m_vkContext->m_bindlessTable->RegisterTexture(
+        m_textureImageView.back(), m_vkContext->m_textureSampler);
+    if (streamHandle != kNotStreamed) {
+      spareIndex = m_vkContext->m_bindlessTable->RegisterTexture(
+          m_textureImageView.back(), m_vkContext->m_textureSampler);
+    }
+  }
+  m_textureBindlessIndex.push_back(bindlessIndex);
+  m_textureBindlessSpare.push_back(spareIndex);
+  return static_cast<uint32_t>(m_textureImageView.size() - 1);
+}
+
+std::array<uint32_t, VKDescriptorCache::kImageBindingCount>
+VKRender::bindlessTextureIndices(const GpuMaterial& material) const {
+  std::array<uint32_t, VKDescriptorCache::kImageBindingCount> indices;
+  for (size_t i = 0; i < indices.size(); i++) {
+    indices[i] = m_textureBindlessIndex[material.textureSlots[i]];
+  }
+  return indices;
+}
+
+void VKRender::setTextureStreamingBudget(vk::DeviceSize bytes) {
+  m_textureStreamingBudget = bytes;
+  if (m_textureStreamer && bytes > 0) m_textureStreamer->SetBudget(bytes);
+}
+
+void VKRender::updateTextureStreaming() {
+  if (m_streamedTextureSlots.empty()) return;
+
+  // 屏幕空间反馈：对象包围球的投影直径（像素）作为其材质纹理的覆盖尺寸
+  const float viewportHeight = static_cast<float>(m_graphExtent.height);
+  const float focal = std::abs(m_frameProj[1][1]);
+  for (uint32_t index : m_visibleObjects) {
+    const RenderObject& object = m_renderObjects[index];
+    const glm::vec4& bounds = m_meshes[object.meshIndex].bounds;
+    glm::vec3 center =
+        glm::vec3(object.transform * glm::vec4(glm::vec3(bounds), 1.0f));
+    float scale = std::max({glm::length(glm::vec3(object.transform[0])),
+                            glm::length(glm::vec3(object.transform[1])),
+                            glm::length(glm::vec3(object.transform[2]))});
+    float radius = bounds.w * scale;
+    float depth = -(m_frameView * glm::vec4(center, 1.0f)).z;
+    // 相机位于包围球内时请求最高精度
+    float pixels = depth > radius ? radius * focal / depth * viewportHeight
+                                  : std::numeric_limits<float>::max();
+    for (uint32_t slot : m_materials[object.materialIndex].textureSlots) {
+      if (m_textureStreamHandles[slot] != kNotStreamed) {
+        m_textureStreamer->RequestScreenSize(m_textureStreamHandles[slot],
+                                             pixels);
+      }
+    }
+  }
+
+  VKTextureStreamer::UpdateResult result = m_textureStreamer->Update();
+  for (vk::ImageView view : result.retired) {
+    m_vkContext->m_descriptorCache->Evict(view);
+  }
+  auto& bindlessTable = m_vkContext->m_bindlessTable;
+  for (uint32_t handle : result.swapped) {
+    uint32_t slot = m_streamedTextureSlots[handle];
+    m_textureImageView[slot] = m_textureStreamer->GetView(handle);
+    if (!bindlessTable) continue;
+    // 新视图写入备用槽位（上一次切换的旧视图已退休），再改写材质记录；
+    // 新索引在本帧的上传过程中复制，在途帧仍读取旧槽位
+    std::swap(m_textureBindlessIndex[slot], m_textureBindlessSpare[slot]);
+    bindlessTable->UpdateTexture(m_textureBindlessIndex[slot],
+                                 m_textureImageView[slot],
+                                 m_vkContext->m_textureSampler);
+    for (const GpuMaterial& material : m_materials) {
+      const auto& slots = material.textureSlots;
+      if (std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+        m_materialTable->UpdateTextureIndices(
+            material.tableIndex, bindlessTextureIndices(material));
+      }
+    }
+  }
+}
+
+void VKRender::reportFirstFrame() {
+  if (m_timeToFirstFrameMs >= 0.0) return;
+  m_timeToFirstFrameMs = m_startupTimer.ElapsedMilliseconds();
+  VKTextureStreamer::Stats streaming = getTextureStreamingStats();
+  Log::LogMessage(
+      Log::Level::Info,
+      "First frame submitted " + std::to_string(m_timeToFirstFrameMs) +
+          " ms after init, " + std::to_string(streaming.textureCount) +
+          " streamed texture(s) with " +
+          std::to_string(streaming.residentBytes / 1024) + " KiB resident");
+}
+
+void VKRender::createDefaultTextures() {
+  // 1x1默认贴图：白色基础色/金属度/粗糙度/AO，平坦法线，黑色自发光
+  struct DefaultTexel {
+    TextureType type;
+    std::array<uint8_t, 4> rgba;
+  };
+  const std::array<DefaultTexel, VKDescriptorCache::kImageBindingCount>
+      defaults = {{{TextureType::Albedo, {255, 255, 255, 255}},
+                   {TextureType::Normal, {128, 128, 255, 255}},
+                   {TextureType::Metallic, {255, 255, 255, 255}},
+                   {TextureType::Roughness, {255, 255, 255, 255}},
+                   {TextureType::AmbientOcclusion, {255, 255, 255, 255}},
+                   {TextureType::Emissive, {0, 0, 0, 255}}}};
+
+  for (size_t i = 0; i < defaults.size(); i++) {
+    Texture texture("default", 1, 1, ChannelType::RGBA, defaults[i].type,
+                    TextureFilter::Nearest);
+    texture.data = std::shared_ptr<uint8_t[]>(new uint8_t[4]);
+    std::memcpy(texture.data.get(), defaults[i].rgba.data(), 4);
+    m_defaultTextureSlots[i] = createTexture(texture);
+  }
+  flushTextureUploads();
+}
+
+void VKRender::createUniformBuffers() {
+  // 每帧区域需容纳所有对象的变换块
+  m_uniformArena = std::make_unique<VKUniformArena>(
+      m_vkContext->m_device->GetHandle(), m_vkContext->m_physicalDevice,
+      m_framesInFlight, kUniformArenaBytesPerFrame);
+}
+
+void VKRender::createFrameDescriptorSets() {
+  if (!m_vkContext->m_bindlessSupported) return;
+
+  // 无绑定路径下set 0只含变换UBO；所有帧共用分配器缓冲，逐绘制以动态偏移区分
+  m_frameDescriptorSet = m_vkContext->m_descriptorPool->AllocateSet(
+      m_vkContext->m_frameSetLayout);
+
+  vk::DescriptorBufferInfo bufferInfo;
+  bufferInfo.buffer = m_uniformArena->GetBuffer();
+  bufferInfo.offset = 0;
+  bufferInfo.range = sizeof(ObjectTransform);
+
+  vk::WriteDescriptorSet write;
+  write.dstSet = m_frameDescriptorSet;
+  write.dstBinding = 0;
+  write.descriptorCount = 1;
+  write.descriptorType = vk::DescriptorType::eUniformBufferDynamic;
+  write.pBufferInfo = &bufferInfo;
+  m_vkContext->m_device->GetHandle().updateDescriptorSets(write, nullptr);
+}
+
+void VKRender::updateDrawDescriptorSet() {
+  if (!m_drawDescriptorSet) {
+    m_drawDescriptorSet = m_vkContext->m_descriptorPool->AllocateSet(
+        m_vkContext->m_drawSetLayout);
+  }
+
+  // 绘制列表扩容后缓冲句柄改变（扩容时已等待设备空闲）
+  vk::DescriptorBufferInfo bufferInfo = m_drawList->GetDrawDataDescriptor();
+  vk::WriteDescriptorSet write;
+  write.dstSet = m_drawDescriptorSet;
+  write.dstBinding = 0;
+  write.descriptorCount = 1;
+  write.descriptorType = vk::DescriptorType::eStorageBufferDynamic;
+  write.pBufferInfo = &bufferInfo;
+  m_vkContext->m_device->GetHandle().updateDescriptorSets(write, nullptr);
+  m_drawSetGeneration = m_drawList->GetGeneration();
+}
+
+void VKRender::createDeviceLocalBuffer(const void* data, vk::DeviceSize size,
+                                       vk::BufferUsageFlags usage,
+                                       vk::Buffer& buffer,
+                                       vk::DeviceMemory& memory) {
+  vk::Device device = m_vkContext->m_device->GetHandle();
+  vk::Buffer stagingBuffer;
+  vk::DeviceMemory stagingMemory;
+  vkutil::CreateBuffer(device, m_vkContext->m_physicalDevice, size,
+                       vk::BufferUsageFlagBits::eTransferSrc,
+                       vk::MemoryPropertyFlagBits::eHostVisible |
+                           vk::MemoryPropertyFlagBits::eHostCoherent,
+                       stagingBuffer, stagingMemory);
+  void* mapped = device.mapMemory(stagingMemory, 0, size);
+  std::memcpy(mapped, data, static_cast<size_t>(size));
+  device.unmapMemory(stagingMemory);
+
+  vkutil::CreateBuffer(device, m_vkContext->m_physicalDevice, size,
+                       usage | vk::BufferUsageFlagBits::eTransferDst,
+                       vk::MemoryPropertyFlagBits::eDeviceLocal, buffer,
+                       memory);
 
-  m_vkContext->m_device->GetHandle().bindImageMemory(
-      m_textureImage.back(), m_textureImageMemory.back(), 0);
+  vk::CommandPool commandPool = *m_vkContext->m_graphicsCommandPool;
+  vk::CommandBuffer commandBuffer =
+      vkutil::BeginSingleTimeCommands(device, commandPool);
+  commandBuffer.copyBuffer(stagingBuffer, buffer, vk::BufferCopy{0, 0, size});
+  vkutil::EndSingleTimeCommands(device, commandPool,
+                                m_vkContext->m_device->GetGraphicsQueue(),
+                                commandBuffer);
 
-  vk::BufferCreateInfo bufferCreateInfo;
+  device.destroyBuffer(stagingBuffer);
+  device.freeMemory(stagingMemory);
 }
 
-void VKRender::createTextureImageView() {}
+void VKRender::prepareMaterialSets() {
+  // 描述符缓存非线程安全，录制前在调用线程上解析所有材质的描述符集
+  m_materialSets.resize(m_materials.size());
+  for (size_t index = 0; index < m_materials.size(); index++) {
+    const GpuMaterial& material = m_materials[index];
+
+    // 以实际绑定的资源作为缓存键，相同绑定跨帧复用描述符集
+    VKDescriptorCache::Bindings bindings;
+    bindings.uniformBuffer.buffer = m_uniformArena->GetBuffer();
+    bindings.uniformBuffer.offset = 0;
+    bindings.uniformBuffer.range = sizeof(ObjectTransform);
+    for (size_t i = 0; i < bindings.images.size(); i++) {
+      bindings.images[i].sampler = m_vkContext->m_textureSampler;
+      bindings.images[i].imageView =
+          m_textureImageView[material.textureSlots[i]];
+      bindings.images[i].imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    }
+    m_materialSets[index] =
+        m_vkContext->m_descriptorCache->GetOrCreate(bindings);
+  }
+}
+
+void VKRender::recordDrawRange(vk::CommandBuffer commandBuffer, uint32_t begin,
+                               uint32_t end) const {
+  // 二级命令缓冲不继承管线与动态状态，每个区间重新设置；
+  // 管线按材质的特性位变体在变化时切换，未就绪的变体跳过绘制
+  vk::Viewport viewport(0.0f, 0.0f, static_cast<float>(m_graphExtent.width),
+                        static_cast<float>(m_graphExtent.height), 0.0f, 1.0f);
+  commandBuffer.setViewport(0, viewport);
+  commandBuffer.setScissor(0, vk::Rect2D{{0, 0}, m_graphExtent});
+
+  // 几何池块变化时才重新绑定顶点与索引缓冲
+  uint32_t boundBlock = UINT32_MAX;
+  auto bindGeometry = [&](const VKGeometryPool::Allocation& geometry) {
+    if (geometry.block == boundBlock) return;
+    boundBlock = geometry.block;
+    commandBuffer.bindVertexBuffers(
+        0, m_geometryPool->GetVertexBuffer(geometry.block),
+        vk::DeviceSize{0});
+    commandBuffer.bindIndexBuffer(
+        m_geometryPool->GetIndexBuffer(geometry.block), 0,
+        vk::IndexType::eUint32);
+  };
+  vk::Pipeline boundPipeline;
+  auto bindPipeline = [&](uint32_t materialIndex) {
+    vk::Pipeline pipeline = m_materialPipelines[materialIndex];
+    if (pipeline && pipeline != boundPipeline) {
+      boundPipeline = pipeline;
+      commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+    }
+    return static_cast<bool>(pipeline);
+  };
+
+  // 区间内所有对象的变换一次性连续分配，逐绘制以动态偏移绑定；
+  // 法线矩阵与MVP直接写入映射内存
+  const glm::mat4 viewProjection = m_frameProj * m_frameView;
+  const auto path = ObjectTransforms::GetBestPath();
+  VKUniformArena::Allocation allocation =
+      m_uniformArena->Allocate(sizeof(ObjectTransform), end - begin);
+  const uint32_t stride = static_cast<uint32_t>(
+      m_uniformArena->AlignedSize(sizeof(ObjectTransform)));
+  auto* mapped = static_cast<uint8_t*>(allocation.mapped);
+  auto writeTransform = [&](uint32_t slot, const glm::mat4& model) {
+    auto* transform =
+        reinterpret_cast<ObjectTransform*>(mapped + slot * stride);
+    ObjectTransforms::Compute(viewProjection, model, *transform, path);
+  };
+
+  if (m_useBindless) {
+    // 无绑定：纹理表只绑定一次，逐绘制更新set 0的动态偏移并推送材质索引
+    vk::PipelineLayout layout = m_vkContext->m_bindlessPipelineLayout;
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout,
+                                     1, m_vkContext->m_bindlessTable->GetSet(),
+                                     nullptr);
+    for (uint32_t i = begin; i < end; i++) {
+      const RenderObject& object = m_renderObjects[m_visibleObjects[i]];
+      if (!bindPipeline(object.materialIndex)) continue;
+      uint32_t slot = i - begin;
+      writeTransform(slot, object.transform);
+      uint32_t dynamicOffset = allocation.offset + slot * stride;
+      commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
+                                       layout, 0, m_frameDescriptorSet,
+                                       dynamicOffset);
+
+      uint32_t materialIndex = m_materials[object.materialIndex].tableIndex;
+      commandBuffer.pushConstants<uint32_t>(
+          layout, vk::ShaderStageFlagBits::eFragment, 0, materialIndex);
+      const auto& geometry = m_meshes[object.meshIndex].geometry;
+      bindGeometry(geometry);
+      commandBuffer.drawIndexed(geometry.indexCount, 1, geometry.firstIndex,
+                                geometry.vertexOffset, 0);
+    }
+  } else {
+    // 逐材质描述符集：每次绘制以新的动态偏移重新绑定材质集，
+    // 材质变化时推送材质常量
+    vk::PipelineLayout layout = m_vkContext->m_pipelineLayout;
+    uint32_t pushedMaterial = UINT32_MAX;
+    for (uint32_t i = begin; i < end; i++) {
+      const RenderObject& object = m_renderObjects[m_visibleObjects[i]];
+      if (!bindPipeline(object.materialIndex)) continue;
+      uint32_t slot = i - begin;
+      writeTransform(slot, object.transform);
+      uint32_t dynamicOffset = allocation.offset + slot * stride;
+      commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
+                                       layout, 0,
+                                       m_materialSets[object.materialIndex],
+                                       dynamicOffset);
+      if (object.materialIndex != pushedMaterial) {
+        pushedMaterial = object.materialIndex;
+        commandBuffer.pushConstants<MaterialConstants>(
+            layout, vk::ShaderStageFlagBits::eFragment, 0,
+            m_materials[object.materialIndex].constants);
+      }
+      const auto& geometry = m_meshes[object.meshIndex].geometry;
+      bindGeometry(geometry);
+      commandBuffer.drawIndexed(geometry.indexCount, 1, geometry.firstIndex,
+                                geometry.vertexOffset, 0);
+    }
+  }
+}
+
+void VKRender::prepareIndirectDraws() {
+  Timer timer;
+  // 逐材质路径按材质分批（需切换描述符集与推送常量），无绑定路径按
+  // 材质特性位分批（需切换管线变体）
+  bool ready = !m_meshes.empty() && !m_materials.empty();
+  m_drawItems.resize(ready ? m_visibleObjects.size() : 0);
+  for (size_t i = 0; i < m_drawItems.size(); i++) {
+    const RenderObject& object = m_renderObjects[m_visibleObjects[i]];
+    const GpuMesh& mesh = m_meshes[object.meshIndex];
+    VKIndirectDrawList::DrawItem& item = m_drawItems[i];
+    item.geometry = &mesh.geometry;
+    item.transform = &object.transform;
+    item.batchKey = m_useBindless
+                        ? m_materials[object.materialIndex].constants.features
+                        : object.materialIndex;
+    item.materialIndex = m_materials[object.materialIndex].tableIndex;
+
+    // 包围球变换到世界空间，半径按最大轴缩放放大
+    const glm::mat4& model = object.transform;
+    float scale = std::max({glm::length(glm::vec3(model[0])),
+                            glm::length(glm::vec3(model[1])),
+                            glm::length(glm::vec3(model[2]))});
+    glm::vec4 center = model * glm::vec4(glm::vec3(mesh.bounds), 1.0f);
+    item.bounds = glm::vec4(glm::vec3(center), mesh.bounds.w * scale);
+  }
+  // 剔除与绘制使用同一视图投影（已含Vulkan的Y轴翻转）
+  const glm::mat4 viewProjection = m_frameProj * m_frameView;
+  m_drawList->Build(m_currentFrame, m_drawItems, viewProjection);
+  if (m_drawSetGeneration != m_drawList->GetGeneration()) {
+    updateDrawDescriptorSet();
+  }
+
+  if (usesGpuCulling()) {
+    m_gpuCulling->BeginFrame(m_currentFrame, *m_drawList, viewProjection);
+    if (m_cullGeneration != m_gpuCulling->GetGeneration()) {
+      m_renderGraph->SetImportedBuffer(m_culling.commands,
+                                       m_gpuCulling->GetCommandBuffer());
+      m_renderGraph->SetImportedBuffer(m_culling.counts,
+                                       m_gpuCulling->GetCountBuffer());
+      m_renderGraph->SetImportedBuffer(m_culling.occluded,
+                                       m_gpuCulling->GetOccludedBuffer());
+      m_cullGeneration = m_gpuCulling->GetGeneration();
+    }
+  }
+  m_indirectBuildMs = timer.ElapsedMilliseconds();
+}
+
+void VKRender::recordIndirectDraws(vk::CommandBuffer commandBuffer,
+                                   VKGpuCulling::Phase phase) {
+  const auto kind = m_useBindless
+                       ? VKContext::GeometryPipeline::IndirectBindless
+                       : VKContext::GeometryPipeline::Indirect;
+  const auto& batches = m_drawList->GetBatches();
+  vk::Viewport viewport(0.0f, 0.0f, static_cast<float>(m_graphExtent.width),
+                        static_cast<float>(m_graphExtent.height), 0.0f, 1.0f);
+  commandBuffer.setViewport(0, viewport);
+  commandBuffer.setScissor(0, vk::Rect2D{{0, 0}, m_graphExtent});
+
+  // 逐绘制变换来自DrawData，set 0的UBO不被读取，动态偏移取0即可
+  const uint32_t frameOffset = 0;
+  uint32_t drawOffset = m_drawList->GetDrawDataOffset();
+
+  vk::PipelineLayout layout =
+      m_useBindless ? m_vkContext->m_indirectBindlessPipelineLayout
+                    : m_vkContext->m_indirectPipelineLayout;
+  commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, 1,
+                                   m_drawDescriptorSet, drawOffset);
+  if (m_useBindless) {
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout,
+                                     0, m_frameDescriptorSet, frameOffset);
+    commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout,
+                                     2, m_vkContext->m_bindlessTable->GetSet(),
+                                     nullptr);
+  }
+
+  const auto& features = m_vkContext->m_device->GetFeatureSupport();
+  const uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand);
+  uint32_t boundBlock = UINT32_MAX;
+  uint32_t boundMaterial = UINT32_MAX;
+  uint32_t boundFeatures = UINT32_MAX;
+  vk::Pipeline pipeline;
+  const bool culling = usesGpuCulling();
+  for (uint32_t index = 0; index < batches.size(); index++) {
+    const auto& batch = batches[index];
+    // 批次键为材质（逐材质路径）或特性位（无绑定路径），变化时切换变体；
+    // 变体与通用变体都在后台编译时跳过该批次
+    const uint32_t features =
+        m_useBindless ? batch.batchKey
+                      : m_materials[batch.batchKey].constants.features;
+    if (features != boundFeatures) {
+      boundFeatures = features;
+      vk::Pipeline variant =
+          m_vkContext->acquireGeometryPipeline(kind, features);
+      if (variant && variant != pipeline) {
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, variant);
+      }
+      pipeline = variant;
+    }
+    if (!pipeline) continue;
+    if (batch.block != boundBlock) {
+      boundBlock = batch.block;
+      commandBuffer.bindVertexBuffers(
+          0, m_geometryPool->GetVertexBuffer(batch.block), vk::DeviceSize{0});
+      commandBuffer.bindIndexBuffer(m_geometryPool->GetIndexBuffer(batch.block),
+                                    0, vk::IndexType::eUint32);
+    }
+    if (!m_useBindless && batch.batchKey != boundMaterial) {
+      boundMaterial = batch.batchKey;
+      commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout,
+                                       0, m_materialSets[batch.batchKey],
+                                       frameOffset);
+      commandBuffer.pushConstants<MaterialConstants>(
+          layout, vk::ShaderStageFlagBits::eFragment, 0,
+          m_materials[batch.batchKey].constants);
+    }
+
+    if (culling) {
+      // 幸存命令由剔除着色器写入，数量来自GPU计数或instanceCount
+      m_gpuCulling->DrawBatch(commandBuffer, phase, index, batch);
+      continue;
+    }
+    vk::DeviceSize offset = m_drawList->GetCommandOffset(batch);
+    if (!features.drawIndirectFirstInstance) {
+      // 间接命令的firstInstance须为0：按相同命令直接绘制，仍共用几何池绑定
+      const auto* commands = m_drawList->GetCommands() + batch.firstDraw;
+      for (uint32_t i = 0; i < batch.drawCount; i++) {
+        commandBuffer.drawIndexed(commands[i].indexCount, 1,
+                                  commands[i].firstIndex,
+                                  commands[i].vertexOffset,
+                                  commands[i].firstInstance);
+      }
+    } else if (features.multiDrawIndirect) {
+      commandBuffer.drawIndexedIndirect(m_drawList->GetCommandBuffer(), offset,
+                                        batch.drawCount, stride);
+    } else {
+      for (uint32_t i = 0; i < batch.drawCount; i++) {
+        commandBuffer.drawIndexedIndirect(m_drawList->GetCommandBuffer(),
+                                          offset + i * stride, 1, stride);
+      }
+    }
+  }
+}
+
+void VKRender::recordDrawCommands(vk::CommandBuffer commandBuffer) {
+  Timer timer;
+  uint32_t drawCount = 0;
+  uint32_t secondaryCount = 0;
+  uint32_t batchCount = 0;
+  bool ready = !m_meshes.empty() && !m_materials.empty();
+  uint32_t objectCount = static_cast<uint32_t>(m_visibleObjects.size());
+  if (ready && !m_useIndirect) {
+    // 管线缓存在调用线程上按材质解析变体，各录制线程只读取结果
+    const auto kind = m_useBindless ? VKContext::GeometryPipeline::Bindless
+                                    : VKContext::GeometryPipeline::Direct;
+    m_materialPipelines.resize(m_materials.size());
+    for (size_t i = 0; i < m_materials.size(); i++) {
+      m_materialPipelines[i] = m_vkContext->acquireGeometryPipeline(
+          kind, m_materials[i].constants.features);
+    }
+  }
+
+  if (ready && !m_useBindless) {
+    prepareMaterialSets();
+  }
+
+  if (m_useIndirect) {
+    if (ready && objectCount > 0) {
+      recordIndirectDraws(commandBuffer, VKGpuCulling::Phase::Early);
+      batchCount = static_cast<uint32_t>(m_drawList->GetBatchCount());
+      drawCount = objectCount;
+    }
+  } else if (m_recordingThreads > 1) {
+    // 过程以eContentsSecondaryCommandBuffers开始渲染，内容只能来自二级命令缓冲
+    if (ready && objectCount > 0) {
+      const auto& formats = m_vkContext->m_gbufferFormats;
+      vk::CommandBufferInheritanceRenderingInfo renderingInfo;
+      renderingInfo.colorAttachmentCount =
+          static_cast<uint32_t>(formats.color.size());
+      renderingInfo.pColorAttachmentFormats = formats.color.data();
+      renderingInfo.depthAttachmentFormat = formats.depth;
+      renderingInfo.rasterizationSamples = vk::SampleCountFlagBits::e1;
+      vk::CommandBufferInheritanceInfo inheritance;
+      inheritance.pNext = &renderingInfo;
+      // 主命令缓冲中活动的管线统计查询须由二级命令缓冲继承
+      if (m_profiler) {
+        inheritance.pipelineStatistics =
+            m_profiler->GetActiveStatisticFlags();
+      }
+
+      auto secondaries = m_recorder->Record(
+          m_currentFrame, objectCount, inheritance,
+          [this](vk::CommandBuffer secondary, uint32_t begin, uint32_t end) {
+            recordDrawRange(secondary, begin, end);
+          },
+          m_recordingThreads);
+      commandBuffer.executeCommands(secondaries);
+      secondaryCount = static_cast<uint32_t>(secondaries.size());
+      drawCount = objectCount;
+    }
+  } else if (ready) {
+    recordDrawRange(commandBuffer, 0, objectCount);
+    drawCount = objectCount;
+  }
+
+  // 间接路径的绘制列表在帧开始时构建，计入录制耗时
+  m_drawLoopStats.cpuTimeMs =
+      timer.ElapsedMilliseconds() + (m_useIndirect ? m_indirectBuildMs : 0.0);
+  m_drawLoopStats.drawCount = drawCount;
+  m_drawLoopStats.bindless = m_useBindless;
+  m_drawLoopStats.threadCount = m_recordingThreads;
+  m_drawLoopStats.secondaryCount = secondaryCount;
+  m_drawLoopStats.indirect = m_useIndirect;
+  m_drawLoopStats.batchCount = batchCount;
+}
+
+void VKRender::setRecordingThreadCount(uint32_t threadCount) {
+  if (m_recorder) {
+    threadCount = std::min(threadCount, m_recorder->GetThreadCount());
+  }
+  threadCount = std::max(threadCount, 1u);
+  bool secondaryBefore = usesSecondaryRecording();
+  m_recordingThreads = threadCount;
+  // 内联与二级命令缓冲两种录制方式对应不同的渲染开始标志
+  if (secondaryBefore != usesSecondaryRecording() && m_renderGraph) {
+    buildRenderGraph();
+  }
+}
+
+std::vector<VKRender::RecordingBenchmarkResult> VKRender::benchmarkRecording(
+    const std::vector<uint32_t>& threadCounts, uint32_t iterations) {
+  std::vector<RecordingBenchmarkResult> results;
+  if (!m_vkContext || iterations == 0) return results;
+
+  // 只录制不提交：等待设备空闲后复用当前帧的命令缓冲与命令池
+  m_vkContext->m_device->waitIdle();
+  uint32_t previousThreads = m_recordingThreads;
+  vk::CommandBuffer commandBuffer =
+      m_vkContext->m_commandBuffers[m_currentFrame];
+
+  // 输出目标沿用图中已导入的图像句柄
+  for (uint32_t threadCount : threadCounts) {
+    setRecordingThreadCount(threadCount);
+
+    RecordingBenchmarkResult result;
+    result.threadCount = m_recordingThreads;
+    for (uint32_t i = 0; i < iterations; i++) {
+      m_recorder->BeginFrame(m_currentFrame);
+      m_uniformArena->BeginFrame(m_currentFrame);
+      updateVisibleObjects();
+      if (m_useIndirect) prepareIndirectDraws();
+      commandBuffer.reset();
+      commandBuffer.begin(vk::CommandBufferBeginInfo(
+          vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+      // 只录制不提交：异步计算的各批次依次录制到同一命令缓冲
+      for (uint32_t b = 0; b < m_renderGraph->GetBatches().size(); b++) {
+        m_renderGraph->ExecuteBatch(b, commandBuffer);
+      }
+      commandBuffer.end();
+      result.averageCpuTimeMs += m_drawLoopStats.cpuTimeMs;
+    }
+    result.averageCpuTimeMs /= iterations;
+    result.drawCount = m_drawLoopStats.drawCount;
+    results.push_back(result);
+  }
+
+  commandBuffer.reset();
+  setRecordingThreadCount(previousThreads);
+  return results;
+}
+
+void VKRender::setProfilingEnabled(bool enabled, bool pipelineStatistics) {
+  if (!m_vkContext) return;
+  m_vkContext->m_device->waitIdle();
+  m_profiler.reset();
+  if (!enabled) return;
+
+  const auto& features = m_vkContext->m_device->GetFeatureSupport();
+  const auto& families = m_vkContext->m_device->m_queueFamilyIndices;
+  uint32_t graphics = families.graphicQueue.value();
+  std::array<uint32_t, 3> queueFamilies = {
+      graphics, families.computeFamily.value_or(graphics),
+      families.transferFamily.value_or(graphics)};
+  VKProfiler::Config config;
+  config.pipelineStatistics =
+      pipelineStatistics && features.pipelineStatistics;
+  config.inheritedQueries = features.inheritedQueries;
+  if (pipelineStatistics && !features.pipelineStatistics) {
+    Log::LogMessage(Log::Level::Warning,
+                    "Pipeline statistics queries not supported, "
+                    "profiling timestamps only.");
+  }
+
+  m_profiler = std::make_unique<VKProfiler>(
+      m_vkContext->m_device->GetHandle(), m_vkContext->m_physicalDevice,
+      queueFamilies, m_framesInFlight, features.hostQueryReset, config);
+  if (!m_profiler->IsSupported(VKProfiler::QueueType::Graphics)) {
+    Log::LogMessage(Log::Level::Warning,
+                    "Graphics queue does not support timestamps.");
+  }
+}
+
+bool VKRender::writeProfilerTrace(const std::string& path) const {
+  return m_profiler && m_profiler->WriteChromeTrace(path);
+}
+
+void VKRender::cleanup() {
+  if (!m_vkContext) return;
+  vk::Device device = m_vkContext->m_device->GetHandle();
+  device.waitIdle();
+  // 延迟销毁可能引用下面释放的对象（如mip生成器的描述符池）
+  m_vkContext->m_frameScheduler->WaitIdle();
+
+  m_renderGraph.reset();
+  m_asyncCompute.reset();
+  m_gpuCulling.reset();
+  m_deferredLighting.reset();
+  m_profiler.reset();
+  m_recorder.reset();
+  m_offscreenTarget.reset();
+  m_vkContext->m_descriptorCache->Clear();
+  if (m_frameDescriptorSet) {
+    m_vkContext->m_descriptorPool->FreeSet(m_frameDescriptorSet);
+    m_frameDescriptorSet = nullptr;
+  }
+  if (m_drawDescriptorSet) {
+    m_vkContext->m_descriptorPool->FreeSet(m_drawDescriptorSet);
+    m_drawDescriptorSet = nullptr;
+  }
+  m_uniformArena.reset();
+  m_drawList.reset();
+  m_materialTable.reset();
+  m_geometryPool.reset();
+  m_meshes.clear();
+  // 流送纹理的视图由流送器销毁，对应的图像与内存句柄为空
+  for (size_t i = 0; i < m_textureImageView.size(); i++) {
+    if (m_textureStreamHandles[i] == kNotStreamed) {
+      device.destroyImageView(m_textureImageView[i]);
+    }
+  }
+  for (auto image : m_textureImage) device.destroyImage(image);
+  for (auto memory : m_textureImageMemory) device.freeMemory(memory);
+  m_textureStreamer.reset();
+  m_mipGenerator.reset();
+  m_textureImageView.clear();
+  m_textureBindlessIndex.clear();
+  m_textureBindlessSpare.clear();
+  m_textureStreamHandles.clear();
+  m_streamedTextureSlots.clear();
+  m_textureImage.clear();
+  m_textureImageMemory.clear();
+}
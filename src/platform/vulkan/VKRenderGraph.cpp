@@ -0,0 +1,1043 @@
+#include "platform/vulkan/VKRenderGraph.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+#include "utils/vkutil.hpp"
+
+namespace {
+const vk::AccessFlags2 kWriteAccessMask =
+    vk::AccessFlagBits2::eShaderWrite |
+    vk::AccessFlagBits2::eShaderStorageWrite |
+    vk::AccessFlagBits2::eColorAttachmentWrite |
+    vk::AccessFlagBits2::eDepthStencilAttachmentWrite |
+    vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eHostWrite |
+    vk::AccessFlagBits2::eMemoryWrite;
+
+bool IsFullOverwrite(RGAccess access) {
+  return access == RGAccess::ColorAttachmentWrite ||
+         access == RGAccess::DepthAttachmentWrite ||
+         access == RGAccess::TransferWrite;
+}
+
+// 以eLoad加载的附件保留之前的内容（如分两次绘制的G-Buffer）
+bool LoadsAttachment(const VKRenderProcess& pass, RGResource resource) {
+  for (const auto& attachment : pass.GetColorAttachments()) {
+    if (attachment.resource.index == resource.index) {
+      return attachment.loadOp == vk::AttachmentLoadOp::eLoad;
+    }
+  }
+  const auto& depth = pass.GetDepthAttachment();
+  return depth && depth->resource.index == resource.index &&
+         depth->loadOp == vk::AttachmentLoadOp::eLoad;
+}
+}  // namespace
+
+VKRenderGraph::VKRenderGraph(vk::Device device,
+                             vk::PhysicalDevice physicalDevice)
+    : m_device(device), m_physicalDevice(physicalDevice) {}
+
+VKRenderGraph::~VKRenderGraph() { DestroyTransientResources(); }
+
+RGResource VKRenderGraph::CreateImage(const std::string& name,
+                                      const ImageDesc& desc) {
+  Resource resource;
+  resource.name = name;
+  resource.type = ResourceType::Image;
+  resource.imageDesc = desc;
+  m_resources.push_back(resource);
+  m_compiled = false;
+  return RGResource{static_cast<uint32_t>(m_resources.size() - 1)};
+}
+
+RGResource VKRenderGraph::CreateBuffer(const std::string& name,
+                                       const BufferDesc& desc) {
+  Resource resource;
+  resource.name = name;
+  resource.type = ResourceType::Buffer;
+  resource.bufferDesc = desc;
+  m_resources.push_back(resource);
+  m_compiled = false;
+  return RGResource{static_cast<uint32_t>(m_resources.size() - 1)};
+}
+
+RGResource VKRenderGraph::ImportImage(const std::string& name,
+                                      const ImageDesc& desc, vk::Image image,
+                                      vk::ImageView view,
+                                      vk::ImageLayout initialLayout,
+                                      vk::ImageLayout finalLayout) {
+  Resource resource;
+  resource.name = name;
+  resource.type = ResourceType::Image;
+  resource.imported = true;
+  resource.output = true;
+  resource.imageDesc = desc;
+  resource.image = image;
+  resource.view = view;
+  resource.initialLayout = initialLayout;
+  resource.finalLayout = finalLayout;
+  m_resources.push_back(resource);
+  m_compiled = false;
+  return RGResource{static_cast<uint32_t>(m_resources.size() - 1)};
+}
+
+RGResource VKRenderGraph::ImportBuffer(const std::string& name,
+                                       vk::Buffer buffer, vk::DeviceSize size) {
+  Resource resource;
+  resource.name = name;
+  resource.type = ResourceType::Buffer;
+  resource.imported = true;
+  resource.output = true;
+  resource.bufferDesc.size = size;
+  resource.buffer = buffer;
+  m_resources.push_back(resource);
+  m_compiled = false;
+  return RGResource{static_cast<uint32_t>(m_resources.size() - 1)};
+}
+
+void VKRenderGraph::SetImportedImage(RGResource resource, vk::Image image,
+                                     vk::ImageView view) {
+  Resource& res = GetResource(resource);
+  if (!res.imported) {
+    throw std::logic_error("Only imported images can be replaced");
+  }
+  res.image = image;
+  res.view = view;
+}
+
+void VKRenderGraph::SetImportedBuffer(RGResource resource,
+                                      vk::Buffer buffer) {
+  Resource& res = GetResource(resource);
+  if (!res.imported) {
+    throw std::logic_error("Only imported buffers can be replaced");
+  }
+  res.buffer = buffer;
+}
+
+void VKRenderGraph::MarkOutput(RGResource resource) {
+  GetResource(resource).output = true;
+  m_compiled = false;
+}
+
+VKRenderProcess& VKRenderGraph::AddPass(const std::string& name) {
+  m_compiled = false;
+  return m_passes.emplace_back(name);
+}
+
+void VKRenderGraph::SetAsyncCompute(bool enabled, uint32_t graphicsFamily,
+                                    uint32_t computeFamily) {
+  // 同一队列族上分批提交没有收益，退化为单命令缓冲
+  m_asyncCompute = enabled && graphicsFamily != computeFamily;
+  m_queueFamilies = {graphicsFamily, computeFamily};
+  m_compiled = false;
+}
+
+void VKRenderGraph::Compile() {
+  DestroyTransientResources();
+  m_schedule.clear();
+  m_culledPasses.clear();
+  m_finalBarriers.clear();
+  m_batches.clear();
+  m_releaseBarriers.clear();
+
+  CullPasses();
+  AssignQueues();
+  ComputeLifetimes();
+  CreateTransientResources();
+  AliasTransientMemory();
+  BuildBarriers();
+  m_compiled = true;
+}
+
+void VKRenderGraph::CullPasses() {
+  // 从输出资源出发反向遍历：写入了被需要资源的过程才保留
+  std::vector<bool> needed(m_resources.size(), false);
+  for (size_t i = 0; i < m_resources.size(); i++) {
+    needed[i] = m_resources[i].output;
+  }
+
+  std::vector<bool> alive(m_passes.size(), false);
+  for (size_t p = m_passes.size(); p-- > 0;) {
+    const VKRenderProcess& pass = m_passes[p];
+    bool isAlive = pass.HasSideEffect();
+    for (const auto& write : pass.GetWrites()) {
+      if (needed[write.resource.index]) isAlive = true;
+    }
+    if (!isAlive) continue;
+
+    alive[p] = true;
+    // 完全覆盖的写入之前的内容不再被需要；部分写入仍依赖之前的内容
+    for (const auto& write : pass.GetWrites()) {
+      if (IsFullOverwrite(write.access) &&
+          !LoadsAttachment(pass, write.resource)) {
+        needed[write.resource.index] = false;
+      }
+    }
+    for (const auto& read : pass.GetReads()) {
+      needed[read.resource.index] = true;
+    }
+  }
+
+  for (uint32_t p = 0; p < m_passes.size(); p++) {
+    if (alive[p]) {
+      m_schedule.push_back({p, {}});
+    } else {
+      m_culledPasses.push_back(p);
+    }
+  }
+}
+
+void VKRenderGraph::AssignQueues() {
+  // 首尾的计算过程留在图形队列：首个批次承担帧开头的命令（如查询重置），
+  // 最后一个批次汇合计算队列，导入资源在帧边界始终归图形队列族所有
+  int firstGraphics = -1;
+  int lastGraphics = -1;
+  for (int i = 0; i < static_cast<int>(m_schedule.size()); i++) {
+    if (m_passes[m_schedule[i].pass].GetQueue() == RGQueue::Graphics) {
+      if (firstGraphics < 0) firstGraphics = i;
+      lastGraphics = i;
+    }
+  }
+
+  m_batches.push_back({});
+  for (int i = 0; i < static_cast<int>(m_schedule.size()); i++) {
+    CompiledPass& compiled = m_schedule[i];
+    compiled.queue = RGQueue::Graphics;
+    if (m_asyncCompute && i > firstGraphics && i < lastGraphics) {
+      compiled.queue = m_passes[compiled.pass].GetQueue();
+    }
+    if (m_batches.back().passCount > 0 &&
+        m_batches.back().queue != compiled.queue) {
+      Batch batch;
+      batch.queue = compiled.queue;
+      batch.firstPass = static_cast<uint32_t>(i);
+      m_batches.push_back(batch);
+    }
+    compiled.batch = static_cast<uint32_t>(m_batches.size() - 1);
+    m_batches.back().passCount++;
+  }
+  m_releaseBarriers.resize(m_batches.size());
+}
+
+void VKRenderGraph::ComputeLifetimes() {
+  for (auto& resource : m_resources) {
+    resource.firstUse = -1;
+    resource.lastUse = -1;
+    resource.sharedQueues = false;
+    resource.imageUsage = resource.imageDesc.extraUsage;
+    resource.bufferUsage = resource.bufferDesc.extraUsage;
+  }
+
+  for (int i = 0; i < static_cast<int>(m_schedule.size()); i++) {
+    const VKRenderProcess& pass = m_passes[m_schedule[i].pass];
+    auto touch = [&](const VKRenderProcess::Access& access) {
+      Resource& res = m_resources[access.resource.index];
+      if (res.firstUse < 0) res.firstUse = i;
+      if (m_schedule[res.firstUse].queue != m_schedule[i].queue) {
+        res.sharedQueues = true;
+      }
+      res.lastUse = i;
+      if (res.type == ResourceType::Image) {
+        res.imageUsage |= GetImageUsage(access.access);
+      } else {
+        res.bufferUsage |= GetBufferUsage(access.access);
+      }
+    };
+    for (const auto& read : pass.GetReads()) touch(read);
+    for (const auto& write : pass.GetWrites()) touch(write);
+  }
+}
+
+void VKRenderGraph::CreateTransientResources() {
+  for (auto& res : m_resources) {
+    if (res.imported || res.firstUse < 0) continue;
+
+    if (res.type == ResourceType::Image) {
+      vk::ImageCreateInfo imageInfo;
+      imageInfo.imageType = vk::ImageType::e2D;
+      imageInfo.format = res.imageDesc.format;
+      imageInfo.extent = vk::Extent3D{res.imageDesc.extent.width,
+                                      res.imageDesc.extent.height, 1};
+      imageInfo.mipLevels = 1;
+      imageInfo.arrayLayers = 1;
+      imageInfo.samples = vk::SampleCountFlagBits::e1;
+      imageInfo.tiling = vk::ImageTiling::eOptimal;
+      imageInfo.usage = res.imageUsage;
+      imageInfo.sharingMode = vk::SharingMode::eExclusive;
+      // 两个队列都访问的瞬态资源并发共享，免去所有权转移
+      if (res.sharedQueues) {
+        imageInfo.sharingMode = vk::SharingMode::eConcurrent;
+        imageInfo.queueFamilyIndexCount = 2;
+        imageInfo.pQueueFamilyIndices = m_queueFamilies.data();
+      }
+      imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+      res.image = m_device.createImage(imageInfo);
+      res.memoryRequirements = m_device.getImageMemoryRequirements(res.image);
+    } else {
+      vk::BufferCreateInfo bufferInfo;
+      bufferInfo.size = res.bufferDesc.size;
+      bufferInfo.usage = res.bufferUsage;
+      bufferInfo.sharingMode = vk::SharingMode::eExclusive;
+      if (res.sharedQueues) {
+        bufferInfo.sharingMode = vk::SharingMode::eConcurrent;
+        bufferInfo.queueFamilyIndexCount = 2;
+        bufferInfo.pQueueFamilyIndices = m_queueFamilies.data();
+      }
+      res.buffer = m_device.createBuffer(bufferInfo);
+      res.memoryRequirements = m_device.getBufferMemoryRequirements(res.buffer);
+    }
+  }
+}
+
+void VKRenderGraph::AliasTransientMemory() {
+  // 按大小降序贪心放置：生命周期不重叠的瞬态图像共享同一内存块
+  std::vector<uint32_t> images;
+  for (uint32_t i = 0; i < m_resources.size(); i++) {
+    const Resource& res = m_resources[i];
+    if (!res.imported && res.firstUse >= 0 &&
+        res.type == ResourceType::Image) {
+      images.push_back(i);
+    }
+  }
+  std::stable_sort(images.begin(), images.end(), [&](uint32_t a, uint32_t b) {
+    return m_resources[a].memoryRequirements.size >
+           m_resources[b].memoryRequirements.size;
+  });
+
+  for (uint32_t index : images) {
+    Resource& res = m_resources[index];
+    int chosen = -1;
+    for (size_t b = 0; b < m_memoryBlocks.size() && chosen < 0; b++) {
+      MemoryBlock& block = m_memoryBlocks[b];
+      if (!(block.memoryTypeBits & res.memoryRequirements.memoryTypeBits)) {
+        continue;
+      }
+      bool overlaps = false;
+      for (uint32_t other : block.resources) {
+        const Resource& o = m_resources[other];
+        if (o.type != ResourceType::Image ||
+            !(res.lastUse < o.firstUse || o.lastUse < res.firstUse)) {
+          overlaps = true;
+          break;
+        }
+      }
+      if (!overlaps) chosen = static_cast<int>(b);
+    }
+
+    if (chosen < 0) {
+      m_memoryBlocks.push_back({});
+      chosen = static_cast<int>(m_memoryBlocks.size() - 1);
+      m_memoryBlocks.back().memoryTypeBits =
+          res.memoryRequirements.memoryTypeBits;
+    }
+
+    MemoryBlock& block = m_memoryBlocks[chosen];
+    // 记录同一块内紧邻的前一个占用者，用于首次使用时的别名屏障
+    int predecessorLastUse = -1;
+    for (uint32_t other : block.resources) {
+      const Resource& o = m_resources[other];
+      if (o.lastUse < res.firstUse && o.lastUse > predecessorLastUse) {
+        predecessorLastUse = o.lastUse;
+        res.aliasPredecessor = static_cast<int>(other);
+      }
+    }
+    for (uint32_t other : block.resources) {
+      Resource& o = m_resources[other];
+      if (o.firstUse > res.lastUse &&
+          (o.aliasPredecessor < 0 ||
+           m_resources[o.aliasPredecessor].lastUse < res.lastUse)) {
+        o.aliasPredecessor = static_cast<int>(index);
+      }
+    }
+
+    block.resources.push_back(index);
+    block.memoryTypeBits &= res.memoryRequirements.memoryTypeBits;
+    block.size = std::max(block.size, res.memoryRequirements.size);
+    res.memoryBlock = chosen;
+  }
+
+  // 瞬态缓冲不做别名，各自独占一个内存块
+  for (uint32_t i = 0; i < m_resources.size(); i++) {
+    Resource& res = m_resources[i];
+    if (res.imported || res.firstUse < 0 ||
+        res.type != ResourceType::Buffer) {
+      continue;
+    }
+    MemoryBlock block;
+    block.size = res.memoryRequirements.size;
+    block.memoryTypeBits = res.memoryRequirements.memoryTypeBits;
+    block.resources.push_back(i);
+    m_memoryBlocks.push_back(block);
+    res.memoryBlock = static_cast<int>(m_memoryBlocks.size() - 1);
+  }
+
+  // 分配内存并绑定
+  for (auto& block : m_memoryBlocks) {
+    vk::MemoryAllocateInfo allocInfo;
+    allocInfo.allocationSize = block.size;
+    allocInfo.memoryTypeIndex =
+        vkutil::FindMemoryType(m_physicalDevice, block.memoryTypeBits,
+                               vk::MemoryPropertyFlagBits::eDeviceLocal);
+    block.memory = m_device.allocateMemory(allocInfo);
+
+    for (uint32_t index : block.resources) {
+      Resource& res = m_resources[index];
+      if (res.type == ResourceType::Image) {
+        m_device.bindImageMemory(res.image, block.memory, 0);
+
+        vk::ImageViewCreateInfo viewInfo;
+        viewInfo.image = res.image;
+        viewInfo.viewType = vk::ImageViewType::e2D;
+        viewInfo.format = res.imageDesc.format;
+        viewInfo.subresourceRange.aspectMask = res.imageDesc.aspect;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+        res.view = m_device.createImageView(viewInfo);
+      } else {
+        m_device.bindBufferMemory(res.buffer, block.memory, 0);
+      }
+    }
+  }
+}
+
+void VKRenderGraph::BuildBarriers() {
+  // 瞬态资源跨帧复用：首次使用需等待上一帧（或别名前驱）的全部访问
+  std::vector<vk::PipelineStageFlags2> frameStages(m_resources.size());
+  std::vector<vk::AccessFlags2> frameWrites(m_resources.size());
+  for (const auto& compiled : m_schedule) {
+    const VKRenderProcess& pass = m_passes[compiled.pass];
+    auto collect = [&](const VKRenderProcess::Access& access) {
+      const Resource& res = m_resources[access.resource.index];
+      AccessInfo info = GetAccessInfo(
+          access.access, res.type == ResourceType::Image &&
+                             (res.imageDesc.aspect &
+                              vk::ImageAspectFlagBits::eDepth));
+      frameStages[access.resource.index] |= info.stage;
+      frameWrites[access.resource.index] |= info.access & kWriteAccessMask;
+    };
+    for (const auto& read : pass.GetReads()) collect(read);
+    for (const auto& write : pass.GetWrites()) collect(write);
+  }
+
+  std::vector<ResourceState> states(m_resources.size());
+  for (uint32_t i = 0; i < m_resources.size(); i++) {
+    const Resource& res = m_resources[i];
+    ResourceState& state = states[i];
+    if (res.imported) {
+      // 导入资源可能在之前的提交中被写入（如跨帧保留的深度金字塔）
+      state.stages = vk::PipelineStageFlagBits2::eAllCommands;
+      state.access = vk::AccessFlagBits2::eMemoryWrite;
+      state.written = true;
+      state.layout = res.initialLayout;
+    } else {
+      uint32_t source =
+          res.aliasPredecessor >= 0 ? res.aliasPredecessor : i;
+      state.stages = frameStages[source] | frameStages[i];
+      state.access = frameWrites[source] | frameWrites[i];
+      state.written = static_cast<bool>(state.access);
+      state.layout = vk::ImageLayout::eUndefined;
+      // 别名前驱可能在另一队列上，首次使用需等待其所在批次
+      if (res.aliasPredecessor >= 0) {
+        const CompiledPass& last =
+            m_schedule[m_resources[res.aliasPredecessor].lastUse];
+        state.queue = last.queue;
+        state.batch = static_cast<int>(last.batch);
+      }
+    }
+  }
+
+  for (auto& compiled : m_schedule) {
+    const VKRenderProcess& pass = m_passes[compiled.pass];
+
+    // 合并同一过程对同一资源的多次访问
+    std::vector<std::pair<uint32_t, AccessInfo>> merged;
+    auto merge = [&](const VKRenderProcess::Access& access) {
+      const Resource& res = m_resources[access.resource.index];
+      AccessInfo info = GetAccessInfo(
+          access.access, res.type == ResourceType::Image &&
+                             (res.imageDesc.aspect &
+                              vk::ImageAspectFlagBits::eDepth));
+      for (auto& [index, existing] : merged) {
+        if (index == access.resource.index) {
+          existing.stage |= info.stage;
+          existing.access |= info.access;
+          // 同一过程内以不同布局访问同一图像时退化为通用布局
+          if (existing.layout != info.layout) {
+            existing.layout = vk::ImageLayout::eGeneral;
+          }
+          existing.write = existing.write || info.write;
+          return;
+        }
+      }
+      merged.push_back({access.resource.index, info});
+    };
+    for (const auto& read : pass.GetReads()) merge(read);
+    for (const auto& write : pass.GetWrites()) merge(write);
+
+    Batch& batch = m_batches[compiled.batch];
+    for (const auto& [index, info] : merged) {
+      const Resource& res = m_resources[index];
+      ResourceState& state = states[index];
+      bool isImage = res.type == ResourceType::Image;
+      bool layoutChange = isImage && state.layout != info.layout;
+      bool hazard = state.written || (info.write && state.stages);
+
+      if (state.queue != compiled.queue) {
+        // 跨队列：等待另一队列上最近访问该资源的批次，
+        // 信号量同时提供执行与内存依赖，只剩布局转换与所有权转移
+        batch.waitBatch = std::max(batch.waitBatch, state.batch);
+        bool transfer = res.imported;  // 导入资源为独占共享
+        if (transfer || layoutChange) {
+          Barrier barrier;
+          barrier.resource = index;
+          barrier.oldLayout =
+              isImage ? state.layout : vk::ImageLayout::eUndefined;
+          barrier.newLayout =
+              isImage ? info.layout : vk::ImageLayout::eUndefined;
+          // 与信号量等待的阶段（全部命令）衔接
+          barrier.srcStage = info.stage;
+          barrier.srcAccess = {};
+          barrier.dstStage = info.stage;
+          barrier.dstAccess = info.access;
+          if (transfer) {
+            barrier.srcFamily = GetQueueFamily(state.queue);
+            barrier.dstFamily = GetQueueFamily(compiled.queue);
+            Barrier release = barrier;
+            release.srcStage = GetQueueStages(state.stages, state.queue);
+            release.srcAccess = state.written
+                                    ? (state.access & kWriteAccessMask)
+                                    : vk::AccessFlags2{};
+            release.dstStage = vk::PipelineStageFlagBits2::eNone;
+            release.dstAccess = {};
+            // 帧开始时归图形队列族所有，由首个批次释放
+            m_releaseBarriers[std::max(state.batch, 0)].push_back(release);
+            barrier.srcStage = vk::PipelineStageFlagBits2::eNone;
+          }
+          compiled.barriers.push_back(barrier);
+        }
+        state.stages = info.stage;
+        state.access = info.access;
+        state.layout = info.layout;
+        state.written = info.write;
+        state.queue = compiled.queue;
+        state.batch = static_cast<int>(compiled.batch);
+        continue;
+      }
+      state.batch = static_cast<int>(compiled.batch);
+
+      if (layoutChange || hazard) {
+        Barrier barrier;
+        barrier.resource = index;
+        barrier.srcStage =
+            state.stages ? GetQueueStages(state.stages, compiled.queue)
+                         : vk::PipelineStageFlagBits2::eNone;
+        barrier.srcAccess =
+            state.written ? (state.access & kWriteAccessMask)
+                          : vk::AccessFlags2{};
+        barrier.dstStage = info.stage;
+        barrier.dstAccess = info.access;
+        barrier.oldLayout = isImage ? state.layout : vk::ImageLayout::eUndefined;
+        barrier.newLayout = isImage ? info.layout : vk::ImageLayout::eUndefined;
+        compiled.barriers.push_back(barrier);
+
+        state.stages = info.stage;
+        state.access = info.access;
+        state.layout = info.layout;
+        state.written = info.write;
+      } else {
+        // 同布局的连续读取无需屏障，累积读取阶段供之后的写入等待
+        state.stages |= info.stage;
+        state.access |= info.access;
+      }
+    }
+  }
+
+  // 计算批次至少等待帧首批次（其之前的图形提交包括上一帧全部工作），
+  // 最后一个批次汇合计算队列，图形时间线值与呈现信号量覆盖整帧
+  Batch& lastBatch = m_batches.back();
+  for (size_t b = 1; b < m_batches.size(); b++) {
+    if (m_batches[b].queue == RGQueue::Compute) {
+      m_batches[b].waitBatch = std::max(m_batches[b].waitBatch, 0);
+      lastBatch.waitBatch = static_cast<int>(b);
+    }
+  }
+
+  // 导入图像转换到要求的最终布局（如呈现）
+  for (uint32_t i = 0; i < m_resources.size(); i++) {
+    const Resource& res = m_resources[i];
+    const ResourceState& state = states[i];
+    if (res.imported && state.queue != RGQueue::Graphics) {
+      // 归还图形队列族：计算批次末尾释放，最后一个批次获取
+      Barrier release;
+      release.resource = i;
+      release.srcStage = GetQueueStages(state.stages, state.queue);
+      release.srcAccess = state.written ? (state.access & kWriteAccessMask)
+                                        : vk::AccessFlags2{};
+      release.dstStage = vk::PipelineStageFlagBits2::eNone;
+      release.dstAccess = {};
+      release.oldLayout = state.layout;
+      release.newLayout = state.layout;
+      if (res.type == ResourceType::Image &&
+          res.finalLayout != vk::ImageLayout::eUndefined) {
+        release.newLayout = res.finalLayout;
+      }
+      release.srcFamily = GetQueueFamily(state.queue);
+      release.dstFamily = GetQueueFamily(RGQueue::Graphics);
+      m_releaseBarriers[state.batch].push_back(release);
+
+      Barrier acquire = release;
+      acquire.srcStage = vk::PipelineStageFlagBits2::eNone;
+      acquire.srcAccess = {};
+      // 下一帧首次访问的屏障以全部命令为源，与此衔接
+      acquire.dstStage = vk::PipelineStageFlagBits2::eAllCommands;
+      m_finalBarriers.push_back(acquire);
+      continue;
+    }
+    if (!res.imported || res.type != ResourceType::Image ||
+        res.finalLayout == vk::ImageLayout::eUndefined ||
+        res.finalLayout == state.layout) {
+      continue;
+    }
+    Barrier barrier;
+    barrier.resource = i;
+    barrier.srcStage = state.stages;
+    barrier.srcAccess =
+        state.written ? (state.access & kWriteAccessMask) : vk::AccessFlags2{};
+    barrier.dstStage = vk::PipelineStageFlagBits2::eNone;
+    barrier.dstAccess = {};
+    barrier.oldLayout = state.layout;
+    barrier.newLayout = res.finalLayout;
+    m_finalBarriers.push_back(barrier);
+  }
+}
+
+void VKRenderGraph::Execute(vk::CommandBuffer commandBuffer,
+                            VKProfiler* profiler) const {
+  if (m_batches.size() > 1) {
+    throw std::logic_error(
+        "Render graph with async compute must be executed per batch");
+  }
+  ExecuteBatch(0, commandBuffer, profiler);
+}
+
+void VKRenderGraph::ExecuteBatch(uint32_t batchIndex,
+                                 vk::CommandBuffer commandBuffer,
+                                 VKProfiler* profiler) const {
+  if (!m_compiled) {
+    throw std::logic_error("Render graph must be compiled before execution");
+  }
+  if (batchIndex >= m_batches.size()) {
+    throw std::out_of_range("Invalid render graph batch");
+  }
+  const Batch& batch = m_batches[batchIndex];
+  const auto queueType = batch.queue == RGQueue::Compute
+                             ? VKProfiler::QueueType::Compute
+                             : VKProfiler::QueueType::Graphics;
+
+  auto submitBarriers = [&](const std::vector<Barrier>& barriers) {
+    if (barriers.empty()) return;
+    std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+    std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+    for (const auto& barrier : barriers) {
+      const Resource& res = m_resources[barrier.resource];
+      if (res.type == ResourceType::Image) {
+        vk::ImageMemoryBarrier2 imageBarrier;
+        imageBarrier.srcStageMask = barrier.srcStage;
+        imageBarrier.srcAccessMask = barrier.srcAccess;
+        imageBarrier.dstStageMask = barrier.dstStage;
+        imageBarrier.dstAccessMask = barrier.dstAccess;
+        imageBarrier.oldLayout = barrier.oldLayout;
+        imageBarrier.newLayout = barrier.newLayout;
+        imageBarrier.srcQueueFamilyIndex = barrier.srcFamily;
+        imageBarrier.dstQueueFamilyIndex = barrier.dstFamily;
+        imageBarrier.image = res.image;
+        imageBarrier.subresourceRange.aspectMask = res.imageDesc.aspect;
+        imageBarrier.subresourceRange.baseMipLevel = 0;
+        imageBarrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+        imageBarrier.subresourceRange.baseArrayLayer = 0;
+        imageBarrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+        imageBarriers.push_back(imageBarrier);
+      } else {
+        vk::BufferMemoryBarrier2 bufferBarrier;
+        bufferBarrier.srcStageMask = barrier.srcStage;
+        bufferBarrier.srcAccessMask = barrier.srcAccess;
+        bufferBarrier.dstStageMask = barrier.dstStage;
+        bufferBarrier.dstAccessMask = barrier.dstAccess;
+        bufferBarrier.srcQueueFamilyIndex = barrier.srcFamily;
+        bufferBarrier.dstQueueFamilyIndex = barrier.dstFamily;
+        bufferBarrier.buffer = res.buffer;
+        bufferBarrier.offset = 0;
+        bufferBarrier.size = VK_WHOLE_SIZE;
+        bufferBarriers.push_back(bufferBarrier);
+      }
+    }
+    vk::DependencyInfo dependencyInfo;
+    dependencyInfo.imageMemoryBarrierCount =
+        static_cast<uint32_t>(imageBarriers.size());
+    dependencyInfo.pImageMemoryBarriers = imageBarriers.data();
+    dependencyInfo.bufferMemoryBarrierCount =
+        static_cast<uint32_t>(bufferBarriers.size());
+    dependencyInfo.pBufferMemoryBarriers = bufferBarriers.data();
+    commandBuffer.pipelineBarrier2(dependencyInfo);
+  };
+
+  const int end = static_cast<int>(batch.firstPass + batch.passCount);
+  for (int i = static_cast<int>(batch.firstPass); i < end; i++) {
+    const CompiledPass& compiled = m_schedule[i];
+    const VKRenderProcess& pass = m_passes[compiled.pass];
+    submitBarriers(compiled.barriers);
+
+    // 管线统计只对渲染过程收集；不支持查询继承时跳过使用二级命令缓冲的过程
+    uint32_t scope = UINT32_MAX;
+    if (profiler) {
+      bool statistics =
+          pass.IsRendering() && (!pass.UsesSecondaryCommandBuffers() ||
+                                 profiler->CanInheritQueries());
+      scope = profiler->BeginScope(commandBuffer, pass.GetName(), queueType,
+                                   statistics);
+    }
+
+    if (!pass.IsRendering()) {
+      if (pass.GetExecute()) pass.GetExecute()(commandBuffer, *this);
+      if (profiler) profiler->EndScope(commandBuffer, scope);
+      continue;
+    }
+
+    // 之后不再使用且非输出的附件无需写回
+    auto storeOp = [&](RGResource resource) {
+      const Resource& res = GetResource(resource);
+      return (!res.output && !res.imported && res.lastUse == i)
+                 ? vk::AttachmentStoreOp::eDontCare
+                 : vk::AttachmentStoreOp::eStore;
+    };
+
+    std::vector<vk::RenderingAttachmentInfo> colorAttachments;
+    vk::Extent2D extent;
+    for (const auto& attachment : pass.GetColorAttachments()) {
+      vk::RenderingAttachmentInfo info;
+      info.imageView = GetImageView(attachment.resource);
+      info.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
+      info.loadOp = attachment.loadOp;
+      info.storeOp = storeOp(attachment.resource);
+      info.clearValue.color = attachment.clearValue;
+      colorAttachments.push_back(info);
+      extent = GetImageDesc(attachment.resource).extent;
+    }
+
+    vk::RenderingAttachmentInfo depthAttachment;
+    const auto& depth = pass.GetDepthAttachment();
+    if (depth) {
+      depthAttachment.imageView = GetImageView(depth->resource);
+      depthAttachment.imageLayout =
+          depth->readOnly ? vk::ImageLayout::eDepthStencilReadOnlyOptimal
+                          : vk::ImageLayout::eDepthStencilAttachmentOptimal;
+      depthAttachment.loadOp = depth->loadOp;
+      depthAttachment.storeOp = storeOp(depth->resource);
+      depthAttachment.clearValue.depthStencil = depth->clearValue;
+      extent = GetImageDesc(depth->resource).extent;
+    }
+
+    vk::RenderingInfo renderingInfo;
+    renderingInfo.renderArea = vk::Rect2D{{0, 0}, extent};
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount =
+        static_cast<uint32_t>(colorAttachments.size());
+    renderingInfo.pColorAttachments = colorAttachments.data();
+    renderingInfo.pDepthAttachment = depth ? &depthAttachment : nullptr;
+    if (pass.UsesSecondaryCommandBuffers()) {
+      renderingInfo.flags =
+          vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+    }
+
+    commandBuffer.beginRendering(renderingInfo);
+    if (pass.GetExecute()) pass.GetExecute()(commandBuffer, *this);
+    commandBuffer.endRendering();
+    if (profiler) profiler->EndScope(commandBuffer, scope);
+  }
+
+  submitBarriers(m_releaseBarriers[batchIndex]);
+  if (batchIndex + 1 == m_batches.size()) {
+    submitBarriers(m_finalBarriers);
+  }
+}
+
+uint32_t VKRenderGraph::GetFirstBatch(RGResource resource) const {
+  const Resource& res = GetResource(resource);
+  return res.firstUse >= 0 ? m_schedule[res.firstUse].batch : 0;
+}
+
+void VKRenderGraph::Reset() {
+  DestroyTransientResources();
+  m_resources.clear();
+  m_passes.clear();
+  m_schedule.clear();
+  m_culledPasses.clear();
+  m_finalBarriers.clear();
+  m_batches.clear();
+  m_releaseBarriers.clear();
+  m_compiled = false;
+}
+
+void VKRenderGraph::DestroyTransientResources() {
+  for (auto& res : m_resources) {
+    if (res.imported) continue;
+    if (res.view) m_device.destroyImageView(res.view);
+    if (res.image) m_device.destroyImage(res.image);
+    if (res.buffer) m_device.destroyBuffer(res.buffer);
+    res.view = nullptr;
+    res.image = nullptr;
+    res.buffer = nullptr;
+    res.memoryBlock = -1;
+    res.aliasPredecessor = -1;
+  }
+  for (auto& block : m_memoryBlocks) {
+    m_device.freeMemory(block.memory);
+  }
+  m_memoryBlocks.clear();
+  m_compiled = false;
+}
+
+std::string VKRenderGraph::DumpSchedule() const {
+  std::ostringstream out;
+  out << "RenderGraph: " << m_schedule.size() << " passes, "
+      << m_culledPasses.size() << " culled\n";
+
+  auto barrierText = [&](const Barrier& barrier) {
+    const Resource& res = m_resources[barrier.resource];
+    std::ostringstream line;
+    line << "      barrier " << res.name << ": "
+         << vk::to_string(barrier.srcStage) << " -> "
+         << vk::to_string(barrier.dstStage);
+    if (res.type == ResourceType::Image &&
+        barrier.oldLayout != barrier.newLayout) {
+      line << "  [" << vk::to_string(barrier.oldLayout) << " -> "
+           << vk::to_string(barrier.newLayout) << "]";
+    }
+    if (barrier.srcFamily != barrier.dstFamily) {
+      line << "  (queue family " << barrier.srcFamily << " -> "
+           << barrier.dstFamily << ")";
+    }
+    return line.str();
+  };
+  auto queueName = [](RGQueue queue) {
+    return queue == RGQueue::Compute ? "compute" : "graphics";
+  };
+
+  size_t barrierCount = m_finalBarriers.size();
+  for (size_t i = 0; i < m_schedule.size(); i++) {
+    const CompiledPass& compiled = m_schedule[i];
+    const VKRenderProcess& pass = m_passes[compiled.pass];
+    const Batch& batch = m_batches[compiled.batch];
+    if (m_batches.size() > 1 && batch.firstPass == i) {
+      out << "  batch " << compiled.batch << " (" << queueName(batch.queue)
+          << ")";
+      if (batch.waitBatch >= 0) out << " waits batch " << batch.waitBatch;
+      out << "\n";
+    }
+    out << "  [" << i << "] " << pass.GetName() << "\n";
+    for (const auto& read : pass.GetReads()) {
+      out << "      read  " << m_resources[read.resource.index].name << "\n";
+    }
+    for (const auto& write : pass.GetWrites()) {
+      out << "      write " << m_resources[write.resource.index].name << "\n";
+    }
+    for (const auto& barrier : compiled.barriers) {
+      out << barrierText(barrier) << "\n";
+    }
+    barrierCount += compiled.barriers.size();
+    const auto& releases = m_releaseBarriers[compiled.batch];
+    if (i + 1 == batch.firstPass + batch.passCount && !releases.empty()) {
+      out << "  [release]\n";
+      for (const auto& barrier : releases) {
+        out << barrierText(barrier) << "\n";
+      }
+      barrierCount += releases.size();
+    }
+  }
+  if (!m_finalBarriers.empty()) {
+    out << "  [final]\n";
+    for (const auto& barrier : m_finalBarriers) {
+      out << barrierText(barrier) << "\n";
+    }
+  }
+  out << "  barriers: " << barrierCount << "\n";
+
+  for (uint32_t culled : m_culledPasses) {
+    out << "  culled: " << m_passes[culled].GetName() << "\n";
+  }
+
+  for (size_t b = 0; b < m_memoryBlocks.size(); b++) {
+    const MemoryBlock& block = m_memoryBlocks[b];
+    out << "  memory block " << b << " (" << block.size << " bytes):";
+    for (uint32_t index : block.resources) {
+      const Resource& res = m_resources[index];
+      out << " " << res.name << "[" << res.firstUse << "," << res.lastUse
+          << "]";
+    }
+    out << "\n";
+  }
+  out << "  transient memory: " << GetTransientMemorySize() << " bytes ("
+      << GetTransientMemorySizeWithoutAliasing() << " without aliasing)\n";
+  return out.str();
+}
+
+vk::Image VKRenderGraph::GetImage(RGResource resource) const {
+  return GetResource(resource).image;
+}
+
+vk::ImageView VKRenderGraph::GetImageView(RGResource resource) const {
+  return GetResource(resource).view;
+}
+
+vk::Buffer VKRenderGraph::GetBuffer(RGResource resource) const {
+  return GetResource(resource).buffer;
+}
+
+const VKRenderGraph::ImageDesc& VKRenderGraph::GetImageDesc(
+    RGResource resource) const {
+  return GetResource(resource).imageDesc;
+}
+
+vk::DeviceSize VKRenderGraph::GetTransientMemorySize() const {
+  vk::DeviceSize total = 0;
+  for (const auto& block : m_memoryBlocks) total += block.size;
+  return total;
+}
+
+vk::DeviceSize VKRenderGraph::GetTransientMemorySizeWithoutAliasing() const {
+  vk::DeviceSize total = 0;
+  for (const auto& res : m_resources) {
+    if (!res.imported && res.firstUse >= 0) {
+      total += res.memoryRequirements.size;
+    }
+  }
+  return total;
+}
+
+VKRenderGraph::Resource& VKRenderGraph::GetResource(RGResource resource) {
+  if (!resource.IsValid() || resource.index >= m_resources.size()) {
+    throw std::out_of_range("Invalid render graph resource");
+  }
+  return m_resources[resource.index];
+}
+
+const VKRenderGraph::Resource& VKRenderGraph::GetResource(
+    RGResource resource) const {
+  if (!resource.IsValid() || resource.index >= m_resources.size()) {
+    throw std::out_of_range("Invalid render graph resource");
+  }
+  return m_resources[resource.index];
+}
+
+vk::PipelineStageFlags2 VKRenderGraph::GetQueueStages(
+    vk::PipelineStageFlags2 stages, RGQueue queue) {
+  using Stage = vk::PipelineStageFlagBits2;
+  const vk::PipelineStageFlags2 computeStages =
+      Stage::eComputeShader | Stage::eDrawIndirect | Stage::eTransfer |
+      Stage::eCopy | Stage::eClear | Stage::eAllCommands;
+  if (queue == RGQueue::Compute && (stages & ~computeStages)) {
+    return Stage::eAllCommands;
+  }
+  return stages;
+}
+
+VKRenderGraph::AccessInfo VKRenderGraph::GetAccessInfo(RGAccess access,
+                                                       bool depth) {
+  using Stage = vk::PipelineStageFlagBits2;
+  using Access = vk::AccessFlagBits2;
+  using Layout = vk::ImageLayout;
+  const vk::PipelineStageFlags2 depthStages =
+      Stage::eEarlyFragmentTests | Stage::eLateFragmentTests;
+  const Layout sampledLayout =
+      depth ? Layout::eDepthStencilReadOnlyOptimal
+            : Layout::eShaderReadOnlyOptimal;
+
+  switch (access) {
+    case RGAccess::ColorAttachmentWrite:
+      return {Stage::eColorAttachmentOutput,
+              Access::eColorAttachmentRead | Access::eColorAttachmentWrite,
+              Layout::eColorAttachmentOptimal, true};
+    case RGAccess::DepthAttachmentWrite:
+      return {depthStages,
+              Access::eDepthStencilAttachmentRead |
+                  Access::eDepthStencilAttachmentWrite,
+              Layout::eDepthStencilAttachmentOptimal, true};
+    case RGAccess::DepthAttachmentRead:
+      return {depthStages, Access::eDepthStencilAttachmentRead,
+              Layout::eDepthStencilReadOnlyOptimal, false};
+    case RGAccess::FragmentSampledRead:
+      return {Stage::eFragmentShader, Access::eShaderSampledRead,
+              sampledLayout, false};
+    case RGAccess::ComputeSampledRead:
+      return {Stage::eComputeShader, Access::eShaderSampledRead,
+              sampledLayout, false};
+    case RGAccess::ComputeStorageRead:
+      return {Stage::eComputeShader, Access::eShaderStorageRead,
+              Layout::eGeneral, false};
+    case RGAccess::ComputeStorageWrite:
+      return {Stage::eComputeShader,
+              Access::eShaderStorageRead | Access::eShaderStorageWrite,
+              Layout::eGeneral, true};
+    case RGAccess::TransferRead:
+      return {Stage::eTransfer, Access::eTransferRead,
+              Layout::eTransferSrcOptimal, false};
+    case RGAccess::TransferWrite:
+      return {Stage::eTransfer, Access::eTransferWrite,
+              Layout::eTransferDstOptimal, true};
+    case RGAccess::VertexShaderRead:
+      return {Stage::eVertexShader, Access::eShaderRead,
+              Layout::eShaderReadOnlyOptimal, false};
+    case RGAccess::FragmentShaderRead:
+      return {Stage::eFragmentShader, Access::eShaderRead,
+              Layout::eShaderReadOnlyOptimal, false};
+    case RGAccess::IndirectRead:
+      return {Stage::eDrawIndirect, Access::eIndirectCommandRead,
+              Layout::eUndefined, false};
+    case RGAccess::Present:
+      return {Stage::eNone, vk::AccessFlags2{}, Layout::ePresentSrcKHR, false};
+  }
+  return {Stage::eAllCommands, Access::eMemoryRead, Layout::eGeneral, false};
+}
+
+vk::ImageUsageFlags VKRenderGraph::GetImageUsage(RGAccess access) {
+  switch (access) {
+    case RGAccess::ColorAttachmentWrite:
+      return vk::ImageUsageFlagBits::eColorAttachment;
+    case RGAccess::DepthAttachmentWrite:
+    case RGAccess::DepthAttachmentRead:
+      return vk::ImageUsageFlagBits::eDepthStencilAttachment;
+    case RGAccess::FragmentSampledRead:
+    case RGAccess::ComputeSampledRead:
+      return vk::ImageUsageFlagBits::eSampled;
+    case RGAccess::ComputeStorageRead:
+    case RGAccess::ComputeStorageWrite:
+      return vk::ImageUsageFlagBits::eStorage;
+    case RGAccess::TransferRead:
+      return vk::ImageUsageFlagBits::eTransferSrc;
+    case RGAccess::TransferWrite:
+      return vk::ImageUsageFlagBits::eTransferDst;
+    default:
+      return {};
+  }
+}
+
+vk::BufferUsageFlags VKRenderGraph::GetBufferUsage(RGAccess access) {
+  switch (access) {
+    case RGAccess::ComputeStorageRead:
+    case RGAccess::ComputeStorageWrite:
+    case RGAccess::VertexShaderRead:
+    case RGAccess::FragmentShaderRead:
+      return vk::BufferUsageFlagBits::eStorageBuffer;
+    case RGAccess::TransferRead:
+      return vk::BufferUsageFlagBits::eTransferSrc;
+    case RGAccess::TransferWrite:
+      return vk::BufferUsageFlagBits::eTransferDst;
+    case RGAccess::IndirectRead:
+      return vk::BufferUsageFlagBits::eIndirectBuffer;
+    default:
+      return {};
+  }
+}
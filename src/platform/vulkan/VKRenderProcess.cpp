@@ -0,0 +1,40 @@
+#include "platform/vulkan/VKRenderProcess.hpp"
+
+VKRenderProcess& VKRenderProcess::Read(RGResource resource, RGAccess access) {
+  m_reads.push_back({resource, access});
+  return *this;
+}
+
+VKRenderProcess& VKRenderProcess::Write(RGResource resource,
+                                        RGAccess access) {
+  m_writes.push_back({resource, access});
+  return *this;
+}
+
+VKRenderProcess& VKRenderProcess::AddColorAttachment(
+    RGResource resource, vk::AttachmentLoadOp loadOp,
+    vk::ClearColorValue clearValue) {
+  m_colorAttachments.push_back({resource, loadOp, clearValue});
+  // 加载已有内容时同时依赖之前的写入
+  if (loadOp == vk::AttachmentLoadOp::eLoad) {
+    Read(resource, RGAccess::ColorAttachmentWrite);
+  }
+  return Write(resource, RGAccess::ColorAttachmentWrite);
+}
+
+VKRenderProcess& VKRenderProcess::SetDepthAttachment(
+    RGResource resource, vk::AttachmentLoadOp loadOp, bool readOnly) {
+  DepthAttachment attachment;
+  attachment.resource = resource;
+  attachment.loadOp = readOnly ? vk::AttachmentLoadOp::eLoad : loadOp;
+  attachment.readOnly = readOnly;
+  m_depthAttachment = attachment;
+
+  if (readOnly) {
+    return Read(resource, RGAccess::DepthAttachmentRead);
+  }
+  if (loadOp == vk::AttachmentLoadOp::eLoad) {
+    Read(resource, RGAccess::DepthAttachmentWrite);
+  }
+  return Write(resource, RGAccess::DepthAttachmentWrite);
+}
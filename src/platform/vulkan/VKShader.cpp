@@ -2,16 +2,31 @@
 
 #include "utils/ShaderLoader.hpp"
 
-VKShader::VKShader(const std::string& shaderName, const std::string& vertexPath,
-                   const std::string& fragmentPath)
-    : name(shaderName) {
-  // 加载着色器代码
-  auto vertexCode = ShaderLoader::LoadSPIRV(vertexPath);
-  auto fragmentCode = ShaderLoader::LoadSPIRV(fragmentPath);
+namespace {
+// FNV-1a 64位
+uint64_t HashCode(uint64_t hash, std::span<const uint32_t> code) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(code.data());
+  for (size_t i = 0; i < code.size_bytes(); i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+}  // namespace
+
+VKShader::VKShader(vk::Device device, const std::string& shaderName,
+                   const std::string& vertexShader,
+                   const std::string& fragmentShader)
+    : name(shaderName), m_device(device) {
+  // 取得着色器代码（默认为构建时嵌入的SPIR-V，不读取文件）
+  ShaderLoader::SPIRVCode vertexCode = ShaderLoader::Load(vertexShader);
+  ShaderLoader::SPIRVCode fragmentCode = ShaderLoader::Load(fragmentShader);
 
   // 创建着色器模块
-  m_vertexModule = CreateShaderModule(vertexCode);
-  m_fragmentModule = CreateShaderModule(fragmentCode);
+  m_vertexModule = CreateShaderModule(vertexCode.Words());
+  m_fragmentModule = CreateShaderModule(fragmentCode.Words());
+  m_codeHash = HashCode(HashCode(0xcbf29ce484222325ull, vertexCode.Words()),
+                        fragmentCode.Words());
 }
 
 VKShader::~VKShader() {
@@ -30,9 +45,9 @@ vk::ShaderModule VKShader::GetFragmentModule() const {
 }
 
 vk::ShaderModule VKShader::CreateShaderModule(
-    const std::vector<uint32_t>& code) {
+    std::span<const uint32_t> code) {
   vk::ShaderModuleCreateInfo createInfo;
-  createInfo.codeSize = code.size() * sizeof(uint32_t);
+  createInfo.codeSize = code.size_bytes();
   createInfo.pCode = code.data();
 
   try {
@@ -0,0 +1,361 @@
+#include "platform/vulkan/VKTextureStreamer.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "utils/vkutil.hpp"
+
+VKTextureStreamer::VKTextureStreamer(vk::Device device,
+                                     vk::PhysicalDevice physicalDevice,
+                                     VKFrameScheduler& scheduler,
+                                     uint32_t transferFamily,
+                                     uint32_t graphicsFamily,
+                                     const Config& config)
+    : m_device(device),
+      m_physicalDevice(physicalDevice),
+      m_scheduler(scheduler),
+      m_config(config) {
+  if (transferFamily != graphicsFamily) {
+    m_queueFamilies = {transferFamily, graphicsFamily};
+  }
+  try {
+    vk::CommandPoolCreateInfo poolInfo;
+    poolInfo.flags = vk::CommandPoolCreateFlagBits::eTransient;
+    poolInfo.queueFamilyIndex = transferFamily;
+    m_commandPool = m_device.createCommandPool(poolInfo);
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create texture streamer: " +
+                             std::string(err.what()));
+  }
+  m_stats.budgetBytes = m_config.budgetBytes;
+}
+
+VKTextureStreamer::~VKTextureStreamer() {
+  for (auto& upload : m_uploads) {
+    FinishUpload(upload);
+    DestroyAllocation(upload.allocation);
+  }
+  for (auto& retired : m_retired) DestroyAllocation(retired.allocation);
+  for (auto& texture : m_textures) DestroyAllocation(texture.current);
+  if (m_commandPool) m_device.destroyCommandPool(m_commandPool);
+}
+
+vk::DeviceSize VKTextureStreamer::MipRangeBytes(const Texture& texture,
+                                                uint32_t firstMip) {
+  return texture.GetTotalBytes() - texture.GetMipOffset(firstMip);
+}
+
+uint32_t VKTextureStreamer::InitialMip(const Texture& texture) const {
+  uint32_t mip = 0;
+  while (mip + 1 < static_cast<uint32_t>(texture.mipLevels) &&
+         static_cast<uint32_t>(std::max(texture.GetMipWidth(mip),
+                                        texture.GetMipHeight(mip))) >
+             m_config.initialSize) {
+    mip++;
+  }
+  return mip;
+}
+
+uint32_t VKTextureStreamer::TargetMip(const StreamedTexture& texture) const {
+  if (m_frame - texture.lastRequestFrame > m_config.evictAfterFrames) {
+    return std::max(InitialMip(texture.source), texture.wantedMip);
+  }
+  return texture.wantedMip;
+}
+
+VKTextureStreamer::Allocation VKTextureStreamer::CreateAllocation(
+    const StreamedTexture& texture, uint32_t firstMip) {
+  const Texture& source = texture.source;
+  Allocation allocation;
+  allocation.firstMip = firstMip;
+
+  vk::ImageCreateInfo imageInfo;
+  imageInfo.imageType = vk::ImageType::e2D;
+  imageInfo.format = texture.format;
+  imageInfo.extent = vk::Extent3D(
+      static_cast<uint32_t>(source.GetMipWidth(firstMip)),
+      static_cast<uint32_t>(source.GetMipHeight(firstMip)), 1);
+  imageInfo.mipLevels = source.mipLevels - firstMip;
+  imageInfo.arrayLayers = 1;
+  imageInfo.samples = vk::SampleCountFlagBits::e1;
+  imageInfo.tiling = vk::ImageTiling::eOptimal;
+  imageInfo.usage =
+      vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+  // 传输队列写入、图形队列采样，队列族不同时并发共享以免所有权转移
+  if (!m_queueFamilies.empty()) {
+    imageInfo.sharingMode = vk::SharingMode::eConcurrent;
+    imageInfo.setQueueFamilyIndices(m_queueFamilies);
+  }
+  imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+  allocation.image = m_device.createImage(imageInfo);
+
+  vk::MemoryRequirements requirements =
+      m_device.getImageMemoryRequirements(allocation.image);
+  vk::MemoryAllocateInfo allocInfo;
+  allocInfo.allocationSize = requirements.size;
+  allocInfo.memoryTypeIndex = vkutil::FindMemoryType(
+      m_physicalDevice, requirements.memoryTypeBits,
+      vk::MemoryPropertyFlagBits::eDeviceLocal);
+  allocation.memory = m_device.allocateMemory(allocInfo);
+  allocation.bytes = requirements.size;
+  m_device.bindImageMemory(allocation.image, allocation.memory, 0);
+
+  vk::ImageViewCreateInfo viewInfo;
+  viewInfo.image = allocation.image;
+  viewInfo.viewType = vk::ImageViewType::e2D;
+  viewInfo.format = texture.format;
+  viewInfo.subresourceRange = vk::ImageSubresourceRange(
+      vk::ImageAspectFlagBits::eColor, 0, imageInfo.mipLevels, 0, 1);
+  allocation.view = m_device.createImageView(viewInfo);
+  return allocation;
+}
+
+void VKTextureStreamer::DestroyAllocation(Allocation& allocation) {
+  if (allocation.view) m_device.destroyImageView(allocation.view);
+  if (allocation.image) m_device.destroyImage(allocation.image);
+  if (allocation.memory) m_device.freeMemory(allocation.memory);
+  allocation = Allocation{};
+}
+
+VKTextureStreamer::Upload VKTextureStreamer::BeginUpload(uint32_t handle,
+                                                         uint32_t firstMip) {
+  const StreamedTexture& texture = m_textures[handle];
+  const Texture& source = texture.source;
+  Upload upload;
+  upload.handle = handle;
+  upload.allocation = CreateAllocation(texture, firstMip);
+
+  // 烘焙数据按mip紧密排列，[firstMip, mipLevels)是一段连续字节
+  vk::DeviceSize bytes = MipRangeBytes(source, firstMip);
+  vkutil::CreateBuffer(m_device, m_physicalDevice, bytes,
+                       vk::BufferUsageFlagBits::eTransferSrc,
+                       vk::MemoryPropertyFlagBits::eHostVisible |
+                           vk::MemoryPropertyFlagBits::eHostCoherent,
+                       upload.staging, upload.stagingMemory);
+  void* mapped = m_device.mapMemory(upload.stagingMemory, 0, bytes);
+  std::memcpy(mapped, source.data.get() + source.GetMipOffset(firstMip),
+              static_cast<size_t>(bytes));
+  m_device.unmapMemory(upload.stagingMemory);
+
+  vk::CommandBufferAllocateInfo allocInfo;
+  allocInfo.commandPool = m_commandPool;
+  allocInfo.level = vk::CommandBufferLevel::ePrimary;
+  allocInfo.commandBufferCount = 1;
+  upload.commandBuffer = m_device.allocateCommandBuffers(allocInfo)[0];
+  vk::CommandBuffer commandBuffer = upload.commandBuffer;
+  commandBuffer.begin(vk::CommandBufferBeginInfo(
+      vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+
+  uint32_t levels = source.mipLevels - firstMip;
+  vk::ImageSubresourceRange range(vk::ImageAspectFlagBits::eColor, 0, levels,
+                                  0, 1);
+  vk::ImageMemoryBarrier2 toTransfer;
+  toTransfer.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+  toTransfer.dstStageMask = vk::PipelineStageFlagBits2::eCopy;
+  toTransfer.dstAccessMask = vk::AccessFlagBits2::eTransferWrite;
+  toTransfer.oldLayout = vk::ImageLayout::eUndefined;
+  toTransfer.newLayout = vk::ImageLayout::eTransferDstOptimal;
+  toTransfer.image = upload.allocation.image;
+  toTransfer.subresourceRange = range;
+  commandBuffer.pipelineBarrier2(vk::DependencyInfo({}, {}, {}, toTransfer));
+
+  vkutil::CopyMipsToImage(commandBuffer, upload.staging,
+                          upload.allocation.image, source, firstMip);
+
+  // 传输队列不支持片元着色阶段：目标作用域留空，
+  // 图形队列在时间线到达触发值之后的提交中才会采样该图像
+  vk::ImageMemoryBarrier2 toShader;
+  toShader.srcStageMask = vk::PipelineStageFlagBits2::eCopy;
+  toShader.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+  toShader.dstStageMask = vk::PipelineStageFlagBits2::eNone;
+  toShader.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+  toShader.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+  toShader.image = upload.allocation.image;
+  toShader.subresourceRange = range;
+  commandBuffer.pipelineBarrier2(vk::DependencyInfo({}, {}, {}, toShader));
+  commandBuffer.end();
+
+  upload.value = m_scheduler.Submit(VKFrameScheduler::QueueType::Transfer,
+                                    commandBuffer);
+  m_stats.uploadedBytes += bytes;
+  return upload;
+}
+
+void VKTextureStreamer::FinishUpload(Upload& upload) {
+  m_scheduler.Wait(VKFrameScheduler::QueueType::Transfer, upload.value);
+  m_device.freeCommandBuffers(m_commandPool, upload.commandBuffer);
+  m_device.destroyBuffer(upload.staging);
+  m_device.freeMemory(upload.stagingMemory);
+}
+
+uint32_t VKTextureStreamer::Register(const Texture& cooked,
+                                     vk::Format format) {
+  uint32_t handle = static_cast<uint32_t>(m_textures.size());
+  StreamedTexture& texture = m_textures.emplace_back();
+  texture.source = cooked;
+  texture.format = format;
+  texture.wantedMip = InitialMip(cooked);
+  texture.lastRequestFrame = m_frame;
+
+  try {
+    // 初始低mip很小，同步完成以保证首帧可用
+    Upload upload = BeginUpload(handle, texture.wantedMip);
+    FinishUpload(upload);
+    texture.current = upload.allocation;
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to upload streamed texture: " +
+                             std::string(err.what()));
+  }
+  m_stats.residentBytes += texture.current.bytes;
+  m_stats.textureCount++;
+  return handle;
+}
+
+void VKTextureStreamer::RequestScreenSize(uint32_t handle, float pixels) {
+  StreamedTexture& texture = m_textures[handle];
+  const Texture& source = texture.source;
+  float size = static_cast<float>(std::max(source.width, source.height));
+  // 每个屏幕像素对应一个纹素的mip（假设UV在对象上展开一次）
+  uint32_t mip = 0;
+  if (pixels > 0.0f && pixels < size) {
+    mip = static_cast<uint32_t>(std::floor(std::log2(size / pixels)));
+  } else if (pixels <= 0.0f) {
+    mip = source.mipLevels - 1;
+  }
+  mip = std::min(mip, static_cast<uint32_t>(source.mipLevels - 1));
+  texture.requestedMip = std::min(texture.requestedMip, mip);
+}
+
+VKTextureStreamer::UpdateResult VKTextureStreamer::Update() {
+  UpdateResult result;
+  m_frame++;
+
+  // 被替换的图像在所有可能引用它的图形提交完成后销毁
+  const uint64_t graphicsCompleted =
+      m_scheduler.GetCompletedValue(VKFrameScheduler::QueueType::Graphics);
+  const uint64_t transferCompleted =
+      m_scheduler.GetCompletedValue(VKFrameScheduler::QueueType::Transfer);
+  for (size_t i = 0; i < m_retired.size();) {
+    Retired& retired = m_retired[i];
+    if (retired.graphicsValue > graphicsCompleted) {
+      i++;
+      continue;
+    }
+    result.retired.push_back(retired.allocation.view);
+    m_textures[retired.handle].retiring--;
+    DestroyAllocation(retired.allocation);
+    m_retired[i] = m_retired.back();
+    m_retired.pop_back();
+  }
+
+  // 完成的上传切换为当前图像
+  for (size_t i = 0; i < m_uploads.size();) {
+    Upload& upload = m_uploads[i];
+    if (upload.value > transferCompleted) {
+      i++;
+      continue;
+    }
+    FinishUpload(upload);
+    StreamedTexture& texture = m_textures[upload.handle];
+    m_stats.residentBytes += upload.allocation.bytes;
+    m_stats.residentBytes -= texture.current.bytes;
+    m_retired.push_back(
+        {upload.handle, texture.current,
+         m_scheduler.GetSubmittedValue(VKFrameScheduler::QueueType::Graphics)});
+    texture.retiring++;
+    texture.current = upload.allocation;
+    texture.uploading = false;
+    result.swapped.push_back(upload.handle);
+    m_uploads[i] = m_uploads.back();
+    m_uploads.pop_back();
+  }
+
+  // 收集本帧反馈
+  for (auto& texture : m_textures) {
+    if (texture.requestedMip != UINT32_MAX) {
+      texture.wantedMip = texture.requestedMip;
+      texture.lastRequestFrame = m_frame;
+      texture.requestedMip = UINT32_MAX;
+    }
+  }
+
+  // 流入候选按缺少的mip级数降序
+  std::vector<uint32_t> streamIn;
+  std::vector<uint32_t> evictable;
+  for (uint32_t handle = 0; handle < m_textures.size(); handle++) {
+    const StreamedTexture& texture = m_textures[handle];
+    if (texture.uploading || texture.retiring > 0) continue;
+    uint32_t target = TargetMip(texture);
+    if (target < texture.current.firstMip) streamIn.push_back(handle);
+    if (target > texture.current.firstMip) evictable.push_back(handle);
+  }
+  std::sort(streamIn.begin(), streamIn.end(), [&](uint32_t a, uint32_t b) {
+    return m_textures[a].current.firstMip - TargetMip(m_textures[a]) >
+           m_textures[b].current.firstMip - TargetMip(m_textures[b]);
+  });
+  // 驱逐候选按最近请求时间升序（最久未用的先驱逐）
+  std::sort(evictable.begin(), evictable.end(), [&](uint32_t a, uint32_t b) {
+    return m_textures[a].lastRequestFrame < m_textures[b].lastRequestFrame;
+  });
+
+  // 预算按切换完成后的常驻量估算（旧图像退休期间短暂超出）
+  vk::DeviceSize projected = m_stats.residentBytes;
+  for (const auto& upload : m_uploads) {
+    projected += upload.allocation.bytes;
+    projected -= m_textures[upload.handle].current.bytes;
+  }
+  vk::DeviceSize uploadBudget = m_config.uploadBytesPerFrame;
+  size_t nextEviction = 0;
+
+  try {
+    for (uint32_t handle : streamIn) {
+      StreamedTexture& texture = m_textures[handle];
+      const Texture& source = texture.source;
+      // 本帧上传量不足时少流入几级，至少一级
+      uint32_t firstMip = TargetMip(texture);
+      while (firstMip + 1 < texture.current.firstMip &&
+             MipRangeBytes(source, firstMip) > uploadBudget) {
+        firstMip++;
+      }
+      vk::DeviceSize bytes = MipRangeBytes(source, firstMip);
+      if (bytes > uploadBudget && uploadBudget < m_config.uploadBytesPerFrame) {
+        break;
+      }
+      vk::DeviceSize growth = bytes - MipRangeBytes(source,
+                                                    texture.current.firstMip);
+
+      // 超出预算时驱逐最久未用的多余mip，腾不出空间则停止流入
+      while (projected + growth > m_config.budgetBytes &&
+             nextEviction < evictable.size()) {
+        uint32_t victim = evictable[nextEviction++];
+        StreamedTexture& evicted = m_textures[victim];
+        uint32_t evictMip = TargetMip(evicted);
+        m_uploads.push_back(BeginUpload(victim, evictMip));
+        evicted.uploading = true;
+        projected -= MipRangeBytes(evicted.source,
+                                   evicted.current.firstMip) -
+                     MipRangeBytes(evicted.source, evictMip);
+        uploadBudget -= std::min(uploadBudget,
+                                 MipRangeBytes(evicted.source, evictMip));
+        m_stats.evictions++;
+      }
+      if (projected + growth > m_config.budgetBytes) break;
+
+      m_uploads.push_back(BeginUpload(handle, firstMip));
+      texture.uploading = true;
+      projected += growth;
+      uploadBudget -= std::min(uploadBudget, bytes);
+      m_stats.streamIns++;
+      if (uploadBudget == 0) break;
+    }
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to stream texture: " +
+                             std::string(err.what()));
+  }
+
+  m_stats.budgetBytes = m_config.budgetBytes;
+  m_stats.pendingUploads = static_cast<uint32_t>(m_uploads.size());
+  return result;
+}
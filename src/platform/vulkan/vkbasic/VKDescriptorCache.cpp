@@ -0,0 +1,150 @@
+#include "platform/vulkan/vkbasic/VKDescriptorCache.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+
+namespace {
+template <typename T>
+uint64_t HandleBits(T handle) {
+  return (uint64_t)(static_cast<typename T::CType>(handle));
+}
+
+inline void HashCombine(size_t& seed, uint64_t value) {
+  seed ^= std::hash<uint64_t>()(value) + 0x9e3779b97f4a7c15ULL + (seed << 6) +
+          (seed >> 2);
+}
+}  // namespace
+
+bool VKDescriptorCache::Bindings::operator==(const Bindings& other) const {
+  return uniformBuffer == other.uniformBuffer && images == other.images;
+}
+
+VKDescriptorCache::VKDescriptorCache(
+    vk::Device device, std::shared_ptr<VKDescriptorPool> descriptorPool,
+    vk::DescriptorSetLayout layout)
+    : m_device(device),
+      m_descriptorPool(std::move(descriptorPool)),
+      m_layout(layout) {
+  CreateUpdateTemplate();
+}
+
+VKDescriptorCache::~VKDescriptorCache() {
+  Clear();
+  if (m_updateTemplate) {
+    m_device.destroyDescriptorUpdateTemplate(m_updateTemplate);
+  }
+}
+
+void VKDescriptorCache::CreateUpdateTemplate() {
+  std::array<vk::DescriptorUpdateTemplateEntry, 1 + kImageBindingCount>
+      entries;
+
+  entries[0].dstBinding = 0;
+  entries[0].dstArrayElement = 0;
+  entries[0].descriptorCount = 1;
+  // 每个绘制的变换来自逐帧uniform分配器，以动态偏移绑定
+  entries[0].descriptorType = vk::DescriptorType::eUniformBufferDynamic;
+  entries[0].offset = offsetof(Bindings, uniformBuffer);
+  entries[0].stride = sizeof(vk::DescriptorBufferInfo);
+
+  for (uint32_t i = 0; i < kImageBindingCount; i++) {
+    auto& entry = entries[i + 1];
+    entry.dstBinding = i + 1;
+    entry.dstArrayElement = 0;
+    entry.descriptorCount = 1;
+    entry.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    entry.offset =
+        offsetof(Bindings, images) + i * sizeof(vk::DescriptorImageInfo);
+    entry.stride = sizeof(vk::DescriptorImageInfo);
+  }
+
+  vk::DescriptorUpdateTemplateCreateInfo createInfo;
+  createInfo.descriptorUpdateEntryCount =
+      static_cast<uint32_t>(entries.size());
+  createInfo.pDescriptorUpdateEntries = entries.data();
+  createInfo.templateType = vk::DescriptorUpdateTemplateType::eDescriptorSet;
+  createInfo.descriptorSetLayout = m_layout;
+
+  try {
+    m_updateTemplate = m_device.createDescriptorUpdateTemplate(createInfo);
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create descriptor update template: " +
+                             std::string(err.what()));
+  }
+}
+
+size_t VKDescriptorCache::Hash(const Bindings& bindings) {
+  size_t seed = 0;
+  HashCombine(seed, HandleBits(bindings.uniformBuffer.buffer));
+  HashCombine(seed, bindings.uniformBuffer.offset);
+  HashCombine(seed, bindings.uniformBuffer.range);
+  for (const auto& image : bindings.images) {
+    HashCombine(seed, HandleBits(image.imageView));
+    HashCombine(seed, HandleBits(image.sampler));
+    HashCombine(seed, static_cast<uint64_t>(image.imageLayout));
+  }
+  return seed;
+}
+
+vk::DescriptorSet VKDescriptorCache::GetOrCreate(const Bindings& bindings) {
+  m_stats.frameLookups++;
+
+  size_t hash = Hash(bindings);
+  auto& bucket = m_sets[hash];
+  for (const auto& entry : bucket) {
+    if (entry.bindings == bindings) {
+      m_stats.hits++;
+      return entry.set;
+    }
+  }
+
+  // 未命中：分配新描述符集并通过模板一次性写入
+  m_stats.misses++;
+  vk::DescriptorSet set = m_descriptorPool->AllocateSet(m_layout);
+  m_device.updateDescriptorSetWithTemplate(set, m_updateTemplate, &bindings);
+  m_stats.frameUpdates++;
+
+  bucket.push_back({bindings, set});
+  m_stats.cachedSets++;
+  return set;
+}
+
+void VKDescriptorCache::BeginFrame() {
+  m_stats.frameLookups = 0;
+  m_stats.frameUpdates = 0;
+}
+
+void VKDescriptorCache::Clear() {
+  for (const auto& [hash, bucket] : m_sets) {
+    for (const auto& entry : bucket) {
+      m_descriptorPool->FreeSet(entry.set);
+    }
+  }
+  m_sets.clear();
+  m_stats.cachedSets = 0;
+}
+
+void VKDescriptorCache::Evict(vk::ImageView imageView) {
+  // 视图句柄可能被新视图复用，不清除会命中指向已销毁视图的描述符集
+  for (auto it = m_sets.begin(); it != m_sets.end();) {
+    auto& bucket = it->second;
+    for (size_t i = 0; i < bucket.size();) {
+      const auto& images = bucket[i].bindings.images;
+      bool uses = std::any_of(images.begin(), images.end(),
+                              [imageView](const vk::DescriptorImageInfo& info) {
+                                return info.imageView == imageView;
+                              });
+      if (!uses) {
+        i++;
+        continue;
+      }
+      m_descriptorPool->FreeSet(bucket[i].set);
+      bucket[i] = bucket.back();
+      bucket.pop_back();
+      m_stats.cachedSets--;
+    }
+    it = bucket.empty() ? m_sets.erase(it) : std::next(it);
+  }
+}
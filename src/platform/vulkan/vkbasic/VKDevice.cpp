@@ -10,8 +10,10 @@ VKDevice::~VKDevice() { m_device.destroy(); }
 void VKDevice::getQueue() {
   m_device.getQueue(m_queueFamilyIndices.graphicQueue.value(), 0,
                     &m_graphicsQueue);
-  m_device.getQueue(m_queueFamilyIndices.presentQueue.value(), 0,
-                    &m_presentQueue);
+  if (m_queueFamilyIndices.presentQueue.has_value()) {
+    m_device.getQueue(m_queueFamilyIndices.presentQueue.value(), 0,
+                      &m_presentQueue);
+  }
 
   // 传输队列：如果与图形队列相同，则直接使用图形队列
   if (m_queueFamilyIndices.transferFamily.value() ==
@@ -44,8 +46,8 @@ void VKDevice::findQueueIndices() {
       m_queueFamilyIndices.graphicQueue = i;
     }
 
-    // 查找呈现队列族
-    if (m_physicalDevice.getSurfaceSupportKHR(i, m_surface)) {
+    // 查找呈现队列族（无表面的离屏模式不需要呈现队列）
+    if (m_surface && m_physicalDevice.getSurfaceSupportKHR(i, m_surface)) {
       m_queueFamilyIndices.presentQueue = i;
     }
 
@@ -142,8 +144,10 @@ void VKDevice::createLogicalDevice(const std::vector<const char*>& extensions) {
 
   // 收集所有需要的队列族
   std::set<uint32_t> uniqueQueueFamilies = {
-      m_queueFamilyIndices.graphicQueue.value(),
-      m_queueFamilyIndices.presentQueue.value()};
+      m_queueFamilyIndices.graphicQueue.value()};
+  if (m_queueFamilyIndices.presentQueue.has_value()) {
+    uniqueQueueFamilies.insert(m_queueFamilyIndices.presentQueue.value());
+  }
 
   // 只有当传输队列族与图形队列族不同时才添加
   if (m_queueFamilyIndices.transferFamily.has_value() &&
@@ -171,6 +175,21 @@ void VKDevice::createLogicalDevice(const std::vector<const char*>& extensions) {
   vk::PhysicalDeviceFeatures deviceFeatures;
   deviceFeatures.fillModeNonSolid = VK_TRUE;  // 启用非实心填充模式特性
   deviceFeatures.samplerAnisotropy = VK_TRUE;  // 启用各向异性过滤特性
+  if (m_profilingEnabled) {
+    deviceFeatures.pipelineStatisticsQuery =
+        m_featureSupport.pipelineStatistics;
+    deviceFeatures.inheritedQueries = m_featureSupport.inheritedQueries;
+  }
+  if (m_indirectDrawEnabled) {
+    deviceFeatures.multiDrawIndirect = m_featureSupport.multiDrawIndirect;
+    deviceFeatures.drawIndirectFirstInstance =
+        m_featureSupport.drawIndirectFirstInstance;
+  }
+
+  // 通过PhysicalDeviceFeatures2携带可选特性链
+  vk::PhysicalDeviceFeatures2 deviceFeatures2;
+  deviceFeatures2.features = deviceFeatures;
+  deviceFeatures2.pNext = m_featureChain;
 
   vk::DeviceCreateInfo createInfo;
   createInfo
@@ -178,7 +197,7 @@ void VKDevice::createLogicalDevice(const std::vector<const char*>& extensions) {
       .setPQueueCreateInfos(queueCreateInfos.data());
   createInfo.setEnabledExtensionCount(static_cast<uint32_t>(extensions.size()))
       .setPpEnabledExtensionNames(extensions.data());
-  createInfo.setPEnabledFeatures(&deviceFeatures);
+  createInfo.setPNext(&deviceFeatures2);
 
   // 记录启用的扩展
   m_enabledExtensions.clear();
@@ -199,6 +218,161 @@ void VKDevice::createLogicalDevice() {
   createLogicalDevice(extensionNames);
 }
 
+bool VKDevice::queryDescriptorIndexingSupport() {
+  m_featureSupport.descriptorIndexing = false;
+  if (!isExtensionSupported(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)) {
+    return false;
+  }
+
+  auto features =
+      m_physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2,
+                                    vk::PhysicalDeviceDescriptorIndexingFeatures>();
+  const auto& indexing =
+      features.get<vk::PhysicalDeviceDescriptorIndexingFeatures>();
+
+  auto properties = m_physicalDevice.getProperties2<
+      vk::PhysicalDeviceProperties2,
+      vk::PhysicalDeviceDescriptorIndexingProperties>();
+  const auto& indexingProps =
+      properties.get<vk::PhysicalDeviceDescriptorIndexingProperties>();
+
+  m_featureSupport.descriptorIndexing =
+      indexing.runtimeDescriptorArray &&
+      indexing.shaderSampledImageArrayNonUniformIndexing &&
+      indexing.descriptorBindingPartiallyBound &&
+      indexing.descriptorBindingSampledImageUpdateAfterBind &&
+      indexing.descriptorBindingUpdateUnusedWhilePending;
+  m_featureSupport.maxBindlessTextures =
+      std::min(indexingProps.maxDescriptorSetUpdateAfterBindSampledImages,
+               indexingProps.maxPerStageDescriptorUpdateAfterBindSampledImages);
+  return m_featureSupport.descriptorIndexing;
+}
+
+void VKDevice::enableDescriptorIndexing() {
+  if (m_descriptorIndexingEnabled) return;
+  if (!m_featureSupport.descriptorIndexing &&
+      !queryDescriptorIndexingSupport()) {
+    throw std::runtime_error("Descriptor indexing is not supported!");
+  }
+
+  addRequiredExtension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+  m_descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+  m_descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing =
+      VK_TRUE;
+  m_descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+  m_descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind =
+      VK_TRUE;
+  m_descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending =
+      VK_TRUE;
+  appendFeatureChain(&m_descriptorIndexingFeatures);
+  m_descriptorIndexingEnabled = true;
+}
+
+bool VKDevice::queryVulkan13Support() {
+  if (m_physicalDevice.getProperties().apiVersion < VK_API_VERSION_1_3) {
+    m_featureSupport.dynamicRendering = false;
+    m_featureSupport.synchronization2 = false;
+    return false;
+  }
+
+  auto features =
+      m_physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2,
+                                    vk::PhysicalDeviceVulkan13Features>();
+  const auto& vulkan13 = features.get<vk::PhysicalDeviceVulkan13Features>();
+  m_featureSupport.dynamicRendering = vulkan13.dynamicRendering;
+  m_featureSupport.synchronization2 = vulkan13.synchronization2;
+  return m_featureSupport.dynamicRendering &&
+         m_featureSupport.synchronization2;
+}
+
+void VKDevice::enableVulkan13Features() {
+  if (m_vulkan13Enabled) return;
+  if (!queryVulkan13Support()) {
+    throw std::runtime_error(
+        "Dynamic rendering and synchronization2 are required!");
+  }
+
+  m_vulkan13Features.dynamicRendering = VK_TRUE;
+  m_vulkan13Features.synchronization2 = VK_TRUE;
+  appendFeatureChain(&m_vulkan13Features);
+  m_vulkan13Enabled = true;
+}
+
+void VKDevice::queryProfilingSupport() {
+  vk::PhysicalDeviceFeatures coreFeatures = m_physicalDevice.getFeatures();
+  m_featureSupport.pipelineStatistics = coreFeatures.pipelineStatisticsQuery;
+  m_featureSupport.inheritedQueries = coreFeatures.inheritedQueries;
+
+  m_featureSupport.hostQueryReset = false;
+  if (m_physicalDevice.getProperties().apiVersion >= VK_API_VERSION_1_2) {
+    auto features = m_physicalDevice.getFeatures2<
+        vk::PhysicalDeviceFeatures2,
+        vk::PhysicalDeviceHostQueryResetFeatures>();
+    m_featureSupport.hostQueryReset =
+        features.get<vk::PhysicalDeviceHostQueryResetFeatures>()
+            .hostQueryReset;
+  }
+}
+
+void VKDevice::enableProfilingFeatures() {
+  if (m_profilingEnabled) return;
+  queryProfilingSupport();
+  if (m_featureSupport.hostQueryReset) {
+    m_hostQueryResetFeatures.hostQueryReset = VK_TRUE;
+    appendFeatureChain(&m_hostQueryResetFeatures);
+  }
+  m_profilingEnabled = true;
+}
+
+void VKDevice::queryIndirectDrawSupport() {
+  vk::PhysicalDeviceFeatures coreFeatures = m_physicalDevice.getFeatures();
+  m_featureSupport.multiDrawIndirect = coreFeatures.multiDrawIndirect;
+  m_featureSupport.drawIndirectFirstInstance =
+      coreFeatures.drawIndirectFirstInstance;
+  m_featureSupport.drawIndirectCount =
+      isExtensionSupported(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+}
+
+void VKDevice::enableIndirectDrawFeatures() {
+  if (m_indirectDrawEnabled) return;
+  queryIndirectDrawSupport();
+  // 以扩展形式启用，避免与已挂载的描述符索引特性结构体冲突
+  if (m_featureSupport.drawIndirectCount) {
+    addRequiredExtension(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+  }
+  m_indirectDrawEnabled = true;
+}
+
+bool VKDevice::queryTimelineSemaphoreSupport() {
+  m_featureSupport.timelineSemaphore = false;
+  if (m_physicalDevice.getProperties().apiVersion < VK_API_VERSION_1_2) {
+    return false;
+  }
+  auto features = m_physicalDevice.getFeatures2<
+      vk::PhysicalDeviceFeatures2,
+      vk::PhysicalDeviceTimelineSemaphoreFeatures>();
+  m_featureSupport.timelineSemaphore =
+      features.get<vk::PhysicalDeviceTimelineSemaphoreFeatures>()
+          .timelineSemaphore;
+  return m_featureSupport.timelineSemaphore;
+}
+
+void VKDevice::enableTimelineSemaphore() {
+  if (m_timelineSemaphoreEnabled) return;
+  if (queryTimelineSemaphoreSupport()) {
+    m_timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+    appendFeatureChain(&m_timelineSemaphoreFeatures);
+  }
+  m_timelineSemaphoreEnabled = true;
+}
+
+void VKDevice::appendFeatureChain(void* feature) {
+  // 所有Vulkan特性结构体都以sType+pNext开头
+  auto* header = static_cast<vk::BaseOutStructure*>(feature);
+  header->pNext = static_cast<vk::BaseOutStructure*>(m_featureChain);
+  m_featureChain = feature;
+}
+
 vk::Format VKDevice::findSupportedFormat(
     const std::vector<vk::Format>& candidates, vk::ImageTiling tiling,
     vk::FormatFeatureFlags features) {
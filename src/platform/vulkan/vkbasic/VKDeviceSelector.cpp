@@ -0,0 +1,241 @@
+#include "platform/vulkan/vkbasic/VKDeviceSelector.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+bool HasExtension(const std::vector<vk::ExtensionProperties>& extensions,
+                  const char* name) {
+  return std::any_of(extensions.begin(), extensions.end(),
+                     [name](const vk::ExtensionProperties& extension) {
+                       return std::string(extension.extensionName.data()) ==
+                              name;
+                     });
+}
+
+std::string ToLower(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  return text;
+}
+
+const char* TypeName(vk::PhysicalDeviceType type) {
+  switch (type) {
+    case vk::PhysicalDeviceType::eDiscreteGpu:
+      return "discrete";
+    case vk::PhysicalDeviceType::eIntegratedGpu:
+      return "integrated";
+    case vk::PhysicalDeviceType::eVirtualGpu:
+      return "virtual";
+    case vk::PhysicalDeviceType::eCpu:
+      return "cpu";
+    default:
+      return "other";
+  }
+}
+
+// 不满足最低要求时返回原因，满足时返回空串
+std::string CheckRequirements(const DeviceCapabilities& caps,
+                              bool needPresent) {
+  if (caps.apiVersion < VK_API_VERSION_1_3) return "Vulkan 1.3 unavailable";
+  if (!caps.dynamicRendering || !caps.synchronization2) {
+    return "dynamic rendering or synchronization2 unsupported";
+  }
+  if (!caps.graphicsQueue) return "no graphics queue";
+  if (needPresent && !caps.presentSupport) return "cannot present to surface";
+  if (needPresent && !caps.swapchain) return "VK_KHR_swapchain unsupported";
+  return {};
+}
+}  // namespace
+
+std::string DeviceCapabilities::ToString() const {
+  std::ostringstream stream;
+  stream << name << " [" << TypeName(type) << ", Vulkan "
+         << VK_API_VERSION_MAJOR(apiVersion) << "."
+         << VK_API_VERSION_MINOR(apiVersion) << ", "
+         << deviceLocalBytes / (1024 * 1024) << " MiB local]";
+  auto flag = [&stream](const char* label, bool value) {
+    if (value) stream << " " << label;
+  };
+  flag("timeline", timelineSemaphore);
+  flag("bindless", descriptorIndexing);
+  flag("drawIndirectCount", drawIndirectCount);
+  flag("multiDrawIndirect", multiDrawIndirect);
+  flag("bc", textureCompressionBC);
+  flag("asyncCompute", dedicatedCompute);
+  flag("asyncTransfer", dedicatedTransfer);
+  return stream.str();
+}
+
+DeviceCapabilities VKDeviceSelector::QueryCapabilities(
+    vk::PhysicalDevice device, vk::SurfaceKHR surface) {
+  DeviceCapabilities caps;
+  vk::PhysicalDeviceProperties properties = device.getProperties();
+  caps.name = properties.deviceName.data();
+  caps.type = properties.deviceType;
+  caps.apiVersion = properties.apiVersion;
+
+  vk::PhysicalDeviceMemoryProperties memory = device.getMemoryProperties();
+  for (uint32_t i = 0; i < memory.memoryHeapCount; i++) {
+    if (memory.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal) {
+      caps.deviceLocalBytes =
+          std::max(caps.deviceLocalBytes, memory.memoryHeaps[i].size);
+    }
+  }
+
+  // 与VKDevice::findQueueIndices的专用队列族判定一致
+  auto families = device.getQueueFamilyProperties();
+  caps.presentSupport = !surface;
+  for (uint32_t i = 0; i < families.size(); i++) {
+    vk::QueueFlags flags = families[i].queueFlags;
+    bool graphics = static_cast<bool>(flags & vk::QueueFlagBits::eGraphics);
+    bool compute = static_cast<bool>(flags & vk::QueueFlagBits::eCompute);
+    bool transfer = static_cast<bool>(flags & vk::QueueFlagBits::eTransfer);
+    caps.graphicsQueue |= graphics;
+    caps.dedicatedCompute |= compute && !graphics;
+    caps.dedicatedTransfer |= transfer && !graphics && !compute;
+    if (surface && device.getSurfaceSupportKHR(i, surface)) {
+      caps.presentSupport = true;
+    }
+  }
+
+  auto extensions = device.enumerateDeviceExtensionProperties();
+  caps.swapchain = HasExtension(extensions, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+  caps.drawIndirectCount =
+      HasExtension(extensions, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+  vk::PhysicalDeviceFeatures core = device.getFeatures();
+  caps.multiDrawIndirect = core.multiDrawIndirect;
+  caps.textureCompressionBC = core.textureCompressionBC;
+
+  // 各项特性按VKDevice的启用条件分别查询（版本不足时不挂载对应结构体）
+  if (HasExtension(extensions, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)) {
+    auto features = device.getFeatures2<
+        vk::PhysicalDeviceFeatures2,
+        vk::PhysicalDeviceDescriptorIndexingFeatures>();
+    const auto& indexing =
+        features.get<vk::PhysicalDeviceDescriptorIndexingFeatures>();
+    caps.descriptorIndexing =
+        indexing.runtimeDescriptorArray &&
+        indexing.shaderSampledImageArrayNonUniformIndexing &&
+        indexing.descriptorBindingPartiallyBound &&
+        indexing.descriptorBindingSampledImageUpdateAfterBind &&
+        indexing.descriptorBindingUpdateUnusedWhilePending;
+  }
+  if (caps.apiVersion >= VK_API_VERSION_1_2) {
+    auto features = device.getFeatures2<
+        vk::PhysicalDeviceFeatures2,
+        vk::PhysicalDeviceTimelineSemaphoreFeatures>();
+    caps.timelineSemaphore =
+        features.get<vk::PhysicalDeviceTimelineSemaphoreFeatures>()
+            .timelineSemaphore;
+  }
+  if (caps.apiVersion >= VK_API_VERSION_1_3) {
+    auto features =
+        device.getFeatures2<vk::PhysicalDeviceFeatures2,
+                            vk::PhysicalDeviceVulkan13Features>();
+    const auto& vulkan13 = features.get<vk::PhysicalDeviceVulkan13Features>();
+    caps.dynamicRendering = vulkan13.dynamicRendering;
+    caps.synchronization2 = vulkan13.synchronization2;
+  }
+  return caps;
+}
+
+int64_t VKDeviceSelector::Score(const DeviceCapabilities& caps) {
+  int64_t score = 0;
+  switch (caps.type) {
+    case vk::PhysicalDeviceType::eDiscreteGpu:
+      score += 10000;
+      break;
+    case vk::PhysicalDeviceType::eIntegratedGpu:
+      score += 5000;
+      break;
+    case vk::PhysicalDeviceType::eVirtualGpu:
+      score += 3000;
+      break;
+    case vk::PhysicalDeviceType::eCpu:
+      score += 100;
+      break;
+    default:
+      score += 1000;
+      break;
+  }
+  // 显存每GiB计100分，上限16GiB，不足以跨越设备类型的差距
+  vk::DeviceSize gib = caps.deviceLocalBytes >> 30;
+  score += static_cast<int64_t>(std::min<vk::DeviceSize>(gib, 16)) * 100;
+  // 可选特性按对渲染器快速路径的影响加分
+  if (caps.descriptorIndexing) score += 400;
+  if (caps.drawIndirectCount) score += 300;
+  if (caps.multiDrawIndirect) score += 200;
+  if (caps.timelineSemaphore) score += 200;
+  if (caps.dedicatedCompute) score += 200;
+  if (caps.dedicatedTransfer) score += 100;
+  if (caps.textureCompressionBC) score += 100;
+  return score;
+}
+
+std::vector<VKDeviceSelector::Candidate> VKDeviceSelector::RankDevices(
+    vk::Instance instance, vk::SurfaceKHR surface) {
+  std::vector<Candidate> candidates;
+  auto devices = instance.enumeratePhysicalDevices();
+  for (uint32_t i = 0; i < devices.size(); i++) {
+    Candidate candidate;
+    candidate.device = devices[i];
+    candidate.index = i;
+    candidate.capabilities = QueryCapabilities(devices[i], surface);
+    candidate.rejectReason = CheckRequirements(
+        candidate.capabilities, static_cast<bool>(surface));
+    candidate.suitable = candidate.rejectReason.empty();
+    candidate.score = Score(candidate.capabilities);
+    candidates.push_back(std::move(candidate));
+  }
+  // 稳定排序：同分时保持驱动的枚举顺序
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Candidate& a, const Candidate& b) {
+                     if (a.suitable != b.suitable) return a.suitable;
+                     return a.score > b.score;
+                   });
+  return candidates;
+}
+
+bool VKDeviceSelector::Matches(const Candidate& candidate,
+                               const std::string& override) {
+  std::string key = ToLower(override);
+  bool numeric = !key.empty() && key.size() <= 9 &&
+                 std::all_of(key.begin(), key.end(), [](unsigned char c) {
+                   return std::isdigit(c);
+                 });
+  if (numeric) return std::stoul(key) == candidate.index;
+  if (key == TypeName(candidate.capabilities.type)) return true;
+  return ToLower(candidate.capabilities.name).find(key) != std::string::npos;
+}
+
+VKDeviceSelector::Candidate VKDeviceSelector::Select(
+    const std::vector<Candidate>& candidates, const std::string& override) {
+  if (candidates.empty()) {
+    throw std::runtime_error("No Vulkan physical device available");
+  }
+  if (!override.empty()) {
+    // 候选已按分数排序，匹配多个设备时取分数最高的合格设备
+    for (const auto& candidate : candidates) {
+      if (candidate.suitable && Matches(candidate, override)) {
+        return candidate;
+      }
+    }
+  }
+  if (!candidates.front().suitable) {
+    throw std::runtime_error("No suitable Vulkan physical device: " +
+                             candidates.front().capabilities.name + " (" +
+                             candidates.front().rejectReason + ")");
+  }
+  return candidates.front();
+}
+
+std::string VKDeviceSelector::GetOverrideFromEnvironment() {
+  const char* value = std::getenv(kOverrideVariable);
+  return value ? std::string(value) : std::string();
+}
@@ -0,0 +1,192 @@
+#include "platform/vulkan/vkbasic/VKGeometryPool.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "utils/vkutil.hpp"
+
+VKGeometryPool::VKGeometryPool(vk::Device device,
+                               vk::PhysicalDevice physicalDevice,
+                               vk::Queue queue, vk::CommandPool commandPool,
+                               uint32_t vertexStride,
+                               uint32_t verticesPerBlock,
+                               uint32_t indicesPerBlock)
+    : m_device(device),
+      m_physicalDevice(physicalDevice),
+      m_queue(queue),
+      m_commandPool(commandPool),
+      m_vertexStride(vertexStride),
+      m_verticesPerBlock(verticesPerBlock),
+      m_indicesPerBlock(indicesPerBlock) {}
+
+VKGeometryPool::~VKGeometryPool() {
+  for (auto& block : m_blocks) {
+    m_device.destroyBuffer(block.vertexBuffer);
+    m_device.freeMemory(block.vertexMemory);
+    m_device.destroyBuffer(block.indexBuffer);
+    m_device.freeMemory(block.indexMemory);
+  }
+}
+
+uint32_t VKGeometryPool::CreateBlock(uint32_t vertexCapacity,
+                                     uint32_t indexCapacity) {
+  Block block;
+  block.vertexCapacity = vertexCapacity;
+  block.indexCapacity = indexCapacity;
+  try {
+    vkutil::CreateBuffer(
+        m_device, m_physicalDevice,
+        static_cast<vk::DeviceSize>(vertexCapacity) * m_vertexStride,
+        vk::BufferUsageFlagBits::eVertexBuffer |
+            vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eDeviceLocal, block.vertexBuffer,
+        block.vertexMemory);
+    vkutil::CreateBuffer(
+        m_device, m_physicalDevice,
+        static_cast<vk::DeviceSize>(indexCapacity) * sizeof(uint32_t),
+        vk::BufferUsageFlagBits::eIndexBuffer |
+            vk::BufferUsageFlagBits::eTransferDst,
+        vk::MemoryPropertyFlagBits::eDeviceLocal, block.indexBuffer,
+        block.indexMemory);
+  } catch (const vk::SystemError& err) {
+    throw std::runtime_error("Failed to create geometry pool block: " +
+                             std::string(err.what()));
+  }
+  block.freeVertices.push_back({0, vertexCapacity});
+  block.freeIndices.push_back({0, indexCapacity});
+  m_blocks.push_back(std::move(block));
+
+  m_stats.blockCount = static_cast<uint32_t>(m_blocks.size());
+  m_stats.capacityBytes +=
+      static_cast<vk::DeviceSize>(vertexCapacity) * m_vertexStride +
+      static_cast<vk::DeviceSize>(indexCapacity) * sizeof(uint32_t);
+  return static_cast<uint32_t>(m_blocks.size() - 1);
+}
+
+bool VKGeometryPool::AllocateRange(std::vector<Range>& freeList,
+                                   uint32_t count, uint32_t& offset) {
+  for (auto it = freeList.begin(); it != freeList.end(); ++it) {
+    if (it->count < count) continue;
+    offset = it->offset;
+    it->offset += count;
+    it->count -= count;
+    if (it->count == 0) freeList.erase(it);
+    return true;
+  }
+  return false;
+}
+
+void VKGeometryPool::ReleaseRange(std::vector<Range>& freeList, Range range) {
+  auto it = std::lower_bound(
+      freeList.begin(), freeList.end(), range,
+      [](const Range& a, const Range& b) { return a.offset < b.offset; });
+  it = freeList.insert(it, range);
+
+  // 与后一个区间合并
+  auto next = it + 1;
+  if (next != freeList.end() && it->offset + it->count == next->offset) {
+    it->count += next->count;
+    freeList.erase(next);
+  }
+  // 与前一个区间合并
+  if (it != freeList.begin()) {
+    auto prev = it - 1;
+    if (prev->offset + prev->count == it->offset) {
+      prev->count += it->count;
+      freeList.erase(it);
+    }
+  }
+}
+
+VKGeometryPool::Allocation VKGeometryPool::Upload(const void* vertices,
+                                                  uint32_t vertexCount,
+                                                  const uint32_t* indices,
+                                                  uint32_t indexCount) {
+  Allocation allocation;
+  if (vertexCount == 0 || indexCount == 0) return allocation;
+
+  // 首次适配：顶点与索引须落在同一块中
+  uint32_t vertexOffset = 0;
+  uint32_t indexOffset = 0;
+  for (uint32_t i = 0; i < m_blocks.size() && !allocation.IsValid(); i++) {
+    Block& block = m_blocks[i];
+    if (!AllocateRange(block.freeVertices, vertexCount, vertexOffset)) {
+      continue;
+    }
+    if (!AllocateRange(block.freeIndices, indexCount, indexOffset)) {
+      ReleaseRange(block.freeVertices, {vertexOffset, vertexCount});
+      continue;
+    }
+    allocation.block = i;
+  }
+  if (!allocation.IsValid()) {
+    allocation.block =
+        CreateBlock(std::max(vertexCount, m_verticesPerBlock),
+                    std::max(indexCount, m_indicesPerBlock));
+    Block& block = m_blocks[allocation.block];
+    AllocateRange(block.freeVertices, vertexCount, vertexOffset);
+    AllocateRange(block.freeIndices, indexCount, indexOffset);
+  }
+  allocation.vertexOffset = static_cast<int32_t>(vertexOffset);
+  allocation.vertexCount = vertexCount;
+  allocation.firstIndex = indexOffset;
+  allocation.indexCount = indexCount;
+
+  // 顶点与索引放在同一个暂存缓冲中，一次提交完成两次拷贝
+  const vk::DeviceSize vertexBytes =
+      static_cast<vk::DeviceSize>(vertexCount) * m_vertexStride;
+  const vk::DeviceSize indexBytes =
+      static_cast<vk::DeviceSize>(indexCount) * sizeof(uint32_t);
+  vk::Buffer stagingBuffer;
+  vk::DeviceMemory stagingMemory;
+  vkutil::CreateBuffer(m_device, m_physicalDevice, vertexBytes + indexBytes,
+                       vk::BufferUsageFlagBits::eTransferSrc,
+                       vk::MemoryPropertyFlagBits::eHostVisible |
+                           vk::MemoryPropertyFlagBits::eHostCoherent,
+                       stagingBuffer, stagingMemory);
+  auto* mapped = static_cast<uint8_t*>(
+      m_device.mapMemory(stagingMemory, 0, vertexBytes + indexBytes));
+  std::memcpy(mapped, vertices, static_cast<size_t>(vertexBytes));
+  std::memcpy(mapped + vertexBytes, indices, static_cast<size_t>(indexBytes));
+  m_device.unmapMemory(stagingMemory);
+
+  const Block& block = m_blocks[allocation.block];
+  vk::CommandBuffer commandBuffer =
+      vkutil::BeginSingleTimeCommands(m_device, m_commandPool);
+  commandBuffer.copyBuffer(
+      stagingBuffer, block.vertexBuffer,
+      vk::BufferCopy{0, vertexOffset * vk::DeviceSize(m_vertexStride),
+                     vertexBytes});
+  commandBuffer.copyBuffer(
+      stagingBuffer, block.indexBuffer,
+      vk::BufferCopy{vertexBytes, indexOffset * vk::DeviceSize(4),
+                     indexBytes});
+  vkutil::EndSingleTimeCommands(m_device, m_commandPool, m_queue,
+                                commandBuffer);
+
+  m_device.destroyBuffer(stagingBuffer);
+  m_device.freeMemory(stagingMemory);
+
+  m_stats.allocationCount++;
+  m_stats.vertexBytesUsed += vertexBytes;
+  m_stats.indexBytesUsed += indexBytes;
+  return allocation;
+}
+
+void VKGeometryPool::Free(const Allocation& allocation) {
+  if (!allocation.IsValid()) return;
+  Block& block = m_blocks[allocation.block];
+  ReleaseRange(block.freeVertices,
+               {static_cast<uint32_t>(allocation.vertexOffset),
+                allocation.vertexCount});
+  ReleaseRange(block.freeIndices,
+               {allocation.firstIndex, allocation.indexCount});
+
+  m_stats.allocationCount--;
+  m_stats.vertexBytesUsed -=
+      static_cast<vk::DeviceSize>(allocation.vertexCount) * m_vertexStride;
+  m_stats.indexBytesUsed -=
+      static_cast<vk::DeviceSize>(allocation.indexCount) * sizeof(uint32_t);
+}
@@ -6,7 +6,10 @@
 
 VKInstance::VKInstance(const CreateInfo& info) {
   // --- 1. 收集扩展 ---
-  std::vector<const char*> extensions = GetRequiredPlatformExtensions();
+  std::vector<const char*> extensions;
+  if (!info.headless) {
+    extensions = GetRequiredPlatformExtensions();
+  }
 
   // 添加用户请求的扩展
   for (const auto& ext : info.requiredExtensions) {
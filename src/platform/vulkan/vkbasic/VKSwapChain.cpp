@@ -141,6 +141,8 @@ vk::Extent2D VKSwapChain::ChooseSwapExtent(
 
 void VKSwapChain::Recreate(const vk::Extent2D& newExtent) {
   m_windowExtent = newExtent;
+  // 旧交换链图像可能仍被在途命令引用
+  m_device.waitIdle();
   Cleanup();
   CreateSwapchain();
   CreateImageViews();
@@ -0,0 +1,56 @@
+#include "platform/vulkan/vkbasic/VKUniformArena.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "utils/vkutil.hpp"
+
+VKUniformArena::VKUniformArena(vk::Device device,
+                               vk::PhysicalDevice physicalDevice,
+                               uint32_t framesInFlight,
+                               vk::DeviceSize bytesPerFrame)
+    : m_device(device) {
+  // 对齐要求保证为2的幂
+  m_alignment = std::max<vk::DeviceSize>(
+      physicalDevice.getProperties().limits.minUniformBufferOffsetAlignment,
+      1);
+  m_bytesPerFrame = AlignedSize(bytesPerFrame);
+
+  vk::DeviceSize totalSize = m_bytesPerFrame * framesInFlight;
+  vkutil::CreateBuffer(m_device, physicalDevice, totalSize,
+                       vk::BufferUsageFlagBits::eUniformBuffer,
+                       vk::MemoryPropertyFlagBits::eHostVisible |
+                           vk::MemoryPropertyFlagBits::eHostCoherent,
+                       m_buffer, m_memory);
+  m_mapped = static_cast<uint8_t*>(m_device.mapMemory(m_memory, 0, totalSize));
+}
+
+VKUniformArena::~VKUniformArena() {
+  if (m_mapped) m_device.unmapMemory(m_memory);
+  if (m_buffer) m_device.destroyBuffer(m_buffer);
+  if (m_memory) m_device.freeMemory(m_memory);
+}
+
+void VKUniformArena::BeginFrame(uint32_t frameIndex) {
+  m_peakUsage = std::max(m_peakUsage, m_frameOffset.load());
+  m_frameBase = m_bytesPerFrame * frameIndex;
+  m_frameOffset = 0;
+}
+
+VKUniformArena::Allocation VKUniformArena::Allocate(vk::DeviceSize size,
+                                                    uint32_t count) {
+  vk::DeviceSize total = AlignedSize(size) * count;
+  vk::DeviceSize offset = m_frameOffset.fetch_add(total);
+  if (offset + total > m_bytesPerFrame) {
+    throw std::runtime_error("Uniform arena exhausted: " +
+                             std::to_string(offset + total) + " of " +
+                             std::to_string(m_bytesPerFrame) +
+                             " bytes per frame");
+  }
+
+  Allocation allocation;
+  allocation.mapped = m_mapped + m_frameBase + offset;
+  allocation.offset = static_cast<uint32_t>(m_frameBase + offset);
+  return allocation;
+}
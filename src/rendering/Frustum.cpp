@@ -0,0 +1,271 @@
+#include "rendering/Frustum.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PBR_FRUSTUM_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC无需编译选项即可使用AVX内建函数
+#define PBR_TARGET_AVX2
+#else
+#define PBR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+AABB AABB::Empty() {
+  constexpr float kMax = std::numeric_limits<float>::max();
+  return {glm::vec3(kMax), glm::vec3(-kMax)};
+}
+
+float AABB::SurfaceArea() const {
+  if (IsEmpty()) return 0.0f;
+  glm::vec3 e = Extent();
+  return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+}
+
+AABB AABB::Transformed(const glm::mat4& transform) const {
+  glm::vec3 center = Center();
+  glm::vec3 half = Extent() * 0.5f;
+  glm::vec3 worldCenter = glm::vec3(transform * glm::vec4(center, 1.0f));
+  glm::vec3 worldHalf =
+      glm::abs(glm::vec3(transform[0])) * half.x +
+      glm::abs(glm::vec3(transform[1])) * half.y +
+      glm::abs(glm::vec3(transform[2])) * half.z;
+  return {worldCenter - worldHalf, worldCenter + worldHalf};
+}
+
+Frustum Frustum::FromViewProjection(const glm::mat4& m) {
+  auto row = [&](int i) {
+    return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+  };
+  Frustum frustum;
+  frustum.planes[0] = row(3) + row(0);  // 左
+  frustum.planes[1] = row(3) - row(0);  // 右
+  frustum.planes[2] = row(3) + row(1);  // 下
+  frustum.planes[3] = row(3) - row(1);  // 上
+  frustum.planes[4] = row(2);           // 近
+  frustum.planes[5] = row(3) - row(2);  // 远
+  for (auto& plane : frustum.planes) {
+    float length = glm::length(glm::vec3(plane));
+    if (length > 0.0f) plane /= length;
+  }
+  return frustum;
+}
+
+Frustum::Result Frustum::Classify(const AABB& box) const {
+  Result result = Result::Inside;
+  for (const auto& plane : planes) {
+    // 正顶点在外侧则整个盒在外侧；负顶点在外侧则与平面相交
+    glm::vec3 positive(plane.x >= 0.0f ? box.max.x : box.min.x,
+                       plane.y >= 0.0f ? box.max.y : box.min.y,
+                       plane.z >= 0.0f ? box.max.z : box.min.z);
+    if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f) {
+      return Result::Outside;
+    }
+    glm::vec3 negative(plane.x >= 0.0f ? box.min.x : box.max.x,
+                       plane.y >= 0.0f ? box.min.y : box.max.y,
+                       plane.z >= 0.0f ? box.min.z : box.max.z);
+    if (glm::dot(glm::vec3(plane), negative) + plane.w < 0.0f) {
+      result = Result::Intersect;
+    }
+  }
+  return result;
+}
+
+void AABBArray::Resize(size_t size) {
+  count = size;
+  // 末尾补齐到8的倍数，SIMD路径整批加载
+  size_t padded = (size + 7) / 8 * 8;
+  for (auto* component : {&minX, &minY, &minZ, &maxX, &maxY, &maxZ}) {
+    component->resize(padded, 0.0f);
+  }
+}
+
+void AABBArray::Set(size_t index, const AABB& box) {
+  minX[index] = box.min.x;
+  minY[index] = box.min.y;
+  minZ[index] = box.min.z;
+  maxX[index] = box.max.x;
+  maxY[index] = box.max.y;
+  maxZ[index] = box.max.z;
+}
+
+AABB AABBArray::Get(size_t index) const {
+  return {glm::vec3(minX[index], minY[index], minZ[index]),
+          glm::vec3(maxX[index], maxY[index], maxZ[index])};
+}
+
+namespace {
+
+// 单个盒的正顶点测试，与SIMD路径逐元素一致
+bool TestBoxScalar(const Frustum& frustum, float minX, float minY, float minZ,
+                   float maxX, float maxY, float maxZ) {
+  for (const auto& plane : frustum.planes) {
+    float x = plane.x >= 0.0f ? maxX : minX;
+    float y = plane.y >= 0.0f ? maxY : minY;
+    float z = plane.z >= 0.0f ? maxZ : minZ;
+    if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t TestBoxes8Scalar(const Frustum& frustum, const float* minX,
+                          const float* minY, const float* minZ,
+                          const float* maxX, const float* maxY,
+                          const float* maxZ) {
+  uint32_t mask = 0;
+  for (uint32_t i = 0; i < 8; i++) {
+    if (TestBoxScalar(frustum, minX[i], minY[i], minZ[i], maxX[i], maxY[i],
+                      maxZ[i])) {
+      mask |= 1u << i;
+    }
+  }
+  return mask;
+}
+
+#ifdef PBR_FRUSTUM_X86
+
+uint32_t TestBoxes4SSE(const Frustum& frustum, const float* minX,
+                       const float* minY, const float* minZ,
+                       const float* maxX, const float* maxY,
+                       const float* maxZ) {
+  __m128 loX = _mm_loadu_ps(minX), hiX = _mm_loadu_ps(maxX);
+  __m128 loY = _mm_loadu_ps(minY), hiY = _mm_loadu_ps(maxY);
+  __m128 loZ = _mm_loadu_ps(minZ), hiZ = _mm_loadu_ps(maxZ);
+  __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+  for (const auto& plane : frustum.planes) {
+    __m128 x = plane.x >= 0.0f ? hiX : loX;
+    __m128 y = plane.y >= 0.0f ? hiY : loY;
+    __m128 z = plane.z >= 0.0f ? hiZ : loZ;
+    __m128 d = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), x),
+                   _mm_mul_ps(_mm_set1_ps(plane.y), y)),
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), z),
+                   _mm_set1_ps(plane.w)));
+    visible = _mm_and_ps(visible, _mm_cmpge_ps(d, _mm_setzero_ps()));
+    if (_mm_movemask_ps(visible) == 0) return 0;
+  }
+  return static_cast<uint32_t>(_mm_movemask_ps(visible));
+}
+
+PBR_TARGET_AVX2 uint32_t TestBoxes8AVX2(const Frustum& frustum,
+                                        const float* minX, const float* minY,
+                                        const float* minZ, const float* maxX,
+                                        const float* maxY,
+                                        const float* maxZ) {
+  __m256 loX = _mm256_loadu_ps(minX), hiX = _mm256_loadu_ps(maxX);
+  __m256 loY = _mm256_loadu_ps(minY), hiY = _mm256_loadu_ps(maxY);
+  __m256 loZ = _mm256_loadu_ps(minZ), hiZ = _mm256_loadu_ps(maxZ);
+  __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+  for (const auto& plane : frustum.planes) {
+    __m256 x = plane.x >= 0.0f ? hiX : loX;
+    __m256 y = plane.y >= 0.0f ? hiY : loY;
+    __m256 z = plane.z >= 0.0f ? hiZ : loZ;
+    __m256 d = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), x),
+                      _mm256_mul_ps(_mm256_set1_ps(plane.y), y)),
+        _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z), z),
+                      _mm256_set1_ps(plane.w)));
+    visible = _mm256_and_ps(visible,
+                            _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GE_OQ));
+    if (_mm256_movemask_ps(visible) == 0) return 0;
+  }
+  return static_cast<uint32_t>(_mm256_movemask_ps(visible));
+}
+
+bool CpuSupportsAVX2() {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) return false;
+  __cpuid(info, 1);
+  // 还需操作系统保存YMM寄存器状态
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif  // PBR_FRUSTUM_X86
+
+}  // namespace
+
+namespace FrustumCulling {
+
+Path GetBestPath() {
+#ifdef PBR_FRUSTUM_X86
+  static const Path path = CpuSupportsAVX2() ? Path::AVX2 : Path::SSE;
+  return path;
+#else
+  return Path::Scalar;
+#endif
+}
+
+const char* GetPathName(Path path) {
+  switch (path) {
+    case Path::AVX2:
+      return "AVX2";
+    case Path::SSE:
+      return "SSE";
+    default:
+      return "Scalar";
+  }
+}
+
+uint32_t TestBoxes8(const Frustum& frustum, const float* minX,
+                    const float* minY, const float* minZ, const float* maxX,
+                    const float* maxY, const float* maxZ, Path path) {
+#ifdef PBR_FRUSTUM_X86
+  if (path == Path::AVX2) {
+    return TestBoxes8AVX2(frustum, minX, minY, minZ, maxX, maxY, maxZ);
+  }
+  if (path == Path::SSE) {
+    uint32_t low = TestBoxes4SSE(frustum, minX, minY, minZ, maxX, maxY, maxZ);
+    uint32_t high = TestBoxes4SSE(frustum, minX + 4, minY + 4, minZ + 4,
+                                  maxX + 4, maxY + 4, maxZ + 4);
+    return low | (high << 4);
+  }
+#endif
+  return TestBoxes8Scalar(frustum, minX, minY, minZ, maxX, maxY, maxZ);
+}
+
+void CullBoxes(const Frustum& frustum, const AABBArray& boxes, size_t begin,
+               size_t end, Path path, std::vector<uint32_t>& visible) {
+  end = std::min(end, boxes.count);
+  size_t index = begin;
+  if (path != Path::Scalar) {
+    // 整批8个；末批超出count的补齐元素由掩码截掉
+    const size_t padded = boxes.minX.size();
+    for (; index < end && index + 8 <= padded; index += 8) {
+      uint32_t mask = TestBoxes8(
+          frustum, &boxes.minX[index], &boxes.minY[index], &boxes.minZ[index],
+          &boxes.maxX[index], &boxes.maxY[index], &boxes.maxZ[index], path);
+      if (end - index < 8) mask &= (1u << (end - index)) - 1;
+      while (mask != 0) {
+        uint32_t bit = 0;
+        while ((mask & (1u << bit)) == 0) bit++;
+        mask &= mask - 1;
+        visible.push_back(static_cast<uint32_t>(index + bit));
+      }
+    }
+  }
+  for (; index < end; index++) {
+    if (TestBoxScalar(frustum, boxes.minX[index], boxes.minY[index],
+                      boxes.minZ[index], boxes.maxX[index], boxes.maxY[index],
+                      boxes.maxZ[index])) {
+      visible.push_back(static_cast<uint32_t>(index));
+    }
+  }
+}
+
+}  // namespace FrustumCulling
@@ -0,0 +1,710 @@
+#include "rendering/IBLBaker.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "core/Log.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/Timer.hpp"
+
+namespace {
+
+constexpr float kPi = 3.14159265358979f;
+constexpr char kCacheMagic[8] = {'P', 'B', 'R', 'I', 'B', 'L', '\0', '\0'};
+// 算法或文件格式变化时递增，使旧缓存失效
+constexpr uint32_t kCacheVersion = 1;
+// 球谐投影使用不超过该边长的mip，低频分量不需要更高分辨率
+constexpr uint32_t kIrradianceMaxSize = 64;
+
+// 面内坐标（u、v ∈ [-1, 1]，v向下）到方向，与Vulkan立方体贴图的面朝向一致
+glm::vec3 FaceDirection(uint32_t face, float u, float v) {
+  switch (face) {
+    case 0:
+      return {1.0f, -v, -u};
+    case 1:
+      return {-1.0f, -v, u};
+    case 2:
+      return {u, 1.0f, v};
+    case 3:
+      return {u, -1.0f, -v};
+    case 4:
+      return {u, -v, 1.0f};
+    default:
+      return {-u, -v, -1.0f};
+  }
+}
+
+// FaceDirection的逆：按主轴选面，再投影到面内坐标
+void DirectionToFace(const glm::vec3& dir, uint32_t& face, float& u,
+                     float& v) {
+  glm::vec3 a = glm::abs(dir);
+  float major;
+  if (a.x >= a.y && a.x >= a.z) {
+    face = dir.x > 0.0f ? 0 : 1;
+    major = a.x;
+    u = dir.x > 0.0f ? -dir.z : dir.z;
+    v = -dir.y;
+  } else if (a.y >= a.z) {
+    face = dir.y > 0.0f ? 2 : 3;
+    major = a.y;
+    u = dir.x;
+    v = dir.y > 0.0f ? dir.z : -dir.z;
+  } else {
+    face = dir.z > 0.0f ? 4 : 5;
+    major = a.z;
+    u = dir.z > 0.0f ? dir.x : -dir.x;
+    v = -dir.y;
+  }
+  u /= major;
+  v /= major;
+}
+
+float FaceCoordinate(uint32_t texel, uint32_t size) {
+  return (static_cast<float>(texel) + 0.5f) / static_cast<float>(size) *
+             2.0f -
+         1.0f;
+}
+
+// 面内双线性采样，边缘夹取（面间接缝在低分辨率mip上可接受）
+glm::vec3 SampleFace(const CubeMipLevel& level, uint32_t face, float u,
+                     float v) {
+  const int size = static_cast<int>(level.size);
+  float fx = (u * 0.5f + 0.5f) * size - 0.5f;
+  float fy = (v * 0.5f + 0.5f) * size - 0.5f;
+  int x0 = static_cast<int>(std::floor(fx));
+  int y0 = static_cast<int>(std::floor(fy));
+  float tx = fx - x0;
+  float ty = fy - y0;
+  int x1 = std::clamp(x0 + 1, 0, size - 1);
+  int y1 = std::clamp(y0 + 1, 0, size - 1);
+  x0 = std::clamp(x0, 0, size - 1);
+  y0 = std::clamp(y0, 0, size - 1);
+
+  const float* texels = level.Face(face);
+  auto fetch = [&](int x, int y) {
+    const float* p = texels + (static_cast<size_t>(y) * size + x) * 4;
+    return glm::vec3(p[0], p[1], p[2]);
+  };
+  glm::vec3 top = glm::mix(fetch(x0, y0), fetch(x1, y0), tx);
+  glm::vec3 bottom = glm::mix(fetch(x0, y1), fetch(x1, y1), tx);
+  return glm::mix(top, bottom, ty);
+}
+
+glm::vec3 SampleCube(const CubeMipLevel& level, const glm::vec3& dir) {
+  uint32_t face;
+  float u, v;
+  DirectionToFace(dir, face, u, v);
+  return SampleFace(level, face, u, v);
+}
+
+// mip间线性插值的三线性采样
+glm::vec3 SampleCubeLod(const std::vector<CubeMipLevel>& mips,
+                        const glm::vec3& dir, float lod) {
+  lod = std::clamp(lod, 0.0f, static_cast<float>(mips.size() - 1));
+  uint32_t lower = static_cast<uint32_t>(lod);
+  uint32_t upper = std::min(lower + 1, static_cast<uint32_t>(mips.size() - 1));
+  float t = lod - static_cast<float>(lower);
+  glm::vec3 a = SampleCube(mips[lower], dir);
+  if (t <= 0.0f || upper == lower) return a;
+  return glm::mix(a, SampleCube(mips[upper], dir), t);
+}
+
+// 源图像的线性RGB（8位数据按sRGB解码）
+class SourceSampler {
+ public:
+  explicit SourceSampler(const Texture& source) : m_source(source) {
+    m_faceSize = source.type == TextureType::CubeMap ? source.width : 0;
+    for (int i = 0; i < 256; i++) {
+      float c = i / 255.0f;
+      m_srgbTable[i] = c <= 0.04045f
+                           ? c / 12.92f
+                           : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+  }
+
+  glm::vec3 Sample(const glm::vec3& dir) const {
+    if (m_faceSize > 0) {
+      uint32_t face;
+      float u, v;
+      DirectionToFace(dir, face, u, v);
+      float fx = (u * 0.5f + 0.5f) * m_faceSize - 0.5f;
+      float fy = (v * 0.5f + 0.5f) * m_faceSize - 0.5f;
+      return Bilinear(fx, fy, m_faceSize, static_cast<int>(face) * m_faceSize,
+                      false);
+    }
+    // 等距柱状投影：经度绕Y轴，纬度自+Y向下
+    float phi = std::atan2(dir.z, dir.x);
+    float theta = std::acos(std::clamp(dir.y, -1.0f, 1.0f));
+    float fx = (phi / (2.0f * kPi) + 0.5f) * m_source.width - 0.5f;
+    float fy = theta / kPi * m_source.height - 0.5f;
+    return Bilinear(fx, fy, m_source.height, 0, true);
+  }
+
+ private:
+  // rowOffset与rows限定立方体贴图的一个面；wrapX用于经度方向环绕
+  glm::vec3 Bilinear(float fx, float fy, int rows, int rowOffset,
+                     bool wrapX) const {
+    const int width = m_source.width;
+    int x0 = static_cast<int>(std::floor(fx));
+    int y0 = static_cast<int>(std::floor(fy));
+    float tx = fx - x0;
+    float ty = fy - y0;
+    int x1 = x0 + 1;
+    if (wrapX) {
+      x0 = (x0 % width + width) % width;
+      x1 = x1 % width;
+    } else {
+      x0 = std::clamp(x0, 0, width - 1);
+      x1 = std::clamp(x1, 0, width - 1);
+    }
+    int y1 = std::clamp(y0 + 1, 0, rows - 1) + rowOffset;
+    y0 = std::clamp(y0, 0, rows - 1) + rowOffset;
+
+    glm::vec3 top = glm::mix(Fetch(x0, y0), Fetch(x1, y0), tx);
+    glm::vec3 bottom = glm::mix(Fetch(x0, y1), Fetch(x1, y1), tx);
+    return glm::mix(top, bottom, ty);
+  }
+
+  glm::vec3 Fetch(int x, int y) const {
+    size_t index = (static_cast<size_t>(y) * m_source.width + x) * 4;
+    if (m_source.floatData) {
+      const float* p =
+          reinterpret_cast<const float*>(m_source.data.get()) + index;
+      return {p[0], p[1], p[2]};
+    }
+    const uint8_t* p = m_source.data.get() + index;
+    return {m_srgbTable[p[0]], m_srgbTable[p[1]], m_srgbTable[p[2]]};
+  }
+
+  const Texture& m_source;
+  int m_faceSize;
+  float m_srgbTable[256];
+};
+
+// Hammersley点集的第二维（位反转的Van der Corput序列）
+float RadicalInverse(uint32_t bits) {
+  bits = (bits << 16u) | (bits >> 16u);
+  bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+  bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+  bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+  bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+  return static_cast<float>(bits) * 2.3283064365386963e-10f;
+}
+
+// 切线空间的GGX重要性采样半程向量（Karis 2013）
+glm::vec3 ImportanceSampleGGX(uint32_t index, uint32_t count,
+                              float roughness) {
+  float a = roughness * roughness;
+  float phi = 2.0f * kPi * (static_cast<float>(index) / count);
+  float xi = RadicalInverse(index);
+  float cosTheta = std::sqrt((1.0f - xi) / (1.0f + (a * a - 1.0f) * xi));
+  float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+  return {sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta};
+}
+
+float DistributionGGX(float NdotH, float roughness) {
+  float a = roughness * roughness;
+  float a2 = a * a;
+  float denom = NdotH * NdotH * (a2 - 1.0f) + 1.0f;
+  return a2 / (kPi * denom * denom);
+}
+
+// 基函数的归一化常数与实数球谐的顺序一致：
+// Y00，Y1-1(y)，Y10(z)，Y11(x)，Y2-2(xy)，Y2-1(yz)，Y20，Y21(xz)，Y22
+std::array<float, 9> EvaluateSHBasis(const glm::vec3& n) {
+  return {0.282095f,
+          0.488603f * n.y,
+          0.488603f * n.z,
+          0.488603f * n.x,
+          1.092548f * n.x * n.y,
+          1.092548f * n.y * n.z,
+          0.315392f * (3.0f * n.z * n.z - 1.0f),
+          1.092548f * n.x * n.z,
+          0.546274f * (n.x * n.x - n.y * n.y)};
+}
+
+template <typename T>
+void WritePod(std::ofstream& file, const T& value) {
+  file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadPod(std::ifstream& file, T& value) {
+  file.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return static_cast<bool>(file);
+}
+
+void WriteFloats(std::ofstream& file, const std::vector<float>& values) {
+  file.write(reinterpret_cast<const char*>(values.data()),
+             static_cast<std::streamsize>(values.size() * sizeof(float)));
+}
+
+bool ReadFloats(std::ifstream& file, std::vector<float>& values,
+                size_t count) {
+  values.resize(count);
+  file.read(reinterpret_cast<char*>(values.data()),
+            static_cast<std::streamsize>(count * sizeof(float)));
+  return static_cast<bool>(file);
+}
+
+}  // namespace
+
+glm::vec3 IBLData::EvaluateIrradiance(const glm::vec3& normal) const {
+  std::array<float, 9> basis = EvaluateSHBasis(normal);
+  glm::vec3 result(0.0f);
+  for (uint32_t i = 0; i < 9; i++) {
+    result += irradianceSH[i] * basis[i];
+  }
+  return glm::max(result, glm::vec3(0.0f));
+}
+
+IBLBaker::IBLBaker(ThreadPool* pool) : m_pool(pool) {
+  if (!m_pool) {
+    m_ownedPool = std::make_unique<ThreadPool>();
+    m_pool = m_ownedPool.get();
+  }
+}
+
+IBLBaker::~IBLBaker() = default;
+
+void IBLBaker::ParallelFor(uint32_t count,
+                           const std::function<void(uint32_t)>& body) const {
+  // 每线程多个分块，平衡各行耗时的差异
+  uint32_t chunks = std::min(count, m_pool->GetThreadCount() * 4);
+  if (chunks <= 1) {
+    for (uint32_t i = 0; i < count; i++) body(i);
+    return;
+  }
+  std::vector<std::future<void>> futures;
+  futures.reserve(chunks);
+  for (uint32_t chunk = 0; chunk < chunks; chunk++) {
+    uint32_t begin = static_cast<uint32_t>(
+        static_cast<uint64_t>(count) * chunk / chunks);
+    uint32_t end = static_cast<uint32_t>(
+        static_cast<uint64_t>(count) * (chunk + 1) / chunks);
+    futures.push_back(m_pool->Submit([&body, begin, end]() {
+      for (uint32_t i = begin; i < end; i++) body(i);
+    }));
+  }
+  for (auto& future : futures) future.get();
+}
+
+IBLData IBLBaker::Bake(const Texture& source, const Settings& settings,
+                       const std::string& cacheDirectory) {
+  if (!source.IsValid() || !source.data ||
+      source.channelType != ChannelType::RGBA) {
+    throw std::runtime_error("IBL source must be a loaded RGBA texture: " +
+                             source.name);
+  }
+  if (source.type == TextureType::CubeMap &&
+      source.height != source.width * 6) {
+    throw std::runtime_error(
+        "IBL cube map source must stack 6 square faces vertically: " +
+        source.name);
+  }
+
+  Timer total;
+  m_stats = {};
+  const uint64_t key = ComputeKey(source, settings);
+  std::string cachePath;
+  if (!cacheDirectory.empty()) {
+    cachePath = GetCachePath(cacheDirectory, key);
+    IBLData cached;
+    if (LoadCache(cachePath, key, cached)) {
+      m_stats.cacheHit = true;
+      m_stats.totalMs = total.ElapsedMilliseconds();
+      Log::LogMessage(Log::Level::Info, "IBL cache hit: " + cachePath);
+      return cached;
+    }
+  }
+
+  IBLData data;
+  data.sourceKey = key;
+
+  Timer stage;
+  std::vector<CubeMipLevel> environment =
+      BuildMipChain(ResampleToCube(source, std::max(settings.cubeSize, 1u)));
+  m_stats.resampleMs = stage.ElapsedMilliseconds();
+
+  stage.Reset();
+  const CubeMipLevel* irradianceLevel = &environment.back();
+  for (const auto& level : environment) {
+    if (level.size <= kIrradianceMaxSize) {
+      irradianceLevel = &level;
+      break;
+    }
+  }
+  data.irradianceSH = ProjectIrradiance(*irradianceLevel);
+  m_stats.irradianceMs = stage.ElapsedMilliseconds();
+
+  Settings effective = settings;
+  effective.mipCount = std::clamp(settings.mipCount, 1u,
+                                  static_cast<uint32_t>(environment.size()));
+  effective.sampleCount = std::max(settings.sampleCount, 1u);
+  effective.brdfLutSize = std::max(settings.brdfLutSize, 1u);
+  effective.brdfSampleCount = std::max(settings.brdfSampleCount, 1u);
+
+  stage.Reset();
+  if (m_backend && m_backend->Prefilter(environment, effective,
+                                        data.prefiltered)) {
+    m_stats.usedCompute = true;
+  } else {
+    data.prefiltered = Prefilter(environment, effective);
+  }
+  m_stats.prefilterMs = stage.ElapsedMilliseconds();
+
+  stage.Reset();
+  data.brdfLutSize = effective.brdfLutSize;
+  if (!m_backend || !m_backend->BakeBrdfLut(effective, data.brdfLut)) {
+    data.brdfLut = BakeBrdfLut(effective);
+  }
+  m_stats.brdfLutMs = stage.ElapsedMilliseconds();
+
+  if (!cachePath.empty()) {
+    std::error_code error;
+    std::filesystem::create_directories(cacheDirectory, error);
+    if (!SaveCache(cachePath, data)) {
+      Log::LogMessage(Log::Level::Warning,
+                      "Failed to write IBL cache: " + cachePath);
+    }
+  }
+  m_stats.totalMs = total.ElapsedMilliseconds();
+  Log::LogMessage(Log::Level::Info,
+                  "IBL baked in " + std::to_string(m_stats.totalMs) +
+                      " ms" + (m_stats.usedCompute ? " (compute)." : "."));
+  return data;
+}
+
+CubeMipLevel IBLBaker::ResampleToCube(const Texture& source,
+                                      uint32_t size) const {
+  CubeMipLevel level;
+  level.size = size;
+  level.texels.resize(static_cast<size_t>(size) * size * 6 * 4);
+
+  // 每纹素2x2超采样，源图像分辨率高于立方体时减少走样
+  SourceSampler sampler(source);
+  ParallelFor(size * 6, [&](uint32_t row) {
+    uint32_t face = row / size;
+    uint32_t y = row % size;
+    float* out = level.Face(face) + static_cast<size_t>(y) * size * 4;
+    for (uint32_t x = 0; x < size; x++) {
+      glm::vec3 color(0.0f);
+      for (uint32_t s = 0; s < 4; s++) {
+        float u = (x + 0.25f + 0.5f * (s & 1)) / size * 2.0f - 1.0f;
+        float v = (y + 0.25f + 0.5f * (s >> 1)) / size * 2.0f - 1.0f;
+        color += sampler.Sample(glm::normalize(FaceDirection(face, u, v)));
+      }
+      color *= 0.25f;
+      out[x * 4 + 0] = color.r;
+      out[x * 4 + 1] = color.g;
+      out[x * 4 + 2] = color.b;
+      out[x * 4 + 3] = 1.0f;
+    }
+  });
+  return level;
+}
+
+std::vector<CubeMipLevel> IBLBaker::BuildMipChain(CubeMipLevel base) const {
+  std::vector<CubeMipLevel> mips;
+  mips.push_back(std::move(base));
+  while (mips.back().size > 1) {
+    const CubeMipLevel& parent = mips.back();
+    CubeMipLevel level;
+    level.size = std::max(parent.size / 2, 1u);
+    level.texels.resize(static_cast<size_t>(level.size) * level.size * 6 * 4);
+    const uint32_t last = parent.size - 1;
+    ParallelFor(6, [&](uint32_t face) {
+      const float* in = parent.Face(face);
+      float* out = level.Face(face);
+      for (uint32_t y = 0; y < level.size; y++) {
+        for (uint32_t x = 0; x < level.size; x++) {
+          uint32_t x0 = std::min(x * 2, last), x1 = std::min(x * 2 + 1, last);
+          uint32_t y0 = std::min(y * 2, last), y1 = std::min(y * 2 + 1, last);
+          for (uint32_t c = 0; c < 4; c++) {
+            out[(y * level.size + x) * 4 + c] =
+                0.25f * (in[(y0 * parent.size + x0) * 4 + c] +
+                         in[(y0 * parent.size + x1) * 4 + c] +
+                         in[(y1 * parent.size + x0) * 4 + c] +
+                         in[(y1 * parent.size + x1) * 4 + c]);
+          }
+        }
+      }
+    });
+    mips.push_back(std::move(level));
+  }
+  return mips;
+}
+
+std::array<glm::vec3, 9> IBLBaker::ProjectIrradiance(
+    const CubeMipLevel& level) const {
+  // 逐面累加辐亮度与基函数之积，按纹素立体角加权
+  struct Partial {
+    std::array<glm::vec3, 9> sh{};
+    float weight = 0.0f;
+  };
+  std::array<Partial, 6> partials;
+  const uint32_t size = level.size;
+  ParallelFor(6, [&](uint32_t face) {
+    Partial& partial = partials[face];
+    const float* texels = level.Face(face);
+    for (uint32_t y = 0; y < size; y++) {
+      float v = FaceCoordinate(y, size);
+      for (uint32_t x = 0; x < size; x++) {
+        float u = FaceCoordinate(x, size);
+        float r2 = 1.0f + u * u + v * v;
+        float solidAngle = 1.0f / (r2 * std::sqrt(r2));
+        glm::vec3 dir = glm::normalize(FaceDirection(face, u, v));
+        const float* p = texels + (static_cast<size_t>(y) * size + x) * 4;
+        glm::vec3 radiance(p[0], p[1], p[2]);
+        std::array<float, 9> basis = EvaluateSHBasis(dir);
+        for (uint32_t i = 0; i < 9; i++) {
+          partial.sh[i] += radiance * (basis[i] * solidAngle);
+        }
+        partial.weight += solidAngle;
+      }
+    }
+  });
+
+  std::array<glm::vec3, 9> sh{};
+  float weight = 0.0f;
+  for (const auto& partial : partials) {
+    for (uint32_t i = 0; i < 9; i++) sh[i] += partial.sh[i];
+    weight += partial.weight;
+  }
+  // 立体角之和归一化到4π，再与余弦核卷积（Ramamoorthi 2001）
+  const std::array<float, 3> band = {kPi, 2.0f * kPi / 3.0f, kPi / 4.0f};
+  const float normalization = 4.0f * kPi / weight;
+  for (uint32_t i = 0; i < 9; i++) {
+    uint32_t l = i == 0 ? 0 : (i < 4 ? 1 : 2);
+    sh[i] *= normalization * band[l];
+  }
+  return sh;
+}
+
+std::vector<CubeMipLevel> IBLBaker::Prefilter(
+    const std::vector<CubeMipLevel>& environment,
+    const Settings& settings) const {
+  std::vector<CubeMipLevel> result(settings.mipCount);
+  result[0] = environment[0];
+  const uint32_t baseSize = environment[0].size;
+  const float texelSolidAngle =
+      4.0f * kPi / (6.0f * static_cast<float>(baseSize) * baseSize);
+
+  for (uint32_t mip = 1; mip < settings.mipCount; mip++) {
+    const float roughness =
+        static_cast<float>(mip) / static_cast<float>(settings.mipCount - 1);
+
+    // 假设N = V = R，样本相对法线的分布与纹素无关：预先计算切线空间的
+    // 入射方向、权重与源mip（样本覆盖的立体角越大，读取越模糊的mip）
+    struct Sample {
+      glm::vec3 direction;
+      float weight;
+      float lod;
+    };
+    std::vector<Sample> samples;
+    for (uint32_t i = 0; i < settings.sampleCount; i++) {
+      glm::vec3 H = ImportanceSampleGGX(i, settings.sampleCount, roughness);
+      glm::vec3 L = 2.0f * H.z * H - glm::vec3(0.0f, 0.0f, 1.0f);
+      if (L.z <= 0.0f) continue;
+      // N = V时pdf = D * NdotH / (4 * VdotH) = D / 4
+      float pdf = DistributionGGX(H.z, roughness) * 0.25f;
+      float sampleSolidAngle = 1.0f / (settings.sampleCount * pdf + 1e-4f);
+      float lod = 0.5f * std::log2(sampleSolidAngle / texelSolidAngle) + 1.0f;
+      samples.push_back({L, L.z, std::max(lod, 0.0f)});
+    }
+
+    CubeMipLevel& level = result[mip];
+    level.size = std::max(baseSize >> mip, 1u);
+    level.texels.resize(static_cast<size_t>(level.size) * level.size * 6 * 4);
+    const uint32_t size = level.size;
+    ParallelFor(size * 6, [&](uint32_t row) {
+      uint32_t face = row / size;
+      uint32_t y = row % size;
+      float* out = level.Face(face) + static_cast<size_t>(y) * size * 4;
+      float v = FaceCoordinate(y, size);
+      for (uint32_t x = 0; x < size; x++) {
+        glm::vec3 N =
+            glm::normalize(FaceDirection(face, FaceCoordinate(x, size), v));
+        glm::vec3 up = std::abs(N.z) < 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f)
+                                              : glm::vec3(1.0f, 0.0f, 0.0f);
+        glm::vec3 T = glm::normalize(glm::cross(up, N));
+        glm::vec3 B = glm::cross(N, T);
+
+        glm::vec3 color(0.0f);
+        float weight = 0.0f;
+        for (const auto& sample : samples) {
+          glm::vec3 L = T * sample.direction.x + B * sample.direction.y +
+                        N * sample.direction.z;
+          color += SampleCubeLod(environment, L, sample.lod) * sample.weight;
+          weight += sample.weight;
+        }
+        color /= std::max(weight, 1e-4f);
+        out[x * 4 + 0] = color.r;
+        out[x * 4 + 1] = color.g;
+        out[x * 4 + 2] = color.b;
+        out[x * 4 + 3] = 1.0f;
+      }
+    });
+  }
+  return result;
+}
+
+std::vector<float> IBLBaker::BakeBrdfLut(const Settings& settings) const {
+  const uint32_t size = settings.brdfLutSize;
+  const uint32_t count = settings.brdfSampleCount;
+  std::vector<float> lut(static_cast<size_t>(size) * size * 2);
+
+  // 分离求和的第二项：∫ f * NdotL = F0 * A + B，
+  // 几何项为IBL的Smith-Schlick（k = α / 2）
+  ParallelFor(size, [&](uint32_t y) {
+    float roughness = (y + 0.5f) / size;
+    float a = roughness * roughness;
+    float k = a * 0.5f;
+    for (uint32_t x = 0; x < size; x++) {
+      float NdotV = (x + 0.5f) / size;
+      glm::vec3 V(std::sqrt(1.0f - NdotV * NdotV), 0.0f, NdotV);
+      float scale = 0.0f;
+      float bias = 0.0f;
+      for (uint32_t i = 0; i < count; i++) {
+        glm::vec3 H = ImportanceSampleGGX(i, count, roughness);
+        float VdotH = glm::dot(V, H);
+        glm::vec3 L = 2.0f * VdotH * H - V;
+        float NdotL = L.z;
+        if (NdotL <= 0.0f) continue;
+        float NdotH = std::max(H.z, 0.0f);
+        VdotH = std::max(VdotH, 0.0f);
+        float G = (NdotV / (NdotV * (1.0f - k) + k)) *
+                  (NdotL / (NdotL * (1.0f - k) + k));
+        float visibility = G * VdotH / (NdotH * NdotV + 1e-6f);
+        float fresnel = std::pow(1.0f - VdotH, 5.0f);
+        scale += (1.0f - fresnel) * visibility;
+        bias += fresnel * visibility;
+      }
+      size_t index = (static_cast<size_t>(y) * size + x) * 2;
+      lut[index + 0] = scale / count;
+      lut[index + 1] = bias / count;
+    }
+  });
+  return lut;
+}
+
+uint64_t IBLBaker::ComputeKey(const Texture& source,
+                              const Settings& settings) {
+  // FNV-1a 64位：覆盖像素数据、尺寸、类型与全部烘焙参数
+  uint64_t hash = 0xcbf29ce484222325ull;
+  auto mix = [&hash](const void* bytes, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(bytes);
+    for (size_t i = 0; i < size; i++) {
+      hash ^= p[i];
+      hash *= 0x100000001b3ull;
+    }
+  };
+  const uint32_t header[] = {kCacheVersion,
+                             static_cast<uint32_t>(source.width),
+                             static_cast<uint32_t>(source.height),
+                             static_cast<uint32_t>(source.type),
+                             static_cast<uint32_t>(source.channelType),
+                             source.floatData ? 1u : 0u,
+                             settings.cubeSize,
+                             settings.mipCount,
+                             settings.sampleCount,
+                             settings.brdfLutSize,
+                             settings.brdfSampleCount};
+  mix(header, sizeof(header));
+  if (source.data) mix(source.data.get(), source.GetTotalBytes());
+  return hash;
+}
+
+std::string IBLBaker::GetCachePath(const std::string& cacheDirectory,
+                                   uint64_t key) {
+  std::ostringstream name;
+  name << "ibl_" << std::hex << std::setw(16) << std::setfill('0') << key
+       << ".bin";
+  return (std::filesystem::path(cacheDirectory) / name.str()).string();
+}
+
+bool IBLBaker::LoadCache(const std::string& path, uint64_t key,
+                         IBLData& data) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) return false;
+
+  char magic[sizeof(kCacheMagic)];
+  uint32_t version = 0;
+  uint64_t storedKey = 0;
+  file.read(magic, sizeof(magic));
+  if (!file || std::memcmp(magic, kCacheMagic, sizeof(magic)) != 0 ||
+      !ReadPod(file, version) || version != kCacheVersion ||
+      !ReadPod(file, storedKey) || storedKey != key) {
+    return false;
+  }
+
+  IBLData result;
+  result.sourceKey = storedKey;
+  for (auto& coefficient : result.irradianceSH) {
+    if (!ReadPod(file, coefficient.x) || !ReadPod(file, coefficient.y) ||
+        !ReadPod(file, coefficient.z)) {
+      return false;
+    }
+  }
+  uint32_t mipCount = 0;
+  if (!ReadPod(file, mipCount) || mipCount == 0 || mipCount > 16) {
+    return false;
+  }
+  result.prefiltered.resize(mipCount);
+  for (auto& level : result.prefiltered) {
+    if (!ReadPod(file, level.size) || level.size == 0 ||
+        level.size > 16384 ||
+        !ReadFloats(file, level.texels,
+                    static_cast<size_t>(level.size) * level.size * 6 * 4)) {
+      return false;
+    }
+  }
+  if (!ReadPod(file, result.brdfLutSize) || result.brdfLutSize == 0 ||
+      result.brdfLutSize > 4096 ||
+      !ReadFloats(file, result.brdfLut,
+                  static_cast<size_t>(result.brdfLutSize) *
+                      result.brdfLutSize * 2)) {
+    return false;
+  }
+  data = std::move(result);
+  return true;
+}
+
+bool IBLBaker::SaveCache(const std::string& path, const IBLData& data) {
+  // 先写临时文件再改名，中断的写入不会留下截断的缓存
+  const std::string temporary = path + ".tmp";
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write(kCacheMagic, sizeof(kCacheMagic));
+    WritePod(file, kCacheVersion);
+    WritePod(file, data.sourceKey);
+    for (const auto& coefficient : data.irradianceSH) {
+      WritePod(file, coefficient.x);
+      WritePod(file, coefficient.y);
+      WritePod(file, coefficient.z);
+    }
+    WritePod(file, static_cast<uint32_t>(data.prefiltered.size()));
+    for (const auto& level : data.prefiltered) {
+      WritePod(file, level.size);
+      WriteFloats(file, level.texels);
+    }
+    WritePod(file, data.brdfLutSize);
+    WriteFloats(file, data.brdfLut);
+    if (!file) return false;
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary, path, error);
+  if (error) {
+    std::filesystem::remove(temporary, error);
+    return false;
+  }
+  return true;
+}
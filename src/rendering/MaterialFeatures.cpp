@@ -0,0 +1,35 @@
+#include "rendering/MaterialFeatures.hpp"
+
+namespace {
+
+template <typename T>
+bool HasMap(const MaterialInput<T>& input) {
+  return !input.UseFallback && input.texture.IsValid() && input.texture.data;
+}
+
+}  // namespace
+
+MaterialConstants MaterialConstants::FromMaterial(const Material& material) {
+  MaterialConstants constants;
+  const bool maps[MaterialFeatures::kSlotCount] = {
+      HasMap(material.baseColor), HasMap(material.normal),
+      HasMap(material.metallic),  HasMap(material.roughness),
+      HasMap(material.ao),        HasMap(material.emissiveIntensity)};
+  for (size_t i = 0; i < MaterialFeatures::kSlotCount; i++) {
+    if (maps[i]) constants.features |= MaterialFeatures::SlotBit(i);
+  }
+
+  if (material.baseColor.UseFallback) {
+    constants.baseColor = material.baseColor.value;
+  }
+  const MaterialInput<float>* scalars[4] = {
+      &material.metallic, &material.roughness, &material.ao,
+      &material.emissiveIntensity};
+  for (int i = 0; i < 4; i++) {
+    if (scalars[i]->UseFallback) constants.factors[i] = scalars[i]->value;
+  }
+  if (material.heightScale.UseFallback) {
+    constants.heightScale = material.heightScale.value;
+  }
+  return constants;
+}
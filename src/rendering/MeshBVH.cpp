@@ -0,0 +1,665 @@
+#include "rendering/MeshBVH.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+
+#include "core/ThreadPool.hpp"
+#include "core/Timer.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PBR_MESH_BVH_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr uint32_t kBinCount = 16;
+// 超过该深度后改为中位数划分，保证树深有界（遍历栈不会溢出）
+constexpr uint32_t kMaxSahDepth = 48;
+constexpr uint32_t kStackSize = 256;
+// 并行构建时单个子树的最小三角形数
+constexpr uint32_t kMinSubtreeSize = 4096;
+// 遍历一个节点相对于测试一个三角形块的代价
+constexpr float kTraversalCost = 1.0f;
+constexpr float kInfinity = std::numeric_limits<float>::infinity();
+
+struct BinaryNode {
+  AABB bounds;
+  uint32_t left = 0;  // 内部节点的子节点
+  uint32_t right = 0;
+  uint32_t first = 0;  // 叶节点在三角形顺序中的范围
+  uint32_t count = 0;  // 内部节点为0
+};
+
+// 延迟到并行阶段构建的子树，node为占位节点
+struct Subtree {
+  uint32_t node;
+  uint32_t begin;
+  uint32_t end;
+  uint32_t depth;
+};
+
+struct Bin {
+  AABB bounds = AABB::Empty();
+  uint32_t count = 0;
+};
+
+// 叶节点的相交代价按4个一组的三角形块计
+float BlockCost(uint32_t count) { return static_cast<float>((count + 3) / 4); }
+
+// 零分量替换为同号的极小值，避免倒数为无穷时slab测试出现NaN
+glm::vec3 SafeInverse(const glm::vec3& direction) {
+  glm::vec3 result;
+  for (int i = 0; i < 3; i++) {
+    float d = direction[i];
+    if (std::abs(d) < 1e-12f) d = std::copysign(1e-12f, d);
+    result[i] = 1.0f / d;
+  }
+  return result;
+}
+
+}  // namespace
+
+class MeshBVH::Builder {
+ public:
+  Builder(const std::vector<Vertex>& vertices,
+          const std::vector<uint32_t>& indices)
+      : m_vertices(vertices), m_indices(indices) {}
+
+  void BuildBinary(ThreadPool* pool, Stats& stats);
+  void Collapse(MeshBVH& bvh);
+
+ private:
+  uint32_t BuildRange(std::vector<BinaryNode>& nodes, uint32_t begin,
+                      uint32_t end, uint32_t depth, uint32_t subtreeSize,
+                      std::vector<Subtree>* deferred);
+  uint32_t CollapseNode(MeshBVH& bvh, uint32_t index, uint32_t depth);
+  uint32_t WriteLeaf(MeshBVH& bvh, const BinaryNode& leaf);
+
+  const std::vector<Vertex>& m_vertices;
+  const std::vector<uint32_t>& m_indices;
+  std::vector<AABB> m_boxes;
+  std::vector<glm::vec3> m_centroids;
+  std::vector<uint32_t> m_order;
+  std::vector<BinaryNode> m_nodes;
+  float m_cost = 0.0f;
+};
+
+void MeshBVH::Builder::BuildBinary(ThreadPool* pool, Stats& stats) {
+  const uint32_t count = static_cast<uint32_t>(m_indices.size() / 3);
+  m_boxes.resize(count);
+  m_centroids.resize(count);
+  m_order.resize(count);
+  for (uint32_t i = 0; i < count; i++) {
+    const glm::vec3& p0 = m_vertices[m_indices[i * 3 + 0]].position;
+    const glm::vec3& p1 = m_vertices[m_indices[i * 3 + 1]].position;
+    const glm::vec3& p2 = m_vertices[m_indices[i * 3 + 2]].position;
+    m_boxes[i] = {glm::min(p0, glm::min(p1, p2)),
+                  glm::max(p0, glm::max(p1, p2))};
+    m_centroids[i] = m_boxes[i].Center();
+    m_order[i] = i;
+  }
+  const uint32_t threads = pool ? pool->GetThreadCount() : 1;
+  if (threads <= 1) {
+    m_nodes.reserve(count * 2);
+    BuildRange(m_nodes, 0, count, 0, 0, nullptr);
+    return;
+  }
+
+  // 串行划分顶层，规模不超过subtreeSize的子树留给并行阶段
+  const uint32_t subtreeSize = std::max(count / (threads * 4),
+                                        kMinSubtreeSize);
+  std::vector<Subtree> subtrees;
+  BuildRange(m_nodes, 0, count, 0, subtreeSize, &subtrees);
+  stats.subtreeTasks = static_cast<uint32_t>(subtrees.size());
+
+  // 子树交错分配到各任务，各自写入独立的节点数组；
+  // 各子树的三角形范围互不重叠，划分可以并发进行
+  std::vector<std::vector<BinaryNode>> locals(subtrees.size());
+  const size_t taskCount = std::min<size_t>(threads, subtrees.size());
+  std::vector<std::future<void>> futures;
+  futures.reserve(taskCount);
+  for (size_t task = 0; task < taskCount; task++) {
+    futures.push_back(pool->Submit([&, task]() {
+      for (size_t i = task; i < subtrees.size(); i += taskCount) {
+        const Subtree& subtree = subtrees[i];
+        locals[i].reserve((subtree.end - subtree.begin) * 2);
+        BuildRange(locals[i], subtree.begin, subtree.end, subtree.depth, 0,
+                   nullptr);
+      }
+    }));
+  }
+  for (auto& future : futures) future.get();
+
+  // 合并：子节点下标加上偏移，子树根复制到占位节点
+  size_t total = m_nodes.size();
+  for (const auto& local : locals) total += local.size();
+  m_nodes.reserve(total);
+  for (size_t i = 0; i < subtrees.size(); i++) {
+    const uint32_t base = static_cast<uint32_t>(m_nodes.size());
+    for (BinaryNode node : locals[i]) {
+      if (node.count == 0) {
+        node.left += base;
+        node.right += base;
+      }
+      m_nodes.push_back(node);
+    }
+    m_nodes[subtrees[i].node] = m_nodes[base];
+  }
+}
+
+uint32_t MeshBVH::Builder::BuildRange(std::vector<BinaryNode>& nodes,
+                                      uint32_t begin, uint32_t end,
+                                      uint32_t depth, uint32_t subtreeSize,
+                                      std::vector<Subtree>* deferred) {
+  const uint32_t index = static_cast<uint32_t>(nodes.size());
+  nodes.emplace_back();
+  const uint32_t count = end - begin;
+  if (deferred && count <= subtreeSize) {
+    deferred->push_back({index, begin, end, depth});
+    return index;
+  }
+
+  AABB bounds = AABB::Empty();
+  AABB centroidBounds = AABB::Empty();
+  for (uint32_t i = begin; i < end; i++) {
+    bounds = bounds.Merged(m_boxes[m_order[i]]);
+    const glm::vec3& c = m_centroids[m_order[i]];
+    centroidBounds = centroidBounds.Merged({c, c});
+  }
+  nodes[index].bounds = bounds;
+
+  auto makeLeaf = [&]() {
+    nodes[index].first = begin;
+    nodes[index].count = count;
+    return index;
+  };
+  if (count <= 1) return makeLeaf();
+
+  const glm::vec3 extent = centroidBounds.Extent();
+  int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2)
+                                 : (extent.y > extent.z ? 1 : 2);
+  uint32_t middle = begin;
+  // 质心重合时无法按空间划分
+  if (extent[axis] <= 0.0f && count <= kMaxLeafSize) return makeLeaf();
+
+  if (extent[axis] > 0.0f && depth < kMaxSahDepth) {
+    // 三个轴各16个分箱，左右两侧扫描求各划分的SAH代价
+    float bestCost = kInfinity;
+    int bestAxis = -1;
+    uint32_t bestSplit = 0;
+    for (int a = 0; a < 3; a++) {
+      if (extent[a] <= 0.0f) continue;
+      const float origin = centroidBounds.min[a];
+      const float scale = kBinCount / extent[a];
+      auto binIndex = [&](uint32_t triangle) {
+        float offset = (m_centroids[triangle][a] - origin) * scale;
+        return std::min(static_cast<uint32_t>(offset), kBinCount - 1);
+      };
+      Bin bins[kBinCount];
+      for (uint32_t i = begin; i < end; i++) {
+        Bin& bin = bins[binIndex(m_order[i])];
+        bin.bounds = bin.bounds.Merged(m_boxes[m_order[i]]);
+        bin.count++;
+      }
+
+      float rightCost[kBinCount] = {};
+      AABB accumulated = AABB::Empty();
+      uint32_t accumulatedCount = 0;
+      for (uint32_t i = kBinCount - 1; i > 0; i--) {
+        accumulated = accumulated.Merged(bins[i].bounds);
+        accumulatedCount += bins[i].count;
+        rightCost[i] = accumulated.SurfaceArea() * BlockCost(accumulatedCount);
+      }
+      accumulated = AABB::Empty();
+      accumulatedCount = 0;
+      for (uint32_t i = 1; i < kBinCount; i++) {
+        accumulated = accumulated.Merged(bins[i - 1].bounds);
+        accumulatedCount += bins[i - 1].count;
+        if (accumulatedCount == 0 || accumulatedCount == count) continue;
+        float cost = accumulated.SurfaceArea() * BlockCost(accumulatedCount) +
+                     rightCost[i];
+        if (cost < bestCost) {
+          bestCost = cost;
+          bestAxis = a;
+          bestSplit = i;
+        }
+      }
+    }
+
+    if (bestAxis >= 0) {
+      const float area = bounds.SurfaceArea();
+      const float splitCost =
+          kTraversalCost + (area > 0.0f ? bestCost / area : 0.0f);
+      if (count <= kMaxLeafSize && BlockCost(count) <= splitCost) {
+        return makeLeaf();
+      }
+      const float origin = centroidBounds.min[bestAxis];
+      const float scale = kBinCount / extent[bestAxis];
+      auto split = std::partition(
+          m_order.begin() + begin, m_order.begin() + end,
+          [&](uint32_t triangle) {
+            float offset = (m_centroids[triangle][bestAxis] - origin) * scale;
+            return std::min(static_cast<uint32_t>(offset), kBinCount - 1) <
+                   bestSplit;
+          });
+      middle = static_cast<uint32_t>(split - m_order.begin());
+    }
+  }
+
+  // 无有效的SAH划分或超过深度限制时按最长轴中位数划分
+  if (middle == begin || middle == end) {
+    middle = begin + count / 2;
+    std::nth_element(m_order.begin() + begin, m_order.begin() + middle,
+                     m_order.begin() + end, [&](uint32_t a, uint32_t b) {
+                       return m_centroids[a][axis] < m_centroids[b][axis];
+                     });
+  }
+
+  uint32_t left =
+      BuildRange(nodes, begin, middle, depth + 1, subtreeSize, deferred);
+  uint32_t right =
+      BuildRange(nodes, middle, end, depth + 1, subtreeSize, deferred);
+  nodes[index].left = left;
+  nodes[index].right = right;
+  return index;
+}
+
+void MeshBVH::Builder::Collapse(MeshBVH& bvh) {
+  const AABB& rootBounds = m_nodes[0].bounds;
+  bvh.m_bounds = rootBounds;
+  bvh.m_nodes.reserve(m_nodes.size() / 2 + 1);
+  bvh.m_blocks.reserve(m_order.size() / 2 + 1);
+  CollapseNode(bvh, 0, 0);
+
+  const float rootArea = rootBounds.SurfaceArea();
+  bvh.m_stats.nodeCount = static_cast<uint32_t>(bvh.m_nodes.size());
+  bvh.m_stats.sahCost = rootArea > 0.0f ? m_cost / rootArea : 0.0f;
+}
+
+uint32_t MeshBVH::Builder::CollapseNode(MeshBVH& bvh, uint32_t index,
+                                        uint32_t depth) {
+  // 从二叉节点的两个子节点开始，反复展开表面积最大的内部子节点
+  uint32_t slots[kWidth];
+  uint32_t slotCount = 0;
+  const BinaryNode& root = m_nodes[index];
+  if (root.count > 0) {
+    slots[slotCount++] = index;
+  } else {
+    slots[slotCount++] = root.left;
+    slots[slotCount++] = root.right;
+  }
+  while (slotCount < kWidth) {
+    int best = -1;
+    float bestArea = -1.0f;
+    for (uint32_t i = 0; i < slotCount; i++) {
+      const BinaryNode& node = m_nodes[slots[i]];
+      float area = node.bounds.SurfaceArea();
+      if (node.count == 0 && area > bestArea) {
+        best = static_cast<int>(i);
+        bestArea = area;
+      }
+    }
+    if (best < 0) break;
+    const BinaryNode& node = m_nodes[slots[best]];
+    slots[best] = node.left;
+    slots[slotCount++] = node.right;
+  }
+
+  const uint32_t wide = static_cast<uint32_t>(bvh.m_nodes.size());
+  Node empty;
+  for (uint32_t i = 0; i < kWidth; i++) {
+    empty.minX[i] = empty.minY[i] = empty.minZ[i] = kInfinity;
+    empty.maxX[i] = empty.maxY[i] = empty.maxZ[i] = -kInfinity;
+    empty.child[i] = kInvalid;
+    empty.count[i] = 0;
+  }
+  bvh.m_nodes.push_back(empty);
+  bvh.m_stats.depth = std::max(bvh.m_stats.depth, depth + 1);
+  m_cost += kTraversalCost * root.bounds.SurfaceArea();
+
+  // 子节点按深度优先紧随父节点之后排列
+  for (uint32_t i = 0; i < slotCount; i++) {
+    const BinaryNode& child = m_nodes[slots[i]];
+    uint32_t target = 0;
+    uint32_t blockCount = 0;
+    if (child.count > 0) {
+      target = static_cast<uint32_t>(bvh.m_blocks.size());
+      blockCount = WriteLeaf(bvh, child);
+      m_cost += child.bounds.SurfaceArea() * BlockCost(child.count);
+      bvh.m_stats.leafCount++;
+    } else {
+      target = CollapseNode(bvh, slots[i], depth + 1);
+    }
+    Node& node = bvh.m_nodes[wide];
+    node.minX[i] = child.bounds.min.x;
+    node.minY[i] = child.bounds.min.y;
+    node.minZ[i] = child.bounds.min.z;
+    node.maxX[i] = child.bounds.max.x;
+    node.maxY[i] = child.bounds.max.y;
+    node.maxZ[i] = child.bounds.max.z;
+    node.child[i] = target;
+    node.count[i] = blockCount;
+  }
+  return wide;
+}
+
+uint32_t MeshBVH::Builder::WriteLeaf(MeshBVH& bvh, const BinaryNode& leaf) {
+  const uint32_t end = leaf.first + leaf.count;
+  uint32_t blockCount = 0;
+  for (uint32_t first = leaf.first; first < end; first += 4) {
+    // 不足4个的槽位保持为零（退化三角形，行列式为0不会命中）
+    TriangleBlock block{};
+    for (uint32_t lane = 0; lane < 4; lane++) {
+      block.triangle[lane] = kInvalid;
+      if (first + lane >= end) continue;
+      const uint32_t triangle = m_order[first + lane];
+      const glm::vec3& p0 = m_vertices[m_indices[triangle * 3 + 0]].position;
+      const glm::vec3& p1 = m_vertices[m_indices[triangle * 3 + 1]].position;
+      const glm::vec3& p2 = m_vertices[m_indices[triangle * 3 + 2]].position;
+      const glm::vec3 e1 = p1 - p0;
+      const glm::vec3 e2 = p2 - p0;
+      block.v0x[lane] = p0.x;
+      block.v0y[lane] = p0.y;
+      block.v0z[lane] = p0.z;
+      block.e1x[lane] = e1.x;
+      block.e1y[lane] = e1.y;
+      block.e1z[lane] = e1.z;
+      block.e2x[lane] = e2.x;
+      block.e2y[lane] = e2.y;
+      block.e2z[lane] = e2.z;
+      block.triangle[lane] = triangle;
+    }
+    bvh.m_blocks.push_back(block);
+    blockCount++;
+  }
+  return blockCount;
+}
+
+MeshBVH::Path MeshBVH::GetBestPath() {
+#ifdef PBR_MESH_BVH_SSE
+  return Path::SSE;
+#else
+  return Path::Scalar;
+#endif
+}
+
+const char* MeshBVH::GetPathName(Path path) {
+  return path == Path::SSE ? "SSE" : "Scalar";
+}
+
+void MeshBVH::Build(const std::vector<Vertex>& vertices,
+                    const std::vector<uint32_t>& indices, ThreadPool* pool) {
+  Timer timer;
+  Clear();
+  const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+  m_stats.triangleCount = triangleCount;
+  if (triangleCount == 0) return;
+
+  Builder builder(vertices, indices);
+  builder.BuildBinary(pool, m_stats);
+  builder.Collapse(*this);
+  m_stats.buildMs = timer.ElapsedMilliseconds();
+}
+
+void MeshBVH::Clear() {
+  m_nodes.clear();
+  m_blocks.clear();
+  m_bounds = AABB::Empty();
+  m_stats = Stats{};
+}
+
+bool MeshBVH::Intersect(const glm::vec3& origin, const glm::vec3& direction,
+                        float tMax, Hit& hit, Path path) const {
+  if (m_nodes.empty()) return false;
+#ifdef PBR_MESH_BVH_SSE
+  if (path == Path::SSE) {
+    return TraverseSSE<false>(origin, direction, tMax, hit);
+  }
+#endif
+  return TraverseScalar<false>(origin, direction, tMax, hit);
+}
+
+bool MeshBVH::Occluded(const glm::vec3& origin, const glm::vec3& direction,
+                       float tMax, Path path) const {
+  if (m_nodes.empty()) return false;
+  Hit hit;
+#ifdef PBR_MESH_BVH_SSE
+  if (path == Path::SSE) {
+    return TraverseSSE<true>(origin, direction, tMax, hit);
+  }
+#endif
+  return TraverseScalar<true>(origin, direction, tMax, hit);
+}
+
+namespace {
+
+// 栈项：count为0时child为节点下标，否则为叶节点的三角形块；
+// t为进入距离，出栈时已超过最近交点的项直接跳过
+struct StackEntry {
+  uint32_t child;
+  uint32_t count;
+  float t;
+};
+
+// 按进入距离由远到近追加，最近的子节点最先出栈
+void PushSorted(StackEntry* stack, uint32_t& size, StackEntry* hits,
+                uint32_t hitCount) {
+  for (uint32_t i = 1; i < hitCount; i++) {
+    StackEntry entry = hits[i];
+    uint32_t j = i;
+    for (; j > 0 && hits[j - 1].t < entry.t; j--) hits[j] = hits[j - 1];
+    hits[j] = entry;
+  }
+  for (uint32_t i = 0; i < hitCount; i++) stack[size++] = hits[i];
+}
+
+}  // namespace
+
+template <bool kAnyHit>
+bool MeshBVH::TraverseScalar(const glm::vec3& origin,
+                             const glm::vec3& direction, float tMax,
+                             Hit& hit) const {
+  const glm::vec3 inverse = SafeInverse(direction);
+  // 按方向符号选取近、远平面，空槽位（min > max）因此总是未命中
+  const bool negative[3] = {inverse.x < 0.0f, inverse.y < 0.0f,
+                            inverse.z < 0.0f};
+  float closest = tMax;
+  bool found = false;
+
+  StackEntry stack[kStackSize];
+  uint32_t size = 0;
+  stack[size++] = {0, 0, 0.0f};
+  while (size > 0) {
+    const StackEntry entry = stack[--size];
+    if (entry.t > closest) continue;
+
+    if (entry.count > 0) {
+      for (uint32_t b = 0; b < entry.count; b++) {
+        const TriangleBlock& block = m_blocks[entry.child + b];
+        for (uint32_t lane = 0; lane < 4; lane++) {
+          const glm::vec3 e1(block.e1x[lane], block.e1y[lane],
+                             block.e1z[lane]);
+          const glm::vec3 e2(block.e2x[lane], block.e2y[lane],
+                             block.e2z[lane]);
+          const glm::vec3 p = glm::cross(direction, e2);
+          const float det = glm::dot(e1, p);
+          if (std::abs(det) < 1e-12f) continue;
+          const float inverseDet = 1.0f / det;
+          const glm::vec3 s =
+              origin -
+              glm::vec3(block.v0x[lane], block.v0y[lane], block.v0z[lane]);
+          const float u = glm::dot(s, p) * inverseDet;
+          const glm::vec3 q = glm::cross(s, e1);
+          const float v = glm::dot(direction, q) * inverseDet;
+          const float t = glm::dot(e2, q) * inverseDet;
+          if (u < 0.0f || v < 0.0f || u + v > 1.0f || t <= 0.0f ||
+              t >= closest) {
+            continue;
+          }
+          closest = t;
+          hit = {t, u, v, block.triangle[lane]};
+          found = true;
+          if (kAnyHit) return true;
+        }
+      }
+      continue;
+    }
+
+    const Node& node = m_nodes[entry.child];
+    const float* nearX = negative[0] ? node.maxX : node.minX;
+    const float* nearY = negative[1] ? node.maxY : node.minY;
+    const float* nearZ = negative[2] ? node.maxZ : node.minZ;
+    const float* farX = negative[0] ? node.minX : node.maxX;
+    const float* farY = negative[1] ? node.minY : node.maxY;
+    const float* farZ = negative[2] ? node.minZ : node.maxZ;
+    StackEntry hits[kWidth];
+    uint32_t hitCount = 0;
+    for (uint32_t i = 0; i < kWidth; i++) {
+      float tNear = std::max(
+          std::max((nearX[i] - origin.x) * inverse.x,
+                   (nearY[i] - origin.y) * inverse.y),
+          std::max((nearZ[i] - origin.z) * inverse.z, 0.0f));
+      float tFar = std::min(std::min((farX[i] - origin.x) * inverse.x,
+                                     (farY[i] - origin.y) * inverse.y),
+                            std::min((farZ[i] - origin.z) * inverse.z,
+                                     closest));
+      if (tNear <= tFar && node.child[i] != kInvalid) {
+        hits[hitCount++] = {node.child[i], node.count[i], tNear};
+      }
+    }
+    PushSorted(stack, size, hits, hitCount);
+  }
+  return found;
+}
+
+#ifdef PBR_MESH_BVH_SSE
+
+template <bool kAnyHit>
+bool MeshBVH::TraverseSSE(const glm::vec3& origin,
+                          const glm::vec3& direction, float tMax,
+                          Hit& hit) const {
+  const glm::vec3 inverse = SafeInverse(direction);
+  const bool negative[3] = {inverse.x < 0.0f, inverse.y < 0.0f,
+                            inverse.z < 0.0f};
+  const __m128 ox = _mm_set1_ps(origin.x);
+  const __m128 oy = _mm_set1_ps(origin.y);
+  const __m128 oz = _mm_set1_ps(origin.z);
+  const __m128 dx = _mm_set1_ps(direction.x);
+  const __m128 dy = _mm_set1_ps(direction.y);
+  const __m128 dz = _mm_set1_ps(direction.z);
+  const __m128 ix = _mm_set1_ps(inverse.x);
+  const __m128 iy = _mm_set1_ps(inverse.y);
+  const __m128 iz = _mm_set1_ps(inverse.z);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 epsilon = _mm_set1_ps(1e-12f);
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  float closest = tMax;
+  bool found = false;
+
+  StackEntry stack[kStackSize];
+  uint32_t size = 0;
+  stack[size++] = {0, 0, 0.0f};
+  while (size > 0) {
+    const StackEntry entry = stack[--size];
+    if (entry.t > closest) continue;
+
+    if (entry.count > 0) {
+      // 一个块的4个三角形同时做Möller-Trumbore测试
+      for (uint32_t b = 0; b < entry.count; b++) {
+        const TriangleBlock& block = m_blocks[entry.child + b];
+        const __m128 e1x = _mm_load_ps(block.e1x);
+        const __m128 e1y = _mm_load_ps(block.e1y);
+        const __m128 e1z = _mm_load_ps(block.e1z);
+        const __m128 e2x = _mm_load_ps(block.e2x);
+        const __m128 e2y = _mm_load_ps(block.e2y);
+        const __m128 e2z = _mm_load_ps(block.e2z);
+        const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+        const __m128 det = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)),
+            _mm_mul_ps(e1z, pz));
+        __m128 valid = _mm_cmpge_ps(_mm_and_ps(det, absMask), epsilon);
+        if (_mm_movemask_ps(valid) == 0) continue;
+        const __m128 inverseDet = _mm_div_ps(one, det);
+
+        const __m128 sx = _mm_sub_ps(ox, _mm_load_ps(block.v0x));
+        const __m128 sy = _mm_sub_ps(oy, _mm_load_ps(block.v0y));
+        const __m128 sz = _mm_sub_ps(oz, _mm_load_ps(block.v0z));
+        const __m128 u = _mm_mul_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)),
+                       _mm_mul_ps(sz, pz)),
+            inverseDet);
+        const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+        const __m128 v = _mm_mul_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)),
+                       _mm_mul_ps(dz, qz)),
+            inverseDet);
+        const __m128 t = _mm_mul_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)),
+                       _mm_mul_ps(e2z, qz)),
+            inverseDet);
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(u, zero));
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(v, zero));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(u, v), one));
+        valid = _mm_and_ps(valid, _mm_cmpgt_ps(t, zero));
+        valid = _mm_and_ps(valid, _mm_cmplt_ps(t, _mm_set1_ps(closest)));
+        int mask = _mm_movemask_ps(valid);
+        if (mask == 0) continue;
+
+        alignas(16) float ts[4], us[4], vs[4];
+        _mm_store_ps(ts, t);
+        _mm_store_ps(us, u);
+        _mm_store_ps(vs, v);
+        for (uint32_t lane = 0; lane < 4; lane++) {
+          if (!(mask & (1 << lane)) || ts[lane] >= closest) continue;
+          closest = ts[lane];
+          hit = {ts[lane], us[lane], vs[lane], block.triangle[lane]};
+          found = true;
+          if (kAnyHit) return true;
+        }
+      }
+      continue;
+    }
+
+    // 4个子包围盒的slab测试
+    const Node& node = m_nodes[entry.child];
+    const __m128 nearX = _mm_load_ps(negative[0] ? node.maxX : node.minX);
+    const __m128 nearY = _mm_load_ps(negative[1] ? node.maxY : node.minY);
+    const __m128 nearZ = _mm_load_ps(negative[2] ? node.maxZ : node.minZ);
+    const __m128 farX = _mm_load_ps(negative[0] ? node.minX : node.maxX);
+    const __m128 farY = _mm_load_ps(negative[1] ? node.minY : node.maxY);
+    const __m128 farZ = _mm_load_ps(negative[2] ? node.minZ : node.maxZ);
+    const __m128 tNear = _mm_max_ps(
+        _mm_max_ps(_mm_mul_ps(_mm_sub_ps(nearX, ox), ix),
+                   _mm_mul_ps(_mm_sub_ps(nearY, oy), iy)),
+        _mm_max_ps(_mm_mul_ps(_mm_sub_ps(nearZ, oz), iz), zero));
+    const __m128 tFar = _mm_min_ps(
+        _mm_min_ps(_mm_mul_ps(_mm_sub_ps(farX, ox), ix),
+                   _mm_mul_ps(_mm_sub_ps(farY, oy), iy)),
+        _mm_min_ps(_mm_mul_ps(_mm_sub_ps(farZ, oz), iz),
+                   _mm_set1_ps(closest)));
+    int mask = _mm_movemask_ps(_mm_cmple_ps(tNear, tFar));
+    if (mask == 0) continue;
+
+    alignas(16) float distances[4];
+    _mm_store_ps(distances, tNear);
+    StackEntry hits[kWidth];
+    uint32_t hitCount = 0;
+    for (uint32_t i = 0; i < kWidth; i++) {
+      if ((mask & (1 << i)) && node.child[i] != kInvalid) {
+        hits[hitCount++] = {node.child[i], node.count[i], distances[i]};
+      }
+    }
+    PushSorted(stack, size, hits, hitCount);
+  }
+  return found;
+}
+
+#endif  // PBR_MESH_BVH_SSE
@@ -0,0 +1,122 @@
+#include "rendering/ObjectTransform.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PBR_TRANSFORM_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+void ComputeScalar(const glm::mat4& viewProjection, const glm::mat4& model,
+                   ObjectTransform& out) {
+  out.model = model;
+  glm::vec3 a(model[0]), b(model[1]), c(model[2]);
+  glm::vec3 n0 = glm::cross(b, c);
+  glm::vec3 n1 = glm::cross(c, a);
+  glm::vec3 n2 = glm::cross(a, b);
+  float det = glm::dot(a, n0);
+  float scale = det != 0.0f ? 1.0f / det : 1.0f;
+  out.normalMatrix[0] = glm::vec4(n0 * scale, 0.0f);
+  out.normalMatrix[1] = glm::vec4(n1 * scale, 0.0f);
+  out.normalMatrix[2] = glm::vec4(n2 * scale, 0.0f);
+  out.modelViewProjection = viewProjection * model;
+}
+
+#ifdef PBR_TRANSFORM_SSE
+
+// x.yzx * y.zxy - x.zxy * y.yzx，先按zxy顺序求出再重排；w分量为0
+inline __m128 Cross(__m128 x, __m128 y) {
+  __m128 xYzx = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 0, 2, 1));
+  __m128 yYzx = _mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 0, 2, 1));
+  __m128 zxy = _mm_sub_ps(_mm_mul_ps(x, yYzx), _mm_mul_ps(xYzx, y));
+  return _mm_shuffle_ps(zxy, zxy, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+inline float Dot(__m128 x, __m128 y) {
+  __m128 product = _mm_mul_ps(x, y);
+  __m128 high = _mm_movehl_ps(product, product);
+  __m128 sum = _mm_add_ps(product, high);
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(sum);
+}
+
+struct ViewProjectionSSE {
+  __m128 columns[4];
+
+  explicit ViewProjectionSSE(const glm::mat4& m) {
+    for (int i = 0; i < 4; i++) columns[i] = _mm_loadu_ps(&m[i][0]);
+  }
+
+  // 与glm的矩阵乘法相同的累加顺序
+  __m128 Transform(__m128 v) const {
+    __m128 r = _mm_mul_ps(columns[0], _mm_shuffle_ps(v, v, 0x00));
+    r = _mm_add_ps(r, _mm_mul_ps(columns[1], _mm_shuffle_ps(v, v, 0x55)));
+    r = _mm_add_ps(r, _mm_mul_ps(columns[2], _mm_shuffle_ps(v, v, 0xAA)));
+    return _mm_add_ps(r,
+                      _mm_mul_ps(columns[3], _mm_shuffle_ps(v, v, 0xFF)));
+  }
+};
+
+void ComputeSSE(const ViewProjectionSSE& viewProjection,
+                const glm::mat4& model, ObjectTransform& out) {
+  __m128 columns[4];
+  for (int i = 0; i < 4; i++) {
+    columns[i] = _mm_loadu_ps(&model[i][0]);
+    _mm_storeu_ps(&out.model[i][0], columns[i]);
+    _mm_storeu_ps(&out.modelViewProjection[i][0],
+                  viewProjection.Transform(columns[i]));
+  }
+
+  // 前三列的w分量不参与伴随矩阵
+  const __m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  __m128 a = _mm_and_ps(columns[0], xyzMask);
+  __m128 b = _mm_and_ps(columns[1], xyzMask);
+  __m128 c = _mm_and_ps(columns[2], xyzMask);
+  __m128 n0 = Cross(b, c);
+  __m128 n1 = Cross(c, a);
+  __m128 n2 = Cross(a, b);
+  float det = Dot(a, n0);
+  __m128 scale = _mm_set1_ps(det != 0.0f ? 1.0f / det : 1.0f);
+  _mm_storeu_ps(&out.normalMatrix[0][0], _mm_mul_ps(n0, scale));
+  _mm_storeu_ps(&out.normalMatrix[1][0], _mm_mul_ps(n1, scale));
+  _mm_storeu_ps(&out.normalMatrix[2][0], _mm_mul_ps(n2, scale));
+}
+
+#endif  // PBR_TRANSFORM_SSE
+
+}  // namespace
+
+namespace ObjectTransforms {
+
+Path GetBestPath() {
+#ifdef PBR_TRANSFORM_SSE
+  return Path::SSE;
+#else
+  return Path::Scalar;
+#endif
+}
+
+const char* GetPathName(Path path) {
+  return path == Path::SSE ? "SSE" : "Scalar";
+}
+
+void Compute(const glm::mat4& viewProjection, const glm::mat4& model,
+             ObjectTransform& out, Path path) {
+  Compute(viewProjection, &model, 1, &out, path);
+}
+
+void Compute(const glm::mat4& viewProjection, const glm::mat4* models,
+             size_t count, ObjectTransform* out, Path path) {
+#ifdef PBR_TRANSFORM_SSE
+  if (path == Path::SSE) {
+    const ViewProjectionSSE columns(viewProjection);
+    for (size_t i = 0; i < count; i++) ComputeSSE(columns, models[i], out[i]);
+    return;
+  }
+#endif
+  for (size_t i = 0; i < count; i++) {
+    ComputeScalar(viewProjection, models[i], out[i]);
+  }
+}
+
+}  // namespace ObjectTransforms
@@ -0,0 +1,488 @@
+#include "rendering/PathTracer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <limits>
+
+#include "core/ThreadPool.hpp"
+#include "core/Timer.hpp"
+#include "rendering/ObjectTransform.hpp"
+#include "rendering/camera.hpp"
+#include "utils/ImageWriter.hpp"
+
+namespace {
+
+constexpr float kPi = 3.14159265358979f;
+// 次级光线起点沿几何法线的偏移，避免与自身相交
+constexpr float kRayOffset = 1e-4f;
+
+// 以下三个函数与deferred_lighting.comp一致
+float DistributionGGX(float NdotH, float roughness) {
+  float a = roughness * roughness;
+  float a2 = a * a;
+  float denom = NdotH * NdotH * (a2 - 1.0f) + 1.0f;
+  return a2 / (kPi * denom * denom);
+}
+
+float GeometrySchlickGGX(float NdotX, float roughness) {
+  float r = roughness + 1.0f;
+  float k = r * r / 8.0f;
+  return NdotX / (NdotX * (1.0f - k) + k);
+}
+
+glm::vec3 FresnelSchlick(float cosTheta, const glm::vec3& F0) {
+  return F0 + (glm::vec3(1.0f) - F0) *
+                  std::pow(std::clamp(1.0f - cosTheta, 0.0f, 1.0f), 5.0f);
+}
+
+glm::vec3 ToneMapACES(const glm::vec3& color) {
+  const float a = 2.51f, b = 0.03f, c = 2.43f, d = 0.59f, e = 0.14f;
+  return glm::clamp((color * (a * color + b)) / (color * (c * color + d) + e),
+                    0.0f, 1.0f);
+}
+
+float LinearToSrgb(float c) {
+  return c <= 0.0031308f ? c * 12.92f
+                         : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+const std::array<float, 256>& SrgbTable() {
+  static const auto table = []() {
+    std::array<float, 256> result{};
+    for (int i = 0; i < 256; i++) {
+      float c = i / 255.0f;
+      result[i] = c <= 0.04045f ? c / 12.92f
+                                : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+    return result;
+  }();
+  return table;
+}
+
+uint32_t Hash(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7FEB352Du;
+  x ^= x >> 15;
+  x *= 0x846CA68Bu;
+  x ^= x >> 16;
+  return x;
+}
+
+// 以n为z轴的正交基
+void BuildBasis(const glm::vec3& n, glm::vec3& t, glm::vec3& b) {
+  float sign = n.z >= 0.0f ? 1.0f : -1.0f;
+  float a = -1.0f / (sign + n.z);
+  float c = n.x * n.y * a;
+  t = glm::vec3(1.0f + sign * n.x * n.x * a, sign * c, -sign * n.x);
+  b = glm::vec3(c, sign + n.y * n.y * a, -n.y);
+}
+
+float MaxComponent(const glm::vec3& v) {
+  return std::max(v.x, std::max(v.y, v.z));
+}
+
+}  // namespace
+
+// PCG随机数，状态由像素、样本序号与种子哈希得到
+class PathTracer::Sampler {
+ public:
+  Sampler(uint32_t pixel, uint32_t sample, uint32_t seed)
+      : m_state(Hash(pixel ^ Hash(sample ^ Hash(seed)))) {}
+
+  float Next() {
+    m_state = m_state * 747796405u + 2891336453u;
+    uint32_t word =
+        ((m_state >> ((m_state >> 28u) + 4u)) ^ m_state) * 277803737u;
+    word = (word >> 22u) ^ word;
+    return (word >> 8) * (1.0f / 16777216.0f);
+  }
+
+ private:
+  uint32_t m_state;
+};
+
+PathTracer::PathTracer(ThreadPool* pool) : m_pool(pool) {
+  if (!m_pool) {
+    m_ownedPool = std::make_unique<ThreadPool>();
+    m_pool = m_ownedPool.get();
+  }
+  Reset();
+}
+
+PathTracer::~PathTracer() = default;
+
+void PathTracer::SetScene(const Model& model, const Material& material,
+                          const std::vector<glm::mat4>& instances) {
+  Timer timer;
+  std::vector<ObjectTransform> transforms(instances.size());
+  ObjectTransforms::Compute(glm::mat4(1.0f), instances.data(),
+                            instances.size(), transforms.data());
+
+  m_vertices.clear();
+  m_indices.clear();
+  m_vertices.reserve(model.vertices.size() * instances.size());
+  m_indices.reserve(model.indices.size() * instances.size());
+  for (const ObjectTransform& transform : transforms) {
+    const uint32_t base = static_cast<uint32_t>(m_vertices.size());
+    const glm::mat3 normalMatrix(glm::vec3(transform.normalMatrix[0]),
+                                 glm::vec3(transform.normalMatrix[1]),
+                                 glm::vec3(transform.normalMatrix[2]));
+    const glm::mat3 linear(transform.model);
+    for (const Vertex& vertex : model.vertices) {
+      Vertex world = vertex;
+      world.position = glm::vec3(transform.model *
+                                 glm::vec4(vertex.position, 1.0f));
+      world.normal = normalMatrix * vertex.normal;
+      world.tangent = linear * vertex.tangent;
+      m_vertices.push_back(world);
+    }
+    for (uint32_t index : model.indices) m_indices.push_back(base + index);
+  }
+
+  m_bvh.Build(m_vertices, m_indices, m_pool);
+
+  m_constants = MaterialConstants::FromMaterial(material);
+  const Texture* textures[MaterialFeatures::kSlotCount] = {
+      &material.baseColor.texture, &material.normal.texture,
+      &material.metallic.texture,  &material.roughness.texture,
+      &material.ao.texture,        &material.emissiveIntensity.texture};
+  for (size_t i = 0; i < m_maps.size(); i++) {
+    m_maps[i] = Map{};
+    if (m_constants.features & MaterialFeatures::SlotBit(i)) {
+      m_maps[i].texture = *textures[i];
+      m_maps[i].srgb = textures[i]->IsSRGB();
+    }
+  }
+
+  const MeshBVH::Stats& bvhStats = m_bvh.GetStats();
+  m_stats.triangleCount = bvhStats.triangleCount;
+  m_stats.nodeCount = bvhStats.nodeCount;
+  m_stats.buildMs = timer.ElapsedMilliseconds();
+  Reset();
+}
+
+glm::vec4 PathTracer::SampleMap(size_t slot, const glm::vec2& uv) const {
+  // 双线性过滤，坐标重复平铺，只读取第0级
+  const Map& map = m_maps[slot];
+  const Texture& texture = map.texture;
+  const int width = texture.width;
+  const int height = texture.height;
+  const int channels =
+      texture.GetBytesPerPixel() / (texture.floatData ? 4 : 1);
+  float fx = (uv.x - std::floor(uv.x)) * width - 0.5f;
+  float fy = (uv.y - std::floor(uv.y)) * height - 0.5f;
+  int x0 = static_cast<int>(std::floor(fx));
+  int y0 = static_cast<int>(std::floor(fy));
+  float tx = fx - x0;
+  float ty = fy - y0;
+
+  auto fetch = [&](int x, int y) {
+    x = (x % width + width) % width;
+    y = (y % height + height) % height;
+    size_t index = (static_cast<size_t>(y) * width + x) * channels;
+    glm::vec4 texel(0.0f, 0.0f, 0.0f, 1.0f);
+    for (int c = 0; c < std::min(channels, 4); c++) {
+      if (texture.floatData) {
+        const float* data = reinterpret_cast<const float*>(texture.data.get());
+        texel[c] = data[index + c];
+      } else {
+        uint8_t value = texture.data[index + c];
+        texel[c] = map.srgb && c < 3 ? SrgbTable()[value] : value / 255.0f;
+      }
+    }
+    return texel;
+  };
+  glm::vec4 top = glm::mix(fetch(x0, y0), fetch(x0 + 1, y0), tx);
+  glm::vec4 bottom = glm::mix(fetch(x0, y0 + 1), fetch(x0 + 1, y0 + 1), tx);
+  return glm::mix(top, bottom, ty);
+}
+
+glm::vec3 PathTracer::TracePath(glm::vec3 origin, glm::vec3 direction,
+                                Sampler& sampler, uint64_t& rays) const {
+  glm::vec3 radiance(0.0f);
+  glm::vec3 throughput(1.0f);
+  const uint32_t features = m_constants.features;
+  auto useMap = [features](uint32_t bit) { return (features & bit) != 0; };
+
+  for (uint32_t bounce = 0; bounce <= m_settings.maxBounces; bounce++) {
+    MeshBVH::Hit hit;
+    rays++;
+    if (!m_bvh.Intersect(origin, direction,
+                         std::numeric_limits<float>::max(), hit)) {
+      radiance += throughput * m_settings.environment;
+      break;
+    }
+
+    // 重心插值顶点属性
+    const uint32_t* indices = &m_indices[hit.triangle * 3];
+    const Vertex& a = m_vertices[indices[0]];
+    const Vertex& b = m_vertices[indices[1]];
+    const Vertex& c = m_vertices[indices[2]];
+    const float w = 1.0f - hit.u - hit.v;
+    const glm::vec3 position = origin + direction * hit.t;
+    const glm::vec2 uv = a.texCoord * w + b.texCoord * hit.u +
+                         c.texCoord * hit.v;
+    glm::vec3 geometric = glm::normalize(
+        glm::cross(b.position - a.position, c.position - a.position));
+    glm::vec3 N = glm::normalize(a.normal * w + b.normal * hit.u +
+                                 c.normal * hit.v);
+    // 双面着色：法线翻转到入射一侧
+    if (glm::dot(geometric, direction) > 0.0f) geometric = -geometric;
+    if (glm::dot(N, geometric) < 0.0f) N = -N;
+
+    if (useMap(MaterialFeatures::kNormalMap)) {
+      // 与geometry.vert相同的施密特正交化TBN
+      glm::vec3 T = a.tangent * w + b.tangent * hit.u + c.tangent * hit.v;
+      T = T - glm::dot(T, N) * N;
+      if (glm::dot(T, T) > 1e-12f) {
+        T = glm::normalize(T);
+        glm::vec3 B = glm::cross(N, T);
+        glm::vec3 tangentNormal =
+            glm::vec3(SampleMap(1, uv)) * 2.0f - 1.0f;
+        glm::vec3 mapped = glm::mat3(T, B, N) * tangentNormal;
+        if (glm::dot(mapped, mapped) > 1e-12f) N = glm::normalize(mapped);
+      }
+    }
+
+    const glm::vec3 albedo = useMap(MaterialFeatures::kAlbedoMap)
+                                 ? glm::vec3(SampleMap(0, uv))
+                                 : glm::vec3(m_constants.baseColor);
+    const float metallic = useMap(MaterialFeatures::kMetallicMap)
+                               ? SampleMap(2, uv).r
+                               : m_constants.factors.x;
+    const float roughness = std::clamp(
+        useMap(MaterialFeatures::kRoughnessMap) ? SampleMap(3, uv).r
+                                                : m_constants.factors.y,
+        0.04f, 1.0f);
+    const float emissive = useMap(MaterialFeatures::kEmissiveMap)
+                               ? SampleMap(5, uv).r
+                               : m_constants.factors.w;
+    radiance += throughput * albedo * emissive;
+
+    const glm::vec3 V = -direction;
+    const float NdotV = std::max(glm::dot(N, V), 1e-4f);
+    const glm::vec3 F0 = glm::mix(glm::vec3(0.04f), albedo, metallic);
+    auto brdf = [&](const glm::vec3& L, float NdotL) {
+      glm::vec3 H = glm::normalize(V + L);
+      float NdotH = std::max(glm::dot(N, H), 0.0f);
+      float D = DistributionGGX(NdotH, roughness);
+      float G = GeometrySchlickGGX(NdotV, roughness) *
+                GeometrySchlickGGX(NdotL, roughness);
+      glm::vec3 F = FresnelSchlick(std::max(glm::dot(H, V), 0.0f), F0);
+      glm::vec3 specular = D * G * F / (4.0f * NdotV * NdotL + 1e-4f);
+      glm::vec3 kD = (glm::vec3(1.0f) - F) * (1.0f - metallic);
+      return kD * albedo / kPi + specular;
+    };
+    const glm::vec3 offsetOrigin = position + geometric * kRayOffset;
+
+    // 点光源的直接光照，衰减与光栅路径一致
+    for (const PointLight& light : m_lights) {
+      glm::vec3 toLight = light.position - position;
+      float distance2 = glm::dot(toLight, toLight);
+      float distance = std::sqrt(distance2);
+      float ratio = distance / light.radius;
+      float window = std::clamp(1.0f - ratio * ratio * ratio * ratio, 0.0f,
+                                1.0f);
+      float attenuation = window * window / std::max(distance2, 1e-4f);
+      if (attenuation <= 0.0f) continue;
+      glm::vec3 L = toLight / distance;
+      float NdotL = glm::dot(N, L);
+      if (NdotL <= 0.0f || glm::dot(geometric, L) <= 0.0f) continue;
+      rays++;
+      if (m_bvh.Occluded(offsetOrigin, L, distance - kRayOffset)) continue;
+      radiance += throughput * brdf(L, NdotL) * light.color *
+                  (light.intensity * attenuation * NdotL);
+    }
+    if (bounce == m_settings.maxBounces) break;
+
+    // 镜面波瓣按GGX分布采样半程向量，漫反射按余弦采样；
+    // 金属表面没有漫反射，只采样镜面
+    const float specularChance = 0.5f + 0.5f * metallic;
+    glm::vec3 tangent, bitangent;
+    BuildBasis(N, tangent, bitangent);
+    const float u1 = sampler.Next();
+    const float u2 = sampler.Next();
+    glm::vec3 L;
+    if (sampler.Next() < specularChance) {
+      float alpha = roughness * roughness;
+      float phi = 2.0f * kPi * u1;
+      float cosTheta =
+          std::sqrt((1.0f - u2) / (1.0f + (alpha * alpha - 1.0f) * u2));
+      float sinTheta = std::sqrt(std::max(1.0f - cosTheta * cosTheta, 0.0f));
+      glm::vec3 H = tangent * (sinTheta * std::cos(phi)) +
+                    bitangent * (sinTheta * std::sin(phi)) + N * cosTheta;
+      L = glm::reflect(-V, H);
+    } else {
+      float radius = std::sqrt(u1);
+      float phi = 2.0f * kPi * u2;
+      L = tangent * (radius * std::cos(phi)) +
+          bitangent * (radius * std::sin(phi)) +
+          N * std::sqrt(std::max(1.0f - u1, 0.0f));
+    }
+    const float NdotL = glm::dot(N, L);
+    if (NdotL <= 0.0f || glm::dot(geometric, L) <= 0.0f) break;
+
+    // 两个波瓣的混合概率密度
+    glm::vec3 H = glm::normalize(V + L);
+    float NdotH = std::max(glm::dot(N, H), 0.0f);
+    float VdotH = std::max(glm::dot(V, H), 1e-4f);
+    float pdf = specularChance * DistributionGGX(NdotH, roughness) * NdotH /
+                    (4.0f * VdotH) +
+                (1.0f - specularChance) * NdotL / kPi;
+    if (pdf <= 0.0f) break;
+    throughput *= brdf(L, NdotL) * (NdotL / pdf);
+
+    // 第二次反弹后俄罗斯轮盘赌
+    if (bounce >= 2) {
+      float survive = std::min(MaxComponent(throughput), 0.95f);
+      if (sampler.Next() >= survive) break;
+      throughput /= survive;
+    }
+    origin = offsetOrigin;
+    direction = L;
+  }
+  return radiance;
+}
+
+void PathTracer::RenderTile(uint32_t tile, uint64_t& rays) {
+  const uint32_t size = m_settings.tileSize;
+  const uint32_t tilesX = (m_settings.width + size - 1) / size;
+  const uint32_t x0 = (tile % tilesX) * size;
+  const uint32_t y0 = (tile / tilesX) * size;
+  const uint32_t x1 = std::min(x0 + size, m_settings.width);
+  const uint32_t y1 = std::min(y0 + size, m_settings.height);
+  const float inverseWidth = 1.0f / m_settings.width;
+  const float inverseHeight = 1.0f / m_settings.height;
+
+  for (uint32_t y = y0; y < y1; y++) {
+    for (uint32_t x = x0; x < x1; x++) {
+      const uint32_t pixel = y * m_settings.width + x;
+      glm::vec3 sum(0.0f);
+      for (uint32_t s = 0; s < m_settings.samplesPerPass; s++) {
+        Sampler sampler(pixel, m_stats.samplesPerPixel + s, m_settings.seed);
+        // 像素内抖动，首行为图像顶部
+        float sx = (x + sampler.Next()) * inverseWidth * 2.0f - 1.0f;
+        float sy = 1.0f - (y + sampler.Next()) * inverseHeight * 2.0f;
+        glm::vec3 direction = glm::normalize(
+            m_cameraForward + m_cameraRight * sx + m_cameraUp * sy);
+        glm::vec3 sample =
+            TracePath(m_cameraPosition, direction, sampler, rays);
+        // 丢弃数值异常的样本，避免污染累积
+        if (std::isfinite(sample.x) && std::isfinite(sample.y) &&
+            std::isfinite(sample.z)) {
+          sum += sample;
+        }
+      }
+      m_accumulation[pixel] += sum;
+    }
+  }
+}
+
+void PathTracer::SetCamera(const Camera& camera) {
+  m_cameraPosition = camera.GetPosition();
+  m_cameraForward = glm::normalize(camera.GetTarget() - m_cameraPosition);
+  glm::vec3 right =
+      glm::normalize(glm::cross(m_cameraForward, camera.GetUp()));
+  glm::vec3 up = glm::cross(right, m_cameraForward);
+  float tanHalfFov = std::tan(glm::radians(camera.GetFov()) * 0.5f);
+  m_cameraRight = right * (tanHalfFov * camera.GetAspectRatio());
+  m_cameraUp = up * tanHalfFov;
+  Reset();
+}
+
+void PathTracer::AddPointLight(const PointLight& light) {
+  m_lights.push_back(light);
+  Reset();
+}
+
+void PathTracer::ClearPointLights() {
+  m_lights.clear();
+  Reset();
+}
+
+void PathTracer::SetSettings(const Settings& settings) {
+  m_settings = settings;
+  m_settings.width = std::max(m_settings.width, 1u);
+  m_settings.height = std::max(m_settings.height, 1u);
+  m_settings.tileSize = std::max(m_settings.tileSize, 1u);
+  m_settings.samplesPerPass = std::max(m_settings.samplesPerPass, 1u);
+  Reset();
+}
+
+void PathTracer::Reset() {
+  m_accumulation.assign(
+      static_cast<size_t>(m_settings.width) * m_settings.height,
+      glm::vec3(0.0f));
+  m_stats.samplesPerPixel = 0;
+}
+
+void PathTracer::RenderPass() {
+  Timer timer;
+  const uint32_t size = m_settings.tileSize;
+  const uint32_t tileCount = ((m_settings.width + size - 1) / size) *
+                             ((m_settings.height + size - 1) / size);
+
+  // 每个线程循环领取下一块，耗时不均的分块自动平衡
+  std::atomic<uint32_t> nextTile{0};
+  std::atomic<uint64_t> totalRays{0};
+  const uint32_t workers = std::min(m_pool->GetThreadCount(), tileCount);
+  std::vector<std::future<void>> futures;
+  futures.reserve(workers);
+  for (uint32_t i = 0; i < workers; i++) {
+    futures.push_back(m_pool->Submit([&]() {
+      uint64_t rays = 0;
+      for (uint32_t tile = nextTile++; tile < tileCount; tile = nextTile++) {
+        RenderTile(tile, rays);
+      }
+      totalRays += rays;
+    }));
+  }
+  for (auto& future : futures) future.get();
+
+  m_stats.samplesPerPixel += m_settings.samplesPerPass;
+  m_stats.raysTraced = totalRays;
+  m_stats.passMs = timer.ElapsedMilliseconds();
+  const double samples = static_cast<double>(m_settings.width) *
+                         m_settings.height * m_settings.samplesPerPass;
+  m_stats.samplesPerSecond =
+      m_stats.passMs > 0.0 ? samples * 1000.0 / m_stats.passMs : 0.0;
+}
+
+std::vector<float> PathTracer::GetImage() const {
+  std::vector<float> image(m_accumulation.size() * 4, 1.0f);
+  const float scale =
+      m_stats.samplesPerPixel > 0
+          ? m_settings.exposure / static_cast<float>(m_stats.samplesPerPixel)
+          : 0.0f;
+  for (size_t i = 0; i < m_accumulation.size(); i++) {
+    glm::vec3 color = m_accumulation[i] * scale;
+    image[i * 4 + 0] = color.r;
+    image[i * 4 + 1] = color.g;
+    image[i * 4 + 2] = color.b;
+  }
+  return image;
+}
+
+bool PathTracer::SavePNG(const std::string& path) const {
+  std::vector<float> image = GetImage();
+  std::vector<uint8_t> pixels(image.size());
+  for (size_t i = 0; i < image.size(); i += 4) {
+    glm::vec3 color =
+        ToneMapACES(glm::vec3(image[i], image[i + 1], image[i + 2]));
+    for (int c = 0; c < 3; c++) {
+      pixels[i + c] = static_cast<uint8_t>(
+          std::lround(LinearToSrgb(color[c]) * 255.0f));
+    }
+    pixels[i + 3] = 255;
+  }
+  return ImageWriter::WritePNG(path, m_settings.width, m_settings.height,
+                               pixels.data());
+}
+
+bool PathTracer::SaveEXR(const std::string& path) const {
+  std::vector<float> image = GetImage();
+  return ImageWriter::WriteEXR(path, m_settings.width, m_settings.height,
+                               image.data());
+}
@@ -0,0 +1,431 @@
+#include "rendering/SceneBVH.hpp"
+
+#include <algorithm>
+#include <future>
+
+#include "core/ThreadPool.hpp"
+
+namespace {
+
+// 中心点包围盒的最长轴
+int LongestAxis(const AABB& centers) {
+  glm::vec3 extent = centers.Extent();
+  if (extent.x >= extent.y && extent.x >= extent.z) return 0;
+  return extent.y >= extent.z ? 1 : 2;
+}
+
+}  // namespace
+
+AABB SceneBVH::Leaf::GetBox(uint32_t slot) const {
+  return {glm::vec3(minX[slot], minY[slot], minZ[slot]),
+          glm::vec3(maxX[slot], maxY[slot], maxZ[slot])};
+}
+
+void SceneBVH::Leaf::SetBox(uint32_t slot, const AABB& box) {
+  minX[slot] = box.min.x;
+  minY[slot] = box.min.y;
+  minZ[slot] = box.min.z;
+  maxX[slot] = box.max.x;
+  maxY[slot] = box.max.y;
+  maxZ[slot] = box.max.z;
+}
+
+AABB SceneBVH::Leaf::ComputeBounds() const {
+  AABB bounds = AABB::Empty();
+  for (uint32_t i = 0; i < count; i++) {
+    bounds = bounds.Merged(GetBox(i));
+  }
+  return bounds;
+}
+
+uint32_t SceneBVH::Insert(const AABB& bounds, uint32_t userData) {
+  uint32_t handle;
+  if (!m_freeHandles.empty()) {
+    handle = m_freeHandles.back();
+    m_freeHandles.pop_back();
+  } else {
+    handle = static_cast<uint32_t>(m_objects.size());
+    m_objects.emplace_back();
+  }
+  m_objects[handle] = {kInvalid, 0, userData, bounds};
+  m_objectCount++;
+
+  if (m_root == kInvalid) {
+    m_root = CreateLeafNode(kInvalid);
+    AddToLeaf(m_nodes[m_root].leaf, handle);
+    return handle;
+  }
+
+  // 逐层选择表面积增量较小的子节点，沿途扩大包围盒以便后续插入的决策
+  uint32_t nodeIndex = m_root;
+  while (!m_nodes[nodeIndex].IsLeaf()) {
+    Node& node = m_nodes[nodeIndex];
+    AABB grown = node.bounds.Merged(bounds);
+    m_currentArea += grown.SurfaceArea() - node.bounds.SurfaceArea();
+    node.bounds = grown;
+    const AABB& left = m_nodes[node.left].bounds;
+    const AABB& right = m_nodes[node.right].bounds;
+    float leftCost = left.Merged(bounds).SurfaceArea() - left.SurfaceArea();
+    float rightCost =
+        right.Merged(bounds).SurfaceArea() - right.SurfaceArea();
+    nodeIndex = leftCost <= rightCost ? node.left : node.right;
+  }
+
+  uint32_t leafIndex = m_nodes[nodeIndex].leaf;
+  if (m_leaves[leafIndex].count < kLeafSize) {
+    AddToLeaf(leafIndex, handle);
+    m_nodes[nodeIndex].bounds = m_nodes[nodeIndex].bounds.Merged(bounds);
+  } else {
+    SplitLeaf(nodeIndex, handle);
+  }
+  return handle;
+}
+
+void SceneBVH::Remove(uint32_t handle) {
+  if (handle >= m_objects.size() || m_objects[handle].leaf == kInvalid) {
+    return;
+  }
+  RemoveFromLeaf(handle);
+  m_objects[handle].leaf = kInvalid;
+  m_freeHandles.push_back(handle);
+  m_objectCount--;
+}
+
+void SceneBVH::Update(uint32_t handle, const AABB& bounds) {
+  Object& object = m_objects[handle];
+  object.bounds = bounds;
+  m_leaves[object.leaf].SetBox(object.slot, bounds);
+  MarkDirty(object.leaf);
+}
+
+void SceneBVH::Clear() {
+  m_nodes.clear();
+  m_leaves.clear();
+  m_objects.clear();
+  m_freeHandles.clear();
+  m_dirtyLeaves.clear();
+  m_root = kInvalid;
+  m_objectCount = 0;
+  m_builtArea = 0.0f;
+  m_currentArea = 0.0f;
+}
+
+uint32_t SceneBVH::CreateLeafNode(uint32_t parent) {
+  uint32_t leafIndex = static_cast<uint32_t>(m_leaves.size());
+  uint32_t nodeIndex = static_cast<uint32_t>(m_nodes.size());
+  m_leaves.emplace_back();
+  m_leaves[leafIndex].node = nodeIndex;
+
+  Node node;
+  node.bounds = AABB::Empty();
+  node.parent = parent;
+  node.leaf = leafIndex;
+  m_nodes.push_back(node);
+  return nodeIndex;
+}
+
+void SceneBVH::AddToLeaf(uint32_t leafIndex, uint32_t handle) {
+  Leaf& leaf = m_leaves[leafIndex];
+  Object& object = m_objects[handle];
+  uint32_t slot = leaf.count++;
+  leaf.SetBox(slot, object.bounds);
+  leaf.userData[slot] = object.userData;
+  leaf.handles[slot] = handle;
+  object.leaf = leafIndex;
+  object.slot = slot;
+  MarkDirty(leafIndex);
+}
+
+void SceneBVH::RemoveFromLeaf(uint32_t handle) {
+  const Object& object = m_objects[handle];
+  Leaf& leaf = m_leaves[object.leaf];
+  uint32_t last = leaf.count - 1;
+  // 末尾槽位移入被删除的位置，保持槽位连续
+  if (object.slot != last) {
+    uint32_t moved = leaf.handles[last];
+    leaf.SetBox(object.slot, leaf.GetBox(last));
+    leaf.userData[object.slot] = leaf.userData[last];
+    leaf.handles[object.slot] = moved;
+    m_objects[moved].slot = object.slot;
+  }
+  leaf.SetBox(last, AABB{});
+  leaf.count--;
+  MarkDirty(object.leaf);
+}
+
+void SceneBVH::SplitLeaf(uint32_t nodeIndex, uint32_t handle) {
+  uint32_t leafIndex = m_nodes[nodeIndex].leaf;
+  std::vector<uint32_t> handles(m_leaves[leafIndex].handles,
+                                m_leaves[leafIndex].handles + kLeafSize);
+  handles.push_back(handle);
+
+  AABB centers = AABB::Empty();
+  for (uint32_t h : handles) {
+    glm::vec3 center = m_objects[h].bounds.Center();
+    centers = centers.Merged({center, center});
+  }
+  int axis = LongestAxis(centers);
+  std::sort(handles.begin(), handles.end(), [&](uint32_t a, uint32_t b) {
+    return m_objects[a].bounds.Center()[axis] <
+           m_objects[b].bounds.Center()[axis];
+  });
+
+  // 原叶节点数据挂到左子节点，节点本身转为内部节点
+  uint32_t left = static_cast<uint32_t>(m_nodes.size());
+  Node leftNode;
+  leftNode.bounds = AABB::Empty();
+  leftNode.parent = nodeIndex;
+  leftNode.leaf = leafIndex;
+  m_nodes.push_back(leftNode);
+  m_leaves[leafIndex].node = left;
+  m_leaves[leafIndex].count = 0;
+  uint32_t right = CreateLeafNode(nodeIndex);
+
+  m_nodes[nodeIndex].leaf = kInvalid;
+  m_nodes[nodeIndex].left = left;
+  m_nodes[nodeIndex].right = right;
+
+  const size_t half = handles.size() / 2;
+  for (size_t i = 0; i < handles.size(); i++) {
+    AddToLeaf(i < half ? leafIndex : m_nodes[right].leaf, handles[i]);
+  }
+  m_nodes[left].bounds = m_leaves[leafIndex].ComputeBounds();
+  m_nodes[right].bounds = m_leaves[m_nodes[right].leaf].ComputeBounds();
+  Node& node = m_nodes[nodeIndex];
+  node.bounds = m_nodes[left].bounds.Merged(m_nodes[right].bounds);
+  m_currentArea += node.bounds.SurfaceArea();
+}
+
+void SceneBVH::MarkDirty(uint32_t leafIndex) {
+  Leaf& leaf = m_leaves[leafIndex];
+  if (!leaf.dirty) {
+    leaf.dirty = true;
+    m_dirtyLeaves.push_back(leafIndex);
+  }
+}
+
+bool SceneBVH::RefitNode(uint32_t nodeIndex) {
+  Node& node = m_nodes[nodeIndex];
+  AABB bounds = node.IsLeaf()
+                    ? m_leaves[node.leaf].ComputeBounds()
+                    : m_nodes[node.left].bounds.Merged(
+                          m_nodes[node.right].bounds);
+  if (bounds == node.bounds) return false;
+  if (!node.IsLeaf()) {
+    m_currentArea += bounds.SurfaceArea() - node.bounds.SurfaceArea();
+  }
+  node.bounds = bounds;
+  m_lastRefitNodes++;
+  return true;
+}
+
+void SceneBVH::Refit() {
+  m_lastRefitNodes = 0;
+  for (uint32_t leafIndex : m_dirtyLeaves) {
+    m_leaves[leafIndex].dirty = false;
+    // 自下而上，包围盒不再变化时祖先也无需更新
+    uint32_t nodeIndex = m_leaves[leafIndex].node;
+    while (nodeIndex != kInvalid && RefitNode(nodeIndex)) {
+      nodeIndex = m_nodes[nodeIndex].parent;
+    }
+  }
+  m_dirtyLeaves.clear();
+
+  // 逐个插入得到的树以首次重拟合的质量为基准
+  if (m_builtArea <= 0.0f) {
+    m_builtArea = m_currentArea;
+  } else if (m_currentArea > 2.0f * m_builtArea) {
+    Rebuild();
+  }
+}
+
+void SceneBVH::Rebuild() {
+  std::vector<uint32_t> handles;
+  handles.reserve(m_objectCount);
+  for (uint32_t i = 0; i < m_objects.size(); i++) {
+    if (m_objects[i].leaf != kInvalid) handles.push_back(i);
+  }
+
+  m_nodes.clear();
+  m_leaves.clear();
+  m_dirtyLeaves.clear();
+  m_root = kInvalid;
+  if (!handles.empty()) {
+    size_t leafCount = (handles.size() + kLeafSize - 1) / kLeafSize;
+    m_leaves.reserve(leafCount);
+    m_nodes.reserve(leafCount * 2);
+    m_root = BuildRecursive(handles, 0, handles.size(), kInvalid);
+  }
+  for (auto& leaf : m_leaves) leaf.dirty = false;
+  m_dirtyLeaves.clear();
+
+  m_builtArea = ComputeInternalArea();
+  m_currentArea = m_builtArea;
+  m_rebuildCount++;
+}
+
+uint32_t SceneBVH::BuildRecursive(std::vector<uint32_t>& handles,
+                                  size_t begin, size_t end, uint32_t parent) {
+  const size_t count = end - begin;
+  if (count <= kLeafSize) {
+    uint32_t nodeIndex = CreateLeafNode(parent);
+    uint32_t leafIndex = m_nodes[nodeIndex].leaf;
+    for (size_t i = begin; i < end; i++) {
+      AddToLeaf(leafIndex, handles[i]);
+    }
+    m_nodes[nodeIndex].bounds = m_leaves[leafIndex].ComputeBounds();
+    return nodeIndex;
+  }
+
+  AABB centers = AABB::Empty();
+  for (size_t i = begin; i < end; i++) {
+    glm::vec3 center = m_objects[handles[i]].bounds.Center();
+    centers = centers.Merged({center, center});
+  }
+  int axis = LongestAxis(centers);
+
+  // 分割点取在叶节点容量的整数倍上，使叶节点尽量装满
+  size_t leafCount = (count + kLeafSize - 1) / kLeafSize;
+  size_t mid = begin + (leafCount / 2) * kLeafSize;
+  std::nth_element(handles.begin() + begin, handles.begin() + mid,
+                   handles.begin() + end, [&](uint32_t a, uint32_t b) {
+                     return m_objects[a].bounds.Center()[axis] <
+                            m_objects[b].bounds.Center()[axis];
+                   });
+
+  uint32_t nodeIndex = static_cast<uint32_t>(m_nodes.size());
+  Node node;
+  node.parent = parent;
+  m_nodes.push_back(node);
+  uint32_t left = BuildRecursive(handles, begin, mid, nodeIndex);
+  uint32_t right = BuildRecursive(handles, mid, end, nodeIndex);
+  m_nodes[nodeIndex].left = left;
+  m_nodes[nodeIndex].right = right;
+  m_nodes[nodeIndex].bounds =
+      m_nodes[left].bounds.Merged(m_nodes[right].bounds);
+  return nodeIndex;
+}
+
+float SceneBVH::ComputeInternalArea() const {
+  float area = 0.0f;
+  for (const auto& node : m_nodes) {
+    if (!node.IsLeaf()) area += node.bounds.SurfaceArea();
+  }
+  return area;
+}
+
+void SceneBVH::CullEntries(const Frustum& frustum,
+                           std::vector<uint32_t>& stack,
+                           FrustumCulling::Path path,
+                           std::vector<uint32_t>& visible) const {
+  while (!stack.empty()) {
+    uint32_t entry = stack.back();
+    stack.pop_back();
+    bool inside = (entry & kInsideFlag) != 0;
+    const Node& node = m_nodes[entry & ~kInsideFlag];
+    if (!inside) {
+      Frustum::Result result = frustum.Classify(node.bounds);
+      if (result == Frustum::Result::Outside) continue;
+      inside = result == Frustum::Result::Inside;
+    }
+
+    if (node.IsLeaf()) {
+      const Leaf& leaf = m_leaves[node.leaf];
+      uint32_t mask = (1u << leaf.count) - 1;
+      if (!inside) {
+        mask &= FrustumCulling::TestBoxes8(frustum, leaf.minX, leaf.minY,
+                                           leaf.minZ, leaf.maxX, leaf.maxY,
+                                           leaf.maxZ, path);
+      }
+      for (uint32_t slot = 0; slot < leaf.count; slot++) {
+        if (mask & (1u << slot)) visible.push_back(leaf.userData[slot]);
+      }
+      continue;
+    }
+
+    uint32_t flag = inside ? kInsideFlag : 0;
+    stack.push_back(node.left | flag);
+    stack.push_back(node.right | flag);
+  }
+}
+
+void SceneBVH::Cull(const Frustum& frustum, std::vector<uint32_t>& visible,
+                    FrustumCulling::Path path, ThreadPool* pool) const {
+  visible.clear();
+  if (m_root == kInvalid) return;
+
+  std::vector<uint32_t> stack;
+  if (!pool || pool->GetThreadCount() <= 1) {
+    stack.push_back(m_root);
+    CullEntries(frustum, stack, path, visible);
+    return;
+  }
+
+  // 广度优先展开顶层，直到子树数量足以在各线程间均衡
+  const size_t target = pool->GetThreadCount() * 4;
+  std::vector<uint32_t> frontier{m_root};
+  std::vector<uint32_t> next;
+  while (frontier.size() < target) {
+    next.clear();
+    bool expanded = false;
+    for (uint32_t entry : frontier) {
+      const Node& node = m_nodes[entry & ~kInsideFlag];
+      if (node.IsLeaf() || (entry & kInsideFlag)) {
+        next.push_back(entry);
+        continue;
+      }
+      Frustum::Result result = frustum.Classify(node.bounds);
+      if (result == Frustum::Result::Outside) continue;
+      if (result == Frustum::Result::Inside) {
+        next.push_back(entry | kInsideFlag);
+        continue;
+      }
+      next.push_back(node.left);
+      next.push_back(node.right);
+      expanded = true;
+    }
+    frontier.swap(next);
+    if (!expanded) break;
+  }
+
+  // 子树交错分配到各任务，各自输出到独立的列表后合并
+  const size_t taskCount =
+      std::min<size_t>(pool->GetThreadCount(), frontier.size());
+  std::vector<std::vector<uint32_t>> results(taskCount);
+  std::vector<std::future<void>> futures;
+  futures.reserve(taskCount);
+  for (size_t task = 0; task < taskCount; task++) {
+    futures.push_back(pool->Submit([&, task]() {
+      std::vector<uint32_t> localStack;
+      for (size_t i = task; i < frontier.size(); i += taskCount) {
+        localStack.push_back(frontier[i]);
+      }
+      CullEntries(frustum, localStack, path, results[task]);
+    }));
+  }
+  for (auto& future : futures) future.get();
+  for (const auto& result : results) {
+    visible.insert(visible.end(), result.begin(), result.end());
+  }
+}
+
+SceneBVH::Stats SceneBVH::GetStats() const {
+  Stats stats;
+  stats.objectCount = static_cast<uint32_t>(m_objectCount);
+  stats.nodeCount = static_cast<uint32_t>(m_nodes.size());
+  stats.leafCount = static_cast<uint32_t>(m_leaves.size());
+  stats.rebuildCount = m_rebuildCount;
+  stats.lastRefitNodes = m_lastRefitNodes;
+  stats.qualityRatio =
+      m_builtArea > 0.0f ? m_currentArea / m_builtArea : 1.0f;
+
+  // 父节点总在子节点之前创建，顺序扫描即可得到深度
+  std::vector<uint32_t> depths(m_nodes.size(), 1);
+  for (size_t i = 0; i < m_nodes.size(); i++) {
+    if (m_nodes[i].parent != kInvalid) {
+      depths[i] = depths[m_nodes[i].parent] + 1;
+    }
+    stats.depth = std::max(stats.depth, depths[i]);
+  }
+  return stats;
+}
@@ -0,0 +1,124 @@
+#include "rendering/TextureCooker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <glm/glm.hpp>
+#include <type_traits>
+
+namespace {
+
+float SrgbToLinear(float c) {
+  return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float LinearToSrgb(float c) {
+  return c <= 0.0031308f ? c * 12.92f
+                         : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+const std::array<float, 256>& SrgbTable() {
+  static const std::array<float, 256> table = [] {
+    std::array<float, 256> values{};
+    for (int i = 0; i < 256; i++) values[i] = SrgbToLinear(i / 255.0f);
+    return values;
+  }();
+  return table;
+}
+
+uint8_t ToUnorm8(float value) {
+  return static_cast<uint8_t>(
+      std::lround(std::min(std::max(value, 0.0f), 1.0f) * 255.0f));
+}
+
+// 由上一级生成下一级，texel均为channels个分量
+template <typename T>
+void Downsample(const Texture& texture, int level, const T* src, T* dst,
+                int channels) {
+  const int srcWidth = texture.GetMipWidth(level - 1);
+  const int srcHeight = texture.GetMipHeight(level - 1);
+  const int width = texture.GetMipWidth(level);
+  const int height = texture.GetMipHeight(level);
+  const bool srgb = texture.IsSRGB();
+  const bool normal = texture.type == TextureType::Normal;
+  const auto& table = SrgbTable();
+
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      int x0 = std::min(x * 2, srcWidth - 1);
+      int x1 = std::min(x * 2 + 1, srcWidth - 1);
+      int y0 = std::min(y * 2, srcHeight - 1);
+      int y1 = std::min(y * 2 + 1, srcHeight - 1);
+      const T* taps[4] = {src + (size_t(y0) * srcWidth + x0) * channels,
+                          src + (size_t(y0) * srcWidth + x1) * channels,
+                          src + (size_t(y1) * srcWidth + x0) * channels,
+                          src + (size_t(y1) * srcWidth + x1) * channels};
+
+      float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+      for (const T* tap : taps) {
+        for (int c = 0; c < channels; c++) {
+          float value;
+          if constexpr (std::is_same_v<T, float>) {
+            value = tap[c];
+          } else if (srgb && c < 3) {
+            value = table[tap[c]];
+          } else {
+            value = tap[c] / 255.0f;
+          }
+          sum[c] += value * 0.25f;
+        }
+      }
+
+      if (normal && channels >= 3) {
+        glm::vec3 n(sum[0], sum[1], sum[2]);
+        n = n * 2.0f - 1.0f;
+        float length = glm::length(n);
+        n = length > 1e-6f ? n / length : glm::vec3(0.0f, 0.0f, 1.0f);
+        n = n * 0.5f + 0.5f;
+        sum[0] = n.x;
+        sum[1] = n.y;
+        sum[2] = n.z;
+      }
+
+      T* out = dst + (size_t(y) * width + x) * channels;
+      for (int c = 0; c < channels; c++) {
+        if constexpr (std::is_same_v<T, float>) {
+          out[c] = sum[c];
+        } else if (srgb && c < 3) {
+          out[c] = ToUnorm8(LinearToSrgb(sum[c]));
+        } else {
+          out[c] = ToUnorm8(sum[c]);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+Texture TextureCooker::BuildMipChain(const Texture& source) {
+  if (!source.IsValid() || !source.data || source.mipLevels > 1) {
+    return source;
+  }
+
+  Texture cooked = source;
+  cooked.mipLevels = source.GetFullMipLevels();
+  cooked.data =
+      std::shared_ptr<uint8_t[]>(new uint8_t[cooked.GetTotalBytes()]);
+  std::memcpy(cooked.data.get(), source.data.get(), source.GetMipBytes(0));
+
+  const int bytesPerPixel = cooked.GetBytesPerPixel();
+  for (int level = 1; level < cooked.mipLevels; level++) {
+    uint8_t* src = cooked.data.get() + cooked.GetMipOffset(level - 1);
+    uint8_t* dst = cooked.data.get() + cooked.GetMipOffset(level);
+    if (cooked.floatData) {
+      Downsample(cooked, level, reinterpret_cast<const float*>(src),
+                 reinterpret_cast<float*>(dst),
+                 bytesPerPixel / static_cast<int>(sizeof(float)));
+    } else {
+      Downsample(cooked, level, src, dst, bytesPerPixel);
+    }
+  }
+  return cooked;
+}
@@ -14,20 +14,29 @@ void AssetManager::loadTexture(std::string path, TextureType type,
   else if (api_ == API::Vulkan)
     stbi_set_flip_vertically_on_load(false);
 
-  // 强制加载为RGBA格式以确保Vulkan兼容性
-  uint8_t* data = stbi_load(path.c_str(), &w, &h, &c, STBI_rgb_alpha);
+  // HDR与浮点立方体贴图加载为RGBA32F线性值，其余强制加载为RGBA8
+  // 以确保Vulkan兼容性
+  const bool loadFloat =
+      (type == TextureType::HDR || type == TextureType::CubeMap) &&
+      stbi_is_hdr(path.c_str());
+  void* data = nullptr;
+  if (loadFloat) {
+    data = stbi_loadf(path.c_str(), &w, &h, &c, STBI_rgb_alpha);
+  } else {
+    data = stbi_load(path.c_str(), &w, &h, &c, STBI_rgb_alpha);
+  }
   if (!data) {
     Log::LogMessage(Log::Level::Error, "Failed to load texture: " + path);
     return;
   }
 
   // 现在数据总是RGBA格式（4通道）
-  std::shared_ptr<uint8_t[]> buffer(new uint8_t[w * h * 4]);
-  std::memcpy(buffer.get(), data, w * h * 4);
-  stbi_image_free(data);
-
-  // 创建纹理对象，指定通道类型为RGBA
   Texture texture(name, w, h, ChannelType::RGBA, type, filter);
+  texture.floatData = loadFloat;
+  const size_t bytes = texture.GetTotalBytes();
+  std::shared_ptr<uint8_t[]> buffer(new uint8_t[bytes]);
+  std::memcpy(buffer.get(), data, bytes);
+  stbi_image_free(data);
   texture.data = buffer;
 
   //这里还需要一些逻辑检查是否有重名纹理
@@ -87,6 +96,8 @@ void AssetManager::loadModel(std::string path, std::string name) {
       model.indices.push_back(uniqueVertices[vertex]);
     }
   }
+  ComputeTangents(model);
+  ComputeBounds(model);
   models[name] = model;
   Log::LogMessage(Log::Level::Info, "Model loaded: " + name);
 }
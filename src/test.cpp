@@ -1,13 +1,29 @@
+#include <algorithm>
+#include <cmath>
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
 #include "core/Log.hpp"
+#include "core/ThreadPool.hpp"
+#include "core/Timer.hpp"
 #include "core/interface/API.hpp"
 #include "platform/WindowHandler.hpp"
 #include "platform/vulkan/VKContext.hpp"
+#include "platform/vulkan/VKIBLBaker.hpp"
 #include "platform/vulkan/VKRender.hpp"
+#include "rendering/IBLBaker.hpp"
+#include "rendering/MeshBVH.hpp"
+#include "rendering/ObjectTransform.hpp"
+#include "rendering/PathTracer.hpp"
+#include "rendering/SceneBVH.hpp"
 #include "rendering/camera.hpp"
 #include "resource/AssetManager.hpp"
 
@@ -36,11 +52,825 @@ Model CreateSquareModel(float size = 1.0f) {
       0, 1, 2,  // 第一个三角形
       2, 3, 0   // 第二个三角形
   };
+  ComputeTangents(model);
+  ComputeBounds(model);
 
   return model;
 }
 
-int main() {
+// XY平面上resolution x resolution个格子的网格，用于顶点密集的基准
+Model CreateGridModel(float size, uint32_t resolution) {
+  Model model;
+  model.name = "Grid";
+  model.isValid = true;
+
+  const uint32_t columns = resolution + 1;
+  model.vertices.reserve(columns * columns);
+  for (uint32_t y = 0; y < columns; y++) {
+    for (uint32_t x = 0; x < columns; x++) {
+      glm::vec2 uv(float(x) / resolution, float(y) / resolution);
+      glm::vec3 position((uv - 0.5f) * size, 0.0f);
+      model.vertices.push_back({position, {0.0f, 0.0f, 1.0f}, uv});
+    }
+  }
+  model.indices.reserve(resolution * resolution * 6);
+  for (uint32_t y = 0; y < resolution; y++) {
+    for (uint32_t x = 0; x < resolution; x++) {
+      uint32_t i = y * columns + x;
+      model.indices.insert(model.indices.end(),
+                           {i, i + 1, i + columns + 1, i + columns + 1,
+                            i + columns, i});
+    }
+  }
+  ComputeTangents(model);
+  ComputeBounds(model);
+  return model;
+}
+
+// 无窗口基准共用的离屏渲染器：相机宽高比与输出尺寸一致；
+// 相机先于渲染器构造、后于渲染器析构
+struct HeadlessRenderer {
+  explicit HeadlessRenderer(const Camera::CreateInfo& cameraInfo)
+      : camera(cameraInfo) {}
+
+  Camera camera;
+  VKRender render;
+};
+
+// 加载模型与材质、初始化离屏渲染并添加objects中的渲染对象；
+// textureStreaming须在上传材质前确定
+std::unique_ptr<HeadlessRenderer> CreateHeadlessRenderer(
+    const VKContext::HeadlessConfig& config, const Model& model,
+    const Material& material,
+    const std::vector<glm::mat4>& objects = {glm::mat4(1.0f)},
+    bool textureStreaming = true) {
+  Camera::CreateInfo cameraInfo;
+  cameraInfo.aspectRatio =
+      static_cast<float>(config.width) / static_cast<float>(config.height);
+  auto renderer = std::make_unique<HeadlessRenderer>(cameraInfo);
+  VKRender& render = renderer->render;
+  render.setTextureStreamingEnabled(textureStreaming);
+  render.setModel(model);
+  render.setMaterial(material);
+  render.initHeadless(config);
+  render.setCamera(&renderer->camera);
+  for (const glm::mat4& transform : objects) render.addRenderObject(transform);
+  return renderer;
+}
+
+// 逐对象变换：逐对象求逆的参考实现与标量、SIMD伴随矩阵路径的CPU耗时，
+// 以及顶点密集网格上几何过程的GPU耗时与顶点吞吐
+int RunTransformBenchmark(const VKContext::HeadlessConfig& config,
+                          const Material& material, uint32_t objectCount) {
+  const uint32_t iterations = 20;
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+  std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+  std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+  std::vector<glm::mat4> models(objectCount);
+  for (auto& model : models) {
+    glm::vec3 offset(position(rng), position(rng), position(rng));
+    glm::vec3 axis = glm::normalize(glm::vec3(scale(rng), scale(rng), 1.0f));
+    model = glm::translate(glm::mat4(1.0f), offset);
+    model = glm::rotate(model, angle(rng), axis);
+    model = glm::scale(model, glm::vec3(scale(rng), scale(rng), scale(rng)));
+  }
+  Camera camera;
+  const glm::mat4 viewProjection = camera.GetViewProjectionMatrix();
+
+  std::vector<ObjectTransform> reference(objectCount), output(objectCount);
+  auto measure = [&](const std::function<void()>& compute) {
+    Timer timer;
+    for (uint32_t i = 0; i < iterations; i++) compute();
+    return timer.ElapsedMilliseconds() / iterations;
+  };
+  double inverseMs = measure([&]() {
+    for (uint32_t i = 0; i < objectCount; i++) {
+      glm::mat3 normal = glm::transpose(glm::inverse(glm::mat3(models[i])));
+      reference[i].model = models[i];
+      for (int c = 0; c < 3; c++) {
+        reference[i].normalMatrix[c] = glm::vec4(normal[c], 0.0f);
+      }
+      reference[i].modelViewProjection = viewProjection * models[i];
+    }
+  });
+
+  using ObjectTransforms::Path;
+  std::vector<Path> paths = {Path::Scalar};
+  if (ObjectTransforms::GetBestPath() != Path::Scalar) {
+    paths.push_back(ObjectTransforms::GetBestPath());
+  }
+  std::string line = "Transforms for " + std::to_string(objectCount) +
+                     " objects: inverse " + std::to_string(inverseMs) +
+                     " ms";
+  for (Path path : paths) {
+    double ms = measure([&]() {
+      ObjectTransforms::Compute(viewProjection, models.data(), objectCount,
+                                output.data(), path);
+    });
+    float maxError = 0.0f;
+    for (uint32_t i = 0; i < objectCount; i++) {
+      for (int c = 0; c < 3; c++) {
+        glm::vec4 d = output[i].normalMatrix[c] - reference[i].normalMatrix[c];
+        maxError = std::max({maxError, std::abs(d.x), std::abs(d.y),
+                             std::abs(d.z)});
+      }
+    }
+    line += ", " + std::string(ObjectTransforms::GetPathName(path)) + " " +
+            std::to_string(ms) + " ms (x" + std::to_string(inverseMs / ms) +
+            ", max error " + std::to_string(maxError) + ")";
+  }
+  Log::LogMessage(Log::Level::Info, line);
+
+  // 顶点着色器只做矩阵向量乘法后，几何过程的顶点吞吐
+  std::vector<glm::mat4> layers;
+  for (uint32_t i = 0; i < 16; i++) {
+    layers.push_back(glm::translate(glm::mat4(1.0f),
+                                    glm::vec3(0.0f, 0.0f, -0.01f * float(i))));
+  }
+  auto renderer = CreateHeadlessRenderer(config, CreateGridModel(8.0f, 512),
+                                         material, layers);
+  VKRender& vkRender = renderer->render;
+  vkRender.setProfilingEnabled(true, true);
+  for (uint32_t frame = 0; frame < 30; frame++) vkRender.renderFrame();
+  vkRender.flushReadbacks();
+  for (const auto& scope : vkRender.getProfiler()->GetLastFrameResults()) {
+    if (scope.name != "GBuffer" || !scope.hasStatistics) continue;
+    double vertices =
+        static_cast<double>(scope.statistics.vertexShaderInvocations);
+    Log::LogMessage(Log::Level::Info,
+                    "GBuffer: " + std::to_string(scope.gpuTimeMs) +
+                        " ms, " + std::to_string(vertices / 1e6) +
+                        " M vertex invocations (" +
+                        std::to_string(vertices / 1e3 / scope.gpuTimeMs) +
+                        " M/s)");
+  }
+  return 0;
+}
+
+// 以不同线程数录制大量绘制调用，输出CPU录制耗时随线程数的变化，
+// 并与单线程多命令间接绘制对比
+void RunRecordingBenchmark(VKRender& render, uint32_t objectCount) {
+  // 网格大部分位于视野外，关闭CPU剔除以保持各次录制的绘制数一致
+  render.setCpuCullingEnabled(false);
+  const uint32_t gridSize =
+      static_cast<uint32_t>(std::ceil(std::sqrt(float(objectCount))));
+  for (uint32_t i = 0; i < objectCount; i++) {
+    glm::vec3 offset(float(i % gridSize), float(i / gridSize), 0.0f);
+    render.addRenderObject(glm::translate(glm::mat4(1.0f), offset * 1.1f));
+  }
+
+  std::vector<uint32_t> threadCounts;
+  for (uint32_t count = 1; count <= 8; count *= 2) {
+    threadCounts.push_back(count);
+  }
+  bool indirectAvailable = render.isIndirectEnabled();
+  render.setIndirectEnabled(false);
+  auto results = render.benchmarkRecording(threadCounts, 20);
+  double baseline = results.empty() ? 0.0 : results.front().averageCpuTimeMs;
+  for (const auto& result : results) {
+    Log::LogMessage(
+        Log::Level::Info,
+        "Recording " + std::to_string(result.drawCount) + " draws with " +
+            std::to_string(result.threadCount) + " thread(s): " +
+            std::to_string(result.averageCpuTimeMs) + " ms (x" +
+            std::to_string(baseline / result.averageCpuTimeMs) + ")");
+  }
+
+  if (!indirectAvailable) return;
+  render.setIndirectEnabled(true);
+  auto indirect = render.benchmarkRecording({1}, 20);
+  const auto& stats = render.getDrawLoopStats();
+  Log::LogMessage(
+      Log::Level::Info,
+      "Recording " + std::to_string(stats.drawCount) + " draws as " +
+          std::to_string(stats.batchCount) + " indirect batch(es): " +
+          std::to_string(indirect.front().averageCpuTimeMs) + " ms (x" +
+          std::to_string(baseline / indirect.front().averageCpuTimeMs) + ")");
+}
+
+// CPU视锥剔除：标量逐盒、SIMD逐批与BVH（单线程/多线程）遍历的对比，
+// 以及移动部分实例后的增量重拟合耗时；各路径的可见集合与标量路径不一致
+// 时返回非零
+int RunCullingBenchmark(uint32_t instanceCount) {
+  const uint32_t iterations = 20;
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+  std::uniform_real_distribution<float> size(0.5f, 4.0f);
+  auto randomBox = [&]() {
+    glm::vec3 center(position(rng), position(rng), position(rng));
+    glm::vec3 half(size(rng), size(rng), size(rng));
+    return AABB{center - half, center + half};
+  };
+
+  std::vector<AABB> boxes(instanceCount);
+  AABBArray array;
+  array.Resize(instanceCount);
+  for (uint32_t i = 0; i < instanceCount; i++) {
+    boxes[i] = randomBox();
+    array.Set(i, boxes[i]);
+  }
+
+  Camera::CreateInfo cameraInfo;
+  cameraInfo.position = glm::vec3(0.0f);
+  cameraInfo.target = glm::vec3(0.0f, 0.0f, -1.0f);
+  cameraInfo.farPlane = 300.0f;
+  Camera camera(cameraInfo);
+  Frustum frustum =
+      Frustum::FromViewProjection(camera.GetViewProjectionMatrix());
+
+  // 返回单次平均毫秒数，visible保留最后一次的结果
+  std::vector<uint32_t> visible;
+  auto measure = [&](const std::function<void()>& cull) {
+    Timer timer;
+    for (uint32_t i = 0; i < iterations; i++) {
+      visible.clear();
+      cull();
+    }
+    return timer.ElapsedMilliseconds() / iterations;
+  };
+  auto report = [&](const std::string& name, double ms, double baseline) {
+    Log::LogMessage(Log::Level::Info,
+                    "Culling " + std::to_string(instanceCount) + " (" +
+                        name + "): " + std::to_string(visible.size()) +
+                        " visible, " + std::to_string(ms) + " ms (x" +
+                        std::to_string(baseline / ms) + ")");
+  };
+
+  using FrustumCulling::Path;
+  const Path best = FrustumCulling::GetBestPath();
+  double scalarMs = measure([&]() {
+    FrustumCulling::CullBoxes(frustum, array, 0, instanceCount, Path::Scalar,
+                              visible);
+  });
+  std::vector<uint32_t> expected = visible;
+  std::sort(expected.begin(), expected.end());
+  report("scalar", scalarMs, scalarMs);
+
+  // 比较排序后的索引集合而非数量，SIMD掩码或尾部处理的错误也能发现
+  bool mismatch = false;
+  auto verify = [&](const std::string& name) {
+    std::vector<uint32_t> sorted = visible;
+    std::sort(sorted.begin(), sorted.end());
+    if (sorted == expected) return;
+    mismatch = true;
+    Log::LogMessage(Log::Level::Warning,
+                    "Culling (" + name + ") result differs from the scalar " +
+                        "loop: " + std::to_string(sorted.size()) + " vs " +
+                        std::to_string(expected.size()) + " visible.");
+  };
+
+  double simdMs = measure([&]() {
+    FrustumCulling::CullBoxes(frustum, array, 0, instanceCount, best,
+                              visible);
+  });
+  report(FrustumCulling::GetPathName(best), simdMs, scalarMs);
+  verify(FrustumCulling::GetPathName(best));
+
+  SceneBVH bvh;
+  std::vector<uint32_t> handles(instanceCount);
+  for (uint32_t i = 0; i < instanceCount; i++) {
+    handles[i] = bvh.Insert(boxes[i], i);
+  }
+  Timer buildTimer;
+  bvh.Rebuild();
+  double buildMs = buildTimer.ElapsedMilliseconds();
+
+  double bvhMs = measure([&]() { bvh.Cull(frustum, visible, best); });
+  report(std::string("BVH ") + FrustumCulling::GetPathName(best), bvhMs,
+         scalarMs);
+  verify("BVH");
+
+  ThreadPool pool;
+  double parallelMs =
+      measure([&]() { bvh.Cull(frustum, visible, best, &pool); });
+  report("BVH " + std::to_string(pool.GetThreadCount()) + " threads",
+         parallelMs, scalarMs);
+  verify("BVH threaded");
+
+  // 10%的实例平移后增量重拟合
+  std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+  for (uint32_t i = 0; i < instanceCount; i += 10) {
+    glm::vec3 delta(offset(rng), offset(rng), offset(rng));
+    bvh.Update(handles[i], {boxes[i].min + delta, boxes[i].max + delta});
+  }
+  Timer refitTimer;
+  bvh.Refit();
+  double refitMs = refitTimer.ElapsedMilliseconds();
+
+  auto stats = bvh.GetStats();
+  Log::LogMessage(Log::Level::Info,
+                  "BVH: " + std::to_string(stats.nodeCount) + " nodes, " +
+                      std::to_string(stats.leafCount) + " leaves, depth " +
+                      std::to_string(stats.depth) + ", build " +
+                      std::to_string(buildMs) + " ms, refit of " +
+                      std::to_string(instanceCount / 10) + " moved in " +
+                      std::to_string(refitMs) + " ms (" +
+                      std::to_string(stats.lastRefitNodes) +
+                      " nodes, quality x" +
+                      std::to_string(stats.qualityRatio) + ")");
+  return mismatch ? 1 : 0;
+}
+
+// 网格射线查询：百万级三角形的起伏网格上SAH BVH的串行与并行构建耗时，
+// 以及标量与SIMD遍历在相干（相机主光线）与非相干（随机起点与方向）
+// 光线下的吞吐
+void RunMeshBVHBenchmark(uint32_t resolution) {
+  // 起伏的高度使网格不再是单一平面，三角形数为resolution^2 * 2
+  Model grid = CreateGridModel(8.0f, resolution);
+  for (Vertex& vertex : grid.vertices) {
+    vertex.position.z = 0.3f * std::sin(vertex.position.x * 1.5f) *
+                        std::cos(vertex.position.y * 1.1f);
+  }
+
+  ThreadPool pool;
+  MeshBVH bvh;
+  bvh.Build(grid);
+  double serialMs = bvh.GetStats().buildMs;
+  bvh.Build(grid, &pool);
+  auto stats = bvh.GetStats();
+  Log::LogMessage(Log::Level::Info,
+                  "Mesh BVH: " + std::to_string(stats.triangleCount) +
+                      " triangles, " + std::to_string(stats.nodeCount) +
+                      " nodes, " + std::to_string(stats.leafCount) +
+                      " leaves, depth " + std::to_string(stats.depth) +
+                      ", SAH cost " + std::to_string(stats.sahCost) +
+                      ", build " + std::to_string(serialMs) + " ms serial, " +
+                      std::to_string(stats.buildMs) + " ms with " +
+                      std::to_string(pool.GetThreadCount()) + " threads (" +
+                      std::to_string(stats.subtreeTasks) + " subtrees)");
+
+  // 相干：1024x1024的相机主光线，斜向俯视整个网格
+  const uint32_t side = 1024;
+  const uint32_t rayCount = side * side;
+  Camera::CreateInfo cameraInfo;
+  cameraInfo.position = glm::vec3(0.0f, -6.0f, 5.0f);
+  cameraInfo.target = glm::vec3(0.0f);
+  cameraInfo.up = glm::vec3(0.0f, 0.0f, 1.0f);
+  cameraInfo.aspectRatio = 1.0f;
+  Camera camera(cameraInfo);
+  const glm::vec3 forward =
+      glm::normalize(camera.GetTarget() - camera.GetPosition());
+  const glm::vec3 right = glm::normalize(glm::cross(forward, camera.GetUp()));
+  const glm::vec3 up = glm::cross(right, forward);
+  const float tanHalfFov = std::tan(glm::radians(camera.GetFov()) * 0.5f);
+  std::vector<glm::vec3> coherentOrigins(rayCount, camera.GetPosition());
+  std::vector<glm::vec3> coherentDirections(rayCount);
+  for (uint32_t y = 0; y < side; y++) {
+    for (uint32_t x = 0; x < side; x++) {
+      float sx = ((x + 0.5f) / side * 2.0f - 1.0f) * tanHalfFov;
+      float sy = (1.0f - (y + 0.5f) / side * 2.0f) * tanHalfFov;
+      coherentDirections[y * side + x] =
+          glm::normalize(forward + right * sx + up * sy);
+    }
+  }
+
+  // 非相干：包围盒内的随机起点与球面上均匀分布的随机方向
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  const AABB& bounds = bvh.GetBounds();
+  std::vector<glm::vec3> randomOrigins(rayCount);
+  std::vector<glm::vec3> randomDirections(rayCount);
+  for (uint32_t i = 0; i < rayCount; i++) {
+    glm::vec3 t(unit(rng), unit(rng), unit(rng));
+    randomOrigins[i] = bounds.min + (bounds.max - bounds.min) * t;
+    float z = unit(rng) * 2.0f - 1.0f;
+    float phi = unit(rng) * 6.2831853f;
+    float r = std::sqrt(std::max(1.0f - z * z, 0.0f));
+    randomDirections[i] = glm::vec3(r * std::cos(phi), r * std::sin(phi), z);
+  }
+
+  // 光线均分到线程池的各任务，返回命中数与每秒百万条光线
+  auto trace = [&](const std::vector<glm::vec3>& origins,
+                   const std::vector<glm::vec3>& directions,
+                   MeshBVH::Path path, double& mrays) {
+    const uint32_t tasks = pool.GetThreadCount() * 4;
+    std::vector<uint32_t> hits(tasks, 0);
+    std::vector<std::future<void>> futures;
+    Timer timer;
+    for (uint32_t task = 0; task < tasks; task++) {
+      futures.push_back(pool.Submit([&, task]() {
+        uint32_t begin = static_cast<uint32_t>(uint64_t(rayCount) * task /
+                                               tasks);
+        uint32_t end = static_cast<uint32_t>(uint64_t(rayCount) *
+                                             (task + 1) / tasks);
+        for (uint32_t i = begin; i < end; i++) {
+          MeshBVH::Hit hit;
+          if (bvh.Intersect(origins[i], directions[i],
+                            std::numeric_limits<float>::max(), hit, path)) {
+            hits[task]++;
+          }
+        }
+      }));
+    }
+    for (auto& future : futures) future.get();
+    mrays = rayCount / (timer.ElapsedMilliseconds() * 1000.0);
+    uint32_t total = 0;
+    for (uint32_t count : hits) total += count;
+    return total;
+  };
+
+  const MeshBVH::Path best = MeshBVH::GetBestPath();
+  struct RaySet {
+    const char* name;
+    const std::vector<glm::vec3>& origins;
+    const std::vector<glm::vec3>& directions;
+  };
+  for (const RaySet& set :
+       {RaySet{"coherent", coherentOrigins, coherentDirections},
+        RaySet{"incoherent", randomOrigins, randomDirections}}) {
+    double scalarMrays = 0.0;
+    double bestMrays = 0.0;
+    uint32_t expected =
+        trace(set.origins, set.directions, MeshBVH::Path::Scalar,
+              scalarMrays);
+    uint32_t hits = trace(set.origins, set.directions, best, bestMrays);
+    Log::LogMessage(Log::Level::Info,
+                    std::string("Rays ") + set.name + ": " +
+                        std::to_string(hits) + "/" +
+                        std::to_string(rayCount) + " hit, scalar " +
+                        std::to_string(scalarMrays) + " Mrays/s, " +
+                        MeshBVH::GetPathName(best) + " " +
+                        std::to_string(bestMrays) + " Mrays/s (x" +
+                        std::to_string(bestMrays / scalarMrays) + ")");
+    if (hits != expected) {
+      Log::LogMessage(Log::Level::Warning,
+                      "SIMD traversal result differs from the scalar path.");
+    }
+  }
+}
+
+// 默认场景光源：相机一侧的一个白色点光源。
+// 光栅路径与CPU参考路径追踪都由此生成，保证两者的场景一致
+std::vector<VKDeferredLighting::PointLight> DefaultLights() {
+  VKDeferredLighting::PointLight light;
+  light.position = glm::vec3(0.5f, 0.5f, 1.5f);
+  light.radius = 10.0f;
+  light.intensity = 5.0f;
+  return {light};
+}
+
+void AddDefaultLights(VKRender& render) {
+  for (const auto& light : DefaultLights()) render.addPointLight(light);
+}
+
+void AddDefaultLights(PathTracer& tracer) {
+  for (const auto& light : DefaultLights()) {
+    PathTracer::PointLight traced;
+    traced.position = light.position;
+    traced.radius = light.radius;
+    traced.color = light.color;
+    traced.intensity = light.intensity;
+    tracer.AddPointLight(traced);
+  }
+}
+
+// 在相机前方的平面附近随机放置小半径点光源（替换已有光源）
+void AddRandomLights(VKRender& render, uint32_t lightCount) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> x(-3.0f, 3.0f), y(-2.0f, 2.0f);
+  std::uniform_real_distribution<float> z(0.05f, 1.0f), unit(0.2f, 1.0f);
+  render.clearPointLights();
+  for (uint32_t i = 0; i < lightCount; i++) {
+    VKDeferredLighting::PointLight light;
+    light.position = glm::vec3(x(rng), y(rng), z(rng));
+    light.radius = 0.6f;
+    light.color = glm::vec3(unit(rng), unit(rng), unit(rng));
+    light.intensity = 0.5f;
+    render.addPointLight(light);
+  }
+}
+
+// 分块延迟光照：铺满屏幕的平面上随机放置不同数量的点光源，
+// 输出光源分块与着色两个过程的GPU耗时随光源数的变化
+int RunLightingBenchmark(const VKContext::HeadlessConfig& config,
+                         const Material& material) {
+  auto renderer =
+      CreateHeadlessRenderer(config, CreateSquareModel(8.0f), material);
+  VKRender& vkRender = renderer->render;
+  if (!vkRender.isDeferredLightingAvailable()) {
+    Log::LogMessage(Log::Level::Error, "Deferred lighting unavailable.");
+    return 1;
+  }
+  vkRender.setProfilingEnabled(true);
+
+  for (uint32_t lightCount : {16u, 64u, 256u, 1024u, 4096u}) {
+    AddRandomLights(vkRender, lightCount);
+    for (uint32_t frame = 0; frame < 30; frame++) vkRender.renderFrame();
+    vkRender.flushReadbacks();
+
+    std::string line = std::to_string(lightCount) + " lights:";
+    for (const auto& scope : vkRender.getProfiler()->GetLastFrameResults()) {
+      if (scope.name == "LightCull" || scope.name == "Lighting") {
+        line += " " + scope.name + " " + std::to_string(scope.gpuTimeMs) +
+                " ms";
+      }
+    }
+    Log::LogMessage(Log::Level::Info, line);
+  }
+  return 0;
+}
+
+// 完整与紧凑两种G-Buffer布局：输出每像素字节数与几何、光照过程的GPU耗时
+int RunGBufferBenchmark(const VKContext::HeadlessConfig& config,
+                        const Material& material) {
+  auto renderer =
+      CreateHeadlessRenderer(config, CreateSquareModel(8.0f), material);
+  VKRender& vkRender = renderer->render;
+  AddRandomLights(vkRender, 256);
+  vkRender.setProfilingEnabled(true);
+
+  const double pixels = double(config.width) * double(config.height);
+  for (auto layout :
+       {VKContext::GBufferLayout::Full, VKContext::GBufferLayout::Lean}) {
+    vkRender.setGBufferLayout(layout);
+    for (uint32_t frame = 0; frame < 30; frame++) vkRender.renderFrame();
+    vkRender.flushReadbacks();
+
+    uint32_t bytesPerPixel = vkRender.getGBufferBytesPerPixel();
+    std::string line =
+        std::string(layout == VKContext::GBufferLayout::Lean ? "Lean"
+                                                             : "Full") +
+        " G-Buffer: " + std::to_string(bytesPerPixel) + " B/px (" +
+        std::to_string(bytesPerPixel * pixels / (1024.0 * 1024.0)) + " MB)";
+    for (const auto& scope : vkRender.getProfiler()->GetLastFrameResults()) {
+      if (scope.name == "GBuffer" || scope.name == "LightCull" ||
+          scope.name == "Lighting") {
+        line += ", " + scope.name + " " + std::to_string(scope.gpuTimeMs) +
+                " ms";
+      }
+    }
+    Log::LogMessage(Log::Level::Info, line);
+  }
+  return 0;
+}
+
+// IBL烘焙：同一HDR等距柱状投影贴图烘焙两次，第二次应命中磁盘缓存；
+// useCompute时预过滤与BRDF查找表使用Vulkan计算后端
+int RunIBLBake(const std::string& path, bool useCompute,
+               const VKContext::HeadlessConfig& config) {
+  AssetManager assetManager(API::Vulkan, false);
+  assetManager.loadTexture(path, TextureType::HDR, TextureFilter::Linear,
+                           "environment");
+  Texture source = assetManager.getTexture("environment");
+  if (!source.IsValid()) return 1;
+
+  IBLBaker baker;
+  std::unique_ptr<VKContext> context;
+  std::unique_ptr<VKIBLBaker> backend;
+  if (useCompute) {
+    context = std::make_unique<VKContext>(config);
+    if (context->m_iblBakeSupported) {
+      backend = std::make_unique<VKIBLBaker>(
+          context->m_device->GetHandle(), context->m_physicalDevice,
+          context->m_descriptorPool, context->getIBLPipelines(),
+          context->m_device->GetComputeQueue(),
+          *context->m_computeCommandPool);
+      baker.SetComputeBackend(backend.get());
+    }
+  }
+
+  IBLBaker::Settings settings;
+  for (int run = 0; run < 2; run++) {
+    try {
+      IBLData data = baker.Bake(source, settings, "cache/ibl");
+      const IBLBaker::Stats& stats = baker.GetLastStats();
+      std::string detail = "cache hit";
+      if (!stats.cacheHit) {
+        detail = "resample " + std::to_string(stats.resampleMs) +
+                 ", irradiance " + std::to_string(stats.irradianceMs) +
+                 ", prefilter " + std::to_string(stats.prefilterMs) +
+                 ", BRDF LUT " + std::to_string(stats.brdfLutMs) +
+                 (stats.usedCompute ? ", compute" : ", CPU");
+      }
+      glm::vec3 up = data.EvaluateIrradiance(glm::vec3(0.0f, 1.0f, 0.0f));
+      Log::LogMessage(Log::Level::Info,
+                      "IBL run " + std::to_string(run + 1) + ": " +
+                          std::to_string(stats.totalMs) + " ms (" + detail +
+                          "), irradiance up (" + std::to_string(up.x) + ", " +
+                          std::to_string(up.y) + ", " +
+                          std::to_string(up.z) + ")");
+    } catch (const std::exception& err) {
+      Log::LogMessage(Log::Level::Error, err.what());
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// CPU参考路径追踪：与光栅路径相同的场景与默认光源，逐次累积并输出
+// 每次的样本吞吐，最终图像写入输出目录下的reference.png/.exr
+int RunPathTracer(const VKContext::HeadlessConfig& config, const Model& model,
+                  const Material& material, uint32_t sampleCount) {
+  Camera::CreateInfo cameraInfo;
+  cameraInfo.aspectRatio =
+      static_cast<float>(config.width) / static_cast<float>(config.height);
+  Camera camera(cameraInfo);
+
+  PathTracer tracer;
+  PathTracer::Settings settings;
+  settings.width = config.width;
+  settings.height = config.height;
+  tracer.SetSettings(settings);
+  tracer.SetScene(model, material, {glm::mat4(1.0f)});
+  tracer.SetCamera(camera);
+  AddDefaultLights(tracer);
+
+  const auto& stats = tracer.GetStats();
+  Log::LogMessage(Log::Level::Info,
+                  "Path tracer: " + std::to_string(stats.triangleCount) +
+                      " triangles, BVH " + std::to_string(stats.nodeCount) +
+                      " nodes in " + std::to_string(stats.buildMs) + " ms");
+  while (stats.samplesPerPixel < sampleCount) {
+    tracer.RenderPass();
+    Log::LogMessage(Log::Level::Info,
+                    "Pass " + std::to_string(stats.samplesPerPixel) + " spp: " +
+                        std::to_string(stats.passMs) + " ms, " +
+                        std::to_string(stats.samplesPerSecond / 1e6) +
+                        " Msamples/s, " +
+                        std::to_string(stats.raysTraced / stats.passMs /
+                                       1e3) +
+                        " Mrays/s");
+  }
+
+  const bool exr = config.fileFormat == VKOffscreenTarget::FileFormat::EXR;
+  std::filesystem::path path = config.outputDirectory;
+  path /= exr ? "reference.exr" : "reference.png";
+  bool written = exr ? tracer.SaveEXR(path.string())
+                     : tracer.SavePNG(path.string());
+  if (!written) {
+    Log::LogMessage(Log::Level::Error, "Failed to write " + path.string());
+    return 1;
+  }
+  Log::LogMessage(Log::Level::Info, "Reference written to " + path.string());
+  return 0;
+}
+
+// 输出最近一帧各过程的GPU耗时并导出Chrome trace
+void ReportProfile(const VKRender& render, const std::string& tracePath) {
+  VKProfiler* profiler = render.getProfiler();
+  if (!profiler) return;
+  for (const auto& scope : profiler->GetLastFrameResults()) {
+    std::string line = "GPU pass " + scope.name + ": " +
+                       std::to_string(scope.gpuTimeMs) + " ms";
+    if (scope.hasStatistics) {
+      line += " (VS " +
+              std::to_string(scope.statistics.vertexShaderInvocations) +
+              ", FS " +
+              std::to_string(scope.statistics.fragmentShaderInvocations) +
+              ")";
+    }
+    Log::LogMessage(Log::Level::Info, line);
+  }
+  if (render.writeProfilerTrace(tracePath)) {
+    Log::LogMessage(Log::Level::Info, "Profiler trace written to " + tracePath);
+  }
+}
+
+// 无窗口批量渲染：渲染固定帧数并回读写出，输出帧率
+int RunHeadless(const VKContext::HeadlessConfig& config, uint32_t frameCount,
+                const Model& model, const Material& material,
+                const std::string& profilePath, bool leanGBuffer,
+                bool asyncCompute, bool textureStreaming) {
+  auto renderer = CreateHeadlessRenderer(config, model, material,
+                                         {glm::mat4(1.0f)}, textureStreaming);
+  VKRender& vkRender = renderer->render;
+  if (leanGBuffer) vkRender.setGBufferLayout(VKContext::GBufferLayout::Lean);
+  if (asyncCompute) vkRender.setAsyncComputeEnabled(true);
+  AddDefaultLights(vkRender);
+  if (!profilePath.empty()) {
+    vkRender.setProfilingEnabled(true, true);
+  }
+
+  Timer timer;
+  for (uint32_t i = 0; i < frameCount; i++) {
+    vkRender.renderFrame();
+  }
+  vkRender.flushReadbacks();
+  double seconds = timer.ElapsedSeconds();
+
+  Log::LogMessage(Log::Level::Info,
+                  "Headless: " + std::to_string(frameCount) + " frames in " +
+                      std::to_string(seconds) + " s, " +
+                      std::to_string(frameCount / seconds) + " fps (" +
+                      std::to_string(config.framesInFlight) +
+                      " frames in flight" +
+                      (vkRender.isAsyncComputeEnabled() ? ", async compute"
+                                                         : "") +
+                      ")");
+  if (vkRender.isGpuCullingEnabled()) {
+    auto culling = vkRender.getCullingStats();
+    Log::LogMessage(Log::Level::Info,
+                    "GPU culling: " + std::to_string(culling.Visible()) +
+                        "/" + std::to_string(culling.drawCount) +
+                        " visible, " + std::to_string(culling.frustumCulled) +
+                        " frustum culled, " +
+                        std::to_string(culling.occlusionCulled) +
+                        " occlusion culled");
+  }
+  if (vkRender.isTextureStreamingEnabled()) {
+    auto streaming = vkRender.getTextureStreamingStats();
+    Log::LogMessage(
+        Log::Level::Info,
+        "Texture streaming: " +
+            std::to_string(streaming.residentBytes / (1024 * 1024)) + "/" +
+            std::to_string(streaming.budgetBytes / (1024 * 1024)) +
+            " MiB resident, " + std::to_string(streaming.streamIns) +
+            " stream-ins, " + std::to_string(streaming.evictions) +
+            " evictions, first frame after " +
+            std::to_string(vkRender.getTimeToFirstFrameMs()) + " ms");
+  }
+  auto pipelines = vkRender.getPipelineCacheStats();
+  Log::LogMessage(Log::Level::Info,
+                  "Pipeline cache: " + std::to_string(pipelines.ready) +
+                      " ready, " + std::to_string(pipelines.compiled) +
+                      " compiled in " +
+                      std::to_string(pipelines.compileMs) + " ms, " +
+                      std::to_string(pipelines.fallbacks) + " fallbacks, " +
+                      std::to_string(pipelines.misses) + " skipped");
+  if (!profilePath.empty()) {
+    ReportProfile(vkRender, profilePath);
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  bool benchRecording = false;
+  bool benchCulling = false;
+  bool benchBVH = false;
+  bool benchLighting = false;
+  bool benchGBuffer = false;
+  bool benchTransforms = false;
+  uint32_t pathTraceSamples = 0;
+  bool leanGBuffer = false;
+  bool asyncCompute = false;
+  bool textureStreaming = true;
+  bool iblCompute = false;
+  std::string iblPath;
+  bool headless = false;
+  uint32_t headlessFrames = 100;
+  VKContext::HeadlessConfig headlessConfig;
+  std::string profilePath;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--bench-recording") {
+      benchRecording = true;
+    } else if (arg == "--bench-culling") {
+      benchCulling = true;
+    } else if (arg == "--bench-bvh") {
+      benchBVH = true;
+    } else if (arg == "--bench-lighting") {
+      benchLighting = true;
+    } else if (arg == "--bench-gbuffer") {
+      benchGBuffer = true;
+    } else if (arg == "--bench-transforms") {
+      benchTransforms = true;
+    } else if (arg == "--path-trace" && hasValue) {
+      pathTraceSamples = static_cast<uint32_t>(std::stoul(argv[++i]));
+    } else if (arg == "--gbuffer-lean") {
+      leanGBuffer = true;
+    } else if (arg == "--async-compute") {
+      asyncCompute = true;
+    } else if (arg == "--no-texture-streaming") {
+      textureStreaming = false;
+    } else if (arg == "--bake-ibl" && hasValue) {
+      iblPath = argv[++i];
+    } else if (arg == "--ibl-compute") {
+      iblCompute = true;
+    } else if (arg == "--headless") {
+      headless = true;
+    } else if (arg == "--frames" && hasValue) {
+      headlessFrames = static_cast<uint32_t>(std::stoul(argv[++i]));
+    } else if (arg == "--frames-in-flight" && hasValue) {
+      headlessConfig.framesInFlight =
+          static_cast<uint32_t>(std::stoul(argv[++i]));
+    } else if (arg == "--output" && hasValue) {
+      headlessConfig.outputDirectory = argv[++i];
+    } else if (arg == "--exr") {
+      headlessConfig.fileFormat = VKOffscreenTarget::FileFormat::EXR;
+    } else if (arg == "--profile" && hasValue) {
+      profilePath = argv[++i];
+    }
+  }
+
+  // 纯CPU基准，不需要窗口与设备
+  if (benchCulling) {
+    int result = RunCullingBenchmark(100000);
+    Log::Shutdown();
+    return result;
+  }
+  if (benchBVH) {
+    RunMeshBVHBenchmark(724);
+    Log::Shutdown();
+    return 0;
+  }
+  if (!iblPath.empty()) {
+    int result = RunIBLBake(iblPath, iblCompute, headlessConfig);
+    Log::Shutdown();
+    return result;
+  }
+
   API enableApi = API::Vulkan;
   auto squareModel = CreateSquareModel();
 
@@ -56,9 +886,69 @@ int main() {
   material.name = "Metal";
   material.baseColor = baseColorInput;
 
+  if (pathTraceSamples > 0) {
+    int result = RunPathTracer(headlessConfig, squareModel, material,
+                               pathTraceSamples);
+    Log::Shutdown();
+    return result;
+  }
+  if (benchLighting) {
+    int result = RunLightingBenchmark(headlessConfig, material);
+    Log::Shutdown();
+    return result;
+  }
+  if (benchGBuffer) {
+    int result = RunGBufferBenchmark(headlessConfig, material);
+    Log::Shutdown();
+    return result;
+  }
+  if (benchTransforms) {
+    int result = RunTransformBenchmark(headlessConfig, material, 100000);
+    Log::Shutdown();
+    return result;
+  }
+  if (headless) {
+    int result =
+        RunHeadless(headlessConfig, headlessFrames, squareModel, material,
+                    profilePath, leanGBuffer, asyncCompute, textureStreaming);
+    Log::Shutdown();
+    return result;
+  }
+
   Window windowsHandler(800, 600, enableApi, "PBR Renderer");
   windowsHandler.createContext();
+
+  Camera::CreateInfo cameraInfo;
+  cameraInfo.aspectRatio = windowsHandler.GetAspectRatio();
+  Camera camera(cameraInfo);
+  windowsHandler.SetCamera(&camera);
+
   VKRender vkRender;
+  vkRender.setTextureStreamingEnabled(textureStreaming);
+  vkRender.setModel(squareModel);
+  vkRender.setMaterial(material);
   vkRender.init(&windowsHandler);
+  if (leanGBuffer) vkRender.setGBufferLayout(VKContext::GBufferLayout::Lean);
+  if (asyncCompute) vkRender.setAsyncComputeEnabled(true);
+  if (benchRecording) {
+    RunRecordingBenchmark(vkRender, 20000);
+    Log::Shutdown();
+    return 0;
+  }
+  vkRender.addRenderObject(glm::mat4(1.0f));
+  AddDefaultLights(vkRender);
+  if (!profilePath.empty()) {
+    vkRender.setProfilingEnabled(true, true);
+  }
+
+  while (!windowsHandler.ShouldClose()) {
+    windowsHandler.PollEvents();
+    windowsHandler.UpdateDeltaTime();
+    windowsHandler.ProcessInput();
+    vkRender.renderFrame();
+  }
+  if (!profilePath.empty()) {
+    ReportProfile(vkRender, profilePath);
+  }
   Log::Shutdown();
 }